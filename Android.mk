@@ -7,21 +7,36 @@ LOCAL_EXPORT_C_INCLUDES := $(LOCAL_PATH)/include/
 LOCAL_C_INCLUDES := \
 	$(LOCAL_PATH)/include/
 LOCAL_SRC_FILES := \
+	src/arena.cpp \
+	src/async.cpp \
+	src/cesp_profile.cpp \
+	src/checksum.cpp \
+	src/cip_profile.cpp \
         src/compressor.cpp \
 	src/cprofile.cpp \
+	src/crc.cpp \
 	src/crtp_profile.cpp \
+	src/crtplite_profile.cpp \
 	src/ctcp_profile.cpp \
 	src/cudp_profile.cpp \
+	src/cudplite_profile.cpp \
 	src/cuncomp_profile.cpp \
 	src/decomp.cpp \
+	src/desp_profile.cpp \
+	src/dip_profile.cpp \
 	src/dprofile.cpp \
 	src/drtp_profile.cpp \
+	src/drtplite_profile.cpp \
 	src/dtcp_profile.cpp \
 	src/dudp_profile.cpp \
+	src/dudplite_profile.cpp \
 	src/duncomp_profile.cpp \
+	src/flow_table.cpp \
 	src/lsb.cpp \
 	src/network.cpp \
-	src/rohc.cpp 
+	src/reader.cpp \
+	src/rohc.cpp \
+	src/tcp_profile_supp.cpp
         
 include $(BUILD_STATIC_LIBRARY)
 
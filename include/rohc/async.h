@@ -0,0 +1,113 @@
+#pragma once
+
+#include "rohc.h"
+#include "compressor.h"
+#include "decomp.h"
+
+namespace ROHC
+{
+    enum CompletionStatus
+    {
+        COMPLETION_OK,          // output contains a packet
+        COMPLETION_NO_OUTPUT    // nothing to deliver, packet dropped or only carried feedback
+    };
+
+    /**
+     * Called from AsyncChannel::Process when a submitted packet has been
+     * handled. data is only valid during the call.
+     */
+    typedef void (*CompletionCallback)(void* user, CompletionStatus status, const uint8_t* data, size_t size);
+
+    /**
+     * Called from AsyncChannel::Process with feedback that could not be
+     * piggybacked on a compressed packet in the same batch. The data is
+     * formatted according to RFC 4995, 5.2.4.1 and can be sent as a
+     * feedback only ROHC packet. data is only valid during the call.
+     */
+    typedef void (*FeedbackCallback)(void* user, const uint8_t* data, size_t size);
+
+    /**
+     * Front-end for event loop (epoll, io_uring, ...) integration.
+     *
+     * The channel owns a compressor for the outgoing direction and a
+     * decompressor for the incoming direction of one link, with the
+     * decompressor feedback routed to the compressor. Packets are submitted
+     * together with a completion callback and are processed in one batch
+     * when Process is called, typically once per loop iteration.
+     * Within a batch, received packets are decompressed before outgoing
+     * packets are compressed, so feedback they trigger is piggybacked
+     * directly. The outgoing packets are compressed with the batch
+     * Compressor::compress before their callbacks are invoked.
+     *
+     * The channel is not thread safe, all calls have to be made from the
+     * thread running the loop.
+     */
+    class AsyncChannel
+    {
+        void operator=(const AsyncChannel&);
+        AsyncChannel(const AsyncChannel&);
+    public:
+        AsyncChannel(size_t maxCID, Reordering_t reorder_ratio, IPIDBehaviour_t ip_id_behaviour);
+
+        void SetFeedbackCallback(FeedbackCallback callback, void* user);
+
+        /**
+         * The data is copied, the buffer can be reused when the call returns.
+         */
+        void SubmitCompress(const uint8_t* data, size_t size, CompletionCallback callback, void* user);
+        void SubmitDecompress(const uint8_t* data, size_t size, CompletionCallback callback, void* user);
+
+        /**
+         * Process all submitted packets and invoke their callbacks.
+         * Callbacks may submit new packets, these are handled by the next
+         * call to Process.
+         * Returns the number of completed packets.
+         */
+        size_t Process();
+
+        size_t Pending() const {return numberOfCompressRequests + numberOfDecompressRequests;}
+
+        Compressor& GetCompressor() {return compressor;}
+        Decompressor& GetDecompressor() {return decompressor;}
+
+    private:
+        struct Request
+        {
+            Request() : data(), output(), callback(0), user(0) {}
+            data_t data;
+            data_t output;
+            CompletionCallback callback;
+            void* user;
+        };
+        typedef std::vector<Request> requests_t;
+
+        static void Submit(requests_t& requests, size_t& numberOfRequests, const uint8_t* data, size_t size, CompletionCallback callback, void* user);
+        void Complete(const Request& request);
+        void DeliverFeedback();
+
+        Compressor compressor;
+        Decompressor decompressor;
+
+        FeedbackCallback feedbackCallback;
+        void* feedbackUser;
+
+        /**
+         * Requests are kept between batches to reuse their buffers,
+         * only the first numberOf*Requests are valid.
+         */
+        requests_t compressRequests;
+        size_t numberOfCompressRequests;
+        requests_t decompressRequests;
+        size_t numberOfDecompressRequests;
+
+        // Swapped with the pending requests while processing a batch
+        requests_t decompressing;
+        requests_t compressing;
+        std::vector<const data_t*> batchPackets;
+        std::vector<data_t*> batchOutputs;
+
+        // Feedback that could not be piggybacked
+        data_t output;
+    };
+
+} // ns ROHC
@@ -1,12 +1,16 @@
 #pragma once
 
 #include "rohc.h"
+#include "statistics.h"
 #include <vector>
 #include <deque>
+#include <map>
 
 namespace ROHC
 {
     class CProfile;
+    class ContextArena;
+    class FlowTable;
     
     struct RTPDestination
     {
@@ -35,15 +39,41 @@ namespace ROHC
          * 1-16383 streams can be handled
          *
          * mrru: Maximum Reconstructed Reception Unit.
-         * Largest reconstructed unit in octets the system can handle.
-         * If 0, possible segments have to be thrown away.
+         * Largest reconstructed unit in octets the decompressor can handle,
+         * including the CRC. If 0, packets are never segmented.
          */
-        explicit Compressor(size_t maxCID, Reordering_t reorder_ratio, IPIDBehaviour_t ip_id_behaviour);
+        explicit Compressor(size_t maxCID, Reordering_t reorder_ratio, IPIDBehaviour_t ip_id_behaviour, size_t mrru = 0);
 
 		~Compressor();
         
         void compress(const data_t& data, data_t& output);
         void compress(const uint8_t* data, size_t size, data_t& output);
+
+        /**
+         * Compresses count packets, packets[i] into outputs[i], with the
+         * same result as compressing them one by one. Packets that are the
+         * predicted next packet of their RTP flow are found in batches,
+         * without classifying them and searching the contexts.
+         *
+         * Received feedback is handled once before the batch, and all
+         * contexts used in the batch get the same last used time.
+         */
+        void compress(const data_t* const* packets, data_t* const* outputs, size_t count);
+
+        /**
+         * Compresses data into outputs, one ROHC packet of at most mtu
+         * octets each. A packet that does not fit is sent as segments
+         * (RFC 4995, 5.2.5) if its reconstructed unit fits in the MRRU,
+         * otherwise it is sent whole. Piggybacked feedback goes in front
+         * of the first segment, as far as it fits in the mtu, the rest is
+         * sent with the next packets.
+         *
+         * An mtu of 1 octet leaves no room for a segment, the packet is
+         * rejected and outputs is left empty. An mtu of 0 is no limit.
+         */
+        void compress(const data_t& data, std::vector<data_t>& outputs, size_t mtu);
+
+        size_t MRRU() const {return mrru;}
         
         
         /**
@@ -52,8 +82,24 @@ namespace ROHC
          */
         void SendFeedback(const_data_iterator begin, const_data_iterator end);
 
+        /**
+         * Same as above, but for feedback concerning a single CID (called by
+         * the decompressor). Only one feedback element per CID is kept until
+         * it is sent: a newer ACK replaces an older one, while a pending
+         * NACK or STATIC-NACK is never replaced by a feedback of lower
+         * precedence (ACK < NACK < STATIC-NACK).
+         */
+        void SendFeedback(uint16_t cid, FBAckType_t type, const_data_iterator begin, const_data_iterator end);
+
         
-        void AppendFeedback(data_t& data);
+        /**
+         * Appends the feedback to piggyback to data. With a limit, only
+         * whole feedback elements of at most limit octets in total are
+         * appended and the others are kept for the next packets, except an
+         * element larger than limit, which could never be sent and is
+         * dropped.
+         */
+        void AppendFeedback(data_t& data, size_t limit = 0);
         /*
          * called by the decompressor
          */
@@ -80,42 +126,113 @@ namespace ROHC
         // After this many packets, the compressor will advance to SO state
         unsigned int NumberOfFOPacketsToSend() const {return 5;}
 
-		void IncreasePacketCount(PacketType packetType) {++statistics[packetType];}
-		size_t PacketCount(PacketType packetType) {return statistics[packetType];}
+        // A NACK is answered with this many co_repair packets
+        unsigned int NumberOfCORepairPacketsToSend() const {return 3;}
+
+        /**
+         * Memory for the contexts, see SetArenaPolicy
+         */
+        ContextArena* Arena() const {return arena;}
+
+        /**
+         * Predicted RTP flows, used by the batch compress
+         */
+        FlowTable* Flows() const {return flows;}
+
+		/**
+		 * Called by the profile for the packet it is sending, counted
+		 * by CompressPacket in the same update as the totals
+		 */
+		void IncreasePacketCount(PacketType packetType)
+		{
+			reportedPacketType = packetType;
+			packetTypeReported = true;
+		}
+		size_t PacketCount(PacketType packetType) {return statistics.Counters().packetCount[packetType];}
         
 
 		// Ports in host byte order
         void addRTPDestinationPort(uint16_t dport);
         void removeRTPDestinationPort(uint16_t dport);
         
-        size_t NumberOfPacketsSent() const {return numberOfPacketsSent;}
-        size_t UncompressedSize() const {return dataSizeUncompressed;}
-        size_t CompressedSize() const {return dataSizeCompressed;}
+        /**
+         * These are only valid from the thread calling compress,
+         * use StatisticsSnapshot from other threads
+         */
+        size_t NumberOfPacketsSent() const {return statistics.Counters().numberOfPacketsSent;}
+        size_t UncompressedSize() const {return statistics.Counters().dataSizeUncompressed;}
+        size_t CompressedSize() const {return statistics.Counters().dataSizeCompressed;}
+
+        /**
+         * Thread safe, can be called by a monitoring thread while
+         * another thread is compressing. Snapshots from several
+         * compressors can be added together. A packet, its type and
+         * its sizes are counted in a single update, so a snapshot never
+         * has one without the others.
+         */
+        void StatisticsSnapshot(CompressorStatistics& snapshot) const {statistics.Snapshot(snapshot);}
+
+        /**
+         * Counters of the context with cid, false if there is none. Only
+         * valid from the thread calling compress.
+         */
+        bool ContextCounters(uint16_t cid, ContextStatistics& counters) const;
     private:
         CProfile* findProfile(unsigned profileId, const void* ip);
+        /**
+         * profile is looked up if null, returns the size of the feedback
+         * put in front of the packet, at most feedbackLimit octets unless 0
+         */
+        size_t CompressPacket(const data_t& data, data_t& output, CProfile* profile, time_t now, size_t feedbackLimit = 0);
+        /**
+         * Splits outputs[0], a compressed packet after feedbackSize octets
+         * of feedback, into segments of at most mtu octets
+         */
+        void Segment(std::vector<data_t>& outputs, size_t feedbackSize, size_t mtu);
 
 		void HandleReceivedFeedback();
         size_t maxCID;
         
+        ContextArena* arena;
         contexts_t contexts;
+        // Changed when a context is created, invalidates the CIDs found by a batch
+        unsigned int contextGeneration;
+        FlowTable* flows;
         
+        struct PendingFeedback
+        {
+            PendingFeedback() : type(FB_ACK), data() {}
+            FBAckType_t type;
+            data_t data;
+        };
+        typedef std::map<uint16_t, PendingFeedback> pendingFeedback_t;
+
+        // Feedback to be piggybacked, pre formatted
         data_t feedbackData;
+        // Feedback to be piggybacked, one element per CID
+        pendingFeedback_t pendingFeedback;
 		void* feedbackMutex;
+        // Set when there is feedback to piggyback, written under
+        // feedbackMutex, read without it to skip the lock when there is none
+        int feedbackPending;
         
         Reordering_t reorder_ratio;
         
         IPIDBehaviour_t ip_id_behaviour;
-        
-        /**
-         * Statistics
-         */
-        size_t numberOfPacketsSent;
-        size_t dataSizeUncompressed;
-        size_t dataSizeCompressed;
+
+        size_t mrru;
+        // The reconstructed unit being segmented
+        data_t unit;
         
         std::vector<RTPDestination> rtpDestinations;
 
-		size_t statistics[PT_2_SEQ_TS + 1];
+        /**
+         * Statistics, only written by the thread calling compress
+         */
+        CounterBlock<CompressorStatistics> statistics;
+        // The type of the packet being compressed, see IncreasePacketCount
+        PacketType reportedPacketType;
+        bool packetTypeReported;
 
 		struct Feedback1 {
 			Feedback1(uint16_t cid, uint8_t lsbMSN) : cid(cid), lsbMSN(lsbMSN) {}
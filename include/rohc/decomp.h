@@ -1,12 +1,12 @@
 #pragma once
 
 #include "rohc.h"
-#include <map>
 
 namespace ROHC
 {
     class Compressor;
     class DProfile;
+    class ContextArena;
     
     class Decompressor
     {
@@ -15,13 +15,24 @@ namespace ROHC
         Decompressor();
         Decompressor(const Decompressor&);
 
-        typedef std::map<uint32_t, DProfile*> context_t;
+        // Indexed by CID
+        typedef std::vector<DProfile*> context_t;
     public:
-        Decompressor(bool largeCID, Compressor* compressor);
+        /**
+         * mrru: Maximum Reconstructed Reception Unit, the largest unit
+         * reassembled from segments including the CRC (RFC 4995, 5.2.5).
+         * If 0, segments are thrown away.
+         */
+        Decompressor(bool largeCID, Compressor* compressor, size_t mrru = 0);
         ~Decompressor();
         
         bool LargeCID() const {return largeCID;}
         
+        /**
+         * Memory for the contexts, see SetArenaPolicy
+         */
+        ContextArena* Arena() const {return arena;}
+        
         
         void Decompress(const uint8_t* data, size_t dataSize, data_t& output);
         /**
@@ -42,13 +53,29 @@ namespace ROHC
         void SendFeedback1(unsigned int cid, uint8_t lsbMsn);
 
     private:
+        static const uint32_t maxLargeCID = 16383;
+        
+        // Returns 0 if there is no context for the CID
+        DProfile* Context(uint32_t cid) const;
+        
         bool ParseFeedback(data_t& data, data_iterator& pos);
+
+        /**
+         * The packet after padding and feedback
+         */
+        void DecompressPacket(data_t& data, data_iterator headerStart, data_t& output);
+        void ParseSegment(data_t& data, data_iterator pos, data_t& output);
         
         /**
          * irType is the unmasked value from the ir header
          * start of the header
          */
         void ParseIR(data_t& data, data_iterator irDataStart, data_t& output);
+        /**
+         * The dynamic chain for an existing context, the static fields
+         * are kept
+         */
+        void ParseIRDYN(data_t& data, data_iterator irDataStart, data_t& output);
         void ParseCO(data_t& data, data_iterator pos, data_t& output);
         void ParseCORepair(data_t& data, data_iterator pos, data_t& output);
         
@@ -57,7 +84,16 @@ namespace ROHC
         Compressor* compressor;
         bool largeCID;
         
+        ContextArena* arena;
         context_t contexts;
+
+        size_t mrru;
+        // Segments received so far, at most mrru octets
+        data_t reassembly;
+        // A unit larger than the MRRU is dropped up to its final segment
+        bool discardingSegments;
+        // The reassembled unit being decompressed
+        data_t unit;
         
         /**
          * Statistics
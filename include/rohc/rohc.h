@@ -69,7 +69,9 @@ namespace ROHC
      * 1111 111x
      */
     static const uint8_t segment = 0xfe;
+    static const uint8_t finalSegment = 0xff;
     inline bool isSegment(uint8_t c) {return (c & segment) == segment;}
+    inline bool isFinalSegment(uint8_t c) {return c == finalSegment;}
 
     /**
      * 1111 1011
@@ -80,6 +82,8 @@ namespace ROHC
 	enum PacketType
 	{
 		PT_IR,
+		PT_IR_DYN,
+		PT_CO_REPAIR,
 		PT_CO_COMMON,
 		PT_0_CRC3,
 		PT_0_CRC7,
@@ -89,7 +93,26 @@ namespace ROHC
 		PT_2_RND,
 		PT_2_SEQ_ID,
 		PT_2_SEQ_BOTH,
-		PT_2_SEQ_TS
+		PT_2_SEQ_TS,
+		// TCP, RFC 6846
+		PT_RND_1,
+		PT_RND_2,
+		PT_RND_3,
+		PT_RND_4,
+		PT_RND_5,
+		PT_RND_6,
+		PT_RND_7,
+		PT_RND_8,
+		PT_SEQ_1,
+		PT_SEQ_2,
+		PT_SEQ_3,
+		PT_SEQ_4,
+		PT_SEQ_5,
+		PT_SEQ_6,
+		PT_SEQ_7,
+		PT_SEQ_8,
+		// Segmentation, RFC 4995 5.2.5, counted per segment
+		PT_SEGMENT
 	};
     
     
@@ -108,6 +131,14 @@ namespace ROHC
         IP_ID_BEHAVIOUR_ZERO                = 3
     };    
     
+    // Checksum coverage of the UDP-Lite profiles
+    enum CoverageBehaviour_t
+    {
+        UDP_LITE_COVERAGE_INFERRED          = 0, // the UDP-Lite length
+        UDP_LITE_COVERAGE_STATIC            = 1,
+        UDP_LITE_COVERAGE_IRREGULAR         = 2
+    };
+    
     enum Reordering_t
     {
         REORDERING_NONE             = 0,
@@ -130,6 +161,28 @@ namespace ROHC
 		FBO_CLOCK_RESOLUTION = 0xa0
 	};
     
+    /**
+     * How the contexts of a compressor or decompressor are allocated,
+     * combination of flags
+     */
+    enum ArenaPolicy_t
+    {
+        ARENA_HEAP          = 0,    // each context allocated from the heap
+        ARENA_HUGEPAGES     = 1,    // contexts packed into 2 MB chunks, huge pages if available
+        ARENA_NUMA_LOCAL    = 2     // chunks bound to the NUMA node of the allocating thread
+    };
+
+    /**
+     * Applies to compressors and decompressors created after the call.
+     * Default is ARENA_HEAP, ARENA_HUGEPAGES | ARENA_NUMA_LOCAL is worth it
+     * with many flows per compressor, each one takes at least a 2 MB chunk.
+     *
+     * The policy is not synchronized, set it before any compressor or
+     * decompressor is created, not while other threads create them.
+     */
+    void SetArenaPolicy(unsigned int policy);
+    unsigned int ArenaPolicy();
+
     static const uint32_t TS_STRIDE_DEFAULT = 160;
     static const uint32_t TIME_STRIDE_DEFAULT = 0;
     
@@ -197,26 +250,18 @@ namespace ROHC
         return true;
     }
     
+    /**
+     * The three and four byte forms of SDVLEncode
+     */
     template<class T>
-    inline T 
-    SDVLEncode(T pos, uint32_t value)
+    T
+    SDVLEncodeLong(T pos, uint32_t value)
     {
         if (!(value <= 0x1fffffff)) {
             error("SDVLEncode, not a valid value\n");
         }
-        
-        if (value < 128)
-        {
-            uint8_t val = static_cast<uint8_t>(value);
-            *pos++ = val;
-        }
-        else if (value < 16384)
-        {
-            uint8_t val = static_cast<uint8_t>(value >> 8) | 0x80;
-            *pos++ = val;
-            *pos++ = static_cast<uint8_t>(value);
-        }
-        else if (value < 2097152)
+
+        if (value < 2097152)
         {
             uint8_t val = static_cast<uint8_t>(value >> 16) | 0xc0;
             *pos++ = val;
@@ -234,6 +279,28 @@ namespace ROHC
         
         return pos;
     }
+
+    /**
+     * RFC 4995 5.3.2, the one and two byte forms (CIDs and most
+     * ts_strides) are encoded inline
+     */
+    template<class T>
+    inline T 
+    SDVLEncode(T pos, uint32_t value)
+    {
+        if (value < 128)
+        {
+            *pos++ = static_cast<uint8_t>(value);
+            return pos;
+        }
+        if (value < 16384)
+        {
+            *pos++ = static_cast<uint8_t>((value >> 8) | 0x80);
+            *pos++ = static_cast<uint8_t>(value);
+            return pos;
+        }
+        return SDVLEncodeLong(pos, value);
+    }
         
     /**
      Print functions
@@ -245,13 +312,49 @@ namespace ROHC
     
     /**
      * CRC functions
+     *
+     * The fastest implementation for the CPU is selected during static
+     * initialization, CRCInit is kept for compatibility and does nothing.
+     *
+     * The overloads taking a crc continue from a previous register value,
+     * CRC3(CRC3(a, b), b, c) == CRC3(a, c).
+     *
+     * The CRCs are affine, CRC3Shift(crc, n) is the register after n zero
+     * octets and CRC3(crc, a, c) == CRC3Shift(CRC3(crc, a, b), c - b) ^
+     * CRC3(0, b, c), so the CRC of a block that does not change can be
+     * computed once.
      */
     void CRCInit();
     uint8_t CRC3(const_data_iterator begin, const_data_iterator end);
 	uint8_t CRC3(const uint8_t* begin, const uint8_t* end);
+	uint8_t CRC3(uint8_t crc, const uint8_t* begin, const uint8_t* end);
+	uint8_t CRC3Shift(uint8_t crc, size_t size);
     uint8_t CRC7(const_data_iterator begin, const_data_iterator end);        
 	uint8_t CRC7(const uint8_t* begin, const uint8_t* end);
+	uint8_t CRC7(uint8_t crc, const uint8_t* begin, const uint8_t* end);
+	uint8_t CRC7Shift(uint8_t crc, size_t size);
     uint8_t CRC8(const_data_iterator begin, const_data_iterator end);        
+	uint8_t CRC8(const uint8_t* begin, const uint8_t* end);
+	uint8_t CRC8(uint8_t crc, const uint8_t* begin, const uint8_t* end);
+    /**
+     * FCS-32 of RFC 1662, the CRC of a reconstructed unit of segments
+     * (RFC 4995, 5.2.5)
+     */
+    uint32_t CRC32(const uint8_t* begin, const uint8_t* end);
+
+    /**
+     * The kernels behind CRC3, CRC7 and CRC8 for a width of 3, 7 or 8,
+     * for the tests. clmul is null when it is not built or the CPU does
+     * not have it, it uses slice below clmulMinimumSize octets.
+     */
+    struct CRCKernels
+    {
+        uint8_t (*slice)(uint8_t crc, const uint8_t* begin, const uint8_t* end);
+        uint8_t (*clmul)(uint8_t crc, const uint8_t* begin, const uint8_t* end);
+        size_t clmulMinimumSize;
+    };
+
+    CRCKernels GetCRCKernels(unsigned int width);
     
     
     time_t millisSinceEpoch();
@@ -281,6 +384,20 @@ namespace ROHC
         data.push_back(static_cast<uint8_t>((value >> 8) & 0xff));
         data.push_back(static_cast<uint8_t>(value & 0xff));
     }
+
+    inline void SetNBO(uint8_t* p, uint32_t value)
+    {
+        p[0] = static_cast<uint8_t>(value >> 24);
+        p[1] = static_cast<uint8_t>(value >> 16);
+        p[2] = static_cast<uint8_t>(value >> 8);
+        p[3] = static_cast<uint8_t>(value);
+    }
+
+    inline void SetNBO(uint8_t* p, uint16_t value)
+    {
+        p[0] = static_cast<uint8_t>(value >> 8);
+        p[1] = static_cast<uint8_t>(value);
+    }
     
     template<class T, class Iter>
     bool GetValue(Iter& pos, const Iter end, T& value)
@@ -299,7 +416,6 @@ namespace ROHC
         if ((end - pos) < static_cast<int>(sizeof(uint16_t))) {
             return false;
         }
-        // TODO fix big endian
         const uint8_t* p8 = reinterpret_cast<const uint8_t*>(&*pos);
         value = (p8[0] << 8) | p8[1];
 		pos += sizeof(uint16_t);
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "rohc.h"
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define ROHC_CACHE_ALIGNED __declspec(align(64))
+#define ROHC_RELEASE_FENCE() _ReadWriteBarrier()
+#define ROHC_ACQUIRE_FENCE() _ReadWriteBarrier()
+#define ROHC_LOAD_RELAXED(v) (*static_cast<volatile int*>(&(v)))
+#define ROHC_STORE_RELAXED(v, x) (*static_cast<volatile int*>(&(v)) = (x))
+#else
+#define ROHC_CACHE_ALIGNED __attribute__((aligned(64)))
+#define ROHC_RELEASE_FENCE() __atomic_thread_fence(__ATOMIC_RELEASE)
+#define ROHC_ACQUIRE_FENCE() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define ROHC_LOAD_RELAXED(v) __atomic_load_n(&(v), __ATOMIC_RELAXED)
+#define ROHC_STORE_RELAXED(v, x) __atomic_store_n(&(v), (x), __ATOMIC_RELAXED)
+#endif
+
+namespace ROHC
+{
+    /**
+     * Counters kept by a compressor, see Compressor::StatisticsSnapshot
+     */
+    struct CompressorStatistics
+    {
+        CompressorStatistics() { Reset(); }
+
+        void Reset()
+        {
+            numberOfPacketsSent = 0;
+            dataSizeUncompressed = 0;
+            dataSizeCompressed = 0;
+            memset(packetCount, 0, sizeof(packetCount));
+        }
+
+        /**
+         * Used to aggregate snapshots from several compressors (shards)
+         */
+        CompressorStatistics& operator+=(const CompressorStatistics& other)
+        {
+            numberOfPacketsSent += other.numberOfPacketsSent;
+            dataSizeUncompressed += other.dataSizeUncompressed;
+            dataSizeCompressed += other.dataSizeCompressed;
+            for (size_t i = 0; i < sizeof(packetCount) / sizeof(packetCount[0]); ++i) {
+                packetCount[i] += other.packetCount[i];
+            }
+            return *this;
+        }
+
+        size_t numberOfPacketsSent;
+        size_t dataSizeUncompressed;
+        size_t dataSizeCompressed;
+        size_t packetCount[PT_SEGMENT + 1];
+    };
+
+    /**
+     * Counters of one compressor context, see Compressor::ContextCounters
+     */
+    struct ContextStatistics
+    {
+        ContextStatistics() { Reset(); }
+
+        void Reset()
+        {
+            profileID = 0;
+            numberOfPacketsSent = 0;
+            dataSizeUncompressed = 0;
+            dataSizeCompressed = 0;
+            predictionHits = 0;
+            predictionMisses = 0;
+        }
+
+        unsigned int profileID;
+        size_t numberOfPacketsSent;
+        size_t dataSizeUncompressed;
+        size_t dataSizeCompressed;
+        // Packets that matched the predicted header and were sent from the
+        // cached encoding, and packets that had a prediction but did not
+        size_t predictionHits;
+        size_t predictionMisses;
+    };
+
+    /**
+     * A block of counters with a single writer, the thread owning the
+     * compressor. The writer never uses atomic instructions, it bumps a
+     * sequence number before and after each update. A reader on any other
+     * thread copies the counters and retries if the sequence number was odd
+     * or changed during the copy (a sequence lock).
+     *
+     * The block is cache line aligned so that counters of different
+     * compressors never share a line.
+     */
+    template<class T>
+    class ROHC_CACHE_ALIGNED CounterBlock
+    {
+        void operator=(const CounterBlock&);
+        CounterBlock(const CounterBlock&);
+    public:
+        CounterBlock() : sequence(0), counters() {}
+
+        /**
+         * Writer side, only to be called by the owning thread.
+         * Every BeginUpdate has to be followed by an EndUpdate.
+         */
+        T& BeginUpdate()
+        {
+            sequence = sequence + 1;
+            ROHC_RELEASE_FENCE();
+            return counters;
+        }
+
+        void EndUpdate()
+        {
+            ROHC_RELEASE_FENCE();
+            sequence = sequence + 1;
+        }
+
+        /**
+         * Direct access, only valid from the owning thread
+         */
+        const T& Counters() const { return counters; }
+
+        /**
+         * Can be called from any thread, returns a consistent copy
+         */
+        void Snapshot(T& snapshot) const
+        {
+            for (;;) {
+                unsigned int before = sequence;
+                ROHC_ACQUIRE_FENCE();
+                if (before & 1) {
+                    continue;
+                }
+                snapshot = counters;
+                ROHC_ACQUIRE_FENCE();
+                if (before == sequence) {
+                    return;
+                }
+            }
+        }
+
+    private:
+        volatile unsigned int sequence;
+        T counters;
+    };
+
+} // ns ROHC
@@ -0,0 +1,417 @@
+#include "benchmark.h"
+
+#include <rohc/compressor.h>
+#include <rohc/decomp.h>
+#include "../src/network.h"
+#include <arpa/inet.h>
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+PerfCounter::PerfCounter(uint32_t type, uint64_t config)
+: fd(-1)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+PerfCounter::~PerfCounter() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+void PerfCounter::Start() {
+    if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+void PerfCounter::Resume() {
+    if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+void PerfCounter::Stop() {
+    if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+}
+
+uint64_t PerfCounter::Value() const {
+    uint64_t value = 0;
+    if (fd < 0 || read(fd, &value, sizeof(value)) != sizeof(value)) {
+        return 0;
+    }
+    return value;
+}
+
+uint64_t nanoTime() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+namespace {
+    struct Result {
+        Result() : nanos(0), tlbMisses(0), tlbValid(false) {}
+        uint64_t nanos;
+        uint64_t tlbMisses;
+        bool tlbValid;
+    };
+
+    Result runPass(const packets_t& packets, const std::vector<int>& rtpPorts) {
+        ROHC::Compressor comp(16383, ROHC::REORDERING_NONE, ROHC::IP_ID_BEHAVIOUR_RANDOM);
+        ROHC::Decompressor decomp(true, &comp);
+        for (std::vector<int>::const_iterator i = rtpPorts.begin(); rtpPorts.end() != i; ++i) {
+            comp.addRTPDestinationPort(*i);
+        }
+
+        PerfCounter dtlb(PERF_TYPE_HW_CACHE,
+                         PERF_COUNT_HW_CACHE_DTLB
+                         | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                         | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+
+        ROHC::data_t compressed;
+        ROHC::data_t decompressed;
+
+        Result result;
+        dtlb.Start();
+        uint64_t start = nanoTime();
+        for (packets_t::const_iterator p = packets.begin(); packets.end() != p; ++p) {
+            compressed.clear();
+            comp.compress(*p, compressed);
+            decompressed.clear();
+            decomp.Decompress(compressed, decompressed);
+        }
+        result.nanos = nanoTime() - start;
+        dtlb.Stop();
+        result.tlbValid = dtlb.Valid();
+        result.tlbMisses = dtlb.Value();
+        return result;
+    }
+
+    void runPolicy(const char* name, unsigned int policy, const packets_t& packets, const std::vector<int>& rtpPorts, unsigned int passes) {
+        ROHC::SetArenaPolicy(policy);
+
+        // Best of the passes, each pass starts with fresh contexts
+        Result best;
+        for (unsigned int i = 0; i < passes; ++i) {
+            Result r = runPass(packets, rtpPorts);
+            if (!i || r.nanos < best.nanos) {
+                best = r;
+            }
+        }
+
+        double perPacket = static_cast<double>(best.nanos) / packets.size();
+        std::cout << name << ": " << perPacket << " ns/packet, "
+                  << (1e9 / perPacket) << " packets/s, dTLB load misses/packet: ";
+        if (best.tlbValid) {
+            std::cout << static_cast<double>(best.tlbMisses) / packets.size();
+        } else {
+            std::cout << "n/a";
+        }
+        std::cout << "\n";
+    }
+
+    const int rtpPort = 5004;
+
+    /**
+     * Packet i of a flow, sequential or random IP-ID. The irregularities
+     * make the compressor use every CO format of the profile.
+     */
+    ROHC::data_t createPacket(unsigned int i, bool rtp, bool sequentialIPID) {
+        const size_t payload = 160;
+        size_t headers = sizeof(ROHC::iphdr) + sizeof(ROHC::udphdr) + (rtp ? sizeof(ROHC::rtphdr) : 0);
+        ROHC::data_t packet(headers + payload, 0);
+        std::fill(packet.begin() + headers, packet.end(), 0xa5);
+
+        // Sequence gaps that need more MSN bits
+        uint16_t sn = static_cast<uint16_t>(i + (i / 17) * 5 + (i / 101) * 40);
+
+        ROHC::iphdr* ip = reinterpret_cast<ROHC::iphdr*>(&packet[0]);
+        ip->version = 4;
+        ip->ihl = 5;
+        ip->tos = 0;
+        ip->tot_len = htons(static_cast<uint16_t>(packet.size()));
+        ip->id = sequentialIPID ? htons(static_cast<uint16_t>(1000 + sn + (i / 13) * 3)) : static_cast<uint16_t>(rand());
+        ip->frag_off = htons(0x4000);
+        ip->ttl = (i % 60 == 59) ? 63 : 64;
+        ip->protocol = 17;
+        ip->saddr = htonl(0x0a000001);
+        ip->daddr = htonl(0x0a000002);
+        ROHC::calculateIpHeaderCheckSum(ip);
+
+        ROHC::udphdr* udp = reinterpret_cast<ROHC::udphdr*>(ip + 1);
+        udp->source = htons(4000);
+        udp->dest = htons(rtp ? rtpPort : 6000);
+        udp->len = htons(static_cast<uint16_t>(packet.size() - sizeof(ROHC::iphdr)));
+        udp->check = 0;
+
+        if (rtp) {
+            ROHC::rtphdr* r = reinterpret_cast<ROHC::rtphdr*>(udp + 1);
+            r->version = 2;
+            r->marker = (i % 9 == 0) ? 1 : 0;
+            r->payload_type = 0;
+            r->sequence_number = htons(sn);
+            // Timestamp jumps that break the inferred timestamp
+            r->timestamp = htonl(5000 + 160 * (sn + (i / 97) * 4));
+            r->ssrc = htonl(0x11223344);
+        }
+        return packet;
+    }
+
+    void runParsePass(const char* name, ROHC::IPIDBehaviour_t behaviour, unsigned int passes) {
+        const unsigned int count = 20000;
+        uint64_t best = 0;
+        size_t packetCount = 0;
+        for (unsigned int pass = 0; pass < passes; ++pass) {
+            srand(1);
+            ROHC::Compressor comp(15, ROHC::REORDERING_NONE, behaviour);
+            comp.addRTPDestinationPort(rtpPort);
+            ROHC::Decompressor decomp(false, &comp);
+
+            // Alternating RTP and UDP flows, compressed up front
+            packets_t compressed;
+            compressed.reserve(2 * count);
+            bool sequential = behaviour <= ROHC::IP_ID_BEHAVIOUR_SEQUENTIAL_SWAPPED;
+            for (unsigned int i = 0; i < count; ++i) {
+                for (int rtp = 0; rtp < 2; ++rtp) {
+                    compressed.push_back(ROHC::data_t());
+                    comp.compress(createPacket(i, rtp != 0, sequential), compressed.back());
+                }
+            }
+
+            ROHC::data_t decompressed;
+            uint64_t start = nanoTime();
+            for (packets_t::iterator p = compressed.begin(); compressed.end() != p; ++p) {
+                decompressed.clear();
+                decomp.Decompress(*p, decompressed);
+            }
+            uint64_t nanos = nanoTime() - start;
+            if (!pass || nanos < best) {
+                best = nanos;
+            }
+            packetCount = compressed.size();
+        }
+        std::cout << name << ": " << packetCount << " packets, "
+                  << static_cast<double>(best) / packetCount << " ns/packet\n";
+    }
+
+    struct VoiceTrace {
+        const char* name;
+        uint8_t payloadType;
+        uint32_t tsStride;
+        // Frame sizes are cycled through
+        const size_t* frameSizes;
+        size_t numberOfFrameSizes;
+    };
+
+    const size_t g711Frames[] = {160};
+    const size_t opusFrames[] = {63, 71, 80, 58, 95, 102, 77, 66};
+
+    /**
+     * Packet i of a voice flow, sequence number and timestamp advance by
+     * one frame and nothing else changes
+     */
+    ROHC::data_t createVoicePacket(const VoiceTrace& trace, unsigned int i, unsigned int flow = 0) {
+        size_t headers = sizeof(ROHC::iphdr) + sizeof(ROHC::udphdr) + sizeof(ROHC::rtphdr);
+        ROHC::data_t packet(headers + trace.frameSizes[i % trace.numberOfFrameSizes], 0);
+        std::fill(packet.begin() + headers, packet.end(), 0x5a);
+
+        ROHC::iphdr* ip = reinterpret_cast<ROHC::iphdr*>(&packet[0]);
+        ip->version = 4;
+        ip->ihl = 5;
+        ip->tot_len = htons(static_cast<uint16_t>(packet.size()));
+        ip->id = htons(static_cast<uint16_t>(2000 + 1000 * flow + i));
+        ip->frag_off = htons(0x4000);
+        ip->ttl = 64;
+        ip->protocol = 17;
+        ip->saddr = htonl(0x0a000001);
+        ip->daddr = htonl(0x0a000002);
+        ROHC::calculateIpHeaderCheckSum(ip);
+
+        ROHC::udphdr* udp = reinterpret_cast<ROHC::udphdr*>(ip + 1);
+        udp->source = htons(static_cast<uint16_t>(4000 + 2 * flow));
+        udp->dest = htons(rtpPort);
+        udp->len = htons(static_cast<uint16_t>(packet.size() - sizeof(ROHC::iphdr)));
+
+        ROHC::rtphdr* r = reinterpret_cast<ROHC::rtphdr*>(udp + 1);
+        r->version = 2;
+        r->payload_type = trace.payloadType;
+        r->sequence_number = htons(static_cast<uint16_t>(100 + i));
+        r->timestamp = htonl(8000 + trace.tsStride * i);
+        r->ssrc = htonl(0x55667788 + flow);
+        return packet;
+    }
+
+    void runCompressPass(const VoiceTrace& trace, unsigned int passes) {
+        const unsigned int count = 50000;
+        packets_t packets;
+        packets.reserve(count);
+        for (unsigned int i = 0; i < count; ++i) {
+            packets.push_back(createVoicePacket(trace, i));
+        }
+
+        // The cost of reading the clock, taken off each timed packet
+        uint64_t start = nanoTime();
+        for (unsigned int i = 0; i < count; ++i) {
+            nanoTime();
+        }
+        uint64_t clockCost = (nanoTime() - start) / count;
+
+        uint64_t bestNanos = 0;
+        uint64_t bestCycles = 0;
+        bool cyclesValid = false;
+        size_t pt0crc3 = 0;
+        size_t predictionHits = 0;
+        size_t predictionMisses = 0;
+        for (unsigned int pass = 0; pass < passes; ++pass) {
+            ROHC::Compressor comp(15, ROHC::REORDERING_NONE, ROHC::IP_ID_BEHAVIOUR_SEQUENTIAL);
+            comp.addRTPDestinationPort(rtpPort);
+            ROHC::Decompressor decomp(false, &comp);
+            PerfCounter cycles(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+
+            ROHC::data_t compressed;
+            ROHC::data_t decompressed;
+            uint64_t nanos = 0;
+            cycles.Start();
+            cycles.Stop();
+            for (packets_t::const_iterator p = packets.begin(); packets.end() != p; ++p) {
+                compressed.clear();
+                uint64_t packetStart = nanoTime();
+                cycles.Resume();
+                comp.compress(*p, compressed);
+                cycles.Stop();
+                uint64_t packetNanos = nanoTime() - packetStart;
+                nanos += packetNanos > clockCost ? packetNanos - clockCost : 0;
+
+                decompressed.clear();
+                decomp.Decompress(compressed, decompressed);
+            }
+
+            if (!pass || nanos < bestNanos) {
+                bestNanos = nanos;
+                bestCycles = cycles.Value();
+                cyclesValid = cycles.Valid();
+                pt0crc3 = comp.PacketCount(ROHC::PT_0_CRC3);
+                predictionHits = 0;
+                predictionMisses = 0;
+                ROHC::ContextStatistics counters;
+                for (uint16_t cid = 0; cid <= 15; ++cid) {
+                    if (comp.ContextCounters(cid, counters)) {
+                        predictionHits += counters.predictionHits;
+                        predictionMisses += counters.predictionMisses;
+                    }
+                }
+            }
+        }
+
+        std::cout << trace.name << ": " << static_cast<double>(bestNanos) / count << " ns/packet, cycles/packet: ";
+        if (cyclesValid) {
+            std::cout << static_cast<double>(bestCycles) / count;
+        } else {
+            std::cout << "n/a";
+        }
+        std::cout << ", pt_0_crc3: " << (100.0 * pt0crc3) / count << "%";
+        std::cout << ", predicted: " << (100.0 * predictionHits) / count << "% (" << predictionMisses << " misses)\n";
+    }
+
+    /**
+     * Packets of many voice flows interleaved, compressed one by one or
+     * with the batch compress. The decompressor runs after each batch.
+     */
+    void runMultiFlowPass(const VoiceTrace& trace, size_t batchSize, unsigned int passes) {
+        const unsigned int flows = 64;
+        const unsigned int count = 64000;
+        packets_t packets;
+        packets.reserve(count);
+        for (unsigned int i = 0; i < count; ++i) {
+            packets.push_back(createVoicePacket(trace, i / flows, i % flows));
+        }
+
+        uint64_t best[2] = {0, 0};
+        for (unsigned int pass = 0; pass < passes; ++pass) {
+            for (int batched = 0; batched < 2; ++batched) {
+                ROHC::Compressor comp(flows, ROHC::REORDERING_NONE, ROHC::IP_ID_BEHAVIOUR_SEQUENTIAL);
+                comp.addRTPDestinationPort(rtpPort);
+                ROHC::Decompressor decomp(true, &comp);
+
+                packets_t compressed(batchSize);
+                std::vector<const ROHC::data_t*> batchPackets(batchSize);
+                std::vector<ROHC::data_t*> batchOutputs(batchSize);
+                ROHC::data_t decompressed;
+                uint64_t nanos = 0;
+                for (size_t first = 0; first + batchSize <= packets.size(); first += batchSize) {
+                    for (size_t i = 0; i < batchSize; ++i) {
+                        compressed[i].clear();
+                        batchPackets[i] = &packets[first + i];
+                        batchOutputs[i] = &compressed[i];
+                    }
+                    uint64_t start = nanoTime();
+                    if (batched) {
+                        comp.compress(&batchPackets[0], &batchOutputs[0], batchSize);
+                    } else {
+                        for (size_t i = 0; i < batchSize; ++i) {
+                            comp.compress(packets[first + i], compressed[i]);
+                        }
+                    }
+                    nanos += nanoTime() - start;
+
+                    for (size_t i = 0; i < batchSize; ++i) {
+                        decompressed.clear();
+                        decomp.Decompress(compressed[i], decompressed);
+                    }
+                }
+                if (!pass || nanos < best[batched]) {
+                    best[batched] = nanos;
+                }
+            }
+        }
+        std::cout << trace.name << ", " << flows << " flows: one by one " << static_cast<double>(best[0]) / count
+                  << " ns/packet, batches of " << batchSize << " " << static_cast<double>(best[1]) / count << " ns/packet\n";
+    }
+} // anon ns
+
+void runCompressBenchmark(unsigned int passes) {
+    std::cout << "Compression, best of " << passes << " passes\n";
+    const VoiceTrace g711 = {"G.711", 0, 160, g711Frames, sizeof(g711Frames) / sizeof(g711Frames[0])};
+    const VoiceTrace opus = {"Opus", 111, 960, opusFrames, sizeof(opusFrames) / sizeof(opusFrames[0])};
+    runCompressPass(g711, passes);
+    runCompressPass(opus, passes);
+    runMultiFlowPass(g711, 32, passes);
+}
+
+void runParseBenchmark(unsigned int passes) {
+    std::cout << "Decompression, best of " << passes << " passes\n";
+    runParsePass("sequential IP-ID", ROHC::IP_ID_BEHAVIOUR_SEQUENTIAL, passes);
+    runParsePass("random IP-ID", ROHC::IP_ID_BEHAVIOUR_RANDOM, passes);
+}
+
+void runArenaBenchmark(const packets_t& packets, const std::vector<int>& rtpPorts, unsigned int passes) {
+    if (packets.empty()) {
+        std::cerr << "No packets to benchmark" << std::endl;
+        return;
+    }
+    std::cout << packets.size() << " packets, best of " << passes << " passes\n";
+
+    unsigned int defaultPolicy = ROHC::ArenaPolicy();
+    runPolicy("heap", ROHC::ARENA_HEAP, packets, rtpPorts, passes);
+    runPolicy("arena", ROHC::ARENA_HUGEPAGES | ROHC::ARENA_NUMA_LOCAL, packets, rtpPorts, passes);
+    ROHC::SetArenaPolicy(defaultPolicy);
+}
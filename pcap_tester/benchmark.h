@@ -0,0 +1,59 @@
+#pragma once
+
+#include <rohc/rohc.h>
+#include <vector>
+
+/**
+ * Hardware counter read through perf_event_open, only counts the
+ * calling thread in user space. Not valid if the kernel refuses
+ * (see /proc/sys/kernel/perf_event_paranoid).
+ */
+class PerfCounter {
+    void operator=(const PerfCounter&);
+    PerfCounter(const PerfCounter&);
+public:
+    PerfCounter(uint32_t type, uint64_t config);
+    ~PerfCounter();
+
+    bool Valid() const { return fd >= 0; }
+    void Start();
+    void Stop();
+    // Continues counting without a reset, for summing timed sections
+    void Resume();
+    uint64_t Value() const;
+
+private:
+    int fd;
+};
+
+/**
+ * Time since some fixed point in nanoseconds
+ */
+uint64_t nanoTime();
+
+typedef std::vector<ROHC::data_t> packets_t;
+
+/**
+ * Compresses and decompresses all packets with a single compressor and
+ * decompressor, once with contexts allocated from the heap and once with
+ * hugepage/NUMA arenas. Reports throughput and dTLB load misses.
+ */
+void runArenaBenchmark(const packets_t& packets, const std::vector<int>& rtpPorts, unsigned int passes);
+
+/**
+ * Decompression of generated RTP and UDP streams that mix all the CO
+ * formats (marker changes, timestamp jumps, sequence gaps and TTL changes),
+ * once with sequential and once with random IP-ID. Only the decompression
+ * is timed, it mostly measures base header dispatch and parsing.
+ */
+void runParseBenchmark(unsigned int passes);
+
+/**
+ * Compression of steady voice flows, a G.711 trace (8 kHz, 160 byte
+ * frames) and an Opus trace (48 kHz, variable frame size). The
+ * decompressor runs in between and acks, so the compressor reaches SO
+ * state and sends pt_0_crc3. Only the compression is timed, in cycles
+ * per packet if the cycle counter is available. Then 64 interleaved
+ * G.711 flows, compressed one by one and with the batch compress.
+ */
+void runCompressBenchmark(unsigned int passes);
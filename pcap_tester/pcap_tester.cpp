@@ -7,6 +7,7 @@
 #include <map>
 #include <sstream>
 #include "../src/network.h"
+#include "benchmark.h"
 
 std::vector<int> RTPPorts;
 struct Host {
@@ -97,12 +98,52 @@ void onPacket(u_char* user, const struct pcap_pkthdr* h, const u_char* bytes) {
     
 }
 
+// Benchmark mode, the packets are loaded before compressing them
+packets_t packets;
+
+void onPacketLoad(u_char* user, const struct pcap_pkthdr* h, const u_char* bytes) {
+    if (h->caplen <= ipHeaderOffset) {
+        return;
+    }
+    packets.push_back(ROHC::data_t(bytes + ipHeaderOffset, bytes + h->caplen));
+}
+
 int main(int argc, const char* argv[]) {
-    if (argc < 2) {
+    // pcap_tester [-b passes] file [rtp ports]
+    // pcap_tester -p passes
+    // pcap_tester -c passes
+    if (argc > 2 && std::string("-p") == argv[1]) {
+        std::stringstream ss;
+        ss << argv[2];
+        unsigned int passes = 0;
+        ss >> passes;
+        runParseBenchmark(passes ? passes : 1);
+        return 0;
+    }
+    if (argc > 2 && std::string("-c") == argv[1]) {
+        std::stringstream ss;
+        ss << argv[2];
+        unsigned int passes = 0;
+        ss >> passes;
+        runCompressBenchmark(passes ? passes : 1);
+        return 0;
+    }
+
+    bool benchmark = false;
+    unsigned int passes = 0;
+    int firstArg = 1;
+    if (argc > 2 && std::string("-b") == argv[1]) {
+        benchmark = true;
+        std::stringstream ss;
+        ss << argv[2];
+        ss >> passes;
+        firstArg = 3;
+    }
+    if (argc <= firstArg) {
         std::cerr << "Please specify a pcap file" << std::endl;
         return 1;
     }
-    for (int i = 2; i < argc; ++i) {
+    for (int i = firstArg + 1; i < argc; ++i) {
         std::stringstream ss;
         ss << argv[i];
         int port;
@@ -110,18 +151,25 @@ int main(int argc, const char* argv[]) {
         RTPPorts.push_back(port);
     }
     
-    currentFile = argv[1];
+    currentFile = argv[firstArg];
     
     //std::cout << "loading " << argv[1] << "\n";
     
     char errbuf[PCAP_ERRBUF_SIZE];
 
-    pcap_t* pcap = pcap_open_offline(argv[1], errbuf);
+    pcap_t* pcap = pcap_open_offline(argv[firstArg], errbuf);
     if (!pcap) {
         std::cerr << errbuf << std::endl;
         return 1;
     }
     
+    if (benchmark) {
+        pcap_loop(pcap, -1, onPacketLoad, 0);
+        pcap_close(pcap);
+        runArenaBenchmark(packets, RTPPorts, passes ? passes : 1);
+        return 0;
+    }
+    
     pcap_loop(pcap, -1, onPacket, 0);
     
     pcap_close(pcap);
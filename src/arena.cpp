@@ -0,0 +1,250 @@
+#include "arena.h"
+
+#include <cstdlib>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace
+{
+    // Set before the compressors and decompressors are created, see
+    // SetArenaPolicy
+    unsigned int arenaPolicy = ROHC::ARENA_HEAP;
+
+    // Blocks up to 4 kB are rounded to 64 bytes, larger blocks to a power of two
+    const size_t granule = 64;
+    const size_t numberOfSmallClasses = 64;
+    const size_t firstLargeShift = 13;
+    const size_t numberOfClasses = numberOfSmallClasses + 8; // up to 1 MB
+
+#if defined(__linux__)
+    /**
+     * Prefer the NUMA node of the calling thread for the pages of the region.
+     * Has to be done before the pages are touched.
+     */
+    void BindToLocalNode(void* mem, size_t size)
+    {
+#if defined(SYS_mbind) && defined(SYS_getcpu)
+        unsigned int cpu = 0;
+        unsigned int node = 0;
+        if (0 != syscall(SYS_getcpu, &cpu, &node, 0)) {
+            return;
+        }
+        if (node >= 8 * sizeof(unsigned long)) {
+            return;
+        }
+        unsigned long nodemask = 1UL << node;
+        const int MPOL_PREFERRED_ = 1;
+        // Fails with ENOSYS on kernels without NUMA support, nothing to do then
+        syscall(SYS_mbind, mem, size, MPOL_PREFERRED_, &nodemask, 8 * sizeof(nodemask) + 1, 0);
+#else
+        (void)mem;
+        (void)size;
+#endif
+    }
+
+    /**
+     * Maps a region of size bytes aligned to size, so that it can be backed
+     * by transparent huge pages
+     */
+    void* MapAligned(size_t size)
+    {
+        void* p = mmap(0, 2 * size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (MAP_FAILED == p) {
+            return 0;
+        }
+        uintptr_t start = reinterpret_cast<uintptr_t>(p);
+        uintptr_t aligned = (start + size - 1) & ~static_cast<uintptr_t>(size - 1);
+        if (aligned > start) {
+            munmap(p, aligned - start);
+        }
+        uintptr_t tail = start + 2 * size - (aligned + size);
+        if (tail) {
+            munmap(reinterpret_cast<void*>(aligned + size), tail);
+        }
+        return reinterpret_cast<void*>(aligned);
+    }
+#endif
+} // anon ns
+
+namespace ROHC
+{
+    void
+    SetArenaPolicy(unsigned int policy)
+    {
+        arenaPolicy = policy;
+    }
+
+    unsigned int
+    ArenaPolicy()
+    {
+        return arenaPolicy;
+    }
+
+    ContextArena::ContextArena(unsigned int policy)
+    : policy(policy)
+    , hugePages(false)
+    , chunks()
+    , chunkPos(0)
+    , chunkEnd(0)
+    , freeLists(numberOfClasses, static_cast<FreeBlock*>(0))
+    {
+    }
+
+    ContextArena::~ContextArena()
+    {
+        for (size_t i = 0; i < chunks.size(); ++i) {
+#if defined(__linux__)
+            if (chunks[i].mapped) {
+                munmap(chunks[i].mem, chunks[i].size);
+                continue;
+            }
+#endif
+            free(chunks[i].mem);
+        }
+    }
+
+    size_t
+    ContextArena::SizeClass(size_t size)
+    {
+        if (size <= granule * numberOfSmallClasses) {
+            return (size + granule - 1) / granule - 1;
+        }
+        size_t sizeClass = numberOfSmallClasses;
+        for (size_t classSize = static_cast<size_t>(1) << firstLargeShift; classSize < size; classSize <<= 1) {
+            ++sizeClass;
+        }
+        return sizeClass;
+    }
+
+    size_t
+    ContextArena::ClassSize(size_t sizeClass)
+    {
+        if (sizeClass < numberOfSmallClasses) {
+            return (sizeClass + 1) * granule;
+        }
+        return static_cast<size_t>(1) << (sizeClass - numberOfSmallClasses + firstLargeShift);
+    }
+
+    void*
+    ContextArena::Allocate(ContextArena* arena, size_t size)
+    {
+        size_t total = size + sizeof(BlockHeader);
+        size_t sizeClass = SizeClass(total);
+
+        BlockHeader* header = 0;
+        if (arena && (ARENA_HEAP != arena->policy) && (sizeClass < numberOfClasses)) {
+            header = static_cast<BlockHeader*>(arena->AllocateBlock(sizeClass));
+        } else {
+            arena = 0;
+            header = static_cast<BlockHeader*>(malloc(total));
+        }
+        if (!header) {
+            throw std::bad_alloc();
+        }
+        header->arena = arena;
+        header->sizeClass = sizeClass;
+        return header + 1;
+    }
+
+    void
+    ContextArena::Free(void* p)
+    {
+        if (!p) {
+            return;
+        }
+        BlockHeader* header = static_cast<BlockHeader*>(p) - 1;
+        if (header->arena) {
+            header->arena->Release(header);
+        } else {
+            free(header);
+        }
+    }
+
+    void*
+    ContextArena::AllocateBlock(size_t sizeClass)
+    {
+        FreeBlock* block = freeLists[sizeClass];
+        if (block) {
+            freeLists[sizeClass] = block->next;
+            return block;
+        }
+
+        size_t size = ClassSize(sizeClass);
+        if (static_cast<size_t>(chunkEnd - chunkPos) < size) {
+            if (!NewChunk()) {
+                return 0;
+            }
+        }
+        void* p = chunkPos;
+        chunkPos += size;
+        return p;
+    }
+
+    void
+    ContextArena::Release(BlockHeader* header)
+    {
+        size_t sizeClass = header->sizeClass;
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(header);
+        block->next = freeLists[sizeClass];
+        freeLists[sizeClass] = block;
+    }
+
+    bool
+    ContextArena::NewChunk()
+    {
+        void* mem = 0;
+        bool mapped = false;
+#if defined(__linux__)
+        if (policy & ARENA_HUGEPAGES) {
+#ifdef MAP_HUGETLB
+            // Explicit huge pages, only available if reserved by the admin
+            mem = mmap(0, ChunkSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (MAP_FAILED == mem) {
+                mem = 0;
+            } else {
+                hugePages = true;
+            }
+#endif
+            if (!mem) {
+                mem = MapAligned(ChunkSize);
+#ifdef MADV_HUGEPAGE
+                if (mem && (0 == madvise(mem, ChunkSize, MADV_HUGEPAGE))) {
+                    hugePages = true;
+                }
+#endif
+            }
+        } else {
+            mem = mmap(0, ChunkSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (MAP_FAILED == mem) {
+                mem = 0;
+            }
+        }
+        if (mem) {
+            mapped = true;
+            if (policy & ARENA_NUMA_LOCAL) {
+                BindToLocalNode(mem, ChunkSize);
+            }
+        }
+#endif
+        if (!mem) {
+            mem = malloc(ChunkSize);
+            if (!mem) {
+                error("ContextArena, failed to allocate chunk\n");
+                return false;
+            }
+        }
+
+        chunks.push_back(Chunk(static_cast<uint8_t*>(mem), ChunkSize, mapped));
+        chunkPos = static_cast<uint8_t*>(mem);
+        chunkEnd = chunkPos + ChunkSize;
+        return true;
+    }
+
+} // ns ROHC
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <rohc/rohc.h>
+#include <vector>
+
+namespace ROHC
+{
+    /**
+     * Memory for the contexts of one compressor or decompressor.
+     *
+     * Memory is carved out of 2 MB chunks which are backed by huge pages
+     * when the system has them (explicit huge pages first, transparent
+     * huge pages otherwise) and placed on the NUMA node of the thread
+     * allocating the chunk, i.e. the thread owning the channel.
+     * Freed blocks are kept on per size free lists and reused.
+     *
+     * Not thread safe, an arena is only used by the thread owning the
+     * compressor or decompressor.
+     */
+    class ContextArena
+    {
+        void operator=(const ContextArena&);
+        ContextArena(const ContextArena&);
+    public:
+        /**
+         * policy is a combination of ArenaPolicy_t flags
+         */
+        explicit ContextArena(unsigned int policy);
+        ~ContextArena();
+
+        /**
+         * If arena is null, or the size too large for the arena,
+         * the memory is taken from the heap.
+         */
+        static void* Allocate(ContextArena* arena, size_t size);
+        static void Free(void* p);
+
+        size_t NumberOfChunks() const {return chunks.size();}
+        bool HugePages() const {return hugePages;}
+
+        static const size_t ChunkSize = 2 * 1024 * 1024;
+
+    private:
+        struct BlockHeader
+        {
+            ContextArena* arena;
+            size_t sizeClass;
+        };
+
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        struct Chunk
+        {
+            Chunk(uint8_t* mem, size_t size, bool mapped) : mem(mem), size(size), mapped(mapped) {}
+            uint8_t* mem;
+            size_t size;
+            bool mapped;
+        };
+
+        static size_t SizeClass(size_t size);
+        static size_t ClassSize(size_t sizeClass);
+
+        void* AllocateBlock(size_t sizeClass);
+        void Release(BlockHeader* header);
+        bool NewChunk();
+
+        unsigned int policy;
+        bool hugePages;
+
+        std::vector<Chunk> chunks;
+        uint8_t* chunkPos;
+        uint8_t* chunkEnd;
+
+        std::vector<FreeBlock*> freeLists;
+    };
+
+} // ns ROHC
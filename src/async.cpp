@@ -0,0 +1,124 @@
+#include <rohc/async.h>
+
+using namespace std;
+
+namespace ROHC
+{
+    AsyncChannel::AsyncChannel(size_t maxCID, Reordering_t reorder_ratio, IPIDBehaviour_t ip_id_behaviour)
+    : compressor(maxCID, reorder_ratio, ip_id_behaviour)
+    , decompressor(maxCID > 15, &compressor)
+    , feedbackCallback(0)
+    , feedbackUser(0)
+    , compressRequests()
+    , numberOfCompressRequests(0)
+    , decompressRequests()
+    , numberOfDecompressRequests(0)
+    , decompressing()
+    , compressing()
+    , batchPackets()
+    , batchOutputs()
+    , output()
+    {
+    }
+
+    void
+    AsyncChannel::SetFeedbackCallback(FeedbackCallback callback, void* user)
+    {
+        feedbackCallback = callback;
+        feedbackUser = user;
+    }
+
+    void
+    AsyncChannel::Submit(requests_t& requests, size_t& numberOfRequests, const uint8_t* data, size_t size, CompletionCallback callback, void* user)
+    {
+        if (requests.size() == numberOfRequests) {
+            requests.push_back(Request());
+        }
+        Request& request = requests[numberOfRequests++];
+        request.data.assign(data, data + size);
+        request.callback = callback;
+        request.user = user;
+    }
+
+    void
+    AsyncChannel::SubmitCompress(const uint8_t* data, size_t size, CompletionCallback callback, void* user)
+    {
+        Submit(compressRequests, numberOfCompressRequests, data, size, callback, user);
+    }
+
+    void
+    AsyncChannel::SubmitDecompress(const uint8_t* data, size_t size, CompletionCallback callback, void* user)
+    {
+        Submit(decompressRequests, numberOfDecompressRequests, data, size, callback, user);
+    }
+
+    void
+    AsyncChannel::Complete(const Request& request)
+    {
+        if (!request.callback) {
+            return;
+        }
+        if (request.output.empty()) {
+            request.callback(request.user, COMPLETION_NO_OUTPUT, 0, 0);
+        } else {
+            request.callback(request.user, COMPLETION_OK, &request.output[0], request.output.size());
+        }
+    }
+
+    void
+    AsyncChannel::DeliverFeedback()
+    {
+        if (!feedbackCallback) {
+            return;
+        }
+        output.clear();
+        compressor.AppendFeedback(output);
+        if (!output.empty()) {
+            feedbackCallback(feedbackUser, &output[0], output.size());
+        }
+    }
+
+    size_t
+    AsyncChannel::Process()
+    {
+        size_t completed = 0;
+
+        // Swap out both batches before any callback runs, so that the
+        // requests callbacks submit go to the next call, the buffers of
+        // all requests are reused
+        size_t count = numberOfDecompressRequests;
+        decompressing.swap(decompressRequests);
+        numberOfDecompressRequests = 0;
+        size_t compressCount = numberOfCompressRequests;
+        compressing.swap(compressRequests);
+        numberOfCompressRequests = 0;
+
+        for (size_t i = 0; i < count; ++i) {
+            decompressing[i].output.clear();
+            decompressor.Decompress(decompressing[i].data, decompressing[i].output);
+            Complete(decompressing[i]);
+        }
+        completed += count;
+
+        count = compressCount;
+        batchPackets.resize(count);
+        batchOutputs.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            compressing[i].output.clear();
+            batchPackets[i] = &compressing[i].data;
+            batchOutputs[i] = &compressing[i].output;
+        }
+        if (count) {
+            compressor.compress(&batchPackets[0], &batchOutputs[0], count);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            Complete(compressing[i]);
+        }
+        completed += count;
+
+        DeliverFeedback();
+
+        return completed;
+    }
+
+} // ns ROHC
@@ -0,0 +1,95 @@
+#include "cesp_profile.h"
+#include "network.h"
+#include <rohc/compressor.h>
+
+namespace ROHC
+{
+    /**************************************************************************
+     * Compression Profile
+     **************************************************************************/
+
+    CESPProfile::CESPProfile(Compressor* comp, uint16_t cid, const iphdr* ip)
+    : CIPProfile(comp, cid, ip),
+    spi(0),
+    sequence_number(0)
+    {
+        const esphdr* esp = NextHeader<esphdr>(ip);
+        spi = esp->spi;
+        sequence_number = rohc_htonl(esp->seq_no);
+        msn = static_cast<uint16_t>(sequence_number);
+    }
+
+    bool
+    CESPProfile::Matches(unsigned int profileID, const ROHC::iphdr *ip) const
+    {
+        return CIPProfile::Matches(profileID, ip) &&
+            (spi == NextHeader<esphdr>(ip)->spi);
+    }
+
+    void
+    CESPProfile::Compress(const data_t& data, data_t& output)
+    {
+        const iphdr* ip = reinterpret_cast<const iphdr*>(&data[0]);
+        if (data.size() >= HeaderSize(ip))
+        {
+            uint32_t sn = rohc_htonl(NextHeader<esphdr>(ip)->seq_no);
+            msn = static_cast<uint16_t>(sn);
+
+            // The decompressor adds the signed MSN delta to its sequence
+            // number and co_common carries 8 MSN bits, anything further
+            // away needs the dynamic chain. An empty window is only seen
+            // before the first packet, which is an IR anyway
+            bool farJump = static_cast<uint32_t>(sn - sequence_number + 0x8000) > 0xffff;
+            bool msnTooWide = !msnWindow.empty() && (msnWindow.width(msn) > 8);
+            if ((IR_State != state) && (farJump || msnTooWide))
+            {
+                RepairDynamicChain();
+            }
+            sequence_number = sn;
+        }
+        CIPProfile::Compress(data, output);
+    }
+
+    void
+    CESPProfile::create_static_chain(const iphdr* ip, data_t& output)
+    {
+        create_ip_static(ip, output);
+        create_esp_static(NextHeader<esphdr>(ip), output);
+    }
+
+    void
+    CESPProfile::create_dynamic_chain(const iphdr* ip, data_t& output)
+    {
+        create_ip_regular_dynamic(ip, output);
+        create_esp_dynamic(NextHeader<esphdr>(ip), output);
+    }
+
+    /*
+     COMPRESSED esp_static {
+     ENFORCE(profile_value == PROFILE_ESP_0103);
+     spi =:= irregular(32) [ 32 ];
+     }
+     */
+    void
+    CESPProfile::create_esp_static(const esphdr* esp, data_t& output)
+    {
+        AppendData(output, esp->spi);
+    }
+
+    /*
+     COMPRESSED esp_dynamic {
+     ENFORCE(profile_value == PROFILE_ESP_0103);
+     ENFORCE(msn.UVALUE == sequence_number.UVALUE % 65536);
+     sequence_number =:= irregular(32)           [ 32 ];
+     reserved        =:= compressed_value(6, 0)  [ 6 ];
+     reorder_ratio   =:= irregular(2)            [ 2 ];
+     }
+     */
+    void
+    CESPProfile::create_esp_dynamic(const esphdr* esp, data_t& output)
+    {
+        AppendData(output, esp->seq_no);
+        output.push_back(static_cast<uint8_t>(reorder_ratio & 3));
+    }
+
+} // ns ROHC
@@ -0,0 +1,49 @@
+#pragma once
+
+/**
+ * ESP/IP profile
+ */
+
+#include "cip_profile.h"
+
+namespace ROHC
+{
+    /**************************************************************************
+     * Compression Profile
+     *
+     * The MSN is the 16 LSBs of the ESP sequence number, the base headers
+     * carry it like the generated MSN of the other profiles
+     **************************************************************************/
+    class CESPProfile : public CIPProfile
+    {
+    public:
+        CESPProfile(Compressor* comp, uint16_t cid, const iphdr* ip);
+
+        virtual bool Matches(unsigned int profileID, const iphdr* ip) const;
+
+        virtual unsigned int ID() const {return ProfileID();}
+
+        virtual void Compress(const data_t& data, data_t& output);
+
+    // Statics
+    public:
+        static uint16_t ProfileID() {return 0x0103;}
+        static uint16_t ProtocolID() {return 50;}
+
+    protected:
+        virtual size_t HeaderSize(const iphdr* ip) const {return IPHeaderSize(ip) + sizeof(esphdr);}
+        // The SPI is static
+        virtual void SetStaticCRC(const iphdr* ip) {header_crc.SetStatic(ip, 4);}
+        virtual void create_static_chain(const iphdr* ip, data_t& output);
+        virtual void create_dynamic_chain(const iphdr* ip, data_t& output);
+
+        static void create_esp_static(const esphdr* esp, data_t& output);
+        void create_esp_dynamic(const esphdr* esp, data_t& output);
+
+    private:
+        uint32_t spi;
+        // Of the last packet, host byte order
+        uint32_t sequence_number;
+    };
+
+} // ns ROHC
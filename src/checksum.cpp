@@ -0,0 +1,195 @@
+#include <rohc/rohc.h>
+#include "network.h"
+
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define ROHC_CHECKSUM_SIMD 1
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    /**
+     * The sum is over 16 bit words in host order, which gives the checksum
+     * in host order as well (RFC 1071 2.(B)), so nothing is swapped.
+     */
+    typedef uint64_t (*sumKernel_t)(const uint8_t* data, size_t size);
+
+    uint32_t Fold(uint64_t sum)
+    {
+        sum = (sum & 0xffffffff) + (sum >> 32);
+        sum = (sum & 0xffffffff) + (sum >> 32);
+        uint32_t s = static_cast<uint32_t>(sum);
+        s = (s & 0xffff) + (s >> 16);
+        s = (s & 0xffff) + (s >> 16);
+        return s;
+    }
+
+    uint64_t SumScalar(const uint8_t* data, size_t size)
+    {
+        uint64_t sum = 0;
+        while (size >= 4)
+        {
+            uint32_t w;
+            memcpy(&w, data, 4);
+            sum += w;
+            data += 4;
+            size -= 4;
+        }
+        if (size >= 2)
+        {
+            uint16_t w;
+            memcpy(&w, data, 2);
+            sum += w;
+            data += 2;
+            size -= 2;
+        }
+        if (size)
+        {
+            // The odd byte is padded with a zero byte after it
+            uint16_t w = 0;
+            memcpy(&w, data, 1);
+            sum += w;
+        }
+        return sum;
+    }
+
+#ifdef ROHC_CHECKSUM_SIMD
+    // Below this the scalar loop wins, IP headers never get here
+    const size_t simdMinimumSize = 64;
+
+    // The 32 bit lanes are added to the 64 bit sum before they can
+    // overflow, each block adds two words to every lane
+    const size_t maxBlocksPerLane = 0x8000;
+
+    uint64_t HorizontalSum(__m128i v)
+    {
+        uint32_t lanes[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), v);
+        return static_cast<uint64_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+    }
+
+    uint64_t SumSSE2(const uint8_t* data, size_t size)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        uint64_t sum = 0;
+        while (size >= 16)
+        {
+            __m128i acc = zero;
+            size_t blocks = size / 16;
+            if (blocks > maxBlocksPerLane)
+                blocks = maxBlocksPerLane;
+            size -= blocks * 16;
+            for (; blocks; --blocks, data += 16)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+                acc = _mm_add_epi32(acc, _mm_unpacklo_epi16(v, zero));
+                acc = _mm_add_epi32(acc, _mm_unpackhi_epi16(v, zero));
+            }
+            sum += HorizontalSum(acc);
+        }
+        return sum + SumScalar(data, size);
+    }
+
+    __attribute__((target("avx2")))
+    uint64_t SumAVX2(const uint8_t* data, size_t size)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        uint64_t sum = 0;
+        while (size >= 32)
+        {
+            __m256i acc = zero;
+            size_t blocks = size / 32;
+            if (blocks > maxBlocksPerLane)
+                blocks = maxBlocksPerLane;
+            size -= blocks * 32;
+            for (; blocks; --blocks, data += 32)
+            {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+                acc = _mm256_add_epi32(acc, _mm256_unpacklo_epi16(v, zero));
+                acc = _mm256_add_epi32(acc, _mm256_unpackhi_epi16(v, zero));
+            }
+            // The lanes are nearly full, the halves are added in 64 bits
+            sum += HorizontalSum(_mm256_castsi256_si128(acc));
+            sum += HorizontalSum(_mm256_extracti128_si256(acc, 1));
+        }
+        return sum + SumSSE2(data, size);
+    }
+
+    // SSE2 is always there on x86-64, ChecksumStartup upgrades to AVX2
+    sumKernel_t sumKernel = SumSSE2;
+
+    struct ChecksumStartup
+    {
+        ChecksumStartup()
+        {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) {
+                sumKernel = SumAVX2;
+            }
+        }
+    } checksumStartup;
+#endif
+} // anon ns
+
+namespace ROHC
+{
+    uint32_t
+    OnesComplementSum(const uint8_t* data, size_t size, uint32_t sum)
+    {
+#ifdef ROHC_CHECKSUM_SIMD
+        if (size >= simdMinimumSize)
+            return Fold(sumKernel(data, size) + sum);
+#endif
+        return Fold(SumScalar(data, size) + sum);
+    }
+
+    OnesComplementSumKernels
+    GetOnesComplementSumKernels()
+    {
+        OnesComplementSumKernels kernels;
+        kernels.scalar = SumScalar;
+        kernels.sse2 = 0;
+        kernels.avx2 = 0;
+#ifdef ROHC_CHECKSUM_SIMD
+        kernels.sse2 = SumSSE2;
+        if (__builtin_cpu_supports("avx2")) {
+            kernels.avx2 = SumAVX2;
+        }
+#endif
+        return kernels;
+    }
+
+    void
+    updateIpHeaderCheckSum(iphdr* ip, const iphdr* previous)
+    {
+        // Words 0 (version, ihl, tos), 3 (frag_off) and 6-9 (addresses)
+        // must be unchanged, and the previous checksum must be valid
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(ip);
+        const uint8_t* q = reinterpret_cast<const uint8_t*>(previous);
+        if (ip->ihl != 5
+            || memcmp(p, q, 2)
+            || ip->frag_off != previous->frag_off
+            || memcmp(&ip->saddr, &previous->saddr, 8))
+        {
+            calculateIpHeaderCheckSum(ip);
+            return;
+        }
+
+        uint16_t check = previous->check;
+        if (ip->tot_len != previous->tot_len)
+            check = UpdateChecksum(check, previous->tot_len, ip->tot_len);
+        if (ip->id != previous->id)
+            check = UpdateChecksum(check, previous->id, ip->id);
+
+        uint16_t ttlProtocol, previousTtlProtocol;
+        memcpy(&ttlProtocol, &ip->ttl, 2);
+        memcpy(&previousTtlProtocol, &previous->ttl, 2);
+        if (ttlProtocol != previousTtlProtocol)
+            check = UpdateChecksum(check, previousTtlProtocol, ttlProtocol);
+
+        ip->check = check;
+    }
+} // ns ROHC
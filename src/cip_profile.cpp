@@ -0,0 +1,616 @@
+#include "cip_profile.h"
+#include "network.h"
+#include <rohc/compressor.h>
+#include <iterator>
+
+using namespace std;
+
+namespace
+{
+    // Fields that rule out all but co_common: tos, df and ttl
+    const uint8_t basicFields[ROHC::headerBlockSize] = {
+        0x00, 0xff, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00,
+        0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    };
+
+    // The same for IPv6: traffic class and hop limit
+    const uint8_t basicFieldsIPv6[ROHC::headerBlockSize] = {
+        0x0f, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    };
+} // anon ns
+
+namespace ROHC
+{
+    /**************************************************************************
+     * Compression Profile
+     **************************************************************************/
+
+    CIPProfile::CIPProfile(Compressor* comp, uint16_t cid, const iphdr* ip)
+    : CProfile(comp, cid, ip),
+    protocol(IPProtocol(ip))
+    {
+    }
+
+    bool
+    CIPProfile::Matches(unsigned int profileID, const ROHC::iphdr *ip) const
+    {
+        return (profileID == ID()) &&
+            MatchesIPStatic(ip) &&
+            (protocol == IPProtocol(ip));
+    }
+
+    void
+    CIPProfile::Compress(const data_t& data, data_t& output)
+    {
+        const iphdr* ip = reinterpret_cast<const iphdr*>(&data[0]);
+        const unsigned minSize = static_cast<unsigned>(HeaderSize(ip));
+        if (data.size() < minSize) {
+            error("Received packet less than %u bytes for profile %x", minSize, ID());
+            return;
+        }
+
+        size_t outputInSize = output.size();
+
+        UpdateIpIdOffset(ip);
+
+        if (IR_State == state)
+        {
+            CreateIR(ip, output);
+        }
+        else if (number_of_co_repair_packets_to_send > 0)
+        {
+            CreateCORepair(ip, output);
+        }
+        else
+        {
+            CreateCO(ip, ChangeFromLastHeader(data), output);
+        }
+
+        UpdateIpInformation(ip);
+        UpdateLastHeader(data);
+
+        AdvanceState(false, false);
+        increaseMsn();
+        // Append payload
+        output.insert(output.end(), data.begin() + minSize, data.end());
+
+        ++numberOfPacketsSent;
+        dataSizeCompressed += output.size() - outputInSize;
+        dataSizeUncompressed += data.size();
+    }
+
+    void
+    CIPProfile::CreateIR(const iphdr* ip, data_t &output)
+    {
+        size_t headerStartIdx = output.size();
+
+        if (!largeCID && cid)
+        {
+            output.push_back(CreateShortCID(cid));
+        }
+
+        output.push_back(IRv2Packet);
+
+        if (largeCID)
+        {
+            SDVLEncode(back_inserter(output), cid);
+        }
+
+        output.push_back(static_cast<uint8_t>(ID()));
+
+        size_t crcPos = output.size();
+
+        // Add zero crc for now
+        output.push_back(0);
+
+        create_static_chain(ip, output);
+
+        create_dynamic_chain(ip, output);
+
+        SetStaticCRC(ip);
+
+        // Calculate CRC
+        uint8_t crc = CRC8(output.begin() + headerStartIdx, output.end());
+        output[crcPos] = crc;
+
+		IncreasePacketCount(PT_IR);
+
+        ++numberOfIRPacketsSent;
+        ++numberOfIRPacketsSinceReset;
+        // The IR repairs the context as well
+        number_of_co_repair_packets_to_send = 0;
+    }
+
+    /*
+     RFC 5225 6.8.2.4, the dynamic chain with the CRC of the uncompressed
+     header, for a context whose static chain the decompressor has
+
+     COMPRESSED co_repair {
+       discriminator =:= '11111011'                            [ 8 ];
+       r1            =:= '0'                                   [ 1 ];
+       header_crc    =:= crc7(THIS.UVALUE, THIS.ULENGTH)       [ 7 ];
+       r2            =:= compressed_value(5, 0)                [ 5 ];
+       control_crc3  =:= control_crc3_encoding                 [ 3 ];
+       dynamic chain                                           [ VARIABLE ];
+     }
+     */
+    void
+    CIPProfile::CreateCORepair(const iphdr* ip, data_t& output)
+    {
+        CalculateCRC(ip);
+
+        if (!largeCID && cid)
+        {
+            output.push_back(CreateShortCID(cid));
+        }
+
+        output.push_back(CORepairPacket);
+
+        if (largeCID)
+        {
+            SDVLEncode(back_inserter(output), cid);
+        }
+
+        output.push_back(header_crc7);
+        output.push_back(control_crc3());
+
+        create_dynamic_chain(ip, output);
+
+        IncreasePacketCount(PT_CO_REPAIR);
+
+        --number_of_co_repair_packets_to_send;
+    }
+
+    void
+    CIPProfile::create_static_chain(const iphdr* ip, data_t& output)
+    {
+        create_ip_static(ip, output);
+    }
+
+    void
+    CIPProfile::create_dynamic_chain(const iphdr* ip, data_t& output)
+    {
+        create_ip_endpoint_dynamic(ip, output);
+    }
+
+    void
+    CIPProfile::create_irregular_chain(const iphdr* ip, data_t& output)
+    {
+        create_ip_innermost_irregular(ip, output);
+    }
+
+    /*
+      0   1   2   3   4   5   6   7
+     --- --- --- --- --- --- --- ---
+     : Add-CID octet                 : if for small CIDs and CID 1-15
+     +---+---+---+---+---+---+---+---+
+     | first octet of base header    | (with type indication)
+     +---+---+---+---+---+---+---+---+
+     :                               :
+     / 0, 1, or 2 octets of CID / 1-2 octets if large CIDs
+     :                               :
+     +---+---+---+---+---+---+---+---+
+     / remainder of base header      / variable length
+     +---+---+---+---+---+---+---+---+
+     :                               :
+     / Irregular Chain               / variable length
+     :                               :
+     --- --- --- --- --- --- --- ---
+     */
+    
+    void
+    CIPProfile::CreateCO(const ROHC::iphdr *ip, const HeaderChange& change, data_t &output)
+    {
+        data_t baseheader;
+        
+        CalculateCRC(ip);
+
+        unsigned int neededMSNWidth = msnWindow.width(msn);
+        
+		bool basic = (SO_State == state) && !change.Any(ipv6 ? basicFieldsIPv6 : basicFields) &&
+			!number_of_packets_with_new_ip_fields_to_send;
+
+		bool pt_0_crc3_possible = basic && (neededMSNWidth <= 4);
+		bool pt_0_crc7_possible = basic && (neededMSNWidth <= 6);
+
+		if ((IP_ID_BEHAVIOUR_RANDOM == ip_id_behaviour) ||
+				 (IP_ID_BEHAVIOUR_ZERO == ip_id_behaviour))
+		{
+			if (pt_0_crc3_possible)
+			{
+				create_pt_0_crc3(baseheader);
+			}
+			else if (pt_0_crc7_possible)
+			{
+				create_pt_0_crc7(baseheader);
+			}
+			else
+			{
+				create_co_common(ip, baseheader);
+			}
+		}
+		else
+		{
+			unsigned int neededIPIDWidth = IpIdOffsetWidth();
+
+			// pt_0 infers the IP-ID from the decompressor's offset, which
+			// can be any offset still in the window if packets were lost
+			bool ip_id_offset_kept = (0 == neededIPIDWidth);
+			pt_0_crc3_possible = pt_0_crc3_possible && ip_id_offset_kept;
+			pt_0_crc7_possible = pt_0_crc7_possible && ip_id_offset_kept;
+			bool pt_1_seq_id_possible = basic && (neededMSNWidth <=6) && (neededIPIDWidth <= 4);
+			bool pt_2_seq_id_possible = basic && (neededMSNWidth <= 8) && (neededIPIDWidth <= 6);
+
+			if (pt_0_crc3_possible)
+			{
+				create_pt_0_crc3(baseheader);
+			}
+			else if (pt_0_crc7_possible)
+			{
+				create_pt_0_crc7(baseheader);
+			}
+			else if (pt_1_seq_id_possible)
+			{
+				create_pt_1_seq_id(baseheader);
+			}
+			else if (pt_2_seq_id_possible)
+			{
+				create_pt_2_seq_id(baseheader);
+			}
+			else
+			{
+				create_co_common(ip, baseheader);
+			}
+		}
+
+        if (!largeCID && cid)
+        {
+            output.push_back(CreateShortCID(cid));
+        }
+        
+        output.push_back(baseheader[0]);
+        
+        if (largeCID)
+        {
+            SDVLEncode(back_inserter(output), cid);
+        }
+        
+        output.insert(output.end(), baseheader.begin() + 1, baseheader.end());
+        
+        create_irregular_chain(ip, output);
+        
+        if (FO_State == state) {
+            ++numberOfFOPacketsSent;
+            ++numberOfFOPacketsSinceReset;
+        }
+        else {
+            ++numberOfSOPacketsSent;
+        }
+    }
+    
+    /*
+     co_common: This format can be used to update the context when the
+     established change pattern of a dynamic field changes, for any of
+     the dynamic fields. However, not all dynamic fields are updated
+     by conveying their uncompressed value; some fields can only be
+     transmitted using a compressed representation. This format is
+     especially useful when a rarely changing field needs to be
+     updated. This format contains a set of flags to indicate what
+     fields are present in the header, and its size can vary
+     accordingly. This format is protected by a 7-bit CRC. It can
+     update control fields, and it thus also carries a 3-bit CRC to
+     protect those fields. This format is similar in purpose to the
+     UOR-2-extension 3 format of [RFC3095].
+     
+     
+     // Replacement for UOR-2-ext3
+     COMPRESSED co_common {
+     ENFORCE(outer_ip_flag == outer_ip_indicator.CVALUE);
+     discriminator          =:= ’1111 1010’                     [ 8 ];
+     ip_id_indicator        =:= irregular(1)                    [ 1 ]; // see ip_id_sequential_variable
+     header_crc =:= crc7(THIS.UVALUE, THIS.ULENGTH)             [ 7 ];
+     flags_indicator        =:= irregular(1)                    [ 1 ];
+     ttl_hopl_indicator     =:= irregular(1)                    [ 1 ];
+     tos_tc_indicator       =:= irregular(1)                    [ 1 ];
+     reorder_ratio          =:= irregular(2)                    [ 2 ];
+     control_crc3           =:= control_crc3_encoding           [ 3 ];
+     outer_ip_indicator : df : ip_id_behavior_innermost =:=
+        profile_2_3_4_flags_enc(
+        flags_indicator.CVALUE, ip_version.UVALUE)              [ 0, 8 ];
+     tos_tc =:= static_or_irreg(tos_tc_indicator.CVALUE, 8)     [ 0, 8 ];
+     ttl_hopl =:= static_or_irreg(ttl_hopl_indicator.CVALUE,
+        ttl_hopl.ULENGTH)                                       [ 0, 8 ];
+     msn =:= msn_lsb(8)                                         [ 8 ];
+     ip_id =:= ip_id_sequential_variable(ip_id_behavior_innermost.UVALUE,
+        ip_id_indicator.CVALUE)                                 [ 0, 8, 16 ];
+     }
+     */
+    
+    void
+    CIPProfile::create_co_common(const ROHC::iphdr *ip, data_t &baseheader)
+    {
+		IncreasePacketCount(PT_CO_COMMON);
+        baseheader.reserve(9);
+        
+        baseheader.push_back(0xfa);
+        const size_t crcIndex = 1;
+        
+        bool ip_id_indicator = (ip_id_behaviour <= IP_ID_BEHAVIOUR_SEQUENTIAL_SWAPPED) &&
+            (IpIdOffsetWidth() > 8);
+		if (ip_id_indicator)
+        {
+            baseheader.push_back(0x80); // ip_id_indicator = 1, crc7 = 0            
+        }
+        else
+        {
+            baseheader.push_back(0x00); // ip_id_indicator = 0, crc7 = 0   
+        }
+        
+        uint8_t flags = 0x00; 
+        bool flags_indicator = DFChanged(ip);
+		if (flags_indicator)
+        {
+            flags |= 0x80;
+        }
+        
+        bool ttl_hopl_indicator = TTLChanged(ip);
+        if (ttl_hopl_indicator)
+        {
+            flags |= 0x40;
+        }
+        
+        bool tos_tc_indicator = TOSChanged(ip);
+        if (tos_tc_indicator)
+        {
+            flags |= 0x20;
+        }
+        
+        flags |= static_cast<uint8_t>((reorder_ratio & 3) << 3); // add reorder_ratio;
+        flags |= static_cast<uint8_t>(control_crc3() & 7); // control crc
+        baseheader.push_back(flags);
+        
+        profile_2_3_4_flags_enc(flags_indicator, ip, baseheader);
+        
+        if (tos_tc_indicator)
+        {
+            baseheader.push_back(TosTc(ip));
+        }
+        
+        if (ttl_hopl_indicator)
+        {
+            baseheader.push_back(TtlHopl(ip));
+        }
+        
+        baseheader.push_back(static_cast<uint8_t>(msn));
+        
+        ip_id_sequential_variable(ip_id_indicator, ip, baseheader);
+        
+        //cout << "create_co_common, header size: " << baseheader.size() << endl;
+        
+        // Save ip_id_indicator
+        baseheader[crcIndex] |= static_cast<uint8_t>(header_crc7 & 0x7f);
+    }
+    
+    /*
+     pt_0_crc3: This format conveys only the MSN; it can therefore only
+     update the MSN and fields that are derived from the MSN, such as
+     IP-ID and the RTP Timestamp (for applicable profiles). It is
+     protected by a 3-bit CRC. This format is equivalent to the UO-0
+     header format in [RFC3095].
+     
+     // UO-0
+     COMPRESSED pt_0_crc3 {
+         discriminator =:= ’0’ [ 1 ];
+         msn =:= msn_lsb(4) [ 4 ];
+         header_crc =:= crc3(THIS.UVALUE, THIS.ULENGTH) [ 3 ];
+         ip_id =:= inferred_sequential_ip_id [ 0 ];
+     }
+     */
+    void
+    CIPProfile::create_pt_0_crc3(data_t &output)
+    {
+		IncreasePacketCount(PT_0_CRC3);
+        uint8_t data = static_cast<uint8_t>((msn & 0x0f) << 3);
+        output.push_back(data | header_crc3);
+    }
+    
+    /*
+     pt_0_crc7: This format has the same properties as pt_0_crc3, but
+     is instead protected by a 7-bit CRC and contains a larger amount
+     of lsb-encoded MSN bits. This format is useful in environments
+     where a high amount of reordering or a high-residual error rate
+     can occur.
+     
+     // New format, Type 0 with strong CRC and more SN bits
+     COMPRESSED pt_0_crc7 {
+         discriminator =:= ’100’ [ 3 ];
+         msn =:= msn_lsb(6) [ 6 ];
+         header_crc =:= crc7(THIS.UVALUE, THIS.ULENGTH) [ 7 ];
+         ip_id =:= inferred_sequential_ip_id [ 0 ];
+     }
+     */
+    void 
+    CIPProfile::create_pt_0_crc7(data_t &output)
+    {
+		IncreasePacketCount(PT_0_CRC7);
+        uint8_t lsbMsn = static_cast<uint8_t>(msn & 0x3f); // lower 6 bits
+        uint8_t discriminator_MsbMSN = static_cast<uint8_t>(0x80 | (lsbMsn >> 1));
+        output.push_back(discriminator_MsbMSN);
+        uint8_t lsbMsn_crc7 = static_cast<uint8_t>((lsbMsn << 7) | header_crc7);
+        output.push_back(lsbMsn_crc7);
+    }
+    
+    /*
+     pt_1_seq_id: This format can convey changes to the MSN and to the
+     IP-ID. It is protected by a 7-bit CRC. It is similar in purpose
+     to the UO-1-ID format in [RFC3095].
+     
+     
+     // UO-1-ID replacement (PT-1 only used for sequential)
+     COMPRESSED pt_1_seq_id {
+         ENFORCE((ip_id_behavior_innermost.UVALUE ==
+                 IP_ID_BEHAVIOR_SEQUENTIAL) ||
+                 (ip_id_behavior_innermost.UVALUE ==
+                 IP_ID_BEHAVIOR_SEQUENTIAL_SWAPPED));
+         discriminator =:= ’101’ [ 3 ];
+         header_crc =:= crc3(THIS.UVALUE, THIS.ULENGTH) [ 3 ];
+         msn =:= msn_lsb(6) [ 6 ];
+         ip_id =:= ip_id_lsb(ip_id_behavior_innermost.UVALUE, 4) [ 4 ];
+     }
+     */
+    
+    void
+    CIPProfile::create_pt_1_seq_id(data_t &output)
+    {
+		IncreasePacketCount(PT_1_SEQ_ID);
+        uint8_t lsbMsn = static_cast<uint8_t>(msn & 0x3f); // lower 6 bits
+        
+        uint8_t disc_crc_msn = static_cast<uint8_t>(0xa0 | (header_crc3 << 2) | (lsbMsn >> 4));
+        output.push_back(disc_crc_msn);
+        uint8_t msn_ip_id = static_cast<uint8_t>(lsbMsn << 4);
+
+		msn_ip_id |= static_cast<uint8_t>(IpIdOffset() & 0x0f); 
+        
+        output.push_back(msn_ip_id);
+    }
+    
+    
+    /*
+     pt_2_seq_id: This format can convey changes to the MSN and to the
+     IP-ID. It is protected by a 7-bit CRC. It is similar in purpose
+     to the UO-2-ID format in [RFC3095].
+     
+     
+     // UOR-2-ID replacement
+     COMPRESSED pt_2_seq_id {
+         ENFORCE((ip_id_behavior_innermost.UVALUE ==
+                 IP_ID_BEHAVIOR_SEQUENTIAL) ||
+                 (ip_id_behavior_innermost.UVALUE ==
+                 IP_ID_BEHAVIOR_SEQUENTIAL_SWAPPED));
+         discriminator =:= ’110’ [ 3 ];
+         ip_id =:= ip_id_lsb(ip_id_behavior_innermost.UVALUE, 6) [ 6 ];
+         header_crc =:= crc7(THIS.UVALUE, THIS.ULENGTH) [ 7 ];
+         msn =:= msn_lsb(8) [ 8 ];
+     }     
+     */
+    void
+    CIPProfile::create_pt_2_seq_id(data_t &output)
+    {
+		IncreasePacketCount(PT_2_SEQ_ID);
+        RASSERT(ip_id_behaviour == IP_ID_BEHAVIOUR_SEQUENTIAL ||
+                ip_id_behaviour == IP_ID_BEHAVIOUR_SEQUENTIAL_SWAPPED);
+
+		uint8_t lsb_ip_id = IpIdOffset() & 0x3f; // 6 bits
+        output.push_back(0xc0 | lsb_ip_id >> 1);
+        output.push_back((lsb_ip_id << 7) | header_crc7); // 1 lsb bit from id and crc
+        output.push_back(static_cast<uint8_t>(msn));
+    }
+        
+    uint8_t
+    CIPProfile::control_crc3() const
+    {
+        uint8_t data[4];
+        // reorder_ratio, 2 bits padded with 6 MSB of zeroes
+        data[0] = static_cast<uint8_t>(reorder_ratio) & 3;
+        SetNBO(&data[1], msn);
+        data[3] = static_cast<uint8_t>(ip_id_behaviour) & 3;
+        return CRC3(data, data + sizeof(data));
+    }
+    
+    
+    /*
+     profile_2_3_4_flags_enc(flag, ip_version)
+     {
+         UNCOMPRESSED {
+             ip_outer_indicator [ 1 ];
+             df [ 0, 1 ];
+             ip_id_behavior [ 2 ];
+         }
+         COMPRESSED not_present {
+             ENFORCE(flag == 0);
+             ENFORCE(ip_outer_indicator.CVALUE == 0);
+             df =:= static;
+             ip_id_behavior =:= static;
+         }
+         COMPRESSED present {
+             ENFORCE(flag == 1);
+             ip_outer_indicator =:= irregular(1) [ 1 ];
+             df =:= dont_fragment(ip_version) [ 1 ];
+             ip_id_behavior =:= irregular(2) [ 2 ];
+             reserved =:= compressed_value(4, 0) [ 4 ];
+         }
+     }
+     */
+    void
+    CIPProfile::profile_2_3_4_flags_enc(bool flag, const iphdr* ip, data_t &output)
+    {
+        if (flag)
+        {
+            uint8_t res = 0x00; // ip_outer_indicator = 0
+            if (DontFragment(ip))
+            {
+                res |= 0x40;
+            }
+            
+            res |= static_cast<uint8_t>((ip_id_behaviour << 4) & 0x30);
+            
+            RASSERT((res & 0x0f) == 0);
+            output.push_back(res);
+        }
+    }
+        
+	void CIPProfile::MsnWasAcked(uint16_t /*ackMSN*/) {
+		AdvanceState(true, true);
+	}
+
+	void CIPProfile::NackMsn(uint16_t msn) {
+		TrimWindows(AckedMSN(msn, 14));
+		// Only the dynamic part of the context is damaged
+		RepairDynamicChain();
+	}
+
+	void CIPProfile::StaticNackMsn(uint16_t msn) {
+		NackMsn(msn);
+		// The context has to start over with an IR
+		static_chain_known = false;
+		number_of_co_repair_packets_to_send = 0;
+		state = IR_State;
+	}
+    
+    void
+    CIPProfile::AdvanceState(bool calledFromFeedback, bool ack)
+    {
+        if (IR_State == state)
+        {
+            // If we received
+            if (calledFromFeedback && ack)
+            {
+                state = FO_State;
+            }
+            else if (numberOfIRPacketsSinceReset >= compressor->NumberOfIRPacketsToSend())
+                state = FO_State;
+
+            if (FO_State == state)
+                static_chain_known = true;
+        }
+        else if (FO_State == state)
+        {
+            if (calledFromFeedback && ack)
+            {
+                state = SO_State;
+            }
+            else if (numberOfFOPacketsSinceReset >= compressor->NumberOfFOPacketsToSend())
+                state = SO_State;
+            
+        }
+        else if (SO_State == state)
+        {
+            
+        }
+    }
+} // ns ROHC
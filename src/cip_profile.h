@@ -0,0 +1,83 @@
+#pragma once
+
+/**
+ * IP-only profile, RFC 5225 6.8
+ */
+
+#include "cprofile.h"
+
+namespace ROHC
+{
+    struct udphdr;
+    /**************************************************************************
+     * Compression Profile
+     *
+     * The base header formats (co_common, pt_0_crc3, pt_0_crc7, pt_1_seq_id
+     * and pt_2_seq_id) are shared by the UDP, ESP and IP-only profiles, the
+     * profiles built on this one add their own items to the chains.
+     **************************************************************************/
+    class CIPProfile : public CProfile
+    {
+    public:
+        CIPProfile(Compressor* comp, uint16_t cid, const iphdr* ip);
+
+        virtual bool Matches(unsigned int profileID, const iphdr* ip) const;
+
+        virtual unsigned int ID() const {return ProfileID();}
+
+        virtual void Compress(const data_t& data, data_t& output);
+
+    // Statics
+    public:
+        static uint16_t ProfileID() {return 0x0104;}
+
+    protected:
+		/**
+		 * called by AckLsbMsn or AckFBMsn with the full MSN that was acked
+		 */
+		virtual void MsnWasAcked(uint16_t ackedMSN);
+		/*
+		 * 14 bit MSN
+		 */
+		virtual void NackMsn(uint16_t fbMSN);
+
+		/*
+		 * 14 bit MSN
+		 */
+		virtual void StaticNackMsn(uint16_t fbMSN);
+
+        /**
+         * The headers that are compressed, the rest of the packet is
+         * payload
+         */
+        virtual size_t HeaderSize(const iphdr* ip) const {return IPHeaderSize(ip);}
+        /**
+         * Static part of the header CRC for the IR, and the CRCs of the
+         * current header for CreateCO
+         */
+        virtual void SetStaticCRC(const iphdr* ip) {header_crc.SetStatic(ip, 0);}
+        void CalculateCRC(const iphdr* ip) {header_crc.Calculate(ip, HeaderSize(ip), header_crc3, header_crc7);}
+        virtual void create_static_chain(const iphdr* ip, data_t& output);
+        virtual void create_dynamic_chain(const iphdr* ip, data_t& output);
+        virtual void create_irregular_chain(const iphdr* ip, data_t& output);
+
+        void CreateIR(const iphdr* ip, data_t& output);
+        void CreateCO(const iphdr* ip, const HeaderChange& change, data_t& output);
+        void CreateCORepair(const iphdr* ip, data_t& output);
+        void create_co_common(const ROHC::iphdr *ip, data_t &output);
+        void create_pt_0_crc3(data_t& output);
+        void create_pt_0_crc7(data_t& output);
+        void create_pt_1_seq_id(data_t& output);
+        void create_pt_2_seq_id(data_t& output);
+
+        uint8_t control_crc3() const;
+        void profile_2_3_4_flags_enc(bool flag, const iphdr* ip, data_t& output);
+
+        void AdvanceState(bool calledFromFeedback, bool ack);
+
+    private:
+        // next_header of the static chain
+        uint8_t protocol;
+    };
+
+} // ns ROHC
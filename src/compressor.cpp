@@ -5,6 +5,8 @@
 #include <rohc/rohc.h>
 #include "cprofile.h"
 #include "cuncomp_profile.h"
+#include "arena.h"
+#include "flow_table.h"
 #include <functional>
 #include <algorithm>
 #include <cstring>
@@ -34,31 +36,37 @@ namespace
             return a->LastUsed() < b->LastUsed();
        }
     };
+
+    // RFC 4995 5.2.4.1, the feedback octet, the size octet when the code
+    // is 0 and the feedback data
+    size_t FeedbackElementSize(ROHC::const_data_iterator pos, ROHC::const_data_iterator end)
+    {
+        size_t available = end - pos;
+        size_t size = ROHC::UnmaskFeedback(*pos);
+        size = size ? (1 + size) : ((available > 1) ? (2 + pos[1]) : 2);
+        return std::min(size, available);
+    }
 } // anon ns
 
 namespace ROHC {
     
-    Compressor::Compressor(size_t maxCID, Reordering_t reorder_ratio, IPIDBehaviour_t ip_id_behaviour)
+    Compressor::Compressor(size_t maxCID, Reordering_t reorder_ratio, IPIDBehaviour_t ip_id_behaviour, size_t mrru)
     : maxCID(maxCID)
+    , arena(new ContextArena(ArenaPolicy()))
     , contexts(0)
+    , contextGeneration(0)
+    , flows(new FlowTable(maxCID))
     , feedbackData(0)
     , feedbackMutex(allocMutex())
+    , feedbackPending(0)
     , reorder_ratio(reorder_ratio)
     , ip_id_behaviour(ip_id_behaviour)
-    , numberOfPacketsSent(0)
-    , dataSizeUncompressed(0)
-    , dataSizeCompressed(0)
+    , mrru(mrru)
+    , unit()
+    , statistics()
+    , reportedPacketType(PT_IR)
+    , packetTypeReported(false)
     {
-    
-        /**
-         statistics
-         */
-        numberOfPacketsSent = 0;
-        dataSizeUncompressed = 0;
-        dataSizeCompressed = 0;
-
-        memset(statistics, 0, sizeof(statistics));
-
         // Make room for the uncompressed profile
         contexts.push_back(0);
     }
@@ -67,6 +75,9 @@ namespace ROHC {
         for (contexts_t::iterator i = contexts.begin(); contexts.end() != i; ++i) {
             delete *i;
         }
+        // All contexts have to be gone before the arena
+        delete arena;
+        delete flows;
         freeMutex(feedbackMutex);
     }
     
@@ -114,12 +125,14 @@ namespace ROHC {
                     // Skip the uncompressed profile
                     ctx = min_element(contexts.begin() + 1, contexts.end(), finder);
                     cid = (*ctx)->CID();
+                    flows->Remove(cid);
                     delete *ctx;
                 }
             }
 
             CProfile* profile = CProfile::Create(this, cid, profileId, reinterpret_cast<const iphdr*>(ip));
             contexts[cid] = profile;
+            ++contextGeneration;
             return profile;
         }
         else {
@@ -129,55 +142,238 @@ namespace ROHC {
     
     void Compressor::compress(const data_t& data, data_t& output)
     {
-        output.reserve(data.size());
         // Take care of received feedback
         HandleReceivedFeedback();
 
+        CompressPacket(data, output, 0, millisSinceEpoch());
+    }
+
+    void Compressor::compress(const data_t* const* packets, data_t* const* outputs, size_t count)
+    {
+        HandleReceivedFeedback();
+        time_t now = millisSinceEpoch();
+
+        FlowTable::Lanes lanes;
+        uint32_t cids[FlowTable::MaxLanes];
+        for (size_t first = 0; first < count; first += FlowTable::MaxLanes)
+        {
+            lanes.count = min(count - first, FlowTable::MaxLanes);
+            for (size_t lane = 0; lane < lanes.count; ++lane)
+            {
+                FlowTable::Load(lanes, lane, *packets[first + lane]);
+            }
+            uint32_t eligible = flows->Eligible(lanes, cids);
+
+            // The exceptions go through the lookup, if that creates a
+            // context the CIDs found for the rest of the lanes may be stale
+            unsigned int generation = contextGeneration;
+            for (size_t lane = 0; lane < lanes.count; ++lane)
+            {
+                CProfile* profile = 0;
+                if (((eligible >> lane) & 1) && (generation == contextGeneration))
+                {
+                    profile = contexts[cids[lane]];
+                }
+                CompressPacket(*packets[first + lane], *outputs[first + lane], profile, now);
+            }
+        }
+    }
+
+    size_t Compressor::CompressPacket(const data_t& data, data_t& output, CProfile* profile, time_t now, size_t feedbackLimit)
+    {
+        output.reserve(data.size());
+
         size_t outputInSize = output.size();
         
-        size_t feedbackSize = feedbackData.size();
-        
-        if (feedbackSize)
+        if (ROHC_LOAD_RELAXED(feedbackPending))
         {
-            ScopedLock lock(feedbackMutex);
             // Add feedback data (if exists)
-            output.insert(output.end(), feedbackData.begin(), feedbackData.end());
-            feedbackData.clear();
+            AppendFeedback(output, feedbackLimit);
         }
+        size_t feedbackSize = output.size() - outputInSize;
         
-        if (data.size() < sizeof(iphdr))
+        if (data.size() < sizeof(iphdr) ||
+            data.size() < IPHeaderSize(reinterpret_cast<const iphdr*>(&data[0])))
         {
             error("Not enough data for an IP header\n");
-            return;
+            return feedbackSize;
         }
         
-        vector<uint8_t>::const_iterator curPos = data.begin();
-        
-        const iphdr* ip = reinterpret_cast<const iphdr*>(&curPos[0]);
-        
-        unsigned int profileId = CProfile::ProfileIDForProtocol(ip, distance(curPos, data.end()), rtpDestinations);
-
-        CProfile* profile = findProfile(profileId, ip);
-        profile->SetLastUsed(millisSinceEpoch());
+        if (!profile)
+        {
+            const iphdr* ip = reinterpret_cast<const iphdr*>(&data[0]);
+            unsigned int profileId = CProfile::ProfileIDForProtocol(ip, data.size(), rtpDestinations);
+            profile = findProfile(profileId, ip);
+        }
+        profile->SetLastUsed(now);
         
+        packetTypeReported = false;
         profile->Compress(data, output);
 
-        ++numberOfPacketsSent;
-        dataSizeUncompressed += data.size();
-        dataSizeCompressed += output.size() - outputInSize;
+        CompressorStatistics& stats = statistics.BeginUpdate();
+        if (packetTypeReported)
+        {
+            ++stats.packetCount[reportedPacketType];
+        }
+        ++stats.numberOfPacketsSent;
+        stats.dataSizeUncompressed += data.size();
+        stats.dataSizeCompressed += output.size() - outputInSize;
+        statistics.EndUpdate();
+        return feedbackSize;
+    }
+
+    void Compressor::compress(const data_t& data, std::vector<data_t>& outputs, size_t mtu)
+    {
+        if (1 == mtu)
+        {
+            outputs.clear();
+            error("MTU of 1 octet, too small for a segment\n");
+            return;
+        }
+
+        HandleReceivedFeedback();
+
+        outputs.resize(1);
+        outputs[0].clear();
+        size_t feedbackSize = CompressPacket(data, outputs[0], 0, millisSinceEpoch(), mtu);
+        Segment(outputs, feedbackSize, mtu);
+    }
+
+    /*
+     RFC 4995 5.2.5, the reconstructed unit is the ROHC packet followed by
+     the FCS-32 over it, least significant octet first as in RFC 1662. It
+     is sent in order, each segment with a 1111111F header where F is set
+     on the last one.
+     */
+    void Compressor::Segment(std::vector<data_t>& outputs, size_t feedbackSize, size_t mtu)
+    {
+        data_t& packet = outputs[0];
+        if (!mtu || (packet.size() <= mtu))
+            return;
+
+        size_t packetSize = packet.size() - feedbackSize;
+        if (!packetSize || (packetSize + 4 > mrru))
+            return;
+
+        unit.assign(packet.begin() + feedbackSize, packet.end());
+        uint32_t crc = CRC32(&unit[0], &unit[0] + unit.size());
+        for (unsigned int i = 0; i < 4; ++i)
+        {
+            unit.push_back(static_cast<uint8_t>(crc >> (8 * i)));
+        }
+        packet.resize(feedbackSize);
+
+        size_t sent = 0;
+        size_t count = 0;
+        size_t segments = 0;
+        while (sent < unit.size())
+        {
+            if (count == outputs.size())
+                outputs.push_back(data_t());
+            else if (count > 0)
+                outputs[count].clear();
+            data_t& segmentPacket = outputs[count++];
+
+            // Feedback that fills the first packet is sent alone
+            if (segmentPacket.size() + 1 >= mtu)
+                continue;
+
+            size_t size = min(mtu - segmentPacket.size() - 1, unit.size() - sent);
+            bool final = (sent + size == unit.size());
+            segmentPacket.push_back(final ? finalSegment : segment);
+            segmentPacket.insert(segmentPacket.end(), unit.begin() + sent, unit.begin() + sent + size);
+            sent += size;
+            ++segments;
+        }
+        outputs.resize(count);
+
+        // The segment headers and the CRC
+        CompressorStatistics& stats = statistics.BeginUpdate();
+        stats.packetCount[PT_SEGMENT] += segments;
+        stats.dataSizeCompressed += segments + 4;
+        statistics.EndUpdate();
     }
     
+    bool
+    Compressor::ContextCounters(uint16_t cid, ContextStatistics& counters) const
+    {
+        if (cid >= contexts.size() || !contexts[cid])
+            return false;
+        contexts[cid]->Counters(counters);
+        return true;
+    }
+
     void
     Compressor::SendFeedback(const_data_iterator begin, const_data_iterator end)
     {
         ScopedLock lock(feedbackMutex);
         feedbackData.insert(feedbackData.end(), begin, end);
+        ROHC_STORE_RELAXED(feedbackPending, 1);
+    }
+    
+    void
+    Compressor::SendFeedback(uint16_t cid, FBAckType_t type, const_data_iterator begin, const_data_iterator end)
+    {
+        ScopedLock lock(feedbackMutex);
+        pendingFeedback_t::iterator i = pendingFeedback.find(cid);
+        if (pendingFeedback.end() == i) {
+            i = pendingFeedback.insert(make_pair(cid, PendingFeedback())).first;
+        }
+        // FBAckType_t values are ordered by precedence
+        else if (i->second.type > type) {
+            return;
+        }
+        i->second.type = type;
+        i->second.data.assign(begin, end);
+        ROHC_STORE_RELAXED(feedbackPending, 1);
     }
     
-    void Compressor::AppendFeedback(data_t& data) {
+    void Compressor::AppendFeedback(data_t& data, size_t limit) {
         ScopedLock lock(feedbackMutex);
-        data.insert(data.end(), feedbackData.begin(), feedbackData.end());
-        feedbackData.clear();
+        if (!limit) {
+            data.insert(data.end(), feedbackData.begin(), feedbackData.end());
+            feedbackData.clear();
+            for (pendingFeedback_t::const_iterator i = pendingFeedback.begin(); pendingFeedback.end() != i; ++i) {
+                data.insert(data.end(), i->second.data.begin(), i->second.data.end());
+            }
+            pendingFeedback.clear();
+            ROHC_STORE_RELAXED(feedbackPending, 0);
+            return;
+        }
+
+        // Whole elements in order while they fit, the others are moved to
+        // the front of feedbackData or left in pendingFeedback
+        size_t size = 0;
+        data_t::iterator kept = feedbackData.begin();
+        for (data_t::iterator pos = feedbackData.begin(); feedbackData.end() != pos; ) {
+            data_t::iterator next = pos + FeedbackElementSize(pos, feedbackData.end());
+            size_t elementSize = next - pos;
+            if (elementSize > limit) {
+                error("Feedback of %u octets larger than the MTU, dropped\n", static_cast<unsigned int>(elementSize));
+            } else if (size + elementSize <= limit) {
+                data.insert(data.end(), pos, next);
+                size += elementSize;
+            } else {
+                kept = copy(pos, next, kept);
+            }
+            pos = next;
+        }
+        feedbackData.erase(kept, feedbackData.end());
+
+        for (pendingFeedback_t::iterator i = pendingFeedback.begin(); pendingFeedback.end() != i; ) {
+            size_t elementSize = i->second.data.size();
+            if (elementSize > limit) {
+                error("Feedback of %u octets larger than the MTU, dropped\n", static_cast<unsigned int>(elementSize));
+            } else if (size + elementSize <= limit) {
+                data.insert(data.end(), i->second.data.begin(), i->second.data.end());
+                size += elementSize;
+            } else {
+                ++i;
+                continue;
+            }
+            pendingFeedback.erase(i++);
+        }
+        ROHC_STORE_RELAXED(feedbackPending, (feedbackData.empty() && pendingFeedback.empty()) ? 0 : 1);
     }
 
     void
@@ -1,10 +1,15 @@
 #include "cprofile.h"
+#include "cip_profile.h"
+#include "cesp_profile.h"
 #include "cudp_profile.h"
+#include "cudplite_profile.h"
 #include "crtp_profile.h"
+#include "crtplite_profile.h"
 #include "cuncomp_profile.h"
 #include "ctcp_profile.h"
 #include "network.h"
 #include <cstdlib>
+#include <algorithm>
 #include <cstring>
 #include <rohc/decomp.h>
 #include <rohc/compressor.h>
@@ -26,37 +31,62 @@ namespace ROHC
     numberOfSOPacketsSent(0),
     dataSizeUncompressed(0),
     dataSizeCompressed(0),
+    predictionHits(0),
+    predictionMisses(0),
     numberOfIRPacketsSinceReset(0),
     numberOfFOPacketsSinceReset(0),
     msn(static_cast<uint16_t>(rand())),
     msnWindow(16, 16, 1)
     ,reorder_ratio(compressor->ReorderRatio())
-    ,ip_id_behaviour(compressor->IPIdBehaviour())
+    ,ip_id_behaviour(IsIPv6(ip) ? IP_ID_BEHAVIOUR_RANDOM : compressor->IPIdBehaviour())
     ,largeCID(compressor->LargeCID())
     ,state(IR_State)
-    ,saddr(ip->saddr)
-    ,daddr(ip->daddr)
+    ,static_chain_known(false)
+    ,number_of_co_repair_packets_to_send(0)
+    ,number_of_packets_with_new_ip_fields_to_send(0)
+    ,ipv6(IsIPv6(ip))
+    ,flow_label(0)
+    ,header_crc()
+    ,header_crc3(0)
+    ,header_crc7(0)
     ,ip_id_offset(0)
     ,ip_id_offset_window(8, 16, 0) //(1<<16)/4 - 1)  // p = ((2^k) / 4) - 1)
     {
         //msn = 0;
         msnWindow.setP(LSBWindowPForReordering(reorder_ratio, 16));
-        if (ip) {
+        memset(addresses, 0, sizeof(addresses));
+        if (ipv6) {
+            const ipv6hdr* ip6 = AsIPv6(ip);
+            memcpy(addresses, ip6->saddr, 32);
+            flow_label = FlowLabel(ip6);
+            memset(&last_ip, 0, sizeof(last_ip));
+            last_ip.version = 6;
+            last_ip.tos = TrafficClass(ip6);
+            last_ip.ttl = ip6->hop_limit;
+        }
+        else {
+            memcpy(addresses, &ip->saddr, 8);
             memcpy(&last_ip, ip, sizeof(last_ip));
         }
-		memset(packetCount, 0, sizeof(packetCount));
+        memset(last_header, 0, sizeof(last_header));
     }
     
     unsigned int
     CProfile::ProfileIDForProtocol(const iphdr* ip, size_t totalSize, const std::vector<RTPDestination>& rtpDestinations) {
-        if (ROHC::HasMoreFragments(ip) || ROHC::HasFragmentOffset(ip)) {
+        // An IPv6 fragment has a fragment header, not UDP, as next header.
+        // No profile compresses the IPv4 fragment fields or options.
+        if (!IsIPv6(ip) && (ROHC::HasMoreFragments(ip) || ROHC::HasFragmentOffset(ip) || (5 != ip->ihl))) {
             return CUncompressedProfile::ProfileID();
         }
 
-        if (CUDPProfile::ProtocolID() == ip->protocol)
+        size_t ipSize = IPHeaderSize(ip);
+        // UDP-Lite has the same header, with the checksum coverage as length
+        bool udpLite = (CUDPLiteProfile::ProtocolID() == IPProtocol(ip));
+        if (((CUDPProfile::ProtocolID() == IPProtocol(ip)) || udpLite) &&
+            (totalSize >= ipSize + sizeof(udphdr)))
         {
-            const udphdr* udp = reinterpret_cast<const udphdr*>(ip+1);
-			if (totalSize >= (sizeof(iphdr) + sizeof(udphdr) + sizeof(rtphdr))) {
+            const udphdr* udp = NextHeader<udphdr>(ip);
+			if (totalSize >= (ipSize + sizeof(udphdr) + sizeof(rtphdr))) {
 				const rtphdr* rtp = reinterpret_cast<const rtphdr*>(udp+1);
 				// Make sure we have rtp version 2
 				if (2 == rtp->version) {
@@ -65,16 +95,28 @@ namespace ROHC
 						 ++rd) {
 						if (/*ip->daddr == rd->daddr &&*/
 							udp->dest == rd->dport) {
-							return CRTPProfile::ProfileID();
+							return udpLite ? CRTPLiteProfile::ProfileID() : CRTPProfile::ProfileID();
 						}
 					}
 				}
 			}
-            return CUDPProfile::ProfileID();
+            return udpLite ? CUDPLiteProfile::ProfileID() : CUDPProfile::ProfileID();
         } 
-        /*else if (CTCPProfile::ProtocolID() == ip->protocol) {
+        // Segments whose options cannot be compressed as a list are left
+        // to the IP-only profile
+        else if ((CTCPProfile::ProtocolID() == IPProtocol(ip)) &&
+                 (totalSize >= ipSize + sizeof(tcphdr)) &&
+                 CTCPProfile::OptionsCompressible(NextHeader<tcphdr>(ip), totalSize - ipSize)) {
             return CTCPProfile::ProfileID();
-        }*/
+        }
+        else if ((CESPProfile::ProtocolID() == IPProtocol(ip)) &&
+                 (totalSize >= ipSize + sizeof(esphdr))) {
+            return CESPProfile::ProfileID();
+        }
+        // A UDP packet too short for its header stays uncompressed
+        else if ((CUDPProfile::ProtocolID() != IPProtocol(ip)) && !udpLite) {
+            return CIPProfile::ProfileID();
+        }
         
         return CUncompressedProfile::ProfileID();
     }
@@ -84,58 +126,71 @@ namespace ROHC
     {
         if (profileID == CUDPProfile::ProfileID())
         {
-            return new CUDPProfile(comp, cid, ip);
+            return new (comp->Arena()) CUDPProfile(comp, cid, ip);
         }
         else if (profileID == CRTPProfile::ProfileID())
         {
-            return new CRTPProfile(comp, cid, ip);
+            return new (comp->Arena()) CRTPProfile(comp, cid, ip);
+        } else if (CUDPLiteProfile::ProfileID() == profileID) {
+            return new (comp->Arena()) CUDPLiteProfile(comp, cid, ip);
+        } else if (CRTPLiteProfile::ProfileID() == profileID) {
+            return new (comp->Arena()) CRTPLiteProfile(comp, cid, ip);
         } else if (CTCPProfile::ProfileID() == profileID) {
-            return new CTCPProfile(comp, cid, ip);
+            return new (comp->Arena()) CTCPProfile(comp, cid, ip);
+        } else if (CESPProfile::ProfileID() == profileID) {
+            return new (comp->Arena()) CESPProfile(comp, cid, ip);
+        } else if (CIPProfile::ProfileID() == profileID) {
+            return new (comp->Arena()) CIPProfile(comp, cid, ip);
         }
         // TODO: other profiles
-        return new CUncompressedProfile(comp, cid, ip);
+        return new (comp->Arena()) CUncompressedProfile(comp, cid, ip);
     }
 
 	uint16_t
-    CProfile::UpdateMSN(uint16_t lsbMSN, unsigned int lsbMSNWidth, uint16_t& newMsn) const
+    CProfile::AckedMSN(uint16_t lsbMSN, unsigned int lsbMSNWidth) const
     {
-		uint16_t msn_p = static_cast<uint16_t>(LSBWindowPForReordering(reorder_ratio, lsbMSNWidth));
-		// Store old val if newMsn is a reference to msn
-		uint16_t oldMsn = msn;
-        uint16_t lowerBound = static_cast<uint16_t>(msn - msn_p);
-        
+        // Feedback can only acknowledge packets already sent, so the MSN
+        // is the latest one at or before the last MSN sent
+        uint16_t lastSent = static_cast<uint16_t>(msn - 1);
         uint16_t mask = static_cast<uint16_t>((1<<lsbMSNWidth) - 1);
 
-        newMsn = static_cast<uint16_t>((msn & ~mask) | (lsbMSN & mask));
-        if (newMsn < lowerBound)
-        {
-            newMsn += static_cast<uint16_t>(1<<lsbMSNWidth);
-        }
-	uint16_t delta_msn = static_cast<uint16_t>(newMsn - oldMsn);
-
-        return delta_msn;
+        return static_cast<uint16_t>(lastSent - ((lastSent - lsbMSN) & mask));
     }
 
     void
     CProfile::AckLsbMsn(uint8_t lsbMsn)
     {
-        uint16_t ackMsn = 0;
-		UpdateMSN(lsbMsn, 8, ackMsn);
-        msnWindow.ackMSN(ackMsn);
-        ip_id_offset_window.ackMSN(ackMsn);
+        uint16_t ackMsn = AckedMSN(lsbMsn, 8);
+        TrimWindows(ackMsn);
 		MsnWasAcked(ackMsn);
     }
     
     void
     CProfile::AckFBMsn(uint16_t fbMsn)
     {
-        uint16_t ackMsn = 0;
-		UpdateMSN(fbMsn, 14, ackMsn);
-        msnWindow.ackMSN(ackMsn);
-        ip_id_offset_window.ackMSN(ackMsn);
+        uint16_t ackMsn = AckedMSN(fbMsn, 14);
+        TrimWindows(ackMsn);
 		MsnWasAcked(ackMsn);
     }
+
+    void
+    CProfile::TrimWindows(uint16_t msn)
+    {
+        msnWindow.ackMSN(msn);
+        ip_id_offset_window.ackMSN(msn);
+    }
     
+    void
+    CProfile::Counters(ContextStatistics& counters) const
+    {
+        counters.profileID = ID();
+        counters.numberOfPacketsSent = numberOfPacketsSent;
+        counters.dataSizeUncompressed = dataSizeUncompressed;
+        counters.dataSizeCompressed = dataSizeCompressed;
+        counters.predictionHits = predictionHits;
+        counters.predictionMisses = predictionMisses;
+    }
+
     void
     CProfile::increaseMsn()
     {
@@ -144,30 +199,134 @@ namespace ROHC
         ++msn;
     }
     
+    void
+    CProfile::RepairDynamicChain()
+    {
+        numberOfIRPacketsSinceReset = numberOfFOPacketsSinceReset = 0;
+        if (static_chain_known && (IR_State != state))
+        {
+            number_of_co_repair_packets_to_send = compressor->NumberOfCORepairPacketsToSend();
+            state = FO_State;
+        }
+        else
+        {
+            state = IR_State;
+        }
+    }
+
     void
     CProfile::UpdateIpIdOffset(const ROHC::iphdr *ip)
     {
         last_ip_id_offset = ip_id_offset;
+        ip_id_offset = CalculateIpIdOffset(ip, msn);
+    }
 
-        // TODO, handle big endian
+    uint16_t
+    CProfile::CalculateIpIdOffset(const ROHC::iphdr *ip, uint16_t packetMsn) const
+    {
         if (IP_ID_BEHAVIOUR_SEQUENTIAL == ip_id_behaviour)
         {
             uint16_t id = rohc_htons(ip->id);
-            ip_id_offset = static_cast<uint16_t>(id - msn);
+            return static_cast<uint16_t>(id - packetMsn);
         }
         else if (IP_ID_BEHAVIOUR_SEQUENTIAL_SWAPPED == ip_id_behaviour)
         {
-            ip_id_offset = static_cast<uint16_t>(ip->id - msn);
+            return static_cast<uint16_t>(rohc_htoles(ip->id) - packetMsn);
         }
+        return ip_id_offset;
     }
     
     void
     CProfile::UpdateIpInformation(const ROHC::iphdr *ip)
     {
-      	memcpy(&last_ip, ip, sizeof(last_ip));
+        if ((TosTc(ip) != last_ip.tos) ||
+            (TtlHopl(ip) != last_ip.ttl) ||
+            (DontFragment(ip) != HasDontFragment(&last_ip)))
+        {
+            number_of_packets_with_new_ip_fields_to_send = 5;
+        }
+        else if (number_of_packets_with_new_ip_fields_to_send > 0)
+        {
+            --number_of_packets_with_new_ip_fields_to_send;
+        }
+
+        if (ipv6) {
+            last_ip.tos = TosTc(ip);
+            last_ip.ttl = TtlHopl(ip);
+        }
+        else {
+            memcpy(&last_ip, ip, sizeof(last_ip));
+        }
 		ip_id_offset_window.add(msn, ip_id_offset);
     }
+
+    bool
+    CProfile::MatchesIPStatic(const iphdr* ip) const
+    {
+        if (IsIPv6(ip) != ipv6)
+            return false;
+        if (ipv6) {
+            const ipv6hdr* ip6 = AsIPv6(ip);
+            return (flow_label == FlowLabel(ip6)) && !memcmp(addresses, ip6->saddr, 32);
+        }
+        return !memcmp(addresses, &ip->saddr, 8);
+    }
+
+    HeaderChange
+    CProfile::ChangeFromLastHeader(const data_t& data) const
+    {
+        if (data.size() >= headerBlockSize)
+            return HeaderChange(last_header, &data[0]);
+
+        uint8_t padded[headerBlockSize];
+        memset(padded, 0, sizeof(padded));
+        memcpy(padded, &data[0], data.size());
+        return HeaderChange(last_header, padded);
+    }
+
+    void
+    CProfile::UpdateLastHeader(const data_t& data)
+    {
+        size_t size = std::min(data.size(), headerBlockSize);
+        memcpy(last_header, &data[0], size);
+        memset(last_header + size, 0, headerBlockSize - size);
+    }
     
+    void
+    CProfile::create_ip_static(const iphdr* ip, data_t& output)
+    {
+        if (ipv6)
+            create_ipv6_static(AsIPv6(ip), output);
+        else
+            create_ipv4_static(ip, output);
+    }
+
+    void
+    CProfile::create_ip_regular_dynamic(const iphdr* ip, data_t& output)
+    {
+        if (ipv6)
+            create_ipv6_regular_dynamic(AsIPv6(ip), output);
+        else
+            create_ipv4_regular_innermost_dynamic(ip, output);
+    }
+
+    void
+    CProfile::create_ip_endpoint_dynamic(const iphdr* ip, data_t& output)
+    {
+        if (ipv6)
+            create_ipv6_endpoint_dynamic(AsIPv6(ip), output);
+        else
+            create_ipv4_endpoint_innermost_dynamic(ip, output);
+    }
+
+    void
+    CProfile::create_ip_innermost_irregular(const iphdr* ip, data_t& output)
+    {
+        // ipv6_innermost_irregular is empty
+        if (!ipv6)
+            create_ipv4_innermost_irregular(ip, output);
+    }
+
     /*
      COMPRESSED ipv4_static {
      version_flag   =:= ’0’             [ 1 ];
@@ -216,6 +375,37 @@ namespace ROHC
         ip_id_enc_dyn(ip, output);
     }
 
+    /*
+     COMPRESSED ipv4_endpoint_innermost_dynamic {
+     ENFORCE((is_innermost == 1) && (profile_value == PROFILE_IP_0104));
+     ENFORCE(ip_id_behavior_innermost.UVALUE == ip_id_behavior_value);
+     reserved                   =:= ’000’                                           [ 3 ];
+     reorder_ratio              =:= irregular(2)                                    [ 2 ];
+     df                         =:= irregular(1)                                    [ 1 ];
+     ip_id_behavior_innermost   =:= irregular(2)                                    [ 2 ];
+     tos_tc                     =:= irregular(8)                                    [ 8 ];
+     ttl_hopl                   =:= irregular(8)                                    [ 8 ];
+     ip_id                      =:= ip_id_enc_dyn(ip_id_behavior_innermost.UVALUE)  [ 0, 16 ];
+     msn                        =:= irregular(16)                                   [ 16 ];
+     }
+     */
+    void
+    CProfile::create_ipv4_endpoint_innermost_dynamic(const iphdr* ip, data_t &output)
+    {
+        uint8_t reservedRRDfIpIdBehaviour = static_cast<uint8_t>((reorder_ratio & 3) << 3);
+        if (HasDontFragment(ip))
+            reservedRRDfIpIdBehaviour |= 4;
+        reservedRRDfIpIdBehaviour |= static_cast<uint8_t>(ip_id_behaviour);
+
+        output.push_back(reservedRRDfIpIdBehaviour);
+
+        output.push_back(ip->tos);
+        output.push_back(ip->ttl);
+
+        ip_id_enc_dyn(ip, output);
+        AppendDataToNBO(output, msn);
+    }
+
 	/*
 	ip_id_enc_dyn(behavior)
 	{
@@ -255,7 +445,6 @@ namespace ROHC
             }
                 break;
             case IP_ID_BEHAVIOUR_SEQUENTIAL_SWAPPED:
-                // TODO, fix for big endian
             {
                 AppendData(output, ip->id);
             }
@@ -324,10 +513,87 @@ namespace ROHC
         ip_id_enc_irreg(ip, output);
     }
 
+    /*
+     COMPRESSED ipv6_static1 {
+     version_flag                   =:= ’1’              [ 1 ];
+     innermost_ip                   =:= irregular(1)     [ 1 ];
+     reserved                       =:= ’0’              [ 1 ];
+     flow_label_enc_discriminator   =:= ’0’              [ 1 ];
+     reserved                       =:= ’0000’           [ 4 ];
+     flow_label   =:= uncompressed_value(20, 0)          [ 0 ];
+     next_header  =:= irregular(8)                       [ 8 ];
+     src_addr     =:= irregular(128)                     [ 128 ];
+     dst_addr     =:= irregular(128)                     [ 128 ];
+     }
+
+     COMPRESSED ipv6_static2 {
+     version_flag                   =:= ’1’              [ 1 ];
+     innermost_ip                   =:= irregular(1)     [ 1 ];
+     reserved                       =:= ’0’              [ 1 ];
+     flow_label_enc_discriminator   =:= ’1’              [ 1 ];
+     flow_label   =:= irregular(20)                      [ 20 ];
+     next_header  =:= irregular(8)                       [ 8 ];
+     src_addr     =:= irregular(128)                     [ 128 ];
+     dst_addr     =:= irregular(128)                     [ 128 ];
+     }
+     */
+    void
+    CProfile::create_ipv6_static(const ipv6hdr* ip, data_t& output)
+    {
+        uint32_t flowLabel = FlowLabel(ip);
+        if (flowLabel)
+        {
+            // version_flag = '1', innermost_ip = 1, flow_label_enc_discriminator = '1'
+            output.push_back(static_cast<uint8_t>(0xd0 | (flowLabel >> 16)));
+            output.push_back(static_cast<uint8_t>(flowLabel >> 8));
+            output.push_back(static_cast<uint8_t>(flowLabel));
+        }
+        else
+        {
+            output.push_back(0xc0);
+        }
+        output.push_back(ip->nexthdr);
+        output.insert(output.end(), ip->saddr, ip->saddr + sizeof(ip->saddr));
+        output.insert(output.end(), ip->daddr, ip->daddr + sizeof(ip->daddr));
+    }
+
+    /*
+     COMPRESSED ipv6_regular_dynamic {
+     ENFORCE((is_innermost == 0) || (profile_value != PROFILE_IP_0104));
+     tos_tc     =:= irregular(8)    [ 8 ];
+     ttl_hopl   =:= irregular(8)    [ 8 ];
+     }
+     */
+    void
+    CProfile::create_ipv6_regular_dynamic(const ipv6hdr* ip, data_t& output)
+    {
+        output.push_back(TrafficClass(ip));
+        output.push_back(ip->hop_limit);
+    }
+
+    /*
+     COMPRESSED ipv6_endpoint_dynamic {
+     ENFORCE((is_innermost == 1) && (profile_value == PROFILE_IP_0104));
+     tos_tc         =:= irregular(8)                [ 8 ];
+     ttl_hopl       =:= irregular(8)                [ 8 ];
+     reserved       =:= compressed_value(14, 0)     [ 14 ];
+     reorder_ratio  =:= irregular(2)                [ 2 ];
+     msn            =:= irregular(16)               [ 16 ];
+     }
+     */
+    void
+    CProfile::create_ipv6_endpoint_dynamic(const ipv6hdr* ip, data_t& output)
+    {
+        output.push_back(TrafficClass(ip));
+        output.push_back(ip->hop_limit);
+        output.push_back(0);
+        output.push_back(static_cast<uint8_t>(reorder_ratio & 3));
+        AppendDataToNBO(output, msn);
+    }
+
 	void 
 	CProfile::IncreasePacketCount(PacketType packetType)
 	{
-		++packetCount[packetType];
 		compressor->IncreasePacketCount(packetType);
 	}
 
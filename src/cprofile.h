@@ -1,7 +1,9 @@
 #pragma once
 
 #include <rohc/rohc.h>
+#include <rohc/statistics.h>
 #include "lsb.h"
+#include "arena.h"
 #include "network.h"
 
 #include <deque>
@@ -23,6 +25,13 @@ namespace ROHC
     public:
         CProfile (Compressor* comp, uint16_t cid, const iphdr* ip);
         virtual ~CProfile() {}
+
+        /**
+         * Contexts are allocated from the arena of the owning compressor
+         */
+        static void* operator new(size_t size, ContextArena* arena) {return ContextArena::Allocate(arena, size);}
+        static void operator delete(void* p, ContextArena*) {ContextArena::Free(p);}
+        static void operator delete(void* p) {ContextArena::Free(p);}
         
         // Virtual functions
     public:
@@ -40,6 +49,8 @@ namespace ROHC
         
         uint16_t CID() const {return cid;}
 
+        void Counters(ContextStatistics& counters) const;
+
 		/*
 		 * msn with 8 bits, (from feedback 1)
 		 */
@@ -72,15 +83,46 @@ namespace ROHC
 		 */
 		virtual void MsnWasAcked(uint16_t ackedMSN) = 0;
 
+		/**
+		 * Drops the references older than msn, which the decompressor has,
+		 * from the windows. Done for ACKs and NACKs alike, a NACK does not
+		 * advance the state though.
+		 */
+		virtual void TrimWindows(uint16_t msn);
+
+        /**
+         * The chain items of the innermost IP header, IPv4 or IPv6
+         * depending on the context
+         */
+        void create_ip_static(const iphdr* ip, data_t& output);
+        void create_ip_regular_dynamic(const iphdr* ip, data_t& output);
+        void create_ip_innermost_irregular(const iphdr* ip, data_t& output);
+        /**
+         * The dynamic chain item of the IP-only profile, where the
+         * innermost IP header also carries the MSN and reorder_ratio
+         */
+        void create_ip_endpoint_dynamic(const iphdr* ip, data_t& output);
+
 		void create_ipv4_static(const iphdr* ip, data_t& output);
         void create_ipv4_regular_innermost_dynamic(const iphdr* ip, data_t& output);
+        void create_ipv4_endpoint_innermost_dynamic(const iphdr* ip, data_t& output);
         void create_ipv4_innermost_irregular(const iphdr* ip, data_t& output);
+        void create_ipv6_static(const ipv6hdr* ip, data_t& output);
+        void create_ipv6_regular_dynamic(const ipv6hdr* ip, data_t& output);
+        void create_ipv6_endpoint_dynamic(const ipv6hdr* ip, data_t& output);
         void ip_id_enc_dyn(const iphdr* ip, data_t& output);
         void ip_id_enc_irreg(const iphdr* ip, data_t& output);
         void ip_id_sequential_variable(bool indicator, const iphdr* ip, data_t& output);
 
         // return number of bits for LSB encoding msn given the current window
         void increaseMsn();
+
+        /**
+         * The dynamic chain has to be sent again (NACK, or a change no
+         * base header can carry): co_repair for the RFC 5225 profiles if
+         * the decompressor has the static chain, otherwise IR state
+         */
+        void RepairDynamicChain();
         
         /*
          returns true if ip_id_offset has changed
@@ -89,10 +131,29 @@ namespace ROHC
         void UpdateIpInformation(const iphdr* ip);
         uint16_t ip_id_lsb(unsigned int k);
         
-		inline bool TOSChanged(const iphdr* ip) const { return ip->tos != last_ip.tos;}
-        inline bool TTLChanged(const iphdr* ip) const { return ip->ttl != last_ip.ttl;}
-        inline bool DFChanged(const iphdr* ip) const {return HasDontFragment(ip) != HasDontFragment(&last_ip);}
+        /**
+         * The addresses of ip, and its flow label for IPv6, are those of
+         * the context
+         */
+        bool MatchesIPStatic(const iphdr* ip) const;
+
+        inline bool DontFragment(const iphdr* ip) const {return !ipv6 && HasDontFragment(ip);}
+        /**
+         * The field has to be sent: it differs from the last header, or
+         * one of tos, ttl and df changed in the last packets, which the
+         * decompressor might not have received
+         */
+		inline bool TOSChanged(const iphdr* ip) const { return (TosTc(ip) != last_ip.tos) || (number_of_packets_with_new_ip_fields_to_send > 0);}
+        inline bool TTLChanged(const iphdr* ip) const { return (TtlHopl(ip) != last_ip.ttl) || (number_of_packets_with_new_ip_fields_to_send > 0);}
+        inline bool DFChanged(const iphdr* ip) const {return (DontFragment(ip) != HasDontFragment(&last_ip)) || (number_of_packets_with_new_ip_fields_to_send > 0);}
         inline bool IPIDOffsetChanged() const {return last_ip_id_offset != ip_id_offset;}
+
+        /**
+         * Changes in the first headerBlockSize bytes of data since the
+         * last packet, short packets are compared zero padded
+         */
+        HeaderChange ChangeFromLastHeader(const data_t& data) const;
+        void UpdateLastHeader(const data_t& data);
         
 
 		void IncreasePacketCount(PacketType packetType);
@@ -104,7 +165,25 @@ namespace ROHC
 
 		uint16_t IpIdOffset() const {return ip_id_offset;}
 
-		uint16_t UpdateMSN(uint16_t lsbMSN, unsigned int lsbMSNWidth, uint16_t& newMsn) const;
+        /**
+         * ip_id_lsb(k, p) with all offsets in the window, the TCP profile
+         * uses other p than 0
+         */
+        bool IpIdOffsetFits(unsigned int k, int p) const
+        {
+            return ip_id_offset_window.fits(ip_id_offset, k, p);
+        }
+
+        /**
+         * The ip_id_offset of ip if it had packetMsn, the current offset
+         * for random and zero IP-ID
+         */
+        uint16_t CalculateIpIdOffset(const iphdr* ip, uint16_t packetMsn) const;
+
+        /**
+         * The full MSN acknowledged by feedback carrying lsbMSNWidth bits
+         */
+		uint16_t AckedMSN(uint16_t lsbMSN, unsigned int lsbMSNWidth) const;
 
         Compressor* compressor;
         uint16_t cid;
@@ -120,6 +199,10 @@ namespace ROHC
         size_t dataSizeUncompressed;
         size_t dataSizeCompressed;
 
+        // See ContextStatistics
+        size_t predictionHits;
+        size_t predictionMisses;
+
         unsigned int numberOfIRPacketsSinceReset;
         unsigned int numberOfFOPacketsSinceReset;
         
@@ -144,17 +227,36 @@ namespace ROHC
             FO_State,
             SO_State
         } state;
+
+        // The decompressor has the static chain once the context has left
+        // IR state, until a STATIC-NACK. TCP then sends IR-DYN in IR state,
+        // the RFC 5225 profiles co_repair (RepairDynamicChain)
+        bool static_chain_known;
+        // co_repair packets left to send, RFC 5225 profiles
+        unsigned int number_of_co_repair_packets_to_send;
+        // Packets that still repeat tos, ttl and df after one of them
+        // changed, pt_0, pt_1 and pt_2 cannot carry them
+        unsigned int number_of_packets_with_new_ip_fields_to_send;
         
-        uint32_t saddr;
-        uint32_t daddr;
+        // Static fields of the innermost IP header, IPv6 has no IP-ID and
+        // its contexts always use IP_ID_BEHAVIOUR_RANDOM
+        bool ipv6;
+        uint8_t addresses[32]; // source and destination, 4 or 16 bytes each
+        uint32_t flow_label;
 
+        // For IPv6 only tos (tos_tc) and ttl (ttl_hopl) are set
 		iphdr last_ip;
+        // The first headerBlockSize bytes of the last packet, zero padded
+        uint8_t last_header[headerBlockSize];
+
+        // Static part set by CreateIR, the CRCs of the current header by CreateCO
+        HeaderCRC header_crc;
+        uint8_t header_crc3;
+        uint8_t header_crc7;
     private:
         uint16_t last_ip_id_offset;
 
 		uint16_t ip_id_offset;
         WLSB<int> ip_id_offset_window;
-
-		size_t packetCount[PT_2_SEQ_TS + 1];
     };
 } // ns ROHC
\ No newline at end of file
@@ -0,0 +1,369 @@
+#include <rohc/rohc.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define ROHC_CRC_CLMUL 1
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#include <cstring>
+#include <cstddef>
+#endif
+
+namespace
+{
+#include "crc_tables.h"
+
+    typedef const uint8_t (*tables_t)[256];
+
+    /**
+     * Table driven, 8 bytes per step (slice-by-8), then 4 (slice-by-4),
+     * then one byte at a time.
+     *
+     * The CRCs are linear, so the register after a block is the xor of the
+     * contributions of each byte, t[k] being the contribution of a byte
+     * followed by k more bytes.
+     */
+    uint8_t CRCSlice(tables_t t, uint8_t crc, const uint8_t* p, const uint8_t* end)
+    {
+        while (end - p >= 8) {
+            crc = t[7][p[0] ^ crc] ^ t[6][p[1]] ^ t[5][p[2]] ^ t[4][p[3]]
+                ^ t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+            p += 8;
+        }
+        if (end - p >= 4) {
+            crc = t[3][p[0] ^ crc] ^ t[2][p[1]] ^ t[1][p[2]] ^ t[0][p[3]];
+            p += 4;
+        }
+        while (p != end) {
+            crc = t[0][*p++ ^ crc];
+        }
+        return crc;
+    }
+
+    /**
+     * The register after size zero octets
+     */
+    uint8_t CRCShift(tables_t t, uint8_t crc, size_t size)
+    {
+        for (; size >= 8; size -= 8) {
+            crc = t[7][crc];
+        }
+        return size ? t[size - 1][crc] : crc;
+    }
+
+    uint8_t CRC3Slice(uint8_t crc, const uint8_t* begin, const uint8_t* end) { return CRCSlice(crc3Tables, crc, begin, end); }
+    uint8_t CRC7Slice(uint8_t crc, const uint8_t* begin, const uint8_t* end) { return CRCSlice(crc7Tables, crc, begin, end); }
+    uint8_t CRC8Slice(uint8_t crc, const uint8_t* begin, const uint8_t* end) { return CRCSlice(crc8Tables, crc, begin, end); }
+
+    typedef uint8_t (*crcKernel_t)(uint8_t crc, const uint8_t* begin, const uint8_t* end);
+
+    // Replaced by CRCStartup if the CPU has something faster
+    crcKernel_t crc3Kernel = CRC3Slice;
+    crcKernel_t crc7Kernel = CRC7Slice;
+    crcKernel_t crc8Kernel = CRC8Slice;
+
+#ifdef ROHC_CRC_CLMUL
+    /**
+     * Carry-less multiplication (PCLMULQDQ) with Barrett reduction.
+     *
+     * A w bit CRC with polynomial P is computed as a 32 bit CRC with the
+     * polynomial P * x^(32-w): the 32 bit register is the w bit register
+     * times x^(32-w), in the reflected bit order that is the w bit register
+     * in the low bits with the high bits zero.
+     *
+     * Blocks of 16 bytes are folded into a 128 bit accumulator A, with
+     * A * x^128 = A_hi * x^192 + A_lo * x^128, reduced modulo P32 using
+     * precomputed x^n mod P32. The accumulator is then reduced to 64 bits.
+     *
+     * A 64 bit value X (with the register xored into the first bytes)
+     * gives the new register (X * x^32) mod P32, computed with
+     * q = floor(X * mu / x^64) and r = (q * P32) mod x^32 where
+     * mu = floor(x^96 / P32) (Barrett reduction).
+     *
+     * All values are bit reflected. A product of reflected operands is the
+     * reflected product shifted by one bit, the exponents of the folding
+     * constants are chosen to compensate for that.
+     *
+     * The fixed cost of the reductions makes the tables faster for short
+     * input, a typical IPv4/UDP/RTP header is 40 bytes.
+     */
+    const ptrdiff_t clmulMinimumSize = 64;
+
+    struct ClmulConstants
+    {
+        uint64_t mu;    // reflected mu without the x^64 term
+        uint64_t poly;  // reflected P32 without the x^32 term
+        uint64_t x159;  // reflected x^n mod P32, 32 bits
+        uint64_t x95;
+        uint64_t x63;
+    };
+
+    ClmulConstants crc3Clmul;
+    ClmulConstants crc7Clmul;
+    ClmulConstants crc8Clmul;
+
+    uint64_t Reflect64(uint64_t v)
+    {
+        uint64_t r = 0;
+        for (int i = 0; i < 64; ++i) {
+            r = (r << 1) | ((v >> i) & 1);
+        }
+        return r;
+    }
+
+    // x^n mod p32, normal bit order
+    uint32_t XPowModP(unsigned int n, uint64_t p32)
+    {
+        uint64_t v = 1;
+        for (unsigned int i = 0; i < n; ++i) {
+            v <<= 1;
+            if (v & (static_cast<uint64_t>(1) << 32)) {
+                v ^= p32;
+            }
+        }
+        return static_cast<uint32_t>(v);
+    }
+
+    uint64_t Reflect32(uint32_t v)
+    {
+        return Reflect64(v) >> 32;
+    }
+
+    /**
+     * reflectedPoly is the polynomial as used by the tables, without the
+     * x^w term, this is also the reflected P32 without the x^32 term.
+     */
+    ClmulConstants CreateClmulConstants(unsigned int width, uint8_t reflectedPoly)
+    {
+        // P32 in normal bit order, bit 32 is the x^32 term
+        uint64_t p32 = static_cast<uint64_t>(1) << 32;
+        for (unsigned int i = 0; i < width; ++i) {
+            if (reflectedPoly & (1 << i)) {
+                p32 |= static_cast<uint64_t>(1) << (31 - i);
+            }
+        }
+
+        // mu = floor(x^96 / P32) by long division, degree 64. The running
+        // remainder stays below x^32 so only the quotient bits are kept.
+        uint64_t rem = 0;
+        uint64_t mu = 0;
+        for (int bit = 96; bit >= 0; --bit) {
+            rem = (rem << 1) | (96 == bit ? 1 : 0);
+            if (bit <= 64) {
+                mu <<= 1;
+            }
+            if (rem & (static_cast<uint64_t>(1) << 32)) {
+                rem ^= p32;
+                if (bit <= 64) {
+                    mu |= 1;
+                }
+            }
+        }
+
+        ClmulConstants c;
+        c.mu = Reflect64(mu);
+        c.poly = reflectedPoly;
+        c.x159 = Reflect32(XPowModP(159, p32));
+        c.x95 = Reflect32(XPowModP(95, p32));
+        c.x63 = Reflect32(XPowModP(63, p32));
+        return c;
+    }
+
+    __attribute__((target("pclmul,sse2")))
+    inline uint32_t ClmulBarrett(const ClmulConstants& c, uint64_t block)
+    {
+        // Low 32 bits of q, only these matter for the remainder.
+        // In reflected order bits 64..95 of the product are bits 31..62.
+        __m128i t1 = _mm_clmulepi64_si128(_mm_cvtsi64_si128(static_cast<long long>(block)),
+                                          _mm_cvtsi64_si128(static_cast<long long>(c.mu)), 0x00);
+        uint32_t q = static_cast<uint32_t>(block >> 32)
+            ^ static_cast<uint32_t>(static_cast<uint64_t>(_mm_cvtsi128_si64(t1)) >> 31);
+
+        __m128i t2 = _mm_clmulepi64_si128(_mm_cvtsi32_si128(static_cast<int>(q)),
+                                          _mm_cvtsi64_si128(static_cast<long long>(c.poly)), 0x00);
+        return static_cast<uint32_t>(static_cast<uint64_t>(_mm_cvtsi128_si64(t2)) >> 31);
+    }
+
+    __attribute__((target("pclmul,sse2")))
+    uint8_t CRCClmul(const ClmulConstants& c, tables_t t, uint8_t crc, const uint8_t* p, const uint8_t* end)
+    {
+        if (end - p < clmulMinimumSize) {
+            return CRCSlice(t, crc, p, end);
+        }
+
+        uint32_t reg = crc;
+        if (end - p >= 16) {
+            const __m128i fold = _mm_set_epi64x(static_cast<long long>(c.x95), static_cast<long long>(c.x159));
+            __m128i a = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), _mm_cvtsi32_si128(static_cast<int>(reg)));
+            p += 16;
+            while (end - p >= 16) {
+                a = _mm_xor_si128(_mm_clmulepi64_si128(a, fold, 0x00), _mm_clmulepi64_si128(a, fold, 0x11));
+                a = _mm_xor_si128(a, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+                p += 16;
+            }
+
+            // A = A_hi * x^64 + A_lo, A_hi = H1 * x^32 + H0, which is
+            // congruent to A_lo + H1 * (x^96 mod P32) + H0 * (x^64 mod P32)
+            uint64_t hi = static_cast<uint64_t>(_mm_cvtsi128_si64(a));
+            __m128i h1 = _mm_cvtsi32_si128(static_cast<int>(static_cast<uint32_t>(hi)));
+            __m128i h0 = _mm_cvtsi32_si128(static_cast<int>(static_cast<uint32_t>(hi >> 32)));
+            __m128i b = _mm_xor_si128(_mm_clmulepi64_si128(h1, _mm_cvtsi64_si128(static_cast<long long>(c.x95)), 0x00),
+                                      _mm_clmulepi64_si128(h0, _mm_cvtsi64_si128(static_cast<long long>(c.x63)), 0x00));
+            b = _mm_xor_si128(b, _mm_unpackhi_epi64(a, a));
+            reg = ClmulBarrett(c, static_cast<uint64_t>(_mm_cvtsi128_si64(b)));
+        }
+        if (end - p >= 8) {
+            uint64_t block;
+            memcpy(&block, p, sizeof(block));
+            reg = ClmulBarrett(c, block ^ reg);
+            p += 8;
+        }
+        crc = static_cast<uint8_t>(reg);
+        while (p != end) {
+            crc = t[0][*p++ ^ crc];
+        }
+        return crc;
+    }
+
+    uint8_t CRC3Clmul(uint8_t crc, const uint8_t* begin, const uint8_t* end) { return CRCClmul(crc3Clmul, crc3Tables, crc, begin, end); }
+    uint8_t CRC7Clmul(uint8_t crc, const uint8_t* begin, const uint8_t* end) { return CRCClmul(crc7Clmul, crc7Tables, crc, begin, end); }
+    uint8_t CRC8Clmul(uint8_t crc, const uint8_t* begin, const uint8_t* end) { return CRCClmul(crc8Clmul, crc8Tables, crc, begin, end); }
+
+#endif
+
+    /**
+     * Selects the kernels for the CPU, the tables are used until then.
+     * The carry-less multiply kernels are checked against the tables by
+     * crc_test, not here.
+     */
+    struct CRCStartup
+    {
+        CRCStartup()
+        {
+#ifdef ROHC_CRC_CLMUL
+            __builtin_cpu_init();
+            if (!__builtin_cpu_supports("pclmul")) {
+                return;
+            }
+
+            crc3Clmul = CreateClmulConstants(3, 6);
+            crc7Clmul = CreateClmulConstants(7, 121);
+            crc8Clmul = CreateClmulConstants(8, 224);
+
+            crc3Kernel = CRC3Clmul;
+            crc7Kernel = CRC7Clmul;
+            crc8Kernel = CRC8Clmul;
+#endif
+        }
+    } crcStartup;
+} // anon ns
+
+namespace ROHC
+{
+    void
+    CRCInit()
+    {
+    }
+
+    CRCKernels
+    GetCRCKernels(unsigned int width)
+    {
+        CRCKernels kernels;
+        kernels.slice = (3 == width) ? CRC3Slice : (7 == width) ? CRC7Slice : CRC8Slice;
+        kernels.clmul = 0;
+        kernels.clmulMinimumSize = 0;
+#ifdef ROHC_CRC_CLMUL
+        if (__builtin_cpu_supports("pclmul")) {
+            kernels.clmul = (3 == width) ? CRC3Clmul : (7 == width) ? CRC7Clmul : CRC8Clmul;
+            kernels.clmulMinimumSize = static_cast<size_t>(clmulMinimumSize);
+        }
+#endif
+        return kernels;
+    }
+
+    uint8_t
+    CRC3(const uint8_t* begin, const uint8_t* end)
+    {
+        return crc3Kernel(0x7, begin, end);
+    }
+
+    uint8_t
+    CRC3(uint8_t crc, const uint8_t* begin, const uint8_t* end)
+    {
+        return crc3Kernel(crc, begin, end);
+    }
+
+    uint8_t
+    CRC3(const_data_iterator begin, const_data_iterator end)
+    {
+        if (begin == end) {
+            return 0x7;
+        }
+        return CRC3(&*begin, &*begin + (end - begin));
+    }
+
+    uint8_t
+    CRC3Shift(uint8_t crc, size_t size)
+    {
+        return CRCShift(crc3Tables, crc, size);
+    }
+
+    uint8_t
+    CRC7(const uint8_t* begin, const uint8_t* end)
+    {
+        return crc7Kernel(0x7f, begin, end);
+    }
+
+    uint8_t
+    CRC7(uint8_t crc, const uint8_t* begin, const uint8_t* end)
+    {
+        return crc7Kernel(crc, begin, end);
+    }
+
+    uint8_t
+    CRC7(const_data_iterator begin, const_data_iterator end)
+    {
+        if (begin == end) {
+            return 0x7f;
+        }
+        return CRC7(&*begin, &*begin + (end - begin));
+    }
+
+    uint8_t
+    CRC7Shift(uint8_t crc, size_t size)
+    {
+        return CRCShift(crc7Tables, crc, size);
+    }
+
+    uint8_t
+    CRC8(const uint8_t* begin, const uint8_t* end)
+    {
+        return crc8Kernel(0xff, begin, end);
+    }
+
+    uint8_t
+    CRC8(uint8_t crc, const uint8_t* begin, const uint8_t* end)
+    {
+        return crc8Kernel(crc, begin, end);
+    }
+
+    uint8_t
+    CRC8(const_data_iterator begin, const_data_iterator end)
+    {
+        if (begin == end) {
+            return 0xff;
+        }
+        return CRC8(&*begin, &*begin + (end - begin));
+    }
+
+    uint32_t
+    CRC32(const uint8_t* begin, const uint8_t* end)
+    {
+        // Only for reconstructed units, a byte at a time is enough
+        uint32_t crc = 0xffffffff;
+        while (begin != end) {
+            crc = (crc >> 8) ^ crc32Table[(crc ^ *begin++) & 0xff];
+        }
+        return ~crc;
+    }
+
+} // ns ROHC
@@ -0,0 +1,513 @@
+#pragma once
+
+/**
+ * Generated, do not edit.
+ *
+ * Tables for the reflected ROHC CRCs (RFC 4995, 5.3.1), slice k gives the
+ * CRC register after feeding byte x followed by k zero bytes, starting from
+ * a zero register:
+ *
+ * def table(poly):
+ *     t = []
+ *     for i in range(256):
+ *         c = i
+ *         for _ in range(8):
+ *             c = (c >> 1) ^ poly if c & 1 else c >> 1
+ *         t.append(c)
+ *     return t
+ *
+ * t[0] = table(poly)
+ * t[k][x] = t[0][t[k-1][x]]
+ *
+ * poly is 6 for CRC-3, 121 for CRC-7 and 224 for CRC-8.
+ *
+ * crc32Table is table(0xedb88320), the reflected FCS-32 of RFC 1662 used
+ * for the reconstructed units of segments (RFC 4995, 5.2.5).
+ */
+
+    static const uint8_t crc3Tables[8][256] = {
+        {
+            0, 6, 1, 7, 2, 4, 3, 5, 4, 2, 5, 3, 6, 0, 7, 1,
+            5, 3, 4, 2, 7, 1, 6, 0, 1, 7, 0, 6, 3, 5, 2, 4,
+            7, 1, 6, 0, 5, 3, 4, 2, 3, 5, 2, 4, 1, 7, 0, 6,
+            2, 4, 3, 5, 0, 6, 1, 7, 6, 0, 7, 1, 4, 2, 5, 3,
+            3, 5, 2, 4, 1, 7, 0, 6, 7, 1, 6, 0, 5, 3, 4, 2,
+            6, 0, 7, 1, 4, 2, 5, 3, 2, 4, 3, 5, 0, 6, 1, 7,
+            4, 2, 5, 3, 6, 0, 7, 1, 0, 6, 1, 7, 2, 4, 3, 5,
+            1, 7, 0, 6, 3, 5, 2, 4, 5, 3, 4, 2, 7, 1, 6, 0,
+            6, 0, 7, 1, 4, 2, 5, 3, 2, 4, 3, 5, 0, 6, 1, 7,
+            3, 5, 2, 4, 1, 7, 0, 6, 7, 1, 6, 0, 5, 3, 4, 2,
+            1, 7, 0, 6, 3, 5, 2, 4, 5, 3, 4, 2, 7, 1, 6, 0,
+            4, 2, 5, 3, 6, 0, 7, 1, 0, 6, 1, 7, 2, 4, 3, 5,
+            5, 3, 4, 2, 7, 1, 6, 0, 1, 7, 0, 6, 3, 5, 2, 4,
+            0, 6, 1, 7, 2, 4, 3, 5, 4, 2, 5, 3, 6, 0, 7, 1,
+            2, 4, 3, 5, 0, 6, 1, 7, 6, 0, 7, 1, 4, 2, 5, 3,
+            7, 1, 6, 0, 5, 3, 4, 2, 3, 5, 2, 4, 1, 7, 0, 6,
+        },
+        {
+            0, 3, 6, 5, 1, 2, 7, 4, 2, 1, 4, 7, 3, 0, 5, 6,
+            4, 7, 2, 1, 5, 6, 3, 0, 6, 5, 0, 3, 7, 4, 1, 2,
+            5, 6, 3, 0, 4, 7, 2, 1, 7, 4, 1, 2, 6, 5, 0, 3,
+            1, 2, 7, 4, 0, 3, 6, 5, 3, 0, 5, 6, 2, 1, 4, 7,
+            7, 4, 1, 2, 6, 5, 0, 3, 5, 6, 3, 0, 4, 7, 2, 1,
+            3, 0, 5, 6, 2, 1, 4, 7, 1, 2, 7, 4, 0, 3, 6, 5,
+            2, 1, 4, 7, 3, 0, 5, 6, 0, 3, 6, 5, 1, 2, 7, 4,
+            6, 5, 0, 3, 7, 4, 1, 2, 4, 7, 2, 1, 5, 6, 3, 0,
+            3, 0, 5, 6, 2, 1, 4, 7, 1, 2, 7, 4, 0, 3, 6, 5,
+            7, 4, 1, 2, 6, 5, 0, 3, 5, 6, 3, 0, 4, 7, 2, 1,
+            6, 5, 0, 3, 7, 4, 1, 2, 4, 7, 2, 1, 5, 6, 3, 0,
+            2, 1, 4, 7, 3, 0, 5, 6, 0, 3, 6, 5, 1, 2, 7, 4,
+            4, 7, 2, 1, 5, 6, 3, 0, 6, 5, 0, 3, 7, 4, 1, 2,
+            0, 3, 6, 5, 1, 2, 7, 4, 2, 1, 4, 7, 3, 0, 5, 6,
+            1, 2, 7, 4, 0, 3, 6, 5, 3, 0, 5, 6, 2, 1, 4, 7,
+            5, 6, 3, 0, 4, 7, 2, 1, 7, 4, 1, 2, 6, 5, 0, 3,
+        },
+        {
+            0, 7, 3, 4, 6, 1, 5, 2, 1, 6, 2, 5, 7, 0, 4, 3,
+            2, 5, 1, 6, 4, 3, 7, 0, 3, 4, 0, 7, 5, 2, 6, 1,
+            4, 3, 7, 0, 2, 5, 1, 6, 5, 2, 6, 1, 3, 4, 0, 7,
+            6, 1, 5, 2, 0, 7, 3, 4, 7, 0, 4, 3, 1, 6, 2, 5,
+            5, 2, 6, 1, 3, 4, 0, 7, 4, 3, 7, 0, 2, 5, 1, 6,
+            7, 0, 4, 3, 1, 6, 2, 5, 6, 1, 5, 2, 0, 7, 3, 4,
+            1, 6, 2, 5, 7, 0, 4, 3, 0, 7, 3, 4, 6, 1, 5, 2,
+            3, 4, 0, 7, 5, 2, 6, 1, 2, 5, 1, 6, 4, 3, 7, 0,
+            7, 0, 4, 3, 1, 6, 2, 5, 6, 1, 5, 2, 0, 7, 3, 4,
+            5, 2, 6, 1, 3, 4, 0, 7, 4, 3, 7, 0, 2, 5, 1, 6,
+            3, 4, 0, 7, 5, 2, 6, 1, 2, 5, 1, 6, 4, 3, 7, 0,
+            1, 6, 2, 5, 7, 0, 4, 3, 0, 7, 3, 4, 6, 1, 5, 2,
+            2, 5, 1, 6, 4, 3, 7, 0, 3, 4, 0, 7, 5, 2, 6, 1,
+            0, 7, 3, 4, 6, 1, 5, 2, 1, 6, 2, 5, 7, 0, 4, 3,
+            6, 1, 5, 2, 0, 7, 3, 4, 7, 0, 4, 3, 1, 6, 2, 5,
+            4, 3, 7, 0, 2, 5, 1, 6, 5, 2, 6, 1, 3, 4, 0, 7,
+        },
+        {
+            0, 5, 7, 2, 3, 6, 4, 1, 6, 3, 1, 4, 5, 0, 2, 7,
+            1, 4, 6, 3, 2, 7, 5, 0, 7, 2, 0, 5, 4, 1, 3, 6,
+            2, 7, 5, 0, 1, 4, 6, 3, 4, 1, 3, 6, 7, 2, 0, 5,
+            3, 6, 4, 1, 0, 5, 7, 2, 5, 0, 2, 7, 6, 3, 1, 4,
+            4, 1, 3, 6, 7, 2, 0, 5, 2, 7, 5, 0, 1, 4, 6, 3,
+            5, 0, 2, 7, 6, 3, 1, 4, 3, 6, 4, 1, 0, 5, 7, 2,
+            6, 3, 1, 4, 5, 0, 2, 7, 0, 5, 7, 2, 3, 6, 4, 1,
+            7, 2, 0, 5, 4, 1, 3, 6, 1, 4, 6, 3, 2, 7, 5, 0,
+            5, 0, 2, 7, 6, 3, 1, 4, 3, 6, 4, 1, 0, 5, 7, 2,
+            4, 1, 3, 6, 7, 2, 0, 5, 2, 7, 5, 0, 1, 4, 6, 3,
+            7, 2, 0, 5, 4, 1, 3, 6, 1, 4, 6, 3, 2, 7, 5, 0,
+            6, 3, 1, 4, 5, 0, 2, 7, 0, 5, 7, 2, 3, 6, 4, 1,
+            1, 4, 6, 3, 2, 7, 5, 0, 7, 2, 0, 5, 4, 1, 3, 6,
+            0, 5, 7, 2, 3, 6, 4, 1, 6, 3, 1, 4, 5, 0, 2, 7,
+            3, 6, 4, 1, 0, 5, 7, 2, 5, 0, 2, 7, 6, 3, 1, 4,
+            2, 7, 5, 0, 1, 4, 6, 3, 4, 1, 3, 6, 7, 2, 0, 5,
+        },
+        {
+            0, 4, 5, 1, 7, 3, 2, 6, 3, 7, 6, 2, 4, 0, 1, 5,
+            6, 2, 3, 7, 1, 5, 4, 0, 5, 1, 0, 4, 2, 6, 7, 3,
+            1, 5, 4, 0, 6, 2, 3, 7, 2, 6, 7, 3, 5, 1, 0, 4,
+            7, 3, 2, 6, 0, 4, 5, 1, 4, 0, 1, 5, 3, 7, 6, 2,
+            2, 6, 7, 3, 5, 1, 0, 4, 1, 5, 4, 0, 6, 2, 3, 7,
+            4, 0, 1, 5, 3, 7, 6, 2, 7, 3, 2, 6, 0, 4, 5, 1,
+            3, 7, 6, 2, 4, 0, 1, 5, 0, 4, 5, 1, 7, 3, 2, 6,
+            5, 1, 0, 4, 2, 6, 7, 3, 6, 2, 3, 7, 1, 5, 4, 0,
+            4, 0, 1, 5, 3, 7, 6, 2, 7, 3, 2, 6, 0, 4, 5, 1,
+            2, 6, 7, 3, 5, 1, 0, 4, 1, 5, 4, 0, 6, 2, 3, 7,
+            5, 1, 0, 4, 2, 6, 7, 3, 6, 2, 3, 7, 1, 5, 4, 0,
+            3, 7, 6, 2, 4, 0, 1, 5, 0, 4, 5, 1, 7, 3, 2, 6,
+            6, 2, 3, 7, 1, 5, 4, 0, 5, 1, 0, 4, 2, 6, 7, 3,
+            0, 4, 5, 1, 7, 3, 2, 6, 3, 7, 6, 2, 4, 0, 1, 5,
+            7, 3, 2, 6, 0, 4, 5, 1, 4, 0, 1, 5, 3, 7, 6, 2,
+            1, 5, 4, 0, 6, 2, 3, 7, 2, 6, 7, 3, 5, 1, 0, 4,
+        },
+        {
+            0, 2, 4, 6, 5, 7, 1, 3, 7, 5, 3, 1, 2, 0, 6, 4,
+            3, 1, 7, 5, 6, 4, 2, 0, 4, 6, 0, 2, 1, 3, 5, 7,
+            6, 4, 2, 0, 3, 1, 7, 5, 1, 3, 5, 7, 4, 6, 0, 2,
+            5, 7, 1, 3, 0, 2, 4, 6, 2, 0, 6, 4, 7, 5, 3, 1,
+            1, 3, 5, 7, 4, 6, 0, 2, 6, 4, 2, 0, 3, 1, 7, 5,
+            2, 0, 6, 4, 7, 5, 3, 1, 5, 7, 1, 3, 0, 2, 4, 6,
+            7, 5, 3, 1, 2, 0, 6, 4, 0, 2, 4, 6, 5, 7, 1, 3,
+            4, 6, 0, 2, 1, 3, 5, 7, 3, 1, 7, 5, 6, 4, 2, 0,
+            2, 0, 6, 4, 7, 5, 3, 1, 5, 7, 1, 3, 0, 2, 4, 6,
+            1, 3, 5, 7, 4, 6, 0, 2, 6, 4, 2, 0, 3, 1, 7, 5,
+            4, 6, 0, 2, 1, 3, 5, 7, 3, 1, 7, 5, 6, 4, 2, 0,
+            7, 5, 3, 1, 2, 0, 6, 4, 0, 2, 4, 6, 5, 7, 1, 3,
+            3, 1, 7, 5, 6, 4, 2, 0, 4, 6, 0, 2, 1, 3, 5, 7,
+            0, 2, 4, 6, 5, 7, 1, 3, 7, 5, 3, 1, 2, 0, 6, 4,
+            5, 7, 1, 3, 0, 2, 4, 6, 2, 0, 6, 4, 7, 5, 3, 1,
+            6, 4, 2, 0, 3, 1, 7, 5, 1, 3, 5, 7, 4, 6, 0, 2,
+        },
+        {
+            0, 1, 2, 3, 4, 5, 6, 7, 5, 4, 7, 6, 1, 0, 3, 2,
+            7, 6, 5, 4, 3, 2, 1, 0, 2, 3, 0, 1, 6, 7, 4, 5,
+            3, 2, 1, 0, 7, 6, 5, 4, 6, 7, 4, 5, 2, 3, 0, 1,
+            4, 5, 6, 7, 0, 1, 2, 3, 1, 0, 3, 2, 5, 4, 7, 6,
+            6, 7, 4, 5, 2, 3, 0, 1, 3, 2, 1, 0, 7, 6, 5, 4,
+            1, 0, 3, 2, 5, 4, 7, 6, 4, 5, 6, 7, 0, 1, 2, 3,
+            5, 4, 7, 6, 1, 0, 3, 2, 0, 1, 2, 3, 4, 5, 6, 7,
+            2, 3, 0, 1, 6, 7, 4, 5, 7, 6, 5, 4, 3, 2, 1, 0,
+            1, 0, 3, 2, 5, 4, 7, 6, 4, 5, 6, 7, 0, 1, 2, 3,
+            6, 7, 4, 5, 2, 3, 0, 1, 3, 2, 1, 0, 7, 6, 5, 4,
+            2, 3, 0, 1, 6, 7, 4, 5, 7, 6, 5, 4, 3, 2, 1, 0,
+            5, 4, 7, 6, 1, 0, 3, 2, 0, 1, 2, 3, 4, 5, 6, 7,
+            7, 6, 5, 4, 3, 2, 1, 0, 2, 3, 0, 1, 6, 7, 4, 5,
+            0, 1, 2, 3, 4, 5, 6, 7, 5, 4, 7, 6, 1, 0, 3, 2,
+            4, 5, 6, 7, 0, 1, 2, 3, 1, 0, 3, 2, 5, 4, 7, 6,
+            3, 2, 1, 0, 7, 6, 5, 4, 6, 7, 4, 5, 2, 3, 0, 1,
+        },
+        {
+            0, 6, 1, 7, 2, 4, 3, 5, 4, 2, 5, 3, 6, 0, 7, 1,
+            5, 3, 4, 2, 7, 1, 6, 0, 1, 7, 0, 6, 3, 5, 2, 4,
+            7, 1, 6, 0, 5, 3, 4, 2, 3, 5, 2, 4, 1, 7, 0, 6,
+            2, 4, 3, 5, 0, 6, 1, 7, 6, 0, 7, 1, 4, 2, 5, 3,
+            3, 5, 2, 4, 1, 7, 0, 6, 7, 1, 6, 0, 5, 3, 4, 2,
+            6, 0, 7, 1, 4, 2, 5, 3, 2, 4, 3, 5, 0, 6, 1, 7,
+            4, 2, 5, 3, 6, 0, 7, 1, 0, 6, 1, 7, 2, 4, 3, 5,
+            1, 7, 0, 6, 3, 5, 2, 4, 5, 3, 4, 2, 7, 1, 6, 0,
+            6, 0, 7, 1, 4, 2, 5, 3, 2, 4, 3, 5, 0, 6, 1, 7,
+            3, 5, 2, 4, 1, 7, 0, 6, 7, 1, 6, 0, 5, 3, 4, 2,
+            1, 7, 0, 6, 3, 5, 2, 4, 5, 3, 4, 2, 7, 1, 6, 0,
+            4, 2, 5, 3, 6, 0, 7, 1, 0, 6, 1, 7, 2, 4, 3, 5,
+            5, 3, 4, 2, 7, 1, 6, 0, 1, 7, 0, 6, 3, 5, 2, 4,
+            0, 6, 1, 7, 2, 4, 3, 5, 4, 2, 5, 3, 6, 0, 7, 1,
+            2, 4, 3, 5, 0, 6, 1, 7, 6, 0, 7, 1, 4, 2, 5, 3,
+            7, 1, 6, 0, 5, 3, 4, 2, 3, 5, 2, 4, 1, 7, 0, 6,
+        },
+    };
+
+    static const uint8_t crc7Tables[8][256] = {
+        {
+            0, 64, 115, 51, 21, 85, 102, 38, 42, 106, 89, 25, 63, 127, 76, 12,
+            84, 20, 39, 103, 65, 1, 50, 114, 126, 62, 13, 77, 107, 43, 24, 88,
+            91, 27, 40, 104, 78, 14, 61, 125, 113, 49, 2, 66, 100, 36, 23, 87,
+            15, 79, 124, 60, 26, 90, 105, 41, 37, 101, 86, 22, 48, 112, 67, 3,
+            69, 5, 54, 118, 80, 16, 35, 99, 111, 47, 28, 92, 122, 58, 9, 73,
+            17, 81, 98, 34, 4, 68, 119, 55, 59, 123, 72, 8, 46, 110, 93, 29,
+            30, 94, 109, 45, 11, 75, 120, 56, 52, 116, 71, 7, 33, 97, 82, 18,
+            74, 10, 57, 121, 95, 31, 44, 108, 96, 32, 19, 83, 117, 53, 6, 70,
+            121, 57, 10, 74, 108, 44, 31, 95, 83, 19, 32, 96, 70, 6, 53, 117,
+            45, 109, 94, 30, 56, 120, 75, 11, 7, 71, 116, 52, 18, 82, 97, 33,
+            34, 98, 81, 17, 55, 119, 68, 4, 8, 72, 123, 59, 29, 93, 110, 46,
+            118, 54, 5, 69, 99, 35, 16, 80, 92, 28, 47, 111, 73, 9, 58, 122,
+            60, 124, 79, 15, 41, 105, 90, 26, 22, 86, 101, 37, 3, 67, 112, 48,
+            104, 40, 27, 91, 125, 61, 14, 78, 66, 2, 49, 113, 87, 23, 36, 100,
+            103, 39, 20, 84, 114, 50, 1, 65, 77, 13, 62, 126, 88, 24, 43, 107,
+            51, 115, 64, 0, 38, 102, 85, 21, 25, 89, 106, 42, 12, 76, 127, 63,
+        },
+        {
+            0, 69, 121, 60, 1, 68, 120, 61, 2, 71, 123, 62, 3, 70, 122, 63,
+            4, 65, 125, 56, 5, 64, 124, 57, 6, 67, 127, 58, 7, 66, 126, 59,
+            8, 77, 113, 52, 9, 76, 112, 53, 10, 79, 115, 54, 11, 78, 114, 55,
+            12, 73, 117, 48, 13, 72, 116, 49, 14, 75, 119, 50, 15, 74, 118, 51,
+            16, 85, 105, 44, 17, 84, 104, 45, 18, 87, 107, 46, 19, 86, 106, 47,
+            20, 81, 109, 40, 21, 80, 108, 41, 22, 83, 111, 42, 23, 82, 110, 43,
+            24, 93, 97, 36, 25, 92, 96, 37, 26, 95, 99, 38, 27, 94, 98, 39,
+            28, 89, 101, 32, 29, 88, 100, 33, 30, 91, 103, 34, 31, 90, 102, 35,
+            32, 101, 89, 28, 33, 100, 88, 29, 34, 103, 91, 30, 35, 102, 90, 31,
+            36, 97, 93, 24, 37, 96, 92, 25, 38, 99, 95, 26, 39, 98, 94, 27,
+            40, 109, 81, 20, 41, 108, 80, 21, 42, 111, 83, 22, 43, 110, 82, 23,
+            44, 105, 85, 16, 45, 104, 84, 17, 46, 107, 87, 18, 47, 106, 86, 19,
+            48, 117, 73, 12, 49, 116, 72, 13, 50, 119, 75, 14, 51, 118, 74, 15,
+            52, 113, 77, 8, 53, 112, 76, 9, 54, 115, 79, 10, 55, 114, 78, 11,
+            56, 125, 65, 4, 57, 124, 64, 5, 58, 127, 67, 6, 59, 126, 66, 7,
+            60, 121, 69, 0, 61, 120, 68, 1, 62, 123, 71, 2, 63, 122, 70, 3,
+        },
+        {
+            0, 16, 32, 48, 64, 80, 96, 112, 115, 99, 83, 67, 51, 35, 19, 3,
+            21, 5, 53, 37, 85, 69, 117, 101, 102, 118, 70, 86, 38, 54, 6, 22,
+            42, 58, 10, 26, 106, 122, 74, 90, 89, 73, 121, 105, 25, 9, 57, 41,
+            63, 47, 31, 15, 127, 111, 95, 79, 76, 92, 108, 124, 12, 28, 44, 60,
+            84, 68, 116, 100, 20, 4, 52, 36, 39, 55, 7, 23, 103, 119, 71, 87,
+            65, 81, 97, 113, 1, 17, 33, 49, 50, 34, 18, 2, 114, 98, 82, 66,
+            126, 110, 94, 78, 62, 46, 30, 14, 13, 29, 45, 61, 77, 93, 109, 125,
+            107, 123, 75, 91, 43, 59, 11, 27, 24, 8, 56, 40, 88, 72, 120, 104,
+            91, 75, 123, 107, 27, 11, 59, 43, 40, 56, 8, 24, 104, 120, 72, 88,
+            78, 94, 110, 126, 14, 30, 46, 62, 61, 45, 29, 13, 125, 109, 93, 77,
+            113, 97, 81, 65, 49, 33, 17, 1, 2, 18, 34, 50, 66, 82, 98, 114,
+            100, 116, 68, 84, 36, 52, 4, 20, 23, 7, 55, 39, 87, 71, 119, 103,
+            15, 31, 47, 63, 79, 95, 111, 127, 124, 108, 92, 76, 60, 44, 28, 12,
+            26, 10, 58, 42, 90, 74, 122, 106, 105, 121, 73, 89, 41, 57, 9, 25,
+            37, 53, 5, 21, 101, 117, 69, 85, 86, 70, 118, 102, 22, 6, 54, 38,
+            48, 32, 16, 0, 112, 96, 80, 64, 67, 83, 99, 115, 3, 19, 35, 51,
+        },
+        {
+            0, 84, 91, 15, 69, 17, 30, 74, 121, 45, 34, 118, 60, 104, 103, 51,
+            1, 85, 90, 14, 68, 16, 31, 75, 120, 44, 35, 119, 61, 105, 102, 50,
+            2, 86, 89, 13, 71, 19, 28, 72, 123, 47, 32, 116, 62, 106, 101, 49,
+            3, 87, 88, 12, 70, 18, 29, 73, 122, 46, 33, 117, 63, 107, 100, 48,
+            4, 80, 95, 11, 65, 21, 26, 78, 125, 41, 38, 114, 56, 108, 99, 55,
+            5, 81, 94, 10, 64, 20, 27, 79, 124, 40, 39, 115, 57, 109, 98, 54,
+            6, 82, 93, 9, 67, 23, 24, 76, 127, 43, 36, 112, 58, 110, 97, 53,
+            7, 83, 92, 8, 66, 22, 25, 77, 126, 42, 37, 113, 59, 111, 96, 52,
+            8, 92, 83, 7, 77, 25, 22, 66, 113, 37, 42, 126, 52, 96, 111, 59,
+            9, 93, 82, 6, 76, 24, 23, 67, 112, 36, 43, 127, 53, 97, 110, 58,
+            10, 94, 81, 5, 79, 27, 20, 64, 115, 39, 40, 124, 54, 98, 109, 57,
+            11, 95, 80, 4, 78, 26, 21, 65, 114, 38, 41, 125, 55, 99, 108, 56,
+            12, 88, 87, 3, 73, 29, 18, 70, 117, 33, 46, 122, 48, 100, 107, 63,
+            13, 89, 86, 2, 72, 28, 19, 71, 116, 32, 47, 123, 49, 101, 106, 62,
+            14, 90, 85, 1, 75, 31, 16, 68, 119, 35, 44, 120, 50, 102, 105, 61,
+            15, 91, 84, 0, 74, 30, 17, 69, 118, 34, 45, 121, 51, 103, 104, 60,
+        },
+        {
+            0, 4, 8, 12, 16, 20, 24, 28, 32, 36, 40, 44, 48, 52, 56, 60,
+            64, 68, 72, 76, 80, 84, 88, 92, 96, 100, 104, 108, 112, 116, 120, 124,
+            115, 119, 123, 127, 99, 103, 107, 111, 83, 87, 91, 95, 67, 71, 75, 79,
+            51, 55, 59, 63, 35, 39, 43, 47, 19, 23, 27, 31, 3, 7, 11, 15,
+            21, 17, 29, 25, 5, 1, 13, 9, 53, 49, 61, 57, 37, 33, 45, 41,
+            85, 81, 93, 89, 69, 65, 77, 73, 117, 113, 125, 121, 101, 97, 109, 105,
+            102, 98, 110, 106, 118, 114, 126, 122, 70, 66, 78, 74, 86, 82, 94, 90,
+            38, 34, 46, 42, 54, 50, 62, 58, 6, 2, 14, 10, 22, 18, 30, 26,
+            42, 46, 34, 38, 58, 62, 50, 54, 10, 14, 2, 6, 26, 30, 18, 22,
+            106, 110, 98, 102, 122, 126, 114, 118, 74, 78, 66, 70, 90, 94, 82, 86,
+            89, 93, 81, 85, 73, 77, 65, 69, 121, 125, 113, 117, 105, 109, 97, 101,
+            25, 29, 17, 21, 9, 13, 1, 5, 57, 61, 49, 53, 41, 45, 33, 37,
+            63, 59, 55, 51, 47, 43, 39, 35, 31, 27, 23, 19, 15, 11, 7, 3,
+            127, 123, 119, 115, 111, 107, 103, 99, 95, 91, 87, 83, 79, 75, 71, 67,
+            76, 72, 68, 64, 92, 88, 84, 80, 108, 104, 100, 96, 124, 120, 116, 112,
+            12, 8, 4, 0, 28, 24, 20, 16, 44, 40, 36, 32, 60, 56, 52, 48,
+        },
+        {
+            0, 21, 42, 63, 84, 65, 126, 107, 91, 78, 113, 100, 15, 26, 37, 48,
+            69, 80, 111, 122, 17, 4, 59, 46, 30, 11, 52, 33, 74, 95, 96, 117,
+            121, 108, 83, 70, 45, 56, 7, 18, 34, 55, 8, 29, 118, 99, 92, 73,
+            60, 41, 22, 3, 104, 125, 66, 87, 103, 114, 77, 88, 51, 38, 25, 12,
+            1, 20, 43, 62, 85, 64, 127, 106, 90, 79, 112, 101, 14, 27, 36, 49,
+            68, 81, 110, 123, 16, 5, 58, 47, 31, 10, 53, 32, 75, 94, 97, 116,
+            120, 109, 82, 71, 44, 57, 6, 19, 35, 54, 9, 28, 119, 98, 93, 72,
+            61, 40, 23, 2, 105, 124, 67, 86, 102, 115, 76, 89, 50, 39, 24, 13,
+            2, 23, 40, 61, 86, 67, 124, 105, 89, 76, 115, 102, 13, 24, 39, 50,
+            71, 82, 109, 120, 19, 6, 57, 44, 28, 9, 54, 35, 72, 93, 98, 119,
+            123, 110, 81, 68, 47, 58, 5, 16, 32, 53, 10, 31, 116, 97, 94, 75,
+            62, 43, 20, 1, 106, 127, 64, 85, 101, 112, 79, 90, 49, 36, 27, 14,
+            3, 22, 41, 60, 87, 66, 125, 104, 88, 77, 114, 103, 12, 25, 38, 51,
+            70, 83, 108, 121, 18, 7, 56, 45, 29, 8, 55, 34, 73, 92, 99, 118,
+            122, 111, 80, 69, 46, 59, 4, 17, 33, 52, 11, 30, 117, 96, 95, 74,
+            63, 42, 21, 0, 107, 126, 65, 84, 100, 113, 78, 91, 48, 37, 26, 15,
+        },
+        {
+            0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+            16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+            32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47,
+            48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63,
+            64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79,
+            80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95,
+            96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111,
+            112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127,
+            115, 114, 113, 112, 119, 118, 117, 116, 123, 122, 121, 120, 127, 126, 125, 124,
+            99, 98, 97, 96, 103, 102, 101, 100, 107, 106, 105, 104, 111, 110, 109, 108,
+            83, 82, 81, 80, 87, 86, 85, 84, 91, 90, 89, 88, 95, 94, 93, 92,
+            67, 66, 65, 64, 71, 70, 69, 68, 75, 74, 73, 72, 79, 78, 77, 76,
+            51, 50, 49, 48, 55, 54, 53, 52, 59, 58, 57, 56, 63, 62, 61, 60,
+            35, 34, 33, 32, 39, 38, 37, 36, 43, 42, 41, 40, 47, 46, 45, 44,
+            19, 18, 17, 16, 23, 22, 21, 20, 27, 26, 25, 24, 31, 30, 29, 28,
+            3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+        },
+        {
+            0, 64, 115, 51, 21, 85, 102, 38, 42, 106, 89, 25, 63, 127, 76, 12,
+            84, 20, 39, 103, 65, 1, 50, 114, 126, 62, 13, 77, 107, 43, 24, 88,
+            91, 27, 40, 104, 78, 14, 61, 125, 113, 49, 2, 66, 100, 36, 23, 87,
+            15, 79, 124, 60, 26, 90, 105, 41, 37, 101, 86, 22, 48, 112, 67, 3,
+            69, 5, 54, 118, 80, 16, 35, 99, 111, 47, 28, 92, 122, 58, 9, 73,
+            17, 81, 98, 34, 4, 68, 119, 55, 59, 123, 72, 8, 46, 110, 93, 29,
+            30, 94, 109, 45, 11, 75, 120, 56, 52, 116, 71, 7, 33, 97, 82, 18,
+            74, 10, 57, 121, 95, 31, 44, 108, 96, 32, 19, 83, 117, 53, 6, 70,
+            121, 57, 10, 74, 108, 44, 31, 95, 83, 19, 32, 96, 70, 6, 53, 117,
+            45, 109, 94, 30, 56, 120, 75, 11, 7, 71, 116, 52, 18, 82, 97, 33,
+            34, 98, 81, 17, 55, 119, 68, 4, 8, 72, 123, 59, 29, 93, 110, 46,
+            118, 54, 5, 69, 99, 35, 16, 80, 92, 28, 47, 111, 73, 9, 58, 122,
+            60, 124, 79, 15, 41, 105, 90, 26, 22, 86, 101, 37, 3, 67, 112, 48,
+            104, 40, 27, 91, 125, 61, 14, 78, 66, 2, 49, 113, 87, 23, 36, 100,
+            103, 39, 20, 84, 114, 50, 1, 65, 77, 13, 62, 126, 88, 24, 43, 107,
+            51, 115, 64, 0, 38, 102, 85, 21, 25, 89, 106, 42, 12, 76, 127, 63,
+        },
+    };
+
+    static const uint8_t crc8Tables[8][256] = {
+        {
+            0, 145, 227, 114, 7, 150, 228, 117, 14, 159, 237, 124, 9, 152, 234, 123,
+            28, 141, 255, 110, 27, 138, 248, 105, 18, 131, 241, 96, 21, 132, 246, 103,
+            56, 169, 219, 74, 63, 174, 220, 77, 54, 167, 213, 68, 49, 160, 210, 67,
+            36, 181, 199, 86, 35, 178, 192, 81, 42, 187, 201, 88, 45, 188, 206, 95,
+            112, 225, 147, 2, 119, 230, 148, 5, 126, 239, 157, 12, 121, 232, 154, 11,
+            108, 253, 143, 30, 107, 250, 136, 25, 98, 243, 129, 16, 101, 244, 134, 23,
+            72, 217, 171, 58, 79, 222, 172, 61, 70, 215, 165, 52, 65, 208, 162, 51,
+            84, 197, 183, 38, 83, 194, 176, 33, 90, 203, 185, 40, 93, 204, 190, 47,
+            224, 113, 3, 146, 231, 118, 4, 149, 238, 127, 13, 156, 233, 120, 10, 155,
+            252, 109, 31, 142, 251, 106, 24, 137, 242, 99, 17, 128, 245, 100, 22, 135,
+            216, 73, 59, 170, 223, 78, 60, 173, 214, 71, 53, 164, 209, 64, 50, 163,
+            196, 85, 39, 182, 195, 82, 32, 177, 202, 91, 41, 184, 205, 92, 46, 191,
+            144, 1, 115, 226, 151, 6, 116, 229, 158, 15, 125, 236, 153, 8, 122, 235,
+            140, 29, 111, 254, 139, 26, 104, 249, 130, 19, 97, 240, 133, 20, 102, 247,
+            168, 57, 75, 218, 175, 62, 76, 221, 166, 55, 69, 212, 161, 48, 66, 211,
+            180, 37, 87, 198, 179, 34, 80, 193, 186, 43, 89, 200, 189, 44, 94, 207,
+        },
+        {
+            0, 109, 218, 183, 117, 24, 175, 194, 234, 135, 48, 93, 159, 242, 69, 40,
+            21, 120, 207, 162, 96, 13, 186, 215, 255, 146, 37, 72, 138, 231, 80, 61,
+            42, 71, 240, 157, 95, 50, 133, 232, 192, 173, 26, 119, 181, 216, 111, 2,
+            63, 82, 229, 136, 74, 39, 144, 253, 213, 184, 15, 98, 160, 205, 122, 23,
+            84, 57, 142, 227, 33, 76, 251, 150, 190, 211, 100, 9, 203, 166, 17, 124,
+            65, 44, 155, 246, 52, 89, 238, 131, 171, 198, 113, 28, 222, 179, 4, 105,
+            126, 19, 164, 201, 11, 102, 209, 188, 148, 249, 78, 35, 225, 140, 59, 86,
+            107, 6, 177, 220, 30, 115, 196, 169, 129, 236, 91, 54, 244, 153, 46, 67,
+            168, 197, 114, 31, 221, 176, 7, 106, 66, 47, 152, 245, 55, 90, 237, 128,
+            189, 208, 103, 10, 200, 165, 18, 127, 87, 58, 141, 224, 34, 79, 248, 149,
+            130, 239, 88, 53, 247, 154, 45, 64, 104, 5, 178, 223, 29, 112, 199, 170,
+            151, 250, 77, 32, 226, 143, 56, 85, 125, 16, 167, 202, 8, 101, 210, 191,
+            252, 145, 38, 75, 137, 228, 83, 62, 22, 123, 204, 161, 99, 14, 185, 212,
+            233, 132, 51, 94, 156, 241, 70, 43, 3, 110, 217, 180, 118, 27, 172, 193,
+            214, 187, 12, 97, 163, 206, 121, 20, 60, 81, 230, 139, 73, 36, 147, 254,
+            195, 174, 25, 116, 182, 219, 108, 1, 41, 68, 243, 158, 92, 49, 134, 235,
+        },
+        {
+            0, 208, 97, 177, 194, 18, 163, 115, 69, 149, 36, 244, 135, 87, 230, 54,
+            138, 90, 235, 59, 72, 152, 41, 249, 207, 31, 174, 126, 13, 221, 108, 188,
+            213, 5, 180, 100, 23, 199, 118, 166, 144, 64, 241, 33, 82, 130, 51, 227,
+            95, 143, 62, 238, 157, 77, 252, 44, 26, 202, 123, 171, 216, 8, 185, 105,
+            107, 187, 10, 218, 169, 121, 200, 24, 46, 254, 79, 159, 236, 60, 141, 93,
+            225, 49, 128, 80, 35, 243, 66, 146, 164, 116, 197, 21, 102, 182, 7, 215,
+            190, 110, 223, 15, 124, 172, 29, 205, 251, 43, 154, 74, 57, 233, 88, 136,
+            52, 228, 85, 133, 246, 38, 151, 71, 113, 161, 16, 192, 179, 99, 210, 2,
+            214, 6, 183, 103, 20, 196, 117, 165, 147, 67, 242, 34, 81, 129, 48, 224,
+            92, 140, 61, 237, 158, 78, 255, 47, 25, 201, 120, 168, 219, 11, 186, 106,
+            3, 211, 98, 178, 193, 17, 160, 112, 70, 150, 39, 247, 132, 84, 229, 53,
+            137, 89, 232, 56, 75, 155, 42, 250, 204, 28, 173, 125, 14, 222, 111, 191,
+            189, 109, 220, 12, 127, 175, 30, 206, 248, 40, 153, 73, 58, 234, 91, 139,
+            55, 231, 86, 134, 245, 37, 148, 68, 114, 162, 19, 195, 176, 96, 209, 1,
+            104, 184, 9, 217, 170, 122, 203, 27, 45, 253, 76, 156, 239, 63, 142, 94,
+            226, 50, 131, 83, 32, 240, 65, 145, 167, 119, 198, 22, 101, 181, 4, 212,
+        },
+        {
+            0, 140, 217, 85, 115, 255, 170, 38, 230, 106, 63, 179, 149, 25, 76, 192,
+            13, 129, 212, 88, 126, 242, 167, 43, 235, 103, 50, 190, 152, 20, 65, 205,
+            26, 150, 195, 79, 105, 229, 176, 60, 252, 112, 37, 169, 143, 3, 86, 218,
+            23, 155, 206, 66, 100, 232, 189, 49, 241, 125, 40, 164, 130, 14, 91, 215,
+            52, 184, 237, 97, 71, 203, 158, 18, 210, 94, 11, 135, 161, 45, 120, 244,
+            57, 181, 224, 108, 74, 198, 147, 31, 223, 83, 6, 138, 172, 32, 117, 249,
+            46, 162, 247, 123, 93, 209, 132, 8, 200, 68, 17, 157, 187, 55, 98, 238,
+            35, 175, 250, 118, 80, 220, 137, 5, 197, 73, 28, 144, 182, 58, 111, 227,
+            104, 228, 177, 61, 27, 151, 194, 78, 142, 2, 87, 219, 253, 113, 36, 168,
+            101, 233, 188, 48, 22, 154, 207, 67, 131, 15, 90, 214, 240, 124, 41, 165,
+            114, 254, 171, 39, 1, 141, 216, 84, 148, 24, 77, 193, 231, 107, 62, 178,
+            127, 243, 166, 42, 12, 128, 213, 89, 153, 21, 64, 204, 234, 102, 51, 191,
+            92, 208, 133, 9, 47, 163, 246, 122, 186, 54, 99, 239, 201, 69, 16, 156,
+            81, 221, 136, 4, 34, 174, 251, 119, 183, 59, 110, 226, 196, 72, 29, 145,
+            70, 202, 159, 19, 53, 185, 236, 96, 160, 44, 121, 245, 211, 95, 10, 134,
+            75, 199, 146, 30, 56, 180, 225, 109, 173, 33, 116, 248, 222, 82, 7, 139,
+        },
+        {
+            0, 233, 19, 250, 38, 207, 53, 220, 76, 165, 95, 182, 106, 131, 121, 144,
+            152, 113, 139, 98, 190, 87, 173, 68, 212, 61, 199, 46, 242, 27, 225, 8,
+            241, 24, 226, 11, 215, 62, 196, 45, 189, 84, 174, 71, 155, 114, 136, 97,
+            105, 128, 122, 147, 79, 166, 92, 181, 37, 204, 54, 223, 3, 234, 16, 249,
+            35, 202, 48, 217, 5, 236, 22, 255, 111, 134, 124, 149, 73, 160, 90, 179,
+            187, 82, 168, 65, 157, 116, 142, 103, 247, 30, 228, 13, 209, 56, 194, 43,
+            210, 59, 193, 40, 244, 29, 231, 14, 158, 119, 141, 100, 184, 81, 171, 66,
+            74, 163, 89, 176, 108, 133, 127, 150, 6, 239, 21, 252, 32, 201, 51, 218,
+            70, 175, 85, 188, 96, 137, 115, 154, 10, 227, 25, 240, 44, 197, 63, 214,
+            222, 55, 205, 36, 248, 17, 235, 2, 146, 123, 129, 104, 180, 93, 167, 78,
+            183, 94, 164, 77, 145, 120, 130, 107, 251, 18, 232, 1, 221, 52, 206, 39,
+            47, 198, 60, 213, 9, 224, 26, 243, 99, 138, 112, 153, 69, 172, 86, 191,
+            101, 140, 118, 159, 67, 170, 80, 185, 41, 192, 58, 211, 15, 230, 28, 245,
+            253, 20, 238, 7, 219, 50, 200, 33, 177, 88, 162, 75, 151, 126, 132, 109,
+            148, 125, 135, 110, 178, 91, 161, 72, 216, 49, 203, 34, 254, 23, 237, 4,
+            12, 229, 31, 246, 42, 195, 57, 208, 64, 169, 83, 186, 102, 143, 117, 156,
+        },
+        {
+            0, 55, 110, 89, 220, 235, 178, 133, 121, 78, 23, 32, 165, 146, 203, 252,
+            242, 197, 156, 171, 46, 25, 64, 119, 139, 188, 229, 210, 87, 96, 57, 14,
+            37, 18, 75, 124, 249, 206, 151, 160, 92, 107, 50, 5, 128, 183, 238, 217,
+            215, 224, 185, 142, 11, 60, 101, 82, 174, 153, 192, 247, 114, 69, 28, 43,
+            74, 125, 36, 19, 150, 161, 248, 207, 51, 4, 93, 106, 239, 216, 129, 182,
+            184, 143, 214, 225, 100, 83, 10, 61, 193, 246, 175, 152, 29, 42, 115, 68,
+            111, 88, 1, 54, 179, 132, 221, 234, 22, 33, 120, 79, 202, 253, 164, 147,
+            157, 170, 243, 196, 65, 118, 47, 24, 228, 211, 138, 189, 56, 15, 86, 97,
+            148, 163, 250, 205, 72, 127, 38, 17, 237, 218, 131, 180, 49, 6, 95, 104,
+            102, 81, 8, 63, 186, 141, 212, 227, 31, 40, 113, 70, 195, 244, 173, 154,
+            177, 134, 223, 232, 109, 90, 3, 52, 200, 255, 166, 145, 20, 35, 122, 77,
+            67, 116, 45, 26, 159, 168, 241, 198, 58, 13, 84, 99, 230, 209, 136, 191,
+            222, 233, 176, 135, 2, 53, 108, 91, 167, 144, 201, 254, 123, 76, 21, 34,
+            44, 27, 66, 117, 240, 199, 158, 169, 85, 98, 59, 12, 137, 190, 231, 208,
+            251, 204, 149, 162, 39, 16, 73, 126, 130, 181, 236, 219, 94, 105, 48, 7,
+            9, 62, 103, 80, 213, 226, 187, 140, 112, 71, 30, 41, 172, 155, 194, 245,
+        },
+        {
+            0, 81, 162, 243, 133, 212, 39, 118, 203, 154, 105, 56, 78, 31, 236, 189,
+            87, 6, 245, 164, 210, 131, 112, 33, 156, 205, 62, 111, 25, 72, 187, 234,
+            174, 255, 12, 93, 43, 122, 137, 216, 101, 52, 199, 150, 224, 177, 66, 19,
+            249, 168, 91, 10, 124, 45, 222, 143, 50, 99, 144, 193, 183, 230, 21, 68,
+            157, 204, 63, 110, 24, 73, 186, 235, 86, 7, 244, 165, 211, 130, 113, 32,
+            202, 155, 104, 57, 79, 30, 237, 188, 1, 80, 163, 242, 132, 213, 38, 119,
+            51, 98, 145, 192, 182, 231, 20, 69, 248, 169, 90, 11, 125, 44, 223, 142,
+            100, 53, 198, 151, 225, 176, 67, 18, 175, 254, 13, 92, 42, 123, 136, 217,
+            251, 170, 89, 8, 126, 47, 220, 141, 48, 97, 146, 195, 181, 228, 23, 70,
+            172, 253, 14, 95, 41, 120, 139, 218, 103, 54, 197, 148, 226, 179, 64, 17,
+            85, 4, 247, 166, 208, 129, 114, 35, 158, 207, 60, 109, 27, 74, 185, 232,
+            2, 83, 160, 241, 135, 214, 37, 116, 201, 152, 107, 58, 76, 29, 238, 191,
+            102, 55, 196, 149, 227, 178, 65, 16, 173, 252, 15, 94, 40, 121, 138, 219,
+            49, 96, 147, 194, 180, 229, 22, 71, 250, 171, 88, 9, 127, 46, 221, 140,
+            200, 153, 106, 59, 77, 28, 239, 190, 3, 82, 161, 240, 134, 215, 36, 117,
+            159, 206, 61, 108, 26, 75, 184, 233, 84, 5, 246, 167, 209, 128, 115, 34,
+        },
+        {
+            0, 253, 59, 198, 118, 139, 77, 176, 236, 17, 215, 42, 154, 103, 161, 92,
+            25, 228, 34, 223, 111, 146, 84, 169, 245, 8, 206, 51, 131, 126, 184, 69,
+            50, 207, 9, 244, 68, 185, 127, 130, 222, 35, 229, 24, 168, 85, 147, 110,
+            43, 214, 16, 237, 93, 160, 102, 155, 199, 58, 252, 1, 177, 76, 138, 119,
+            100, 153, 95, 162, 18, 239, 41, 212, 136, 117, 179, 78, 254, 3, 197, 56,
+            125, 128, 70, 187, 11, 246, 48, 205, 145, 108, 170, 87, 231, 26, 220, 33,
+            86, 171, 109, 144, 32, 221, 27, 230, 186, 71, 129, 124, 204, 49, 247, 10,
+            79, 178, 116, 137, 57, 196, 2, 255, 163, 94, 152, 101, 213, 40, 238, 19,
+            200, 53, 243, 14, 190, 67, 133, 120, 36, 217, 31, 226, 82, 175, 105, 148,
+            209, 44, 234, 23, 167, 90, 156, 97, 61, 192, 6, 251, 75, 182, 112, 141,
+            250, 7, 193, 60, 140, 113, 183, 74, 22, 235, 45, 208, 96, 157, 91, 166,
+            227, 30, 216, 37, 149, 104, 174, 83, 15, 242, 52, 201, 121, 132, 66, 191,
+            172, 81, 151, 106, 218, 39, 225, 28, 64, 189, 123, 134, 54, 203, 13, 240,
+            181, 72, 142, 115, 195, 62, 248, 5, 89, 164, 98, 159, 47, 210, 20, 233,
+            158, 99, 165, 88, 232, 21, 211, 46, 114, 143, 73, 180, 4, 249, 63, 194,
+            135, 122, 188, 65, 241, 12, 202, 55, 107, 150, 80, 173, 29, 224, 38, 219,
+        },
+    };
+
+    static const uint32_t crc32Table[256] = {
+        0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419, 0x706af48f,
+        0xe963a535, 0x9e6495a3, 0x0edb8832, 0x79dcb8a4, 0xe0d5e91e, 0x97d2d988,
+        0x09b64c2b, 0x7eb17cbd, 0xe7b82d07, 0x90bf1d91, 0x1db71064, 0x6ab020f2,
+        0xf3b97148, 0x84be41de, 0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7,
+        0x136c9856, 0x646ba8c0, 0xfd62f97a, 0x8a65c9ec, 0x14015c4f, 0x63066cd9,
+        0xfa0f3d63, 0x8d080df5, 0x3b6e20c8, 0x4c69105e, 0xd56041e4, 0xa2677172,
+        0x3c03e4d1, 0x4b04d447, 0xd20d85fd, 0xa50ab56b, 0x35b5a8fa, 0x42b2986c,
+        0xdbbbc9d6, 0xacbcf940, 0x32d86ce3, 0x45df5c75, 0xdcd60dcf, 0xabd13d59,
+        0x26d930ac, 0x51de003a, 0xc8d75180, 0xbfd06116, 0x21b4f4b5, 0x56b3c423,
+        0xcfba9599, 0xb8bda50f, 0x2802b89e, 0x5f058808, 0xc60cd9b2, 0xb10be924,
+        0x2f6f7c87, 0x58684c11, 0xc1611dab, 0xb6662d3d, 0x76dc4190, 0x01db7106,
+        0x98d220bc, 0xefd5102a, 0x71b18589, 0x06b6b51f, 0x9fbfe4a5, 0xe8b8d433,
+        0x7807c9a2, 0x0f00f934, 0x9609a88e, 0xe10e9818, 0x7f6a0dbb, 0x086d3d2d,
+        0x91646c97, 0xe6635c01, 0x6b6b51f4, 0x1c6c6162, 0x856530d8, 0xf262004e,
+        0x6c0695ed, 0x1b01a57b, 0x8208f4c1, 0xf50fc457, 0x65b0d9c6, 0x12b7e950,
+        0x8bbeb8ea, 0xfcb9887c, 0x62dd1ddf, 0x15da2d49, 0x8cd37cf3, 0xfbd44c65,
+        0x4db26158, 0x3ab551ce, 0xa3bc0074, 0xd4bb30e2, 0x4adfa541, 0x3dd895d7,
+        0xa4d1c46d, 0xd3d6f4fb, 0x4369e96a, 0x346ed9fc, 0xad678846, 0xda60b8d0,
+        0x44042d73, 0x33031de5, 0xaa0a4c5f, 0xdd0d7cc9, 0x5005713c, 0x270241aa,
+        0xbe0b1010, 0xc90c2086, 0x5768b525, 0x206f85b3, 0xb966d409, 0xce61e49f,
+        0x5edef90e, 0x29d9c998, 0xb0d09822, 0xc7d7a8b4, 0x59b33d17, 0x2eb40d81,
+        0xb7bd5c3b, 0xc0ba6cad, 0xedb88320, 0x9abfb3b6, 0x03b6e20c, 0x74b1d29a,
+        0xead54739, 0x9dd277af, 0x04db2615, 0x73dc1683, 0xe3630b12, 0x94643b84,
+        0x0d6d6a3e, 0x7a6a5aa8, 0xe40ecf0b, 0x9309ff9d, 0x0a00ae27, 0x7d079eb1,
+        0xf00f9344, 0x8708a3d2, 0x1e01f268, 0x6906c2fe, 0xf762575d, 0x806567cb,
+        0x196c3671, 0x6e6b06e7, 0xfed41b76, 0x89d32be0, 0x10da7a5a, 0x67dd4acc,
+        0xf9b9df6f, 0x8ebeeff9, 0x17b7be43, 0x60b08ed5, 0xd6d6a3e8, 0xa1d1937e,
+        0x38d8c2c4, 0x4fdff252, 0xd1bb67f1, 0xa6bc5767, 0x3fb506dd, 0x48b2364b,
+        0xd80d2bda, 0xaf0a1b4c, 0x36034af6, 0x41047a60, 0xdf60efc3, 0xa867df55,
+        0x316e8eef, 0x4669be79, 0xcb61b38c, 0xbc66831a, 0x256fd2a0, 0x5268e236,
+        0xcc0c7795, 0xbb0b4703, 0x220216b9, 0x5505262f, 0xc5ba3bbe, 0xb2bd0b28,
+        0x2bb45a92, 0x5cb36a04, 0xc2d7ffa7, 0xb5d0cf31, 0x2cd99e8b, 0x5bdeae1d,
+        0x9b64c2b0, 0xec63f226, 0x756aa39c, 0x026d930a, 0x9c0906a9, 0xeb0e363f,
+        0x72076785, 0x05005713, 0x95bf4a82, 0xe2b87a14, 0x7bb12bae, 0x0cb61b38,
+        0x92d28e9b, 0xe5d5be0d, 0x7cdcefb7, 0x0bdbdf21, 0x86d3d2d4, 0xf1d4e242,
+        0x68ddb3f8, 0x1fda836e, 0x81be16cd, 0xf6b9265b, 0x6fb077e1, 0x18b74777,
+        0x88085ae6, 0xff0f6a70, 0x66063bca, 0x11010b5c, 0x8f659eff, 0xf862ae69,
+        0x616bffd3, 0x166ccf45, 0xa00ae278, 0xd70dd2ee, 0x4e048354, 0x3903b3c2,
+        0xa7672661, 0xd06016f7, 0x4969474d, 0x3e6e77db, 0xaed16a4a, 0xd9d65adc,
+        0x40df0b66, 0x37d83bf0, 0xa9bcae53, 0xdebb9ec5, 0x47b2cf7f, 0x30b5ffe9,
+        0xbdbdf21c, 0xcabac28a, 0x53b39330, 0x24b4a3a6, 0xbad03605, 0xcdd70693,
+        0x54de5729, 0x23d967bf, 0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94,
+        0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d,
+    };
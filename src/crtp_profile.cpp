@@ -1,5 +1,6 @@
 #include "crtp_profile.h"
 #include "cudp_profile.h"
+#include "flow_table.h"
 #include "network.h"
 #include <rohc/compressor.h>
 #include <iterator>
@@ -7,35 +8,94 @@
 
 using namespace std;
 
+namespace
+{
+    // Fields that rule out all but co_common: tos, df, ttl and the rtp
+    // padding, extension and payload type
+    const uint8_t basicFields[ROHC::headerBlockSize] = {
+        0x00, 0xff, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00,
+        0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x30, 0x7f, 0x00, 0x00
+    };
+
+    const uint8_t markerField[ROHC::headerBlockSize] = {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00
+    };
+
+    // basicFields and markerField, none of them may change in pt_0
+    const uint8_t steadyStateFields[ROHC::headerBlockSize] = {
+        0x00, 0xff, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00,
+        0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x30, 0xff, 0x00, 0x00
+    };
+
+    // Traffic class and hop limit, the RTP header of an IPv6 packet is
+    // past the header block and compared field by field
+    const uint8_t basicFieldsIPv6[ROHC::headerBlockSize] = {
+        0x0f, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    };
+
+    uint8_t PT0CRC3(uint16_t msn, uint8_t crc3)
+    {
+        return static_cast<uint8_t>(((msn & 0x0f) << 3) | crc3);
+    }
+
+    // The headers covered by the header CRC
+    size_t HeaderSize(const ROHC::iphdr* ip)
+    {
+        return ROHC::IPHeaderSize(ip) + sizeof(ROHC::udphdr) + sizeof(ROHC::rtphdr);
+    }
+} // anon ns
+
 namespace ROHC
 {
     CRTPProfile::CRTPProfile(Compressor* comp, uint16_t cid, const iphdr* ip)
     : CProfile(comp, cid, ip)
+    , udp_checksum_used(false)
     , csrc_list(16)
 	, number_of_packets_with_new_ts_stride_to_send(0)
     , time_stride(TIME_STRIDE_DEFAULT)
 	, timestamp_window(16, 16, 0)
     , ts_stride(TS_STRIDE_DEFAULT)
+    , ssrc(0)
+    , crc3_control(0)
+    , crc3_reorder_ratio(reorder_ratio)
+    , crc3_ts_stride(ts_stride)
+    , crc3_time_stride(time_stride)
+    , predicted_crc3(0)
+    , predicted_encoding_size(0)
     {
-        const udphdr* udp = reinterpret_cast<const udphdr*>(ip+1);
+        const udphdr* udp = NextHeader<udphdr>(ip);
         sport = udp->source;
         dport = udp->dest;
         const rtphdr* rtp = reinterpret_cast<const rtphdr*>(udp+1);
         RASSERT(rtp->version == 2);
+        ssrc = rtp->ssrc;
         msn = rtp->sequence_number;
         last_rtp.sequence_number = 0;
         last_rtp.timestamp = 0;
+        UpdateControlCRC3();
     }
     
     bool
     CRTPProfile::Matches(unsigned int profileID, const ROHC::iphdr *ip) const
     {
-        const udphdr* udp = reinterpret_cast<const udphdr*>(ip+1);
+        const udphdr* udp = NextHeader<udphdr>(ip);
+        const rtphdr* rtp = reinterpret_cast<const rtphdr*>(udp+1);
+        // The SSRC is a static field, another one needs a new context
         return (profileID == ID()) &&
-        (saddr == ip->saddr) &&
+        MatchesIPStatic(ip) &&
         (sport == udp->source) &&
-        (daddr == ip->daddr) &&
-        (dport == udp->dest);        
+        (dport == udp->dest) &&
+        (ssrc == rtp->ssrc);
     }
     
     void
@@ -43,10 +103,27 @@ namespace ROHC
     {
         size_t outputInSize = output.size();
         const iphdr* ip = reinterpret_cast<const iphdr*>(&data[0]);
-        const udphdr* udp = reinterpret_cast<const udphdr*>(ip+1);
+        const udphdr* udp = NextHeader<udphdr>(ip);
         const rtphdr* rtp = reinterpret_cast<const rtphdr*>(udp+1);
         
-
+        if (!CompressPredicted(ip, rtp, data, output) &&
+            !CompressSteadyState(ip, udp, rtp, data, output))
+        {
+            CompressGeneral(ip, udp, rtp, data, output);
+        }
+        PredictNextHeader(data);
+        
+        // Append payload
+        output.insert(output.end(), data.begin() + IPHeaderSize(ip) + sizeof(udphdr) + sizeof(rtphdr), data.end());
+        
+        ++numberOfPacketsSent;
+        dataSizeCompressed += output.size() - outputInSize;
+        dataSizeUncompressed += data.size();        
+    }
+    
+    void
+    CRTPProfile::CompressGeneral(const iphdr* ip, const udphdr* udp, const rtphdr* rtp, const data_t& data, data_t& output)
+    {
 		// MSN should always be the sequence number of rtp
 		msn = rohc_htons(rtp->sequence_number);
 
@@ -67,9 +144,13 @@ namespace ROHC
         {
             CreateIR(ip, udp, rtp, output);
         }
+        else if (number_of_co_repair_packets_to_send > 0)
+        {
+            CreateCORepair(ip, udp, rtp, output);
+        }
         else
         {
-            CreateCO(ip, udp, rtp, output);
+            CreateCO(ip, udp, rtp, ChangeFromLastHeader(data), output);
         }
 
 		// Decrease this after packet it sent
@@ -80,16 +161,198 @@ namespace ROHC
 
 		UpdateIpInformation(ip);
 		UpdateRtpInformation(rtp);
+		UpdateLastHeader(data);
 
         AdvanceState(false, false);
         msnWindow.add(msn, msn);
+    }
+
+    /*
+     In SO state a flow where every packet has the next sequence number and
+     the timestamp advanced by ts_stride, and nothing else changed, is sent
+     as pt_0_crc3. This checks exactly the conditions CreateCO would use to
+     pick pt_0_crc3 and updates the context the same way, but without the
+     stride calculation, the width searches and the divisions. The field
+     masks are for IPv4, IPv6 flows always take the general path.
+     */
+    bool
+    CRTPProfile::CompressSteadyState(const iphdr* ip, const udphdr* udp, const rtphdr* rtp, const data_t& data, data_t& output)
+    {
+        if (ipv6 ||
+            (SO_State != state) ||
+            (number_of_packets_with_new_ts_stride_to_send > 0) ||
+            (number_of_packets_with_new_ip_fields_to_send > 0))
+        {
+            return false;
+        }
+
+        uint16_t new_msn = rohc_htons(rtp->sequence_number);
+        if (static_cast<uint16_t>(msn + 1) != new_msn || !new_msn)
+            return false;
+
+        // No wrap, then ts_scaled is one more and ts_offset the same
+        uint32_t host_timestamp = rohc_htonl(rtp->timestamp);
+        uint32_t last_host_timestamp = rohc_htonl(last_rtp.timestamp);
+        if ((host_timestamp - last_host_timestamp != ts_stride) ||
+            (host_timestamp < last_host_timestamp))
+        {
+            return false;
+        }
+
+        if (ChangeFromLastHeader(data).Any(steadyStateFields))
+            return false;
+
+        if ((ip_id_behaviour <= IP_ID_BEHAVIOUR_SEQUENTIAL_SWAPPED) &&
+            (CalculateIpIdOffset(ip, new_msn) != IpIdOffset()))
+        {
+            return false;
+        }
+
+        if (!msnWindow.fits(new_msn, 4))
+            return false;
+
+        msn = new_msn;
+        UpdateIpIdOffset(ip);
+        header_crc3 = header_crc.CRC3(ip, HeaderSize(ip));
+
+        if (!largeCID && cid)
+        {
+            output.push_back(CreateShortCID(cid));
+        }
         
-        // Append payload
-        output.insert(output.end(), data.begin() + sizeof(iphdr) + sizeof(udphdr) + sizeof(rtphdr), data.end());
+        create_pt_0_crc3(output);
         
-        ++numberOfPacketsSent;
-        dataSizeCompressed += output.size() - outputInSize;
-        dataSizeUncompressed += data.size();        
+        if (largeCID)
+        {
+            SDVLEncode(back_inserter(output), cid);
+        }
+        
+        create_ipv4_innermost_irregular(ip, output);
+        create_udp_irregular(udp, output);
+        
+        UpdateSteadyStateContext(ip, rtp, data);
+        return true;
+    }
+
+    void
+    CRTPProfile::UpdateSteadyStateContext(const iphdr* ip, const rtphdr* rtp, const data_t& data)
+    {
+        ++numberOfSOPacketsSent;
+
+        UpdateIpInformation(ip);
+		memcpy(&last_rtp, rtp, sizeof(last_rtp));
+		++last_scaled_timestamp;
+		timestamp_window.add(msn, last_scaled_timestamp);
+		UpdateLastHeader(data);
+        msnWindow.add(msn, msn);
+    }
+
+    /*
+     After each packet the header of the next one is predicted, assuming
+     the flow stays as CompressSteadyState wants it, together with its
+     pt_0_crc3 encoding. Random IP-IDs and UDP checksums are covered by the
+     CRC and sent in the irregular chain, so those flows are not predicted.
+     Neither are IPv6 flows, the flow table only holds IPv4 headers.
+
+     The MSN window only loses entries until the next packet (acks), so if
+     the next MSN fits now it still fits then, unless the window was
+     emptied.
+     */
+    void
+    CRTPProfile::PredictNextHeader(const data_t& data)
+    {
+        predicted_encoding_size = 0;
+        compressor->Flows()->Disarm(cid);
+        if (ipv6 ||
+            (SO_State != state) ||
+            (number_of_packets_with_new_ts_stride_to_send > 0) ||
+            (number_of_packets_with_new_ip_fields_to_send > 0) ||
+            udp_checksum_used ||
+            (IP_ID_BEHAVIOUR_RANDOM == ip_id_behaviour) ||
+            (data.size() < predictedHeaderSize))
+        {
+            return;
+        }
+
+        uint16_t next_msn = static_cast<uint16_t>(msn + 1);
+        uint32_t host_timestamp = rohc_htonl(last_rtp.timestamp);
+        uint32_t next_timestamp = host_timestamp + ts_stride;
+        if (!next_msn || (next_timestamp < host_timestamp) || !msnWindow.fits(next_msn, 4))
+            return;
+
+        memcpy(predicted_header, &data[0], predictedHeaderSize);
+        iphdr* ip = reinterpret_cast<iphdr*>(predicted_header);
+        udphdr* udp = reinterpret_cast<udphdr*>(ip+1);
+        rtphdr* rtp = reinterpret_cast<rtphdr*>(udp+1);
+
+        if (IP_ID_BEHAVIOUR_SEQUENTIAL == ip_id_behaviour)
+        {
+            ip->id = rohc_htons(static_cast<uint16_t>(rohc_htons(ip->id) + 1));
+        }
+        else if (IP_ID_BEHAVIOUR_SEQUENTIAL_SWAPPED == ip_id_behaviour)
+        {
+            ip->id = rohc_htoles(static_cast<uint16_t>(rohc_htoles(ip->id) + 1));
+        }
+        calculateIpHeaderCheckSum(ip);
+        rtp->sequence_number = rohc_htons(next_msn);
+        rtp->timestamp = rohc_htonl(next_timestamp);
+
+        predicted_crc3 = header_crc.CRC3(ip, predictedHeaderSize);
+
+        uint8_t* pos = predicted_encoding;
+        if (!largeCID && cid)
+        {
+            *pos++ = CreateShortCID(cid);
+        }
+        *pos++ = PT0CRC3(next_msn, predicted_crc3);
+        if (largeCID)
+        {
+            pos = SDVLEncode(pos, cid);
+        }
+        predicted_encoding_size = pos - predicted_encoding;
+        compressor->Flows()->Arm(cid, ip, udp, rtp);
+    }
+
+    bool
+    CRTPProfile::CompressPredicted(const iphdr* ip, const rtphdr* rtp, const data_t& data, data_t& output)
+    {
+        if (!predicted_encoding_size || (SO_State != state) || msnWindow.empty())
+            return false;
+
+        // The lengths are predicted to be those of the last packet. A
+        // packet of another size is still a hit, but the lengths and the
+        // IP checksum are covered by the CRC, which has to be computed again
+        iphdr* predicted_ip = reinterpret_cast<iphdr*>(predicted_header);
+        bool resized = (predicted_ip->tot_len != ip->tot_len);
+        if (resized)
+        {
+            udphdr* predicted_udp = reinterpret_cast<udphdr*>(predicted_ip+1);
+            predicted_ip->tot_len = ip->tot_len;
+            predicted_udp->len = rohc_htons(static_cast<uint16_t>(rohc_htons(ip->tot_len) - sizeof(iphdr)));
+            calculateIpHeaderCheckSum(predicted_ip);
+        }
+        if (data.size() < predictedHeaderSize ||
+            memcmp(predicted_header, &data[0], predictedHeaderSize))
+        {
+            ++predictionMisses;
+            return false;
+        }
+        ++predictionHits;
+
+        if (resized)
+        {
+            predicted_crc3 = header_crc.CRC3(predicted_ip, predictedHeaderSize);
+            predicted_encoding[(!largeCID && cid) ? 1 : 0] = PT0CRC3(static_cast<uint16_t>(msn + 1), predicted_crc3);
+        }
+
+        msn = static_cast<uint16_t>(msn + 1);
+        UpdateIpIdOffset(ip);
+        header_crc3 = predicted_crc3;
+		IncreasePacketCount(PT_0_CRC3);
+        output.insert(output.end(), predicted_encoding, predicted_encoding + predicted_encoding_size);
+
+        UpdateSteadyStateContext(ip, rtp, data);
+        return true;
     }
     
     void
@@ -109,24 +372,26 @@ namespace ROHC
             SDVLEncode(back_inserter(output), cid);
         }
         
-        output.push_back(static_cast<uint8_t>(ProfileID()));
+        output.push_back(static_cast<uint8_t>(ID()));
         
         size_t crcPos = output.size();
         
         // Add zero crc for now
         output.push_back(0);
         
-        create_ipv4_static(ip, output);
+        create_ip_static(ip, output);
         
         CUDPProfile::create_udp_static(sport, dport, output);
         
         create_rtp_static(rtp, output);
         
-        create_ipv4_regular_innermost_dynamic(ip, output);
+        create_ip_regular_dynamic(ip, output);
         
         create_udp_regular_dynamic(udp, output);
         
         create_rtp_dynamic(rtp, output);
+
+        header_crc.SetStatic(ip, 4); // ports
         
         // Calculate CRC
         
@@ -137,20 +402,69 @@ namespace ROHC
         IncreasePacketCount(PT_IR);
         ++numberOfIRPacketsSent;
         ++numberOfIRPacketsSinceReset;        
+        number_of_co_repair_packets_to_send = 0;
+    }
+
+    /*
+     See CIPProfile::CreateCORepair
+     */
+    void
+    CRTPProfile::CreateCORepair(const ROHC::iphdr *ip, const ROHC::udphdr *udp, const ROHC::rtphdr *rtp, data_t &output)
+    {
+        header_crc.Calculate(ip, HeaderSize(ip), header_crc3, header_crc7);
+
+        if (!largeCID && cid)
+        {
+            output.push_back(CreateShortCID(cid));
+        }
+
+        output.push_back(CORepairPacket);
+
+        if (largeCID)
+        {
+            SDVLEncode(back_inserter(output), cid);
+        }
+
+        output.push_back(header_crc7);
+        output.push_back(control_crc3());
+
+        create_ip_regular_dynamic(ip, output);
+
+        create_udp_regular_dynamic(udp, output);
+
+        create_rtp_dynamic(rtp, output);
+
+        IncreasePacketCount(PT_CO_REPAIR);
+
+        --number_of_co_repair_packets_to_send;
     }
     
     void
-    CRTPProfile::CreateCO(const ROHC::iphdr *ip, const ROHC::udphdr *udp, const ROHC::rtphdr *rtp, data_t &output)
+    CRTPProfile::CreateCO(const ROHC::iphdr *ip, const ROHC::udphdr *udp, const ROHC::rtphdr *rtp, const HeaderChange& change, data_t &output)
     {
         data_t baseheader;
         
+        header_crc.Calculate(ip, HeaderSize(ip), header_crc3, header_crc7);
+
         unsigned int neededMSNWidth = msnWindow.width(msn);
 
 		//cout << "Needed MSN: " << neededMSNWidth << endl;
         
 		uint32_t host_timestamp = rohc_htonl(rtp->timestamp);
 
-		bool markerChanged =  MarkerChanged(rtp);
+		bool markerChanged;
+		bool basic;
+		if (ipv6)
+		{
+			markerChanged = rtp->marker != last_rtp.marker;
+			basic = !change.Any(basicFieldsIPv6) && !PTChanged(rtp) && !PadChanged(rtp) && !ExtensionChanged(rtp);
+		}
+		else
+		{
+			markerChanged = change.Any(markerField);
+			basic = !change.Any(basicFields);
+		}
+		basic = basic && !number_of_packets_with_new_ip_fields_to_send;
 
 		// If ts follows the rule delta-SN * ts_stride + old_ts = new_ts, we can compress hard
 		bool inferred_scaled_ts_possible = host_timestamp == (rohc_htonl(last_rtp.timestamp) + ts_stride * (msn - rohc_htons(last_rtp.sequence_number)));
@@ -160,8 +474,6 @@ namespace ROHC
 		uint32_t ts_offset = host_timestamp % ts_stride;
 		bool ts_offset_changed = ts_offset != last_ts_offset;
 
-		bool basic = !TOSChanged(ip) && !TTLChanged(ip) && !PTChanged(rtp) && !PadChanged(rtp) && !ExtensionChanged(rtp);
-
 		bool pt_0_crc3_possible = basic && (neededMSNWidth <= 4) && inferred_scaled_ts_possible && !markerChanged;
 		bool pt_0_crc7_possible = basic && (neededMSNWidth <= 5) && inferred_scaled_ts_possible && !markerChanged;
 
@@ -215,9 +527,9 @@ namespace ROHC
 			pt_0_crc3_possible = pt_0_crc3_possible && !IPIDOffsetChanged();
 			pt_0_crc7_possible = pt_0_crc7_possible && !IPIDOffsetChanged();
 
-			bool pt_1_seq_id_possible = basic && (neededIPIDWidth <= 4) && (neededMSNWidth <= 5) && !markerChanged && (neededTSWidth == 0);
+			bool pt_1_seq_id_possible = basic && (neededIPIDWidth <= 4) && (neededMSNWidth <= 5) && !markerChanged && inferred_scaled_ts_possible;
 			bool pt_1_seq_ts_possible = basic && !IPIDOffsetChanged() && (neededMSNWidth <= 4) && (neededTSWidth <= 5) && !ts_offset_changed;
-			bool pt_2_seq_id_possible = basic && (neededIPIDWidth <= 5) && (neededMSNWidth <= 7) && !markerChanged  && (neededTSWidth == 0);
+			bool pt_2_seq_id_possible = basic && (neededIPIDWidth <= 5) && (neededMSNWidth <= 7) && !markerChanged  && inferred_scaled_ts_possible;
 			bool pt_2_seq_both_possible = basic && (neededIPIDWidth <= 5) && (neededMSNWidth <= 7) && (neededTSWidth <= 7) && !ts_offset_changed;
 			bool pt_2_seq_ts_possible = basic && !IPIDOffsetChanged() && (neededMSNWidth <= 7) && (neededTSWidth <= 5) && !ts_offset_changed;
 
@@ -276,9 +588,8 @@ namespace ROHC
         
         output.insert(output.end(), baseheader.begin() + 1, baseheader.end());
         
-        create_ipv4_innermost_irregular(ip, output);
-        if (udp_checksum_used)
-            CUDPProfile::create_udp_with_checksum_irregular(udp, output);
+        create_ip_innermost_irregular(ip, output);
+        create_udp_irregular(udp, output);
         
         
         if (FO_State == state)
@@ -413,15 +724,37 @@ namespace ROHC
         AppendData(output, udp->check);
     }
 
+    void
+    CRTPProfile::create_udp_irregular(const ROHC::udphdr *udp, data_t& output)
+    {
+        if (udp_checksum_used)
+            CUDPProfile::create_udp_with_checksum_irregular(udp, output);
+    }
+
 	uint8_t
-	CRTPProfile::control_crc3() const
+	CRTPProfile::control_crc3()
 	{
-		data_t data;
+		// Only recalculated when one of the control fields has changed
+		if ((reorder_ratio != crc3_reorder_ratio) ||
+			(ts_stride != crc3_ts_stride) ||
+			(time_stride != crc3_time_stride))
+		{
+			UpdateControlCRC3();
+		}
+		return crc3_control;
+	}
 
-		data.push_back(static_cast<uint8_t>(reorder_ratio) & 0x03);
-		AppendDataToNBO(data, ts_stride);
-		AppendDataToNBO(data, time_stride);
-		return CRC3(data.begin(), data.end());
+	void
+	CRTPProfile::UpdateControlCRC3()
+	{
+		uint8_t data[9];
+		data[0] = static_cast<uint8_t>(reorder_ratio) & 0x03;
+		SetNBO(&data[1], ts_stride);
+		SetNBO(&data[5], time_stride);
+		crc3_control = CRC3(data, data + sizeof(data));
+		crc3_reorder_ratio = reorder_ratio;
+		crc3_ts_stride = ts_stride;
+		crc3_time_stride = time_stride;
 	}
     
     /*
@@ -523,12 +856,12 @@ namespace ROHC
 
 		if (TOSChanged(ip))
 		{
-			baseheader.push_back(ip->tos);
+			baseheader.push_back(TosTc(ip));
 		}
 
 		if (TTLChanged(ip))
 		{
-			baseheader.push_back(ip->ttl);
+			baseheader.push_back(TtlHopl(ip));
 		}
 
 		if (PTChanged(rtp))
@@ -555,10 +888,7 @@ namespace ROHC
 		if (list_indicator)
 		{
 		}
-		// crc7 from idx of crc minus one (the discriminator)
-		uint8_t crc7 = CRC7(baseheader.begin() + crcIdx - 1, baseheader.end());
-
-		baseheader[crcIdx] |= crc7 & 0x7f;
+		baseheader[crcIdx] |= header_crc7 & 0x7f;
     }
     
     /*
@@ -575,9 +905,7 @@ namespace ROHC
     CRTPProfile::create_pt_0_crc3(data_t &output)
     {
 		IncreasePacketCount(PT_0_CRC3);
-        uint8_t disc_msn_crc = static_cast<uint8_t>((msn & 0x0f) << 3);
-        uint8_t crc3 = CRC3(&disc_msn_crc, &disc_msn_crc + 1);
-		output.push_back(disc_msn_crc | crc3);
+		output.push_back(PT0CRC3(msn, header_crc3));
     }
     
     /*
@@ -599,9 +927,7 @@ namespace ROHC
 
         output[0] = static_cast<uint8_t>(0x80 + ((msn >> 1) & 0x0f));
 
-		output[1] = static_cast<uint8_t>(msn << 7);
-		uint8_t crc7 = CRC7(output.begin(), output.end());
-		output[1] |= crc7;
+		output[1] = static_cast<uint8_t>((msn << 7) | header_crc7);
     }
     
     /*
@@ -635,9 +961,7 @@ namespace ROHC
 			output[0] |= 0x10;
 
 		uint8_t lsbTS = scaled_timestamp & 0x1f;
-		output[1] = lsbTS << 3;
-		uint8_t crc3 = CRC3(output.begin(), output.end());
-		output[1] |= crc3;
+		output[1] = (lsbTS << 3) | header_crc3;
     }
     
     /*
@@ -663,9 +987,7 @@ namespace ROHC
 		
 		output.resize(2);
 		output[0] = 0x90 | (IpIdOffset() & 0x0f);
-		output[1] = static_cast<uint8_t>(msn << 3);
-		uint8_t crc3 = CRC3(output.begin(), output.end());
-		output[1] |= crc3;
+		output[1] = static_cast<uint8_t>((msn << 3) | header_crc3);
     }
     
     /*
@@ -699,8 +1021,7 @@ namespace ROHC
 		else
 			output[0] = 0xa0 | (msn & 0x0f);
 
-		output[1] = (scaled_timestamp & 0x1f) << 3;
-		output[1] |= CRC3(output.begin(), output.end());
+		output[1] = ((scaled_timestamp & 0x1f) << 3) | header_crc3;
     }
     
     /*
@@ -730,8 +1051,7 @@ namespace ROHC
 		if (marker)
 			output[2] = 0x80;
 		
-		uint8_t crc7 = CRC7(output.begin(), output.end());
-		output[2] |= crc7;
+		output[2] |= header_crc7;
 
 		//cout << "TS scaled: " << hex << scaled_timestamp << dec << endl;
 		//cout << "lsb ts: " << hex << (unsigned) scaled_ts_lsb << dec << endl;
@@ -764,9 +1084,7 @@ namespace ROHC
 		buf[0] = 0xc0 | (msnLSB >> 4);
 		uint8_t ip_id_lsb = IpIdOffset() & 0x1f; // 5 bit ip id offset
 		buf[1] = (msnLSB << 4) | (ip_id_lsb >> 1);
-		buf[2] = ip_id_lsb << 7;
-		uint8_t crc7 = CRC7(buf, buf + sizeof(buf));
-		buf[2] |= crc7;
+		buf[2] = (ip_id_lsb << 7) | header_crc7;
 		output.insert(output.end(), buf, buf + sizeof(buf));
     }
     
@@ -802,12 +1120,11 @@ namespace ROHC
 		uint8_t ipLSB = IpIdOffset() & 0x1f;
 		buf[1] = (msn << 4) | (ipLSB >> 1);
 		buf[2] = ipLSB << 7;
+		buf[2] |= header_crc7;
 		buf[3] = scaled_timestamp << 1;
 		if(marker)
 			buf[3] |= 1;
 
-		uint8_t crc7 = CRC7(buf, buf + sizeof(buf));
-		buf[2] |= crc7;
 		output.insert(output.end(), buf, buf + sizeof(buf));
     }
     
@@ -848,8 +1165,7 @@ namespace ROHC
 		else
 			buf[2] = 0x00;
 
-		uint8_t crc7 = CRC7(buf, buf + sizeof(buf));
-		buf[2] |= crc7;
+		buf[2] |= header_crc7;
 		output.insert(output.end(), buf, buf + sizeof(buf));
     }
     
@@ -869,7 +1185,7 @@ namespace ROHC
 			{
 				flags |= 0x20;
 			}
-			if (HasDontFragment(ip))
+			if (DontFragment(ip))
 			{
 				flags |= 0x10;
 			}
@@ -998,6 +1314,9 @@ namespace ROHC
             }
             else if (numberOfIRPacketsSinceReset >= compressor->NumberOfIRPacketsToSend())
                 state = FO_State;
+
+            if (FO_State == state)
+                static_chain_known = true;
         }
         else if (FO_State == state)
         {
@@ -1025,7 +1344,10 @@ namespace ROHC
 
 		uint16_t sn_diff = rohc_htons(rtp->sequence_number) - rohc_htons(last_rtp.sequence_number);
 		uint32_t ts_diff = rohc_htonl(rtp->timestamp) - rohc_htonl(last_rtp.timestamp);
-		return ts_diff / sn_diff;
+		uint32_t stride = ts_diff / sn_diff;
+		// ts_stride is sent SDVL encoded (29 bits), a larger one comes from a
+		// timestamp going backwards and is no stride
+		return (stride <= 0x1fffffff) ? stride : 0;
 	}
 
 	void 
@@ -1040,19 +1362,32 @@ namespace ROHC
 	}
 
 	void
-	CRTPProfile::MsnWasAcked(uint16_t ackMSN)
+	CRTPProfile::MsnWasAcked(uint16_t /*ackMSN*/)
 	{
-		timestamp_window.ackMSN(ackMSN);
 		AdvanceState(true, true);
 	}
 
+	void
+	CRTPProfile::TrimWindows(uint16_t msn)
+	{
+		CProfile::TrimWindows(msn);
+		timestamp_window.ackMSN(msn);
+	}
+
 	void CRTPProfile::NackMsn(uint16_t msn) {
-		AckFBMsn(msn);
-		numberOfIRPacketsSinceReset = numberOfFOPacketsSinceReset = 0;
-		state = IR_State;
+		predicted_encoding_size = 0;
+		compressor->Flows()->Disarm(cid);
+		TrimWindows(AckedMSN(msn, 14));
+		RepairDynamicChain();
+		// The control_crc3 of co_repair covers ts_stride, send it along
+		if (ts_stride && (number_of_packets_with_new_ts_stride_to_send < number_of_co_repair_packets_to_send))
+			number_of_packets_with_new_ts_stride_to_send = number_of_co_repair_packets_to_send;
 	}
 
 	void CRTPProfile::StaticNackMsn(uint16_t msn) {
 		NackMsn(msn);
+		static_chain_known = false;
+		number_of_co_repair_packets_to_send = 0;
+		state = IR_State;
 	}
 }
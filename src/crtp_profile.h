@@ -4,8 +4,6 @@
 
 namespace ROHC
 {
-    struct udphdr;
-    struct rtphdr;
     class CRTPProfile : public CProfile
     {
     public:
@@ -21,6 +19,7 @@ namespace ROHC
 		 * called by AckLsbMsn or AckFBMsn with the full MSN that was acked
 		 */
 		virtual void MsnWasAcked(uint16_t ackedMSN);
+		virtual void TrimWindows(uint16_t msn);
 		/*
 		 * 14 bit MSN
 		 */
@@ -31,13 +30,33 @@ namespace ROHC
 		 */
 		virtual void StaticNackMsn(uint16_t fbMSN);
 
+        void CompressGeneral(const iphdr* ip, const udphdr* udp, const rtphdr* rtp, const data_t& data, data_t& output);
+        /**
+         * pt_0_crc3 for the next packet of an unchanged flow in SO state,
+         * false (and nothing done) for anything else
+         */
+        bool CompressSteadyState(const iphdr* ip, const udphdr* udp, const rtphdr* rtp, const data_t& data, data_t& output);
+        /**
+         * The cached encoding if the packet is the predicted next header,
+         * otherwise false (a miss)
+         */
+        bool CompressPredicted(const iphdr* ip, const rtphdr* rtp, const data_t& data, data_t& output);
+        void PredictNextHeader(const data_t& data);
+        void UpdateSteadyStateContext(const iphdr* ip, const rtphdr* rtp, const data_t& data);
+
         void CreateIR(const iphdr* ip, const udphdr* udp, const rtphdr* rtp, data_t& output);
-        void CreateCO(const iphdr* ip, const udphdr* udp, const rtphdr* rtp, data_t& output);
+        void CreateCO(const iphdr* ip, const udphdr* udp, const rtphdr* rtp, const HeaderChange& change, data_t& output);
+        void CreateCORepair(const iphdr* ip, const udphdr* udp, const rtphdr* rtp, data_t& output);
         
         void create_rtp_static(const rtphdr* rtp, data_t& output);
         void create_rtp_dynamic(const rtphdr* rtp, data_t& output);
         void create_csrc_list_dynchain(const rtphdr* rtp, data_t& output);
-        void create_udp_regular_dynamic(const udphdr* udp, data_t& output);
+        /**
+         * The udp items of the dynamic and irregular chains, the UDP-Lite
+         * profile adds the checksum coverage
+         */
+        virtual void create_udp_regular_dynamic(const udphdr* udp, data_t& output);
+        virtual void create_udp_irregular(const udphdr* udp, data_t& output);
         
         void create_co_common(const iphdr *ip, const rtphdr *rtp, data_t &output);
         void create_pt_0_crc3(data_t& output);
@@ -56,6 +75,8 @@ namespace ROHC
 
 	void create_variable_unscaled_timestamp(bool tss_indicator, bool tsc_indicator, const rtphdr* rtp, data_t& baseheader);
 
+        bool udp_checksum_used;
+
 	private:
 		void AdvanceState(bool calledFromFeedback, bool ack);
 
@@ -74,15 +95,11 @@ namespace ROHC
 			return rtp->extension != last_rtp.extension;
 		}
 
-		bool MarkerChanged(const rtphdr* rtp) const
-		{
-			return rtp->marker != last_rtp.marker;
-		}
-
 	uint32_t CalculateTSStride(const rtphdr* rtp) const;
 
 	void UpdateRtpInformation(const rtphdr* rtp);
-	uint8_t control_crc3() const;
+	uint8_t control_crc3();
+	void UpdateControlCRC3();
 
 
         
@@ -115,7 +132,23 @@ namespace ROHC
 	uint32_t time_stride;
 	WLSB<uint32_t> timestamp_window;
 	uint32_t ts_stride;
-        bool udp_checksum_used;
+        uint32_t ssrc;
+
+	// control_crc3 and the control fields it was calculated from
+	uint8_t crc3_control;
+	Reordering_t crc3_reorder_ratio;
+	uint32_t crc3_ts_stride;
+	uint32_t crc3_time_stride;
+
+	// ip, udp and rtp header
+	static const size_t predictedHeaderSize = 40;
+
+	// The expected next header and its pt_0_crc3 encoding (with CID),
+	// predicted_encoding_size is 0 when nothing is predicted
+	uint8_t predicted_header[predictedHeaderSize];
+	uint8_t predicted_crc3;
+	uint8_t predicted_encoding[4];
+	size_t predicted_encoding_size;
 
 
     };
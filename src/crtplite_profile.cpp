@@ -0,0 +1,50 @@
+#include "crtplite_profile.h"
+#include "cudplite_profile.h"
+#include "network.h"
+#include <rohc/compressor.h>
+
+namespace ROHC
+{
+    CRTPLiteProfile::CRTPLiteProfile(Compressor* comp, uint16_t cid, const iphdr* ip)
+    : CRTPProfile(comp, cid, ip)
+    , coverage_behaviour(UDP_LITE_COVERAGE_INFERRED)
+    , coverage(rohc_htons(NextHeader<udphdr>(ip)->len))
+    {
+        udp_checksum_used = true;
+    }
+
+    void
+    CRTPLiteProfile::Compress(const data_t& data, data_t& output)
+    {
+        const iphdr* ip = reinterpret_cast<const iphdr*>(&data[0]);
+        if (CUDPLiteProfile::UpdateCoverage(NextHeader<udphdr>(ip), data.size() - IPHeaderSize(ip), coverage_behaviour, coverage))
+        {
+            RepairDynamicChain();
+        }
+        CRTPProfile::Compress(data, output);
+    }
+
+    /*
+     COMPRESSED udp_lite_regular_dynamic {
+     ENFORCE(profile_value == PROFILE_RTP_0107);
+     checksum_coverage =:= irregular(16)           [ 16 ];
+     checksum          =:= irregular(16)           [ 16 ];
+     reserved          =:= compressed_value(6, 0)  [ 6 ];
+     coverage_behavior =:= irregular(2)            [ 2 ];
+     }
+     */
+    void
+    CRTPLiteProfile::create_udp_regular_dynamic(const udphdr* udp, data_t& output)
+    {
+        AppendData(output, udp->len);
+        AppendData(output, udp->check);
+        output.push_back(static_cast<uint8_t>(coverage_behaviour));
+    }
+
+    void
+    CRTPLiteProfile::create_udp_irregular(const udphdr* udp, data_t& output)
+    {
+        CUDPLiteProfile::create_udp_lite_irregular(coverage_behaviour, udp, output);
+    }
+
+} // ns ROHC
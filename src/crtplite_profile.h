@@ -0,0 +1,32 @@
+#pragma once
+
+/**
+ * RTP/UDP-Lite/IP profile
+ */
+
+#include "crtp_profile.h"
+
+namespace ROHC
+{
+    /**
+     * The RTP profile with the checksum coverage of CUDPLiteProfile, the
+     * checksum is always sent so the steady state prediction is not used
+     */
+    class CRTPLiteProfile : public CRTPProfile
+    {
+    public:
+        CRTPLiteProfile(Compressor* comp, uint16_t cid, const iphdr* ip);
+        static uint16_t ProfileID() {return 0x0107;}
+        virtual unsigned int ID() const {return ProfileID();}
+        virtual void Compress(const data_t& data, data_t& output);
+
+    protected:
+        virtual void create_udp_regular_dynamic(const udphdr* udp, data_t& output);
+        virtual void create_udp_irregular(const udphdr* udp, data_t& output);
+
+    private:
+        CoverageBehaviour_t coverage_behaviour;
+        uint16_t coverage;
+    };
+
+} // ns ROHC
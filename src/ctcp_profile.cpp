@@ -1,121 +1,723 @@
 #include "ctcp_profile.h"
 #include "tcp_profile_supp.h"
+#include "network.h"
+#include <rohc/compressor.h>
+#include <rohc/log.h>
+#include <iterator>
+#include <cstring>
+
+using namespace std;
+
+namespace
+{
+    // References kept for each field, the 4 bit msn_lsb(4, 4) of the
+    // base headers covers every MSN in such a window
+    const size_t tcpWindowSize = 8;
+
+    // The flag octets of the TCP header split the way RFC 6846 does
+    inline uint8_t ResFlags(const ROHC::tcphdr* tcp) {
+        return reinterpret_cast<const uint8_t*>(tcp)[12] & 0x0f;
+    }
+    inline uint8_t EcnFlags(const ROHC::tcphdr* tcp) {
+        return reinterpret_cast<const uint8_t*>(tcp)[13] >> 6;
+    }
+    inline uint8_t RsfFlags(const ROHC::tcphdr* tcp) {
+        return reinterpret_cast<const uint8_t*>(tcp)[13] & 0x07;
+    }
+
+    /*
+     rsf_index_enc, at most one of RST, SYN and FIN
+     */
+    inline bool RsfIndexPossible(uint8_t rsf) {
+        return !(rsf & (rsf - 1));
+    }
+    inline uint8_t RsfIndex(uint8_t rsf) {
+        switch (rsf) {
+            case 4: return 1; // RST
+            case 2: return 2; // SYN
+            case 1: return 3; // FIN
+            default: return 0;
+        }
+    }
+
+    /*
+     variable_length_32_enc(flag): 0 static, 1 lsb(8, 63),
+     2 lsb(16, 16383), 3 irregular(32)
+     */
+    unsigned int variable_length_32_indicator(const ROHC::WLSB<uint32_t>& window, uint32_t value)
+    {
+        if (window.fits(value, 0, 0))
+            return 0;
+        if (window.fits(value, 8, 63))
+            return 1;
+        if (window.fits(value, 16, 16383))
+            return 2;
+        return 3;
+    }
+
+    void variable_length_32_enc(unsigned int indicator, uint32_t value, ROHC::data_t& output)
+    {
+        switch (indicator) {
+            case 1:
+                output.push_back(static_cast<uint8_t>(value));
+                break;
+            case 2:
+                ROHC::AppendDataToNBO(output, static_cast<uint16_t>(value));
+                break;
+            case 3:
+                ROHC::AppendDataToNBO(output, value);
+                break;
+        }
+    }
+
+    // Packets a new list or item is sent in, a lost one is covered by the
+    // next ones
+    const unsigned int listRepetitions = 3;
+
+    inline uint32_t OptionU32(const ROHC::TCPOptionItem& item, size_t pos) {
+        uint32_t value;
+        memcpy(&value, &item.data[pos], sizeof(value));
+        return ROHC::rohc_htonl(value);
+    }
+
+    // TSval and TSecr of a timestamp option
+    inline uint32_t TsVal(const ROHC::TCPOptionItem& item) {return OptionU32(item, 2);}
+    inline uint32_t TsEcr(const ROHC::TCPOptionItem& item) {return OptionU32(item, 6);}
+
+    /*
+     tcp_opt_ts_lsb: '0' lsb(7, -1), '10' lsb(14, -1),
+     '110' lsb(21, 0x00040000), '111' lsb(29, 0x04000000).
+     Returns the size, 0 if the value does not fit.
+     */
+    size_t ts_lsb_size(const ROHC::WLSB<uint32_t>& window, uint32_t value)
+    {
+        if (window.fits(value, 7, -1))
+            return 1;
+        if (window.fits(value, 14, -1))
+            return 2;
+        if (window.fits(value, 21, 0x00040000))
+            return 3;
+        if (window.fits(value, 29, 0x04000000))
+            return 4;
+        return 0;
+    }
+
+    void ts_lsb_enc(size_t size, uint32_t value, ROHC::data_t& output)
+    {
+        switch (size) {
+            case 1:
+                output.push_back(static_cast<uint8_t>(value & 0x7f));
+                break;
+            case 2:
+                ROHC::AppendDataToNBO(output, static_cast<uint16_t>(0x8000 | (value & 0x3fff)));
+                break;
+            case 3:
+                output.push_back(static_cast<uint8_t>(0xc0 | ((value >> 16) & 0x1f)));
+                ROHC::AppendDataToNBO(output, static_cast<uint16_t>(value));
+                break;
+            default:
+                ROHC::AppendDataToNBO(output, 0xe0000000 | (value & 0x1fffffff));
+                break;
+        }
+    }
+
+    /*
+     sack_var_length_enc, the offset from the reference in 15, 22 or 29
+     bits after a '0', '10' or '110' discriminator, or all of it after
+     0xff
+     */
+    void sack_var_length_enc(uint32_t offset, ROHC::data_t& output)
+    {
+        if (offset < 0x8000) {
+            ROHC::AppendDataToNBO(output, static_cast<uint16_t>(offset));
+        }
+        else if (offset < 0x400000) {
+            output.push_back(static_cast<uint8_t>(0x80 | (offset >> 16)));
+            ROHC::AppendDataToNBO(output, static_cast<uint16_t>(offset));
+        }
+        else if (offset < 0x20000000) {
+            ROHC::AppendDataToNBO(output, 0xc0000000 | offset);
+        }
+        else {
+            output.push_back(0xff);
+            ROHC::AppendDataToNBO(output, offset);
+        }
+    }
+} // anon ns
 
 namespace ROHC {
-    CTCPProfile::CTCPProfile(Compressor* comp, uint16_t cid, const iphdr* ip) 
-    : CProfile(comp, cid, ip) {
-        
+    CTCPProfile::CTCPProfile(Compressor* comp, uint16_t cid, const iphdr* ip)
+    : CProfile(comp, cid, ip)
+    , sport(NextHeader<tcphdr>(ip)->source)
+    , dport(NextHeader<tcphdr>(ip)->dest)
+    , ecn_used(false)
+    , payload_size(0)
+    , seq_residue(0)
+    , seq_scaled_packets(0)
+    , ack_stride(0)
+    , ack_residue(0)
+    , ack_scaled_packets(0)
+    , last_ack_delta(0)
+    , number_of_packets_with_new_ack_stride_to_send(0)
+    , seq_window(tcpWindowSize, 32, 0)
+    , seq_scaled_window(tcpWindowSize, 32, 0)
+    , ack_window(tcpWindowSize, 32, 0)
+    , ack_scaled_window(tcpWindowSize, 32, 0)
+    , window_size_window(tcpWindowSize, 16, 0)
+    , ttl_window(tcpWindowSize, 8, 0)
+    , number_of_packets_with_new_list_to_send(0)
+    , tsval_window(tcpWindowSize, 32, 0)
+    , tsecr_window(tcpWindowSize, 32, 0)
+    , option_count(0)
+    , option_list_present(false)
+    {
+        memset(&last_tcp, 0, sizeof(last_tcp));
+        option_context.Clear();
+        memset(option_repetitions, 0, sizeof(option_repetitions));
     }
-    
+
     bool CTCPProfile::Matches(unsigned int profileID, const ROHC::iphdr *ip) const {
         if (profileID != ProfileID()) {
             return false;
         }
-        
-        const tcphdr* tcp = reinterpret_cast<const tcphdr*>(ip + 4*ip->ihl);
 
-        return (ProtocolID() == ip->protocol) &&
-            (saddr == ip->saddr) &&
-            (daddr == ip->daddr) &&
-            (last_tcp.source == tcp->source) &&
-            (last_tcp.dest == tcp->dest);
+        const tcphdr* tcp = NextHeader<tcphdr>(ip);
+
+        return (ProtocolID() == IPProtocol(ip)) &&
+            MatchesIPStatic(ip) &&
+            (sport == tcp->source) &&
+            (dport == tcp->dest);
     }
-    
+
     void CTCPProfile::MsnWasAcked(uint16_t /*ackedMSN*/) {
-        
+        AdvanceState(true, true);
     }
-    
-    void CTCPProfile::NackMsn(uint16_t /*fbMSN*/) {
-        
+
+    void CTCPProfile::TrimWindows(uint16_t msn) {
+        CProfile::TrimWindows(msn);
+        seq_window.ackMSN(msn);
+        seq_scaled_window.ackMSN(msn);
+        ack_window.ackMSN(msn);
+        ack_scaled_window.ackMSN(msn);
+        window_size_window.ackMSN(msn);
+        ttl_window.ackMSN(msn);
+        tsval_window.ackMSN(msn);
+        tsecr_window.ackMSN(msn);
+    }
+
+    void CTCPProfile::NackMsn(uint16_t fbMSN) {
+        TrimWindows(AckedMSN(fbMSN, 14));
+        numberOfIRPacketsSinceReset = numberOfFOPacketsSinceReset = 0;
+        state = IR_State;
+    }
+
+    void CTCPProfile::StaticNackMsn(uint16_t fbMSN) {
+        NackMsn(fbMSN);
+        static_chain_known = false;
     }
-    
-    void CTCPProfile::StaticNackMsn(uint16_t /*fbMSN*/) {
-        
+
+    size_t CTCPProfile::HeaderSize(const iphdr* ip) const {
+        return IPHeaderSize(ip) + NextHeader<tcphdr>(ip)->dataOffset * 4;
     }
-    
+
     void CTCPProfile::Compress(const data_t &data, data_t &output) {
-        size_t outputInSize = output.size();
         const iphdr* ip = reinterpret_cast<const iphdr*>(&data[0]);
-        const tcphdr* tcp = reinterpret_cast<const tcphdr*>(ip+ip->ihl*4);
-        
+        const tcphdr* tcp = NextHeader<tcphdr>(ip);
+        const unsigned minSize = static_cast<unsigned>(IPHeaderSize(ip) + sizeof(tcphdr));
+        if ((data.size() < minSize) || (data.size() < HeaderSize(ip))) {
+            error("Received packet less than %u bytes for profile %x", minSize, ID());
+            return;
+        }
+
+        size_t outputInSize = output.size();
+        size_t payloadSize = data.size() - HeaderSize(ip);
+
         UpdateIpIdOffset(ip);
-        
+        UpdateAckStride(rohc_htonl(tcp->ackNumber));
+
+        // The base headers can only carry one of RST, SYN and FIN
+        if (!RsfIndexPossible(RsfFlags(tcp))) {
+            numberOfIRPacketsSinceReset = numberOfFOPacketsSinceReset = 0;
+            state = IR_State;
+        }
+
+        if (!PrepareOptionList(tcp, IR_State == state)) {
+            error("TCP options of profile %x cannot be compressed", ID());
+            return;
+        }
+
         if (IR_State == state)
         {
             CreateIR(ip, tcp, output);
         }
         else
         {
-            CreateCO(ip, tcp, output);
+            CreateCO(ip, tcp, payloadSize, output);
         }
-        
+
         UpdateIpInformation(ip);
-        
+        UpdateTcpInformation(ip, tcp, payloadSize);
+
         AdvanceState(false, false);
         increaseMsn();
         // Append payload
-        // TODO, handle TCP options
-        output.insert(output.end(), data.begin() + sizeof(iphdr) + sizeof(tcphdr), data.end());
-        
+        output.insert(output.end(), data.begin() + HeaderSize(ip), data.end());
+
         ++numberOfPacketsSent;
         dataSizeCompressed += output.size() - outputInSize;
         dataSizeUncompressed += data.size();
-        
     }
-    
+
+    void CTCPProfile::UpdateAckStride(uint32_t ack) {
+        uint32_t delta = ack - rohc_htonl(last_tcp.ackNumber);
+        if (!delta || (delta > 0xffff))
+            return;
+
+        if ((delta == last_ack_delta) &&
+            (!ack_stride || (delta % ack_stride)))
+        {
+            ack_stride = static_cast<uint16_t>(delta);
+            ack_scaled_packets = 0;
+            number_of_packets_with_new_ack_stride_to_send = 5;
+        }
+        last_ack_delta = delta;
+    }
+
+    bool CTCPProfile::SeqScalingPossible(uint32_t seq, size_t payloadSize) const {
+        return payloadSize &&
+            (payloadSize == payload_size) &&
+            (seq % payloadSize == seq_residue) &&
+            (seq_scaled_packets >= tcpWindowSize);
+    }
+
+    bool CTCPProfile::AckScalingPossible(uint32_t ack) const {
+        return ack_stride &&
+            (ack % ack_stride == ack_residue) &&
+            (ack_scaled_packets >= tcpWindowSize) &&
+            !number_of_packets_with_new_ack_stride_to_send;
+    }
+
+    void CTCPProfile::UpdateTcpInformation(const iphdr* ip, const tcphdr* tcp, size_t payloadSize) {
+        uint32_t seq = rohc_htonl(tcp->sequenceNumber);
+        uint32_t ack = rohc_htonl(tcp->ackNumber);
+
+        if (payloadSize && (payloadSize == payload_size) && (seq % payloadSize == seq_residue))
+            ++seq_scaled_packets;
+        else
+            seq_scaled_packets = payloadSize ? 1 : 0;
+        payload_size = payloadSize;
+        if (payloadSize) {
+            seq_residue = static_cast<uint32_t>(seq % payloadSize);
+            seq_scaled_window.add(msn, static_cast<uint32_t>(seq / payloadSize));
+        }
+
+        if (ack_stride) {
+            if (ack % ack_stride == ack_residue)
+                ++ack_scaled_packets;
+            else
+                ack_scaled_packets = 1;
+            ack_residue = ack % ack_stride;
+            ack_scaled_window.add(msn, ack / ack_stride);
+        }
+
+        seq_window.add(msn, seq);
+        ack_window.add(msn, ack);
+        window_size_window.add(msn, rohc_htons(tcp->windowSize));
+        ttl_window.add(msn, TtlHopl(ip));
+
+        ecn_used = EcnUsed(ip, tcp);
+        memcpy(&last_tcp, tcp, sizeof(last_tcp));
+
+        UpdateOptionContext(IR_State == state);
+    }
+
+    bool CTCPProfile::OptionsCompressible(const tcphdr* tcp, size_t size) {
+        size_t headerSize = tcp->dataOffset * 4;
+        if ((headerSize < sizeof(tcphdr)) || (headerSize > size))
+            return false;
+
+        TCPOptionItem items[maxTCPOptionListSize];
+        unsigned int count;
+        if (!SplitTCPOptions(reinterpret_cast<const uint8_t*>(tcp + 1), headerSize - sizeof(tcphdr), items, count))
+            return false;
+
+        // Options without a reserved index, or a second one of a kind,
+        // need a generic index each
+        bool used[tcpOptionTableSize] = {false};
+        unsigned int generic = 0;
+        for (unsigned int i = 0; i < count; ++i) {
+            unsigned int index = ReservedTableIndex(items[i].Kind());
+            if ((index < tcpOptionTableSize) &&
+                (!used[index] || (ReservedTableIndexs::OPT_NOP == index)))
+                used[index] = true;
+            else
+                ++generic;
+        }
+        return generic <= tcpOptionTableSize - firstGenericTableIndex;
+    }
+
+    /*
+     Reserved kinds have their own index, a NOP can be in a list more
+     than once, the other items once. The X flag is set for an item the
+     table does not have yet, one defined in the last listRepetitions
+     packets, and one that changed, except for timestamps that fit
+     tcp_opt_ts_lsb and SACK blocks, they are in the irregular chain.
+     */
+    bool CTCPProfile::PrepareOptionList(const tcphdr* tcp, bool ir) {
+        const uint8_t* options = reinterpret_cast<const uint8_t*>(tcp + 1);
+        if (!SplitTCPOptions(options, tcp->dataOffset * 4 - sizeof(tcphdr), option_items, option_count))
+            return false;
+
+        bool used[tcpOptionTableSize] = {false};
+        option_list_present = ir ||
+            (option_count != option_context.listSize) ||
+            (number_of_packets_with_new_list_to_send > 0);
+
+        for (unsigned int i = 0; i < option_count; ++i) {
+            const TCPOptionItem& item = option_items[i];
+            unsigned int index = ReservedTableIndex(item.Kind());
+            if ((index < tcpOptionTableSize) && used[index] && (ReservedTableIndexs::OPT_NOP != index))
+                index = tcpOptionTableSize;
+            if (index == tcpOptionTableSize) {
+                index = GenericTableIndex(item, used);
+                if (index == tcpOptionTableSize)
+                    return false;
+            }
+            used[index] = true;
+            option_index[i] = static_cast<uint8_t>(index);
+
+            if ((i < option_context.listSize) && (option_context.list[i] != index))
+                option_list_present = true;
+
+            const TCPOptionItem& entry = option_context.table[index];
+            bool x;
+            if (ir || !entry.size || (entry.Kind() != item.Kind()) || option_repetitions[index])
+                x = true;
+            else if (ReservedTableIndexs::OPT_TIMESTAMP == index)
+                x = !TsLsbPossible(item);
+            else if (ReservedTableIndexs::OPT_SACK == index)
+                x = false;
+            else
+                x = entry != item;
+
+            option_x[i] = x;
+            if (x)
+                option_list_present = true;
+        }
+        return true;
+    }
+
+    /*
+     The generic entry with the same kind, an unused one, or the first
+     one that is not in this list
+     */
+    unsigned int CTCPProfile::GenericTableIndex(const TCPOptionItem& item, const bool* used) const {
+        unsigned int unused = tcpOptionTableSize;
+        unsigned int replace = tcpOptionTableSize;
+        for (unsigned int index = firstGenericTableIndex; index < tcpOptionTableSize; ++index) {
+            if (used[index])
+                continue;
+            const TCPOptionItem& entry = option_context.table[index];
+            if (entry.size && (entry.Kind() == item.Kind()))
+                return index;
+            if (!entry.size && (tcpOptionTableSize == unused))
+                unused = index;
+            if (tcpOptionTableSize == replace)
+                replace = index;
+        }
+        return (tcpOptionTableSize != unused) ? unused : replace;
+    }
+
+    bool CTCPProfile::TsLsbPossible(const TCPOptionItem& item) const {
+        return ts_lsb_size(tsval_window, TsVal(item)) && ts_lsb_size(tsecr_window, TsEcr(item));
+    }
+
+    void CTCPProfile::UpdateOptionContext(bool ir) {
+        bool newList = (option_count != option_context.listSize);
+        if (ir) {
+            option_context.Clear();
+            memset(option_repetitions, 0, sizeof(option_repetitions));
+            number_of_packets_with_new_list_to_send = 0;
+        }
+
+        for (unsigned int i = 0; i < option_count; ++i) {
+            const TCPOptionItem& item = option_items[i];
+            unsigned int index = option_index[i];
+            TCPOptionItem& entry = option_context.table[index];
+
+            if (!ir && option_x[i]) {
+                bool irregular = (ReservedTableIndexs::OPT_TIMESTAMP == index) ||
+                    (ReservedTableIndexs::OPT_SACK == index);
+                if (!entry.size || (entry.Kind() != item.Kind()) || (!irregular && (entry != item)))
+                    option_repetitions[index] = listRepetitions - 1;
+                else if (option_repetitions[index] > 0)
+                    --option_repetitions[index];
+            }
+            entry = item;
+
+            if (ReservedTableIndexs::OPT_TIMESTAMP == index) {
+                tsval_window.add(msn, TsVal(item));
+                tsecr_window.add(msn, TsEcr(item));
+            }
+
+            if ((i < option_context.listSize) && (option_context.list[i] != index))
+                newList = true;
+            option_context.list[i] = static_cast<uint8_t>(index);
+        }
+        option_context.listSize = option_count;
+
+        if (ir)
+            return;
+        if (newList)
+            number_of_packets_with_new_list_to_send = listRepetitions - 1;
+        else if (number_of_packets_with_new_list_to_send > 0)
+            --number_of_packets_with_new_list_to_send;
+    }
+
     void CTCPProfile::CreateIR(const ROHC::iphdr *ip, const ROHC::tcphdr *tcp, data_t &output) {
         size_t headerStartIdx = output.size();
-        
+
         if (!largeCID && cid)
         {
             output.push_back(CreateShortCID(cid));
         }
-        
-        output.push_back(IRv2Packet);
-        
+
+        bool irDyn = static_chain_known;
+        output.push_back(irDyn ? IR_DYNPacket : IRv2Packet);
+
         if (largeCID)
         {
             SDVLEncode(back_inserter(output), cid);
         }
-        
+
         output.push_back(static_cast<uint8_t>(ProfileID()));
-        
+
         size_t crcPos = output.size();
-        
+
         // Add zero crc for now
         output.push_back(0);
-        
-        create_ipv4_static(ip, output);
-        
-        create_tcp_static(tcp, output);
-        
-        create_ipv4_regular_innermost_dynamic(ip, output);
-        
-        //create_tcp_dynamic(msn, reorder_ratio, udp, output);
-        
+
+        if (!irDyn)
+        {
+            // The innermost_ip bit of RFC 5225 is reserved in RFC 6846
+            size_t ipStaticIdx = output.size();
+            create_ip_static(ip, output);
+            output[ipStaticIdx] &= 0xbf;
+
+            create_tcp_static(tcp, output);
+        }
+
+        create_ip_regular_dynamic(ip, output);
+
+        create_tcp_dynamic(ip, tcp, output);
+
+        header_crc.SetStatic(ip, 4); // ports
+
         // Calculate CRC
         uint8_t crc = CRC8(output.begin() + headerStartIdx, output.end());
         output[crcPos] = crc;
-        
-		IncreasePacketCount(PT_IR);
-        
+
+		IncreasePacketCount(irDyn ? PT_IR_DYN : PT_IR);
+
         ++numberOfIRPacketsSent;
         ++numberOfIRPacketsSinceReset;
     }
-    
-    void CTCPProfile::CreateCO(const ROHC::iphdr */*ip*/, const ROHC::tcphdr */*tcp*/, data_t &/*output*/) {
-        
+
+    /*
+     The base header is followed by the irregular chain, as for the
+     ROHCv2 profiles (see CIPProfile::CreateCO).
+
+     Fields a format does not carry are static, they have to be the
+     same in all references, the ones it carries have to fit the
+     lsb(k, p) of the format with all references. The ack_flag,
+     urg_flag, urg_ptr, df and dscp are only carried by co_common,
+     rsf_flags, ttl_hopl, ecn_used and the option list also by seq_8
+     and rnd_8.
+     */
+    void CTCPProfile::CreateCO(const ROHC::iphdr *ip, const ROHC::tcphdr *tcp, size_t payloadSize, data_t &output) {
+        data_t baseheader;
+
+        header_crc.Calculate(ip, HeaderSize(ip), header_crc3, header_crc7);
+
+        uint32_t seq = rohc_htonl(tcp->sequenceNumber);
+        uint32_t ack = rohc_htonl(tcp->ackNumber);
+
+        bool seq_static = seq_window.fits(seq, 0, 0);
+        bool ack_static = ack_window.fits(ack, 0, 0);
+        bool window_static = window_size_window.fits(rohc_htons(tcp->windowSize), 0, 0);
+
+        uint32_t seqScaled = payloadSize ? static_cast<uint32_t>(seq / payloadSize) : 0;
+        bool seq_scaled = SeqScalingPossible(seq, payloadSize) &&
+            seq_scaled_window.fits(seqScaled, 4, 7);
+        uint32_t ackScaled = ack_stride ? ack / ack_stride : 0;
+        bool ack_scaled = AckScalingPossible(ack) &&
+            ack_scaled_window.fits(ackScaled, 4, 3);
+
+        bool co_common = (SO_State != state) ||
+            ((TosTc(ip) >> 2) != (last_ip.tos >> 2)) ||
+            DFChanged(ip) ||
+            (tcp->URG != last_tcp.URG) ||
+            (tcp->ACK != last_tcp.ACK) ||
+            (tcp->urgPtr != last_tcp.urgPtr);
+
+        bool ecn_used_now = EcnUsed(ip, tcp);
+        bool formats_8 = RsfFlags(tcp) ||
+            !ttl_window.fits(TtlHopl(ip), 0, 0) ||
+            (ecn_used_now != ecn_used) ||
+            option_list_present;
+
+        bool small = !co_common && !formats_8 && window_static;
+
+        if ((IP_ID_BEHAVIOUR_RANDOM == ip_id_behaviour) ||
+            (IP_ID_BEHAVIOUR_ZERO == ip_id_behaviour))
+        {
+            if (small && seq_scaled && ack_static)
+            {
+                create_rnd_2(tcp, seqScaled, baseheader);
+            }
+            else if (small && ack_scaled && seq_static)
+            {
+                create_rnd_4(tcp, ackScaled, baseheader);
+            }
+            else if (small && seq_static && ack_window.fits(ack, 15, 8191))
+            {
+                create_rnd_3(tcp, baseheader);
+            }
+            else if (small && ack_static && seq_window.fits(seq, 18, 65535))
+            {
+                create_rnd_1(tcp, baseheader);
+            }
+            else if (small && seq_scaled && ack_window.fits(ack, 16, 16383))
+            {
+                create_rnd_6(tcp, seqScaled, baseheader);
+            }
+            else if (small && seq_window.fits(seq, 14, 8191) && ack_window.fits(ack, 15, 8191))
+            {
+                create_rnd_5(tcp, baseheader);
+            }
+            else if (!co_common && !formats_8 && seq_static && ack_window.fits(ack, 18, 65535))
+            {
+                create_rnd_7(tcp, baseheader);
+            }
+            else if (!co_common && window_static &&
+                     ttl_window.fits(TtlHopl(ip), 3, 3) &&
+                     seq_window.fits(seq, 16, 65535) &&
+                     ack_window.fits(ack, 16, 16383))
+            {
+                create_rnd_8(ip, tcp, baseheader);
+            }
+            else
+            {
+                create_co_common(ip, tcp, baseheader);
+            }
+        }
+        else
+        {
+            if (small && ack_scaled && seq_static && IpIdOffsetFits(3, 1))
+            {
+                create_seq_4(tcp, ackScaled, baseheader);
+            }
+            else if (small && seq_scaled && ack_static && IpIdOffsetFits(7, 3))
+            {
+                create_seq_2(tcp, seqScaled, baseheader);
+            }
+            else if (small && ack_static && seq_window.fits(seq, 16, 32767) && IpIdOffsetFits(4, 3))
+            {
+                create_seq_1(tcp, baseheader);
+            }
+            else if (small && seq_static && ack_window.fits(ack, 16, 16383) && IpIdOffsetFits(4, 3))
+            {
+                create_seq_3(tcp, baseheader);
+            }
+            else if (small && seq_scaled && ack_window.fits(ack, 16, 16383) && IpIdOffsetFits(7, 3))
+            {
+                create_seq_6(tcp, seqScaled, baseheader);
+            }
+            else if (small && seq_window.fits(seq, 16, 32767) &&
+                     ack_window.fits(ack, 16, 16383) && IpIdOffsetFits(4, 3))
+            {
+                create_seq_5(tcp, baseheader);
+            }
+            else if (!co_common && !formats_8 && seq_static &&
+                     window_size_window.fits(rohc_htons(tcp->windowSize), 15, 16383) &&
+                     ack_window.fits(ack, 16, 32767) && IpIdOffsetFits(5, 3))
+            {
+                create_seq_7(tcp, baseheader);
+            }
+            else if (!co_common && window_static &&
+                     ttl_window.fits(TtlHopl(ip), 3, 3) &&
+                     seq_window.fits(seq, 14, 8191) &&
+                     ack_window.fits(ack, 15, 8191) && IpIdOffsetFits(4, 3))
+            {
+                create_seq_8(ip, tcp, baseheader);
+            }
+            else
+            {
+                create_co_common(ip, tcp, baseheader);
+            }
+        }
+
+        if (!largeCID && cid)
+        {
+            output.push_back(CreateShortCID(cid));
+        }
+
+        output.push_back(baseheader[0]);
+
+        if (largeCID)
+        {
+            SDVLEncode(back_inserter(output), cid);
+        }
+
+        output.insert(output.end(), baseheader.begin() + 1, baseheader.end());
+
+        create_ip_innermost_irregular(ip, output);
+        create_tcp_irregular(ip, tcp, output);
+
+        if (FO_State == state) {
+            ++numberOfFOPacketsSent;
+            ++numberOfFOPacketsSinceReset;
+        }
+        else {
+            ++numberOfSOPacketsSent;
+        }
     }
-    
-    void CTCPProfile::AdvanceState(bool /*calledFromFeedback*/, bool /*ack*/) {
-        
+
+    void CTCPProfile::AdvanceState(bool calledFromFeedback, bool ack) {
+        if (IR_State == state)
+        {
+            if (calledFromFeedback && ack)
+            {
+                state = FO_State;
+            }
+            else if (numberOfIRPacketsSinceReset >= compressor->NumberOfIRPacketsToSend())
+                state = FO_State;
+
+            if (FO_State == state)
+                static_chain_known = true;
+        }
+        else if (FO_State == state)
+        {
+            if (calledFromFeedback && ack)
+            {
+                state = SO_State;
+            }
+            else if (numberOfFOPacketsSinceReset >= compressor->NumberOfFOPacketsToSend())
+                state = SO_State;
+        }
     }
-    
+
+    /*
+     COMPRESSED tcp_static {
+     src_port =:= irregular(16) [ 16 ];
+     dst_port =:= irregular(16) [ 16 ];
+     }
+     */
     void CTCPProfile::create_tcp_static(const ROHC::tcphdr *tcp, data_t &output) {
         AppendData(output, tcp->source);
         AppendData(output, tcp->dest);
     }
-    
+
     /**
      COMPRESSED tcp_dynamic {
      ecn_used =:= one_bit_choice [ 1 ];
@@ -140,46 +742,616 @@ namespace ROHC {
        static_or_irreg(ack_stride_flag.CVALUE, 16) [ 0, 16 ];
      options =:= list_tcp_options [ VARIABLE ];
      }
-     
+
      */
-    
-    void CTCPProfile::create_tcp_dynamic(const ROHC::tcphdr *tcp, data_t &output) {
-        uint8_t ecn_ackStride_ackZero_urpZero_res  = 0;
-        
-        // ecn_used
-        if (tcp->ECE) {
+    void CTCPProfile::create_tcp_dynamic(const ROHC::iphdr *ip, const ROHC::tcphdr *tcp, data_t &output) {
+        uint8_t ecn_ackStride_ackZero_urpZero_res = ResFlags(tcp);
+
+        if (EcnUsed(ip, tcp)) {
             ecn_ackStride_ackZero_urpZero_res |= 0x80;
         }
-        
-        // ack_stride_flag
-        
-        // ack_zero
-        if (tcp->ACK && tcp->ackNumber) {
+
+        if (ack_stride) {
+            ecn_ackStride_ackZero_urpZero_res |= 0x40;
+        }
+
+        if (!tcp->ackNumber) {
             ecn_ackStride_ackZero_urpZero_res |= 0x20;
         }
-        
-        // urp_zero
-        if (tcp->URG && tcp->urgPtr) {
+
+        if (!tcp->urgPtr) {
             ecn_ackStride_ackZero_urpZero_res |= 0x10;
         }
-        
-        ecn_ackStride_ackZero_urpZero_res |= tcp->reserved;
-        
+
         output.push_back(ecn_ackStride_ackZero_urpZero_res);
-        
-        AppendData(output, msn);
+        // tcp_ecn_flags, urg_flag, ack_flag, psh_flag and rsf_flags
+        output.push_back(reinterpret_cast<const uint8_t*>(tcp)[13]);
+
+        AppendDataToNBO(output, msn);
         AppendData(output, tcp->sequenceNumber);
-        
-        if (tcp->ACK && tcp->ackNumber) {
+
+        if (tcp->ackNumber) {
             AppendData(output, tcp->ackNumber);
         }
-        
+
         AppendData(output, tcp->windowSize);
 
         AppendData(output, tcp->check);
-        
-        if (tcp->URG && tcp->urgPtr) {
+
+        if (tcp->urgPtr) {
             AppendData(output, tcp->urgPtr);
         }
+
+        if (ack_stride) {
+            AppendDataToNBO(output, ack_stride);
+            if (number_of_packets_with_new_ack_stride_to_send > 0)
+                --number_of_packets_with_new_ack_stride_to_send;
+        }
+
+        create_list_tcp_options(tcp, output);
+    }
+
+    /*
+     COMPRESSED tcp_irregular {
+     ip_ecn_flags =:= tcp_irreg_ip_ecn(ip_inner_ecn) [ 0, 2 ];
+     rsf_flags =:= tcp_irreg_rsf_flags(ecn_used.CVALUE) [ 0, 4 ];
+     tcp_ecn_flags =:= static_or_irreg(ecn_used.CVALUE, 2) [ 0, 2 ];
+     checksum =:= irregular(16) [ 16 ];
+     options =:= list_tcp_options_irregular [ VARIABLE ];
+     }
+
+     The ECN bits are sent as one octet when ecn_used, the reserved
+     flags in the middle.
+     */
+    void CTCPProfile::create_tcp_irregular(const ROHC::iphdr *ip, const ROHC::tcphdr *tcp, data_t &output) {
+        if (EcnUsed(ip, tcp)) {
+            output.push_back(static_cast<uint8_t>(((TosTc(ip) & 3) << 6) |
+                                                  (ResFlags(tcp) << 2) |
+                                                  EcnFlags(tcp)));
+        }
+        AppendData(output, tcp->check);
+        create_tcp_options_irregular(tcp, output);
+    }
+
+    /*
+     COMPRESSED list_tcp_options {
+     reserved =:= compressed_value(3, 0) [ 3 ];
+     PS =:= irregular(1) [ 1 ];
+     m =:= irregular(4) [ 4 ];
+     XI_list =:= irregular(m * (4 + PS * 4)) [ VARIABLE ];
+     padding =:= optional_padding(PS, m) [ VARIABLE ];
+     item_list =:= compressed_items [ VARIABLE ];
+     }
+
+     A 4 bit XI is X and a 3 bit index, an 8 bit XI is X, 3 reserved
+     bits and a 4 bit index.
+     */
+    void CTCPProfile::create_list_tcp_options(const ROHC::tcphdr *tcp, data_t &output) {
+        bool ps = false;
+        for (unsigned int i = 0; i < option_count; ++i) {
+            if (option_index[i] >= 8)
+                ps = true;
+        }
+
+        output.push_back(static_cast<uint8_t>((ps << 4) | option_count));
+        if (ps) {
+            for (unsigned int i = 0; i < option_count; ++i)
+                output.push_back(static_cast<uint8_t>((option_x[i] << 7) | option_index[i]));
+        }
+        else {
+            for (unsigned int i = 0; i < option_count; i += 2) {
+                uint8_t xi = static_cast<uint8_t>(((option_x[i] << 3) | option_index[i]) << 4);
+                if (i + 1 < option_count)
+                    xi |= static_cast<uint8_t>((option_x[i + 1] << 3) | option_index[i + 1]);
+                output.push_back(xi);
+            }
+        }
+
+        uint32_t ack = rohc_htonl(tcp->ackNumber);
+        for (unsigned int i = 0; i < option_count; ++i) {
+            if (option_x[i])
+                create_tcp_option_item(option_index[i], option_items[i], ack, output);
+        }
+    }
+
+    /*
+     The list items by table index: nothing for NOP and SACK permitted,
+     pad_len for EOL, the value for MSS and window scale, TSval and TSecr,
+     the length and blocks of SACK, and type, length and contents for the
+     generic indexes.
+
+     The start of a SACK block is relative to the ack number, its end to
+     its start.
+     */
+    void CTCPProfile::create_tcp_option_item(unsigned int index, const TCPOptionItem& item, uint32_t ack, data_t &output) {
+        switch (index) {
+            case ReservedTableIndexs::OPT_NOP:
+            case ReservedTableIndexs::OPT_SACK_PERMITTED:
+                break;
+            case ReservedTableIndexs::OPT_EOL:
+                output.push_back(static_cast<uint8_t>(item.size - 1));
+                break;
+            case ReservedTableIndexs::OPT_MSS:
+            case ReservedTableIndexs::OPT_WINDOW_SCALE:
+            case ReservedTableIndexs::OPT_TIMESTAMP:
+                output.insert(output.end(), item.data + 2, item.data + item.size);
+                break;
+            case ReservedTableIndexs::OPT_SACK:
+                output.push_back(item.size);
+                for (size_t pos = 2; pos < item.size; pos += 8) {
+                    uint32_t start = OptionU32(item, pos);
+                    uint32_t end = OptionU32(item, pos + 4);
+                    sack_var_length_enc(start - ack, output);
+                    sack_var_length_enc(end - start, output);
+                }
+                break;
+            default:
+                // option_static = 0
+                output.insert(output.end(), item.data, item.data + item.size);
+                break;
+        }
+    }
+
+    /*
+     COMPRESSED tcp_opt_ts irregular {
+     tsval =:= tcp_opt_ts_lsb [ 8, 16, 24, 32 ];
+     tsecho =:= tcp_opt_ts_lsb [ 8, 16, 24, 32 ];
+     }
+
+     COMPRESSED tcp_opt_sack irregular {
+     discriminator =:= '00000000' | tcp_opt_sack [ 8, VARIABLE ];
+     }
+     */
+    void CTCPProfile::create_tcp_options_irregular(const ROHC::tcphdr *tcp, data_t &output) {
+        for (unsigned int i = 0; i < option_count; ++i) {
+            if (option_x[i])
+                continue;
+
+            const TCPOptionItem& item = option_items[i];
+            if (ReservedTableIndexs::OPT_TIMESTAMP == option_index[i]) {
+                ts_lsb_enc(ts_lsb_size(tsval_window, TsVal(item)), TsVal(item), output);
+                ts_lsb_enc(ts_lsb_size(tsecr_window, TsEcr(item)), TsEcr(item), output);
+            }
+            else if (ReservedTableIndexs::OPT_SACK == option_index[i]) {
+                if (item == option_context.table[option_index[i]])
+                    output.push_back(0);
+                else
+                    create_tcp_option_item(option_index[i], item, rohc_htonl(tcp->ackNumber), output);
+            }
+        }
+    }
+
+    bool CTCPProfile::EcnUsed(const ROHC::iphdr *ip, const ROHC::tcphdr *tcp) const {
+        return ecn_used || (TosTc(ip) & 3) || ResFlags(tcp) || EcnFlags(tcp);
+    }
+
+    uint8_t CTCPProfile::msn_psh_crc3(const ROHC::tcphdr *tcp) const {
+        return static_cast<uint8_t>(((msn & 0x0f) << 4) | (tcp->PSH << 3) | header_crc3);
+    }
+
+    /*
+     COMPRESSED co_common {
+     discriminator =:= '1111101' [ 7 ];
+     ack_flag =:= irregular(1) [ 1 ];
+     psh_flag =:= irregular(1) [ 1 ];
+     rsf_flags =:= rsf_index_enc [ 2 ];
+     msn =:= lsb(4, 4) [ 4 ];
+     seq_indicator =:= irregular(2) [ 2 ];
+     ack_indicator =:= irregular(2) [ 2 ];
+     ack_stride_indicator =:= irregular(1) [ 1 ];
+     window_indicator =:= irregular(1) [ 1 ];
+     ip_id_indicator =:= irregular(1) [ 1 ];
+     urg_ptr_present =:= irregular(1) [ 1 ];
+     reserved =:= compressed_value(1, 0) [ 1 ];
+     ecn_used =:= one_bit_choice [ 1 ];
+     dscp_present =:= irregular(1) [ 1 ];
+     ttl_hopl_present =:= irregular(1) [ 1 ];
+     list_present =:= irregular(1) [ 1 ];
+     ip_id_behavior =:= irregular(2) [ 2 ];
+     urg_flag =:= irregular(1) [ 1 ];
+     df =:= dont_fragment(version.UVALUE) [ 1 ];
+     header_crc =:= crc7(THIS.UVALUE,THIS.ULENGTH) [ 7 ];
+     seq_number =:= variable_length_32_enc(seq_indicator.CVALUE) [ 0, 8, 16, 32 ];
+     ack_number =:= variable_length_32_enc(ack_indicator.CVALUE) [ 0, 8, 16, 32 ];
+     ack_stride =:= static_or_irreg(ack_stride_indicator.CVALUE, 16) [ 0, 16 ];
+     window =:= static_or_irreg(window_indicator.CVALUE, 16) [ 0, 16 ];
+     ip_id =:= optional_ip_id_lsb(ip_id_behavior.UVALUE, ip_id_indicator.CVALUE) [ 0, 8, 16 ];
+     urg_ptr =:= static_or_irreg(urg_ptr_present.CVALUE, 16) [ 0, 16 ];
+     dscp =:= dscp_enc(dscp_present.CVALUE) [ 0, 8 ];
+     ttl_hopl =:= static_or_irreg(ttl_hopl_present.CVALUE, 8) [ 0, 8 ];
+     options =:= tcp_list_presence_enc(list_present.CVALUE) [ VARIABLE ];
+     }
+
+     The discriminator is sent as the octet 0xfa, the 7 bits of the
+     RFC followed by ack_flag would collide with CORepairPacket.
+     */
+    void CTCPProfile::create_co_common(const ROHC::iphdr *ip, const ROHC::tcphdr *tcp, data_t &baseheader) {
+		IncreasePacketCount(PT_CO_COMMON);
+        baseheader.reserve(24);
+
+        uint32_t seq = rohc_htonl(tcp->sequenceNumber);
+        uint32_t ack = rohc_htonl(tcp->ackNumber);
+        unsigned int seq_indicator = variable_length_32_indicator(seq_window, seq);
+        unsigned int ack_indicator = variable_length_32_indicator(ack_window, ack);
+        bool ack_stride_indicator = number_of_packets_with_new_ack_stride_to_send > 0;
+        bool window_indicator = !window_size_window.fits(rohc_htons(tcp->windowSize), 0, 0);
+        bool sequential = (IP_ID_BEHAVIOUR_SEQUENTIAL == ip_id_behaviour) ||
+            (IP_ID_BEHAVIOUR_SEQUENTIAL_SWAPPED == ip_id_behaviour);
+        bool ip_id_indicator = sequential && !IpIdOffsetFits(8, 3);
+        bool urg_ptr_present = tcp->urgPtr != last_tcp.urgPtr;
+        bool dscp_present = ((TosTc(ip) >> 2) != (last_ip.tos >> 2)) ||
+            (number_of_packets_with_new_ip_fields_to_send > 0);
+        bool ttl_hopl_present = !ttl_window.fits(TtlHopl(ip), 0, 0);
+        bool ecn_used_now = EcnUsed(ip, tcp);
+
+        baseheader.push_back(0xfa);
+        baseheader.push_back(static_cast<uint8_t>((tcp->ACK << 7) |
+                                                  (tcp->PSH << 6) |
+                                                  (RsfIndex(RsfFlags(tcp)) << 4) |
+                                                  (msn & 0x0f)));
+        baseheader.push_back(static_cast<uint8_t>((seq_indicator << 6) |
+                                                  (ack_indicator << 4) |
+                                                  (ack_stride_indicator << 3) |
+                                                  (window_indicator << 2) |
+                                                  (ip_id_indicator << 1) |
+                                                  urg_ptr_present));
+        baseheader.push_back(static_cast<uint8_t>((ecn_used_now << 6) |
+                                                  (dscp_present << 5) |
+                                                  (ttl_hopl_present << 4) |
+                                                  (option_list_present << 3) |
+                                                  ((ip_id_behaviour & 3) << 1) |
+                                                  tcp->URG));
+        baseheader.push_back(static_cast<uint8_t>((DontFragment(ip) << 7) | (header_crc7 & 0x7f)));
+
+        variable_length_32_enc(seq_indicator, seq, baseheader);
+        variable_length_32_enc(ack_indicator, ack, baseheader);
+
+        if (ack_stride_indicator)
+        {
+            AppendDataToNBO(baseheader, ack_stride);
+            --number_of_packets_with_new_ack_stride_to_send;
+        }
+
+        if (window_indicator)
+        {
+            AppendData(baseheader, tcp->windowSize);
+        }
+
+        // optional_ip_id_lsb, lsb(8, 3) or the IP-ID itself
+        if (sequential)
+        {
+            if (ip_id_indicator)
+                AppendData(baseheader, ip->id);
+            else
+                baseheader.push_back(static_cast<uint8_t>(IpIdOffset()));
+        }
+
+        if (urg_ptr_present)
+        {
+            AppendData(baseheader, tcp->urgPtr);
+        }
+
+        if (dscp_present)
+        {
+            baseheader.push_back(TosTc(ip) & 0xfc);
+        }
+
+        if (ttl_hopl_present)
+        {
+            baseheader.push_back(TtlHopl(ip));
+        }
+
+        if (option_list_present)
+        {
+            create_list_tcp_options(tcp, baseheader);
+        }
+    }
+
+    /*
+     COMPRESSED rnd_1 {
+     discriminator =:= '101110' [ 6 ];
+     seq_number =:= lsb(18, 65535) [ 18 ];
+     msn =:= lsb(4, 4) [ 4 ];
+     psh_flag =:= irregular(1) [ 1 ];
+     header_crc =:= crc3(THIS.UVALUE, THIS.ULENGTH) [ 3 ];
+     }
+     */
+    void CTCPProfile::create_rnd_1(const ROHC::tcphdr *tcp, data_t &baseheader) {
+		IncreasePacketCount(PT_RND_1);
+        uint32_t seq = rohc_htonl(tcp->sequenceNumber);
+        baseheader.push_back(static_cast<uint8_t>(0xb8 | ((seq >> 16) & 0x03)));
+        AppendDataToNBO(baseheader, static_cast<uint16_t>(seq));
+        baseheader.push_back(msn_psh_crc3(tcp));
+    }
+
+    /*
+     COMPRESSED rnd_2 {
+     discriminator =:= '1100' [ 4 ];
+     seq_number_scaled =:= lsb(4, 7) [ 4 ];
+     msn =:= lsb(4, 4) [ 4 ];
+     psh_flag =:= irregular(1) [ 1 ];
+     header_crc =:= crc3(THIS.UVALUE, THIS.ULENGTH) [ 3 ];
+     }
+     */
+    void CTCPProfile::create_rnd_2(const ROHC::tcphdr *tcp, uint32_t seqScaled, data_t &baseheader) {
+		IncreasePacketCount(PT_RND_2);
+        baseheader.push_back(static_cast<uint8_t>(0xc0 | (seqScaled & 0x0f)));
+        baseheader.push_back(msn_psh_crc3(tcp));
+    }
+
+    /*
+     COMPRESSED rnd_3 {
+     discriminator =:= '0' [ 1 ];
+     ack_number =:= lsb(15, 8191) [ 15 ];
+     msn =:= lsb(4, 4) [ 4 ];
+     psh_flag =:= irregular(1) [ 1 ];
+     header_crc =:= crc3(THIS.UVALUE, THIS.ULENGTH) [ 3 ];
+     }
+     */
+    void CTCPProfile::create_rnd_3(const ROHC::tcphdr *tcp, data_t &baseheader) {
+		IncreasePacketCount(PT_RND_3);
+        uint32_t ack = rohc_htonl(tcp->ackNumber);
+        AppendDataToNBO(baseheader, static_cast<uint16_t>(ack & 0x7fff));
+        baseheader.push_back(msn_psh_crc3(tcp));
+    }
+
+    /*
+     COMPRESSED rnd_4 {
+     discriminator =:= '1101' [ 4 ];
+     ack_number_scaled =:= lsb(4, 3) [ 4 ];
+     msn =:= lsb(4, 4) [ 4 ];
+     psh_flag =:= irregular(1) [ 1 ];
+     header_crc =:= crc3(THIS.UVALUE, THIS.ULENGTH) [ 3 ];
+     }
+     */
+    void CTCPProfile::create_rnd_4(const ROHC::tcphdr *tcp, uint32_t ackScaled, data_t &baseheader) {
+		IncreasePacketCount(PT_RND_4);
+        baseheader.push_back(static_cast<uint8_t>(0xd0 | (ackScaled & 0x0f)));
+        baseheader.push_back(msn_psh_crc3(tcp));
+    }
+
+    /*
+     COMPRESSED rnd_5 {
+     discriminator =:= '100' [ 3 ];
+     psh_flag =:= irregular(1) [ 1 ];
+     msn =:= lsb(4, 4) [ 4 ];
+     header_crc =:= crc3(THIS.UVALUE, THIS.ULENGTH) [ 3 ];
+     seq_number =:= lsb(14, 8191) [ 14 ];
+     ack_number =:= lsb(15, 8191) [ 15 ];
+     }
+     */
+    void CTCPProfile::create_rnd_5(const ROHC::tcphdr *tcp, data_t &baseheader) {
+		IncreasePacketCount(PT_RND_5);
+        uint32_t seq = rohc_htonl(tcp->sequenceNumber);
+        uint32_t ack = rohc_htonl(tcp->ackNumber);
+        baseheader.push_back(static_cast<uint8_t>(0x80 | (tcp->PSH << 4) | (msn & 0x0f)));
+        AppendDataToNBO(baseheader, static_cast<uint32_t>((header_crc3 << 29) |
+                                                          ((seq & 0x3fff) << 15) |
+                                                          (ack & 0x7fff)));
+    }
+
+    /*
+     COMPRESSED rnd_6 {
+     discriminator =:= '1010' [ 4 ];
+     header_crc =:= crc3(THIS.UVALUE, THIS.ULENGTH) [ 3 ];
+     psh_flag =:= irregular(1) [ 1 ];
+     ack_number =:= lsb(16, 16383) [ 16 ];
+     msn =:= lsb(4, 4) [ 4 ];
+     seq_number_scaled =:= lsb(4, 7) [ 4 ];
+     }
+     */
+    void CTCPProfile::create_rnd_6(const ROHC::tcphdr *tcp, uint32_t seqScaled, data_t &baseheader) {
+		IncreasePacketCount(PT_RND_6);
+        baseheader.push_back(static_cast<uint8_t>(0xa0 | (header_crc3 << 1) | tcp->PSH));
+        AppendDataToNBO(baseheader, static_cast<uint16_t>(rohc_htonl(tcp->ackNumber)));
+        baseheader.push_back(static_cast<uint8_t>(((msn & 0x0f) << 4) | (seqScaled & 0x0f)));
+    }
+
+    /*
+     COMPRESSED rnd_7 {
+     discriminator =:= '101111' [ 6 ];
+     ack_number =:= lsb(18, 65535) [ 18 ];
+     window =:= irregular(16) [ 16 ];
+     msn =:= lsb(4, 4) [ 4 ];
+     psh_flag =:= irregular(1) [ 1 ];
+     header_crc =:= crc3(THIS.UVALUE, THIS.ULENGTH) [ 3 ];
+     }
+     */
+    void CTCPProfile::create_rnd_7(const ROHC::tcphdr *tcp, data_t &baseheader) {
+		IncreasePacketCount(PT_RND_7);
+        uint32_t ack = rohc_htonl(tcp->ackNumber);
+        baseheader.push_back(static_cast<uint8_t>(0xbc | ((ack >> 16) & 0x03)));
+        AppendDataToNBO(baseheader, static_cast<uint16_t>(ack));
+        AppendData(baseheader, tcp->windowSize);
+        baseheader.push_back(msn_psh_crc3(tcp));
+    }
+
+    /*
+     COMPRESSED rnd_8 {
+     discriminator =:= '10110' [ 5 ];
+     rsf_flags =:= rsf_index_enc [ 2 ];
+     list_present =:= irregular(1) [ 1 ];
+     header_crc =:= crc7(THIS.UVALUE, THIS.ULENGTH) [ 7 ];
+     msn =:= lsb(4, 4) [ 4 ];
+     psh_flag =:= irregular(1) [ 1 ];
+     ttl_hopl =:= lsb(3, 3) [ 3 ];
+     ecn_used =:= one_bit_choice [ 1 ];
+     seq_number =:= lsb(16, 65535) [ 16 ];
+     ack_number =:= lsb(16, 16383) [ 16 ];
+     options =:= tcp_list_presence_enc(list_present.CVALUE) [ VARIABLE ];
+     }
+     */
+    void CTCPProfile::create_rnd_8(const ROHC::iphdr *ip, const ROHC::tcphdr *tcp, data_t &baseheader) {
+		IncreasePacketCount(PT_RND_8);
+        bool ecn_used_now = EcnUsed(ip, tcp);
+        baseheader.push_back(static_cast<uint8_t>(0xb0 | (RsfIndex(RsfFlags(tcp)) << 1) | option_list_present));
+        baseheader.push_back(static_cast<uint8_t>((header_crc7 << 1) | ((msn >> 3) & 0x01)));
+        baseheader.push_back(static_cast<uint8_t>(((msn & 0x07) << 5) |
+                                                  (tcp->PSH << 4) |
+                                                  ((TtlHopl(ip) & 0x07) << 1) |
+                                                  ecn_used_now));
+        AppendDataToNBO(baseheader, static_cast<uint16_t>(rohc_htonl(tcp->sequenceNumber)));
+        AppendDataToNBO(baseheader, static_cast<uint16_t>(rohc_htonl(tcp->ackNumber)));
+        if (option_list_present)
+            create_list_tcp_options(tcp, baseheader);
+    }
+
+    /*
+     COMPRESSED seq_1 {
+     discriminator =:= '1010' [ 4 ];
+     ip_id =:= ip_id_lsb(ip_id_behavior.UVALUE, 4, 3) [ 4 ];
+     seq_number =:= lsb(16, 32767) [ 16 ];
+     msn =:= lsb(4, 4) [ 4 ];
+     psh_flag =:= irregular(1) [ 1 ];
+     header_crc =:= crc3(THIS.UVALUE, THIS.ULENGTH) [ 3 ];
+     }
+     */
+    void CTCPProfile::create_seq_1(const ROHC::tcphdr *tcp, data_t &baseheader) {
+		IncreasePacketCount(PT_SEQ_1);
+        baseheader.push_back(static_cast<uint8_t>(0xa0 | (IpIdOffset() & 0x0f)));
+        AppendDataToNBO(baseheader, static_cast<uint16_t>(rohc_htonl(tcp->sequenceNumber)));
+        baseheader.push_back(msn_psh_crc3(tcp));
+    }
+
+    /*
+     COMPRESSED seq_2 {
+     discriminator =:= '11010' [ 5 ];
+     ip_id =:= ip_id_lsb(ip_id_behavior.UVALUE, 7, 3) [ 7 ];
+     seq_number_scaled =:= lsb(4, 7) [ 4 ];
+     msn =:= lsb(4, 4) [ 4 ];
+     psh_flag =:= irregular(1) [ 1 ];
+     header_crc =:= crc3(THIS.UVALUE, THIS.ULENGTH) [ 3 ];
+     }
+     */
+    void CTCPProfile::create_seq_2(const ROHC::tcphdr *tcp, uint32_t seqScaled, data_t &baseheader) {
+		IncreasePacketCount(PT_SEQ_2);
+        uint8_t ip_id = IpIdOffset() & 0x7f;
+        baseheader.push_back(static_cast<uint8_t>(0xd0 | (ip_id >> 4)));
+        baseheader.push_back(static_cast<uint8_t>(((ip_id & 0x0f) << 4) | (seqScaled & 0x0f)));
+        baseheader.push_back(msn_psh_crc3(tcp));
+    }
+
+    /*
+     COMPRESSED seq_3 {
+     discriminator =:= '1001' [ 4 ];
+     ip_id =:= ip_id_lsb(ip_id_behavior.UVALUE, 4, 3) [ 4 ];
+     ack_number =:= lsb(16, 16383) [ 16 ];
+     msn =:= lsb(4, 4) [ 4 ];
+     psh_flag =:= irregular(1) [ 1 ];
+     header_crc =:= crc3(THIS.UVALUE, THIS.ULENGTH) [ 3 ];
+     }
+     */
+    void CTCPProfile::create_seq_3(const ROHC::tcphdr *tcp, data_t &baseheader) {
+		IncreasePacketCount(PT_SEQ_3);
+        baseheader.push_back(static_cast<uint8_t>(0x90 | (IpIdOffset() & 0x0f)));
+        AppendDataToNBO(baseheader, static_cast<uint16_t>(rohc_htonl(tcp->ackNumber)));
+        baseheader.push_back(msn_psh_crc3(tcp));
+    }
+
+    /*
+     COMPRESSED seq_4 {
+     discriminator =:= '0' [ 1 ];
+     ack_number_scaled =:= lsb(4, 3) [ 4 ];
+     ip_id =:= ip_id_lsb(ip_id_behavior.UVALUE, 3, 1) [ 3 ];
+     msn =:= lsb(4, 4) [ 4 ];
+     psh_flag =:= irregular(1) [ 1 ];
+     header_crc =:= crc3(THIS.UVALUE, THIS.ULENGTH) [ 3 ];
+     }
+     */
+    void CTCPProfile::create_seq_4(const ROHC::tcphdr *tcp, uint32_t ackScaled, data_t &baseheader) {
+		IncreasePacketCount(PT_SEQ_4);
+        baseheader.push_back(static_cast<uint8_t>(((ackScaled & 0x0f) << 3) | (IpIdOffset() & 0x07)));
+        baseheader.push_back(msn_psh_crc3(tcp));
+    }
+
+    /*
+     COMPRESSED seq_5 {
+     discriminator =:= '1000' [ 4 ];
+     ip_id =:= ip_id_lsb(ip_id_behavior.UVALUE, 4, 3) [ 4 ];
+     ack_number =:= lsb(16, 16383) [ 16 ];
+     seq_number =:= lsb(16, 32767) [ 16 ];
+     msn =:= lsb(4, 4) [ 4 ];
+     psh_flag =:= irregular(1) [ 1 ];
+     header_crc =:= crc3(THIS.UVALUE, THIS.ULENGTH) [ 3 ];
+     }
+     */
+    void CTCPProfile::create_seq_5(const ROHC::tcphdr *tcp, data_t &baseheader) {
+		IncreasePacketCount(PT_SEQ_5);
+        baseheader.push_back(static_cast<uint8_t>(0x80 | (IpIdOffset() & 0x0f)));
+        AppendDataToNBO(baseheader, static_cast<uint16_t>(rohc_htonl(tcp->ackNumber)));
+        AppendDataToNBO(baseheader, static_cast<uint16_t>(rohc_htonl(tcp->sequenceNumber)));
+        baseheader.push_back(msn_psh_crc3(tcp));
+    }
+
+    /*
+     COMPRESSED seq_6 {
+     discriminator =:= '11011' [ 5 ];
+     seq_number_scaled =:= lsb(4, 7) [ 4 ];
+     ip_id =:= ip_id_lsb(ip_id_behavior.UVALUE, 7, 3) [ 7 ];
+     ack_number =:= lsb(16, 16383) [ 16 ];
+     msn =:= lsb(4, 4) [ 4 ];
+     psh_flag =:= irregular(1) [ 1 ];
+     header_crc =:= crc3(THIS.UVALUE, THIS.ULENGTH) [ 3 ];
+     }
+     */
+    void CTCPProfile::create_seq_6(const ROHC::tcphdr *tcp, uint32_t seqScaled, data_t &baseheader) {
+		IncreasePacketCount(PT_SEQ_6);
+        baseheader.push_back(static_cast<uint8_t>(0xd8 | ((seqScaled >> 1) & 0x07)));
+        baseheader.push_back(static_cast<uint8_t>(((seqScaled & 0x01) << 7) | (IpIdOffset() & 0x7f)));
+        AppendDataToNBO(baseheader, static_cast<uint16_t>(rohc_htonl(tcp->ackNumber)));
+        baseheader.push_back(msn_psh_crc3(tcp));
+    }
+
+    /*
+     COMPRESSED seq_7 {
+     discriminator =:= '1100' [ 4 ];
+     window =:= lsb(15, 16383) [ 15 ];
+     ip_id =:= ip_id_lsb(ip_id_behavior.UVALUE, 5, 3) [ 5 ];
+     ack_number =:= lsb(16, 32767) [ 16 ];
+     msn =:= lsb(4, 4) [ 4 ];
+     psh_flag =:= irregular(1) [ 1 ];
+     header_crc =:= crc3(THIS.UVALUE, THIS.ULENGTH) [ 3 ];
+     }
+     */
+    void CTCPProfile::create_seq_7(const ROHC::tcphdr *tcp, data_t &baseheader) {
+		IncreasePacketCount(PT_SEQ_7);
+        uint16_t window = rohc_htons(tcp->windowSize) & 0x7fff;
+        baseheader.push_back(static_cast<uint8_t>(0xc0 | (window >> 11)));
+        baseheader.push_back(static_cast<uint8_t>(window >> 3));
+        baseheader.push_back(static_cast<uint8_t>(((window & 0x07) << 5) | (IpIdOffset() & 0x1f)));
+        AppendDataToNBO(baseheader, static_cast<uint16_t>(rohc_htonl(tcp->ackNumber)));
+        baseheader.push_back(msn_psh_crc3(tcp));
+    }
+
+    /*
+     COMPRESSED seq_8 {
+     discriminator =:= '1011' [ 4 ];
+     ip_id =:= ip_id_lsb(ip_id_behavior.UVALUE, 4, 3) [ 4 ];
+     list_present =:= irregular(1) [ 1 ];
+     header_crc =:= crc7(THIS.UVALUE, THIS.ULENGTH) [ 7 ];
+     msn =:= lsb(4, 4) [ 4 ];
+     psh_flag =:= irregular(1) [ 1 ];
+     ttl_hopl =:= lsb(3, 3) [ 3 ];
+     ecn_used =:= one_bit_choice [ 1 ];
+     ack_number =:= lsb(15, 8191) [ 15 ];
+     rsf_flags =:= rsf_index_enc [ 2 ];
+     seq_number =:= lsb(14, 8191) [ 14 ];
+     options =:= tcp_list_presence_enc(list_present.CVALUE) [ VARIABLE ];
+     }
+     */
+    void CTCPProfile::create_seq_8(const ROHC::iphdr *ip, const ROHC::tcphdr *tcp, data_t &baseheader) {
+		IncreasePacketCount(PT_SEQ_8);
+        bool ecn_used_now = EcnUsed(ip, tcp);
+        baseheader.push_back(static_cast<uint8_t>(0xb0 | (IpIdOffset() & 0x0f)));
+        baseheader.push_back(static_cast<uint8_t>((option_list_present << 7) | (header_crc7 & 0x7f)));
+        baseheader.push_back(static_cast<uint8_t>(((msn & 0x0f) << 4) |
+                                                  (tcp->PSH << 3) |
+                                                  (TtlHopl(ip) & 0x07)));
+        AppendDataToNBO(baseheader, static_cast<uint16_t>((ecn_used_now << 15) |
+                                                          (rohc_htonl(tcp->ackNumber) & 0x7fff)));
+        AppendDataToNBO(baseheader, static_cast<uint16_t>((RsfIndex(RsfFlags(tcp)) << 14) |
+                                                          (rohc_htonl(tcp->sequenceNumber) & 0x3fff)));
+        if (option_list_present)
+            create_list_tcp_options(tcp, baseheader);
     }
-}
+} // ns ROHC
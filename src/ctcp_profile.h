@@ -1,15 +1,31 @@
 #pragma once
 
+/**
+ * TCP/IP profile, RFC 6846
+ */
+
 #include "cprofile.h"
+#include "tcp_profile_supp.h"
 
 namespace ROHC {
+    /**************************************************************************
+     * Compression Profile
+     *
+     * Fields a base header does not carry have to be the same in every
+     * reference of the windows, the ones it carries have to fit against
+     * all of them, so a lost packet does not leave the decompressor with
+     * another value than the compressor assumed.
+     *
+     * The options are compressed as a list, RFC 6846 6.3.3. An unchanged
+     * list is not sent, the timestamps and SACK blocks of its items are
+     * in the irregular chain.
+     **************************************************************************/
     class CTCPProfile : public CProfile {
-    private:
     public:
         CTCPProfile(Compressor* comp, uint16_t cid, const iphdr* ip);
         static uint16_t ProfileID() {return 0x0106;}
         static uint16_t ProtocolID() {return 6;}
-        
+
         /**
          * return the profile ID
          */
@@ -17,32 +33,143 @@ namespace ROHC {
         virtual bool Matches(unsigned int profileID, const iphdr* ip) const;
         virtual void Compress(const data_t& data, data_t& output);
 
+        /**
+         * Whether the options of a segment can be compressed as a list,
+         * size is what the packet has after the IP header
+         */
+        static bool OptionsCompressible(const tcphdr* tcp, size_t size);
+
     protected:
         /**
 		 * called by AckLsbMsn or AckFBMsn with the full MSN that was acked
 		 */
 		virtual void MsnWasAcked(uint16_t ackedMSN);
-        
+		virtual void TrimWindows(uint16_t msn);
+
         /*
 		 * 14 bit MSN
 		 */
 		virtual void NackMsn(uint16_t fbMSN);
-        
+
 		/*
 		 * 14 bit MSN
 		 */
 		virtual void StaticNackMsn(uint16_t fbMSN);
 
     private:
+        size_t HeaderSize(const iphdr* ip) const;
+
         void CreateIR(const iphdr* ip, const tcphdr* tcp, data_t& output);
-        void CreateCO(const iphdr* ip, const tcphdr* tcp, data_t& output);
-        
+        void CreateCO(const iphdr* ip, const tcphdr* tcp, size_t payloadSize, data_t& output);
+
         void create_tcp_static(const tcphdr* tcp, data_t& output);
-        void create_tcp_dynamic(const tcphdr* tcp, data_t& output);
-        
+        void create_tcp_dynamic(const iphdr* ip, const tcphdr* tcp, data_t& output);
+        void create_tcp_irregular(const iphdr* ip, const tcphdr* tcp, data_t& output);
+
+        /**
+         * The compressed list, the items with X set carry their value
+         */
+        void create_list_tcp_options(const tcphdr* tcp, data_t& output);
+        void create_tcp_option_item(unsigned int index, const TCPOptionItem& item, uint32_t ack, data_t& output);
+        /**
+         * The items with X cleared: timestamps as tcp_opt_ts_lsb, SACK
+         * unchanged or in full
+         */
+        void create_tcp_options_irregular(const tcphdr* tcp, data_t& output);
+
+        void create_co_common(const iphdr* ip, const tcphdr* tcp, data_t& baseheader);
+        void create_rnd_1(const tcphdr* tcp, data_t& baseheader);
+        void create_rnd_2(const tcphdr* tcp, uint32_t seqScaled, data_t& baseheader);
+        void create_rnd_3(const tcphdr* tcp, data_t& baseheader);
+        void create_rnd_4(const tcphdr* tcp, uint32_t ackScaled, data_t& baseheader);
+        void create_rnd_5(const tcphdr* tcp, data_t& baseheader);
+        void create_rnd_6(const tcphdr* tcp, uint32_t seqScaled, data_t& baseheader);
+        void create_rnd_7(const tcphdr* tcp, data_t& baseheader);
+        void create_rnd_8(const iphdr* ip, const tcphdr* tcp, data_t& baseheader);
+        void create_seq_1(const tcphdr* tcp, data_t& baseheader);
+        void create_seq_2(const tcphdr* tcp, uint32_t seqScaled, data_t& baseheader);
+        void create_seq_3(const tcphdr* tcp, data_t& baseheader);
+        void create_seq_4(const tcphdr* tcp, uint32_t ackScaled, data_t& baseheader);
+        void create_seq_5(const tcphdr* tcp, data_t& baseheader);
+        void create_seq_6(const tcphdr* tcp, uint32_t seqScaled, data_t& baseheader);
+        void create_seq_7(const tcphdr* tcp, data_t& baseheader);
+        void create_seq_8(const iphdr* ip, const tcphdr* tcp, data_t& baseheader);
+
+        /**
+         * ecn_used once the packet is compressed, it is set by the first
+         * packet with any of the ECN or reserved bits set
+         */
+        bool EcnUsed(const iphdr* ip, const tcphdr* tcp) const;
+
+        /**
+         * The last byte of all formats but co_common, seq_8 and rnd_8
+         */
+        uint8_t msn_psh_crc3(const tcphdr* tcp) const;
+
+        /**
+         * Sets ack_stride when the same ack delta has been seen twice
+         * and the current stride does not divide it
+         */
+        void UpdateAckStride(uint32_t ack);
+
+        /**
+         * Splits the options of the packet into option_items, gives them
+         * table indexes and sets X and option_list_present
+         */
+        bool PrepareOptionList(const tcphdr* tcp, bool ir);
+        unsigned int GenericTableIndex(const TCPOptionItem& item, const bool* used) const;
+        bool TsLsbPossible(const TCPOptionItem& item) const;
+        void UpdateOptionContext(bool ir);
+
+        void UpdateTcpInformation(const iphdr* ip, const tcphdr* tcp, size_t payloadSize);
+
+        /**
+         * The scaled numbers of RFC 6846 6.3.4, once every reference in
+         * the windows has the same payload size (or stride) and residue
+         */
+        bool SeqScalingPossible(uint32_t seq, size_t payloadSize) const;
+        bool AckScalingPossible(uint32_t ack) const;
+
         void AdvanceState(bool calledFromFeedback, bool ack);
-        
+
+        uint16_t sport;
+        uint16_t dport;
+
         tcphdr last_tcp;
-        
+        bool ecn_used;
+
+        // seq_number / payload size
+        size_t payload_size;
+        uint32_t seq_residue;
+        unsigned int seq_scaled_packets;
+
+        // ack_number / ack_stride
+        uint16_t ack_stride;
+        uint32_t ack_residue;
+        unsigned int ack_scaled_packets;
+        uint32_t last_ack_delta;
+        unsigned int number_of_packets_with_new_ack_stride_to_send;
+
+        WLSB<uint32_t> seq_window;
+        WLSB<uint32_t> seq_scaled_window;
+        WLSB<uint32_t> ack_window;
+        WLSB<uint32_t> ack_scaled_window;
+        WLSB<int> window_size_window;
+        WLSB<int> ttl_window;
+
+        // The table and list the decompressor has
+        TCPOptionContext option_context;
+        // Packets an item is still sent with X set after it was defined
+        unsigned int option_repetitions[tcpOptionTableSize];
+        unsigned int number_of_packets_with_new_list_to_send;
+        WLSB<uint32_t> tsval_window;
+        WLSB<uint32_t> tsecr_window;
+
+        // The options of the packet being compressed
+        TCPOptionItem option_items[maxTCPOptionListSize];
+        uint8_t option_index[maxTCPOptionListSize];
+        bool option_x[maxTCPOptionListSize];
+        unsigned int option_count;
+        bool option_list_present;
     };
 } // ns ROHC
@@ -4,7 +4,7 @@
  * UDP/IP profile
  */
 
-#include "cprofile.h"
+#include "cip_profile.h"
 
 namespace ROHC
 {
@@ -12,17 +12,15 @@ namespace ROHC
     /**************************************************************************
      * Compression Profile
      **************************************************************************/
-    class CUDPProfile : public CProfile
+    class CUDPProfile : public CIPProfile
     {
     public:
         CUDPProfile(Compressor* comp, uint16_t cid, const iphdr* ip);
         
-        bool Matches(unsigned int profileID, const iphdr* ip) const;
+        virtual bool Matches(unsigned int profileID, const iphdr* ip) const;
         
         virtual unsigned int ID() const {return ProfileID();}
         
-        virtual void Compress(const data_t& data, data_t& output);
-
     // Statics
     public:
         static uint16_t ProfileID() {return 0x0102;}
@@ -35,34 +33,16 @@ namespace ROHC
         static void create_udp_with_checksum_irregular(const udphdr* udp, data_t& output);
         
     protected:
-		/**
-		 * called by AckLsbMsn or AckFBMsn with the full MSN that was acked
-		 */
-		virtual void MsnWasAcked(uint16_t ackedMSN);
-		/*
-		 * 14 bit MSN
-		 */
-		virtual void NackMsn(uint16_t fbMSN);
-
-		/*
-		 * 14 bit MSN
-		 */
-		virtual void StaticNackMsn(uint16_t fbMSN);
+        virtual size_t HeaderSize(const iphdr* ip) const {return IPHeaderSize(ip) + sizeof(udphdr);}
+        // The ports are static
+        virtual void SetStaticCRC(const iphdr* ip) {header_crc.SetStatic(ip, 4);}
+        virtual void create_static_chain(const iphdr* ip, data_t& output);
+        virtual void create_dynamic_chain(const iphdr* ip, data_t& output);
+        virtual void create_irregular_chain(const iphdr* ip, data_t& output);
 
         static void create_udp_endpoint_dynamic(uint16_t msn, Reordering_t reorder_ratio, const udphdr* udp, data_t& output);
-        void CreateIR(const iphdr* ip, const udphdr* udp, data_t& output);
-        void CreateCO(const iphdr* ip, const udphdr* udp, data_t& output);
-        void create_co_common(const ROHC::iphdr *ip, data_t &output);
         void create_co_repair(const ROHC::iphdr *ip, const ROHC::udphdr *udp, data_t &output);
-        void create_pt_0_crc3(data_t& output);
-        void create_pt_0_crc7(data_t& output);
-        void create_pt_1_seq_id(data_t& output);
-        void create_pt_2_seq_id(data_t& output);
-        
-        uint8_t control_crc3() const;
-        void profile_2_3_4_flags_enc(bool flag, const iphdr* ip, data_t& output);
         
-        void AdvanceState(bool calledFromFeedback, bool ack);
     protected:
         uint16_t sport;
         uint16_t dport;
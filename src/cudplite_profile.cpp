@@ -0,0 +1,104 @@
+#include "cudplite_profile.h"
+#include "network.h"
+#include <rohc/compressor.h>
+
+namespace ROHC
+{
+    /**************************************************************************
+     * Compression Profile
+     **************************************************************************/
+
+    CUDPLiteProfile::CUDPLiteProfile(Compressor* comp, uint16_t cid, const iphdr* ip)
+    : CUDPProfile(comp, cid, ip),
+    coverage_behaviour(UDP_LITE_COVERAGE_INFERRED),
+    coverage(rohc_htons(NextHeader<udphdr>(ip)->len))
+    {
+    }
+
+    void
+    CUDPLiteProfile::Compress(const data_t& data, data_t& output)
+    {
+        const iphdr* ip = reinterpret_cast<const iphdr*>(&data[0]);
+        if ((data.size() >= HeaderSize(ip)) &&
+            UpdateCoverage(NextHeader<udphdr>(ip), data.size() - IPHeaderSize(ip), coverage_behaviour, coverage))
+        {
+            RepairDynamicChain();
+        }
+        CUDPProfile::Compress(data, output);
+    }
+
+    bool
+    CUDPLiteProfile::UpdateCoverage(const udphdr* udp, size_t udpLength, CoverageBehaviour_t& behaviour, uint16_t& coverage)
+    {
+        uint16_t new_coverage = rohc_htons(udp->len);
+        bool inferred = (new_coverage == udpLength);
+        bool fits = (UDP_LITE_COVERAGE_IRREGULAR == behaviour) ||
+            ((UDP_LITE_COVERAGE_INFERRED == behaviour) && inferred) ||
+            ((UDP_LITE_COVERAGE_STATIC == behaviour) && (new_coverage == coverage));
+
+        CoverageBehaviour_t previous = behaviour;
+        if (!fits)
+        {
+            // A flow that leaves its behaviour twice ends up irregular
+            if (inferred)
+                behaviour = UDP_LITE_COVERAGE_INFERRED;
+            else if (new_coverage == coverage)
+                behaviour = UDP_LITE_COVERAGE_STATIC;
+            else
+                behaviour = UDP_LITE_COVERAGE_IRREGULAR;
+        }
+        coverage = new_coverage;
+        return previous != behaviour;
+    }
+
+    void
+    CUDPLiteProfile::create_dynamic_chain(const iphdr* ip, data_t& output)
+    {
+        create_ip_regular_dynamic(ip, output);
+        create_udp_lite_endpoint_dynamic(NextHeader<udphdr>(ip), output);
+    }
+
+    void
+    CUDPLiteProfile::create_irregular_chain(const iphdr* ip, data_t& output)
+    {
+        create_ip_innermost_irregular(ip, output);
+        create_udp_lite_irregular(coverage_behaviour, NextHeader<udphdr>(ip), output);
+    }
+
+    /*
+     COMPRESSED udp_lite_endpoint_dynamic {
+     ENFORCE(profile_value == PROFILE_UDPLITE_0108);
+     checksum_coverage =:= irregular(16)           [ 16 ];
+     checksum          =:= irregular(16)           [ 16 ];
+     msn               =:= irregular(16)           [ 16 ];
+     reserved          =:= compressed_value(4, 0)  [ 4 ];
+     coverage_behavior =:= irregular(2)            [ 2 ];
+     reorder_ratio     =:= irregular(2)            [ 2 ];
+     }
+     */
+    void
+    CUDPLiteProfile::create_udp_lite_endpoint_dynamic(const udphdr* udp, data_t& output)
+    {
+        AppendData(output, udp->len);
+        AppendData(output, udp->check);
+        AppendDataToNBO(output, msn);
+        output.push_back(static_cast<uint8_t>((coverage_behaviour << 2) | (reorder_ratio & 3)));
+    }
+
+    /*
+     COMPRESSED udp_lite_irregular {
+     checksum_coverage =:= checksum_coverage_enc  [ 0, 16 ];
+     checksum          =:= irregular(16)          [ 16 ];
+     }
+     */
+    void
+    CUDPLiteProfile::create_udp_lite_irregular(CoverageBehaviour_t behaviour, const udphdr* udp, data_t& output)
+    {
+        if (UDP_LITE_COVERAGE_IRREGULAR == behaviour)
+        {
+            AppendData(output, udp->len);
+        }
+        AppendData(output, udp->check);
+    }
+
+} // ns ROHC
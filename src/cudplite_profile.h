@@ -0,0 +1,53 @@
+#pragma once
+
+/**
+ * UDP-Lite/IP profile
+ */
+
+#include "cudp_profile.h"
+
+namespace ROHC
+{
+    /**************************************************************************
+     * Compression Profile
+     *
+     * UDP-Lite has the checksum coverage where UDP has the length. It is
+     * inferred from the length, static or sent in the irregular chain, the
+     * coverage behaviour is only carried by the dynamic chain.
+     **************************************************************************/
+    class CUDPLiteProfile : public CUDPProfile
+    {
+    public:
+        CUDPLiteProfile(Compressor* comp, uint16_t cid, const iphdr* ip);
+
+        virtual unsigned int ID() const {return ProfileID();}
+
+        virtual void Compress(const data_t& data, data_t& output);
+
+    // Statics
+    public:
+        static uint16_t ProfileID() {return 0x0108;}
+        static uint16_t ProtocolID() {return 136;}
+
+        /**
+         * used by the RTP/UDP-Lite profile
+         *
+         * Keeps the coverage behaviour while the packets fit it, coverage
+         * is that of the last packet in host byte order. Returns true if
+         * the behaviour changed, which takes an IR.
+         */
+        static bool UpdateCoverage(const udphdr* udp, size_t udpLength, CoverageBehaviour_t& behaviour, uint16_t& coverage);
+        static void create_udp_lite_irregular(CoverageBehaviour_t behaviour, const udphdr* udp, data_t& output);
+
+    protected:
+        virtual void create_dynamic_chain(const iphdr* ip, data_t& output);
+        virtual void create_irregular_chain(const iphdr* ip, data_t& output);
+
+        void create_udp_lite_endpoint_dynamic(const udphdr* udp, data_t& output);
+
+    private:
+        CoverageBehaviour_t coverage_behaviour;
+        uint16_t coverage;
+    };
+
+} // ns ROHC
@@ -3,9 +3,15 @@
 #include <rohc/rohc.h>
 #include <rohc/log.h>
 #include "dprofile.h"
+#include "dip_profile.h"
+#include "desp_profile.h"
 #include "dudp_profile.h"
+#include "dudplite_profile.h"
 #include "duncomp_profile.h"
 #include "drtp_profile.h"
+#include "drtplite_profile.h"
+#include "dtcp_profile.h"
+#include "arena.h"
 
 #include <iterator>
 #include <cstring>
@@ -14,10 +20,15 @@ using namespace std;
 
 namespace ROHC 
 {
-    Decompressor::Decompressor(bool largeCID, Compressor* compressor)
+    Decompressor::Decompressor(bool largeCID, Compressor* compressor, size_t mrru)
     : compressor(compressor),
     largeCID(largeCID),
-    contexts(),
+    arena(new ContextArena(ArenaPolicy())),
+    contexts(1, static_cast<DProfile*>(0)),
+    mrru(mrru),
+    reassembly(),
+    discardingSegments(false),
+    unit(),
     numberOfPacketsReceived(0),
     dataSizeUncompressed(0),
     dataSizeCompressed(0)
@@ -28,8 +39,19 @@ namespace ROHC
     
     Decompressor::~Decompressor() {
         for (context_t::iterator i = contexts.begin(); contexts.end() != i; ++i) {
-            delete i->second;
+            delete *i;
         }
+        // All contexts have to be gone before the arena
+        delete arena;
+    }
+
+    DProfile*
+    Decompressor::Context(uint32_t cid) const
+    {
+        if (cid < contexts.size()) {
+            return contexts[cid];
+        }
+        return 0;
     }
     
     void
@@ -43,7 +65,6 @@ namespace ROHC
     {
         output.reserve(data.size());
         data_iterator pos = data.begin();
-        size_t outputInitialSize = output.size();
         
 		while ((data.end() != pos) &&
 			IsPadding(*pos)) ++pos;
@@ -62,8 +83,30 @@ namespace ROHC
             //info("Decompressor::Decompress, no data left\n");
 			return;
         }
-        
-        data_iterator headerStart = pos;
+
+        if (isSegment(*pos))
+        {
+            ParseSegment(data, pos, output);
+            return;
+        }
+
+        // The segments of a unit are sent back to back, a unit whose final
+        // segment was lost is dropped
+        if (!reassembly.empty() || discardingSegments)
+        {
+            error("Decompressor, final segment missing\n");
+            reassembly.clear();
+            discardingSegments = false;
+        }
+
+        DecompressPacket(data, pos, output);
+    }
+
+    void
+    Decompressor::DecompressPacket(data_t& data, data_iterator headerStart, data_t& output)
+    {
+        size_t outputInitialSize = output.size();
+        data_iterator pos = headerStart;
         
         uint8_t packetTypeIndication = 0;
         if (!largeCID && IsAddCID(*pos))
@@ -81,7 +124,7 @@ namespace ROHC
         }
         else if (IsIR_DYN(packetTypeIndication))
         {
-            // ParseIRDYN
+            ParseIRDYN(data, headerStart, output);
         }
         else if (IsCORepairPacket(packetTypeIndication))
         {
@@ -97,6 +140,77 @@ namespace ROHC
         dataSizeUncompressed += output.size() - outputInitialSize;
     }
 
+    /*
+     * See RFC 4995 5.2.5
+       0   1   2   3   4   5   6   7
+     +---+---+---+---+---+---+---+---+
+     | 1   1   1   1   1   1   1 | F |
+     +---+---+---+---+---+---+---+---+
+     /           Segment             /  variable length
+     +---+---+---+---+---+---+---+---+
+     F: set on the final segment of a reconstructed unit, the ROHC packet
+     followed by its FCS-32 (see Compressor::Segment)
+     */
+    void
+    Decompressor::ParseSegment(data_t& data, data_iterator pos, data_t& output)
+    {
+        bool final = isFinalSegment(*pos++);
+        size_t size = data.end() - pos;
+
+        if (!discardingSegments)
+        {
+            if (reassembly.size() + size > mrru)
+            {
+                error("Decompressor, reconstructed unit larger than the MRRU (%u)\n", static_cast<unsigned int>(mrru));
+                reassembly.clear();
+                discardingSegments = true;
+            }
+            else
+            {
+                if (reassembly.empty())
+                    reassembly.reserve(mrru);
+                reassembly.insert(reassembly.end(), pos, data.end());
+            }
+        }
+
+        if (!final)
+            return;
+
+        if (discardingSegments)
+        {
+            discardingSegments = false;
+            return;
+        }
+
+        unit.swap(reassembly);
+        reassembly.clear();
+        if (unit.size() < 5)
+        {
+            error("Decompressor, reconstructed unit too small\n");
+            return;
+        }
+
+        size_t unitSize = unit.size() - 4;
+        uint32_t crc = 0;
+        for (unsigned int i = 0; i < 4; ++i)
+        {
+            crc |= static_cast<uint32_t>(unit[unitSize + i]) << (8 * i);
+        }
+        if (CRC32(&unit[0], &unit[0] + unitSize) != crc)
+        {
+            error("Decompressor, reconstructed unit CRC failure\n");
+            return;
+        }
+        unit.resize(unitSize);
+
+        if (isSegment(unit[0]))
+        {
+            error("Decompressor, segment in a reconstructed unit\n");
+            return;
+        }
+        DecompressPacket(unit, unit.begin(), output);
+    }
+
     /*
      * See RFC 4995 5.2.4.1
        0   1   2   3   4   5   6   7
@@ -204,6 +318,11 @@ namespace ROHC
             }
         }
         
+        if (cid > maxLargeCID) {
+            error("Decompressor::ParseIR, invalid CID: %u\n", cid);
+            return;
+        }
+        
         uint8_t lsbProfile = *pos++;
         
         // Store CRC position
@@ -255,6 +374,71 @@ namespace ROHC
                 return;
             }
         }
+        else if (lsbProfile == (DUDPLiteProfile::ProfileID() & 0xff))
+        {
+            if (packetTypeIndication != 0xfd)
+            {
+                error("Decompressor::Decompress, wrong pti\n");
+				SendStaticNACK(cid);
+                return;
+            }
+            if (!DUDPLiteProfile::ParseIR(gc, data, endOfIr)) {
+                error("Decompressor, failed to parse UDP-Lite IR\n");
+                return;
+            }
+        }
+        else if (lsbProfile == (DRTPLiteProfile::ProfileID() & 0xff))
+        {
+            if (packetTypeIndication != 0xfd)
+            {
+                error("Decompressor::Decompress, wrong pti\n");
+				SendStaticNACK(cid);
+                return;
+            }
+            if (!DRTPLiteProfile::ParseIR(gc, data, endOfIr)) {
+                error("Decompressor, failed to parse RTP/UDP-Lite IR\n");
+                return;
+            }
+        }
+        else if (lsbProfile == (DESPProfile::ProfileID() & 0xff))
+        {
+            if (packetTypeIndication != 0xfd)
+            {
+                error("Decompressor::Decompress, wrong pti\n");
+				SendStaticNACK(cid);
+                return;
+            }
+            if (!DESPProfile::ParseIR(gc, data, endOfIr)) {
+                error("Decompressor, failed to parse ESP IR\n");
+                return;
+            }
+        }
+        else if (lsbProfile == (DIPProfile::ProfileID() & 0xff))
+        {
+            if (packetTypeIndication != 0xfd)
+            {
+                error("Decompressor::Decompress, wrong pti\n");
+				SendStaticNACK(cid);
+                return;
+            }
+            if (!DIPProfile::ParseIR(gc, data, endOfIr)) {
+                error("Decompressor, failed to parse IP IR\n");
+                return;
+            }
+        }
+        else if (lsbProfile == (DTCPProfile::ProfileID() & 0xff))
+        {
+            if (packetTypeIndication != 0xfd)
+            {
+                error("Decompressor::Decompress, wrong pti\n");
+				SendStaticNACK(cid);
+                return;
+            }
+            if (!DTCPProfile::ParseIR(gc, data, endOfIr)) {
+                error("Decompressor, failed to parse TCP IR\n");
+                return;
+            }
+        }
         else
         {
             error("Decompressor::ParseIR, unknown profile: %u\n", (unsigned)lsbProfile);
@@ -289,23 +473,17 @@ namespace ROHC
         }
         
 
-        context_t::iterator existingProfile = contexts.find(cid);
-        
-        DProfile* profile = 0;
+        DProfile* profile = Context(cid);
         
-        if (contexts.end() != existingProfile)
+        if (profile)
         {
             // TODO:
             // Is this correct, do we need to verify more than if the profile is the same
             // to use an existing context?
-            if (existingProfile->second->LSBID() != lsbProfile)
-            {
-                delete existingProfile->second;
-                existingProfile = contexts.end();
-            }
-            else
+            if (profile->LSBID() != lsbProfile)
             {
-                profile = existingProfile->second;
+                delete profile;
+                profile = 0;
             }
         }
         
@@ -314,6 +492,9 @@ namespace ROHC
         }    
         
         // Store the profile if CS is ok
+        if (cid >= contexts.size()) {
+            contexts.resize(cid + 1, 0);
+        }
         contexts[cid] = profile;
         
         size_t outputInitSize = output.size();
@@ -331,6 +512,113 @@ namespace ROHC
         }
     }
     
+    /*
+     See RFC 3095 5.7.7.2 and RFC 6846 7.3.2
+       0   1   2   3   4   5   6   7
+      --- --- --- --- --- --- --- ---
+     : Add-CID octet                 : if for small CIDs and CID 1-15
+     +---+---+---+---+---+---+---+---+
+     | 1   1   1   1   1   0   0   0 | IR-DYN packet type
+     +---+---+---+---+---+---+---+---+
+     :                               :
+     / 0-2 octets of CID info        / 1-2 octets if for large CIDs
+     :                               :
+     +---+---+---+---+---+---+---+---+
+     |            Profile            | 1 octet
+     +---+---+---+---+---+---+---+---+
+     |              CRC              | 1 octet
+     +---+---+---+---+---+---+---+---+
+     |                               |
+     /         Dynamic chain         / variable length
+     |                               |
+     +---+---+---+---+---+---+---+---+
+     :                               :
+     /           Payload             / variable length
+     :                               :
+      - - - - - - - - - - - - - - - -
+     */
+    void
+    Decompressor::ParseIRDYN(data_t& data, data_iterator irDataStart, data_t& output)
+    {
+        data_iterator pos = irDataStart;
+
+        uint32_t cid = 0;
+        if (!largeCID && IsAddCID(*pos))
+        {
+            cid = UnmaskShortCID(*pos++);
+        }
+
+        // skip packet type
+        ++pos;
+
+        if (largeCID)
+        {
+            if (!SDVLDecode(pos, data.end(), &cid)){
+                return;
+            }
+        }
+
+        if (cid > maxLargeCID) {
+            error("Decompressor::ParseIRDYN, invalid CID: %u\n", cid);
+            return;
+        }
+
+        if ((data.end() - pos) < 2) {
+            error("Decompressor::ParseIRDYN, not enough data\n");
+            return;
+        }
+
+        uint8_t lsbProfile = *pos++;
+        data_iterator crcPos = pos++;
+
+        // IR-DYN is only defined for TCP (RFC 6846 7.3.2), the RFC 5225
+        // profiles repair the dynamic chain with co_repair
+        if ((DTCPProfile::ProfileID() & 0xff) != lsbProfile)
+        {
+            error("Decompressor::ParseIRDYN, no IR-DYN for profile %u\n", (unsigned)lsbProfile);
+            SendStaticNACK(cid);
+            return;
+        }
+
+        // The static chain is that of the context
+        DProfile* profile = Context(cid);
+        if (!profile || (profile->LSBID() != lsbProfile))
+        {
+            error("Decompressor::ParseIRDYN, no context for CID %u, profile %u\n", cid, (unsigned)lsbProfile);
+            SendStaticNACK(cid);
+            return;
+        }
+
+        global_control gc;
+        memset(&gc, 0, sizeof(gc));
+
+        const_data_iterator endOfIr = pos;
+        if (!profile->ParseIRDYN(gc, data, endOfIr)) {
+            error("Decompressor, failed to parse IR-DYN\n");
+            return;
+        }
+
+        uint8_t readCRC = *crcPos;
+        *crcPos = 0;
+        uint8_t calcCRC = CRC8(irDataStart, endOfIr);
+        *crcPos = readCRC;
+
+        if (calcCRC != readCRC)
+        {
+            error("Decompressor::ParseIRDYN, CRC8 failure\n");
+            SendStaticNACK(cid);
+            return;
+        }
+
+        size_t outputInitSize = output.size();
+
+        profile->MergeGlobalControlAndAppendHeaders(gc, output);
+
+        output.insert(output.end(), endOfIr, const_data_iterator(data.end()));
+
+        setLengthsAndIPChecksum(output.begin() + outputInitSize, output.end());
+    }
+
     void 
     Decompressor::ParseCO(data_t& data, data_iterator pos, data_t& output)
     {
@@ -347,13 +635,12 @@ namespace ROHC
                 return;
         }
         
-        context_t::iterator i = contexts.find(cid);
-        if (contexts.end() == i) {
+        DProfile* profile = Context(cid);
+        if (!profile) {
             SendStaticNACK(cid);
             return;
         }
         
-        DProfile* profile = i->second;
         profile->ParseCO(packetTypeIndication, data, pos, output);
     }
     
@@ -383,7 +670,6 @@ namespace ROHC
     Decompressor::ParseCORepair(data_t &data, data_iterator pos, data_t &output)
     {
         uint32_t cid = 0;
-        data_iterator headerStart = pos;
         
         if (!largeCID && IsAddCID(*pos))
         {
@@ -393,42 +679,23 @@ namespace ROHC
         // skip discriminiator;
         ++pos;
         
-        if (!largeCID)
+        if (largeCID)
         {
             if (!SDVLDecode(pos, data.end(), &cid)) {
                 return;
             }
         }
         
-        uint8_t r1_crc7 = *pos;
-        if (r1_crc7 & 0x80)
-        {
-            // TODO Send nack?
-            return;
-        }
-        
-        *pos = 0;
-        
-        // TODO, this is not correct, since we may have packet data
-        // at the end
-        uint8_t calcCRC = CRC7(headerStart, data.end());
-        
-        // write back old crc
-        *pos++ = r1_crc7;
-        
-        if (r1_crc7 != calcCRC)
-        {
-            // TODO: Send nack
-            return;
-        }
-        
-        context_t::iterator i = contexts.find(cid);
-        if (contexts.end() == i)
+        // The CRC-7 is over the uncompressed header, the profile checks
+        // it once the header has been rebuilt
+        DProfile* profile = Context(cid);
+        if (!profile)
         {
+            SendStaticNACK(cid);
             return;
         }
         
-        i->second->ParseCORepair(data, pos, output);
+        profile->ParseCORepair(data, pos, output);
     }
     
     void
@@ -479,7 +746,7 @@ namespace ROHC
 				SDVLEncode(back_inserter(fbData), cid);
 			}
 			fbData.push_back(lsbMsn);
-			compressor->SendFeedback(fbData.begin(), fbData.end());
+			compressor->SendFeedback(static_cast<uint16_t>(cid), FB_ACK, fbData.begin(), fbData.end());
 		}
     }
 
@@ -523,7 +790,7 @@ namespace ROHC
 			}
 
 			fbData.insert(fbData.begin(), header.begin(), header.end());
-			compressor->SendFeedback(fbData.begin(), fbData.end());
+			compressor->SendFeedback(static_cast<uint16_t>(cid), type, fbData.begin(), fbData.end());
 		}
     }
 } // ns ROHC
@@ -0,0 +1,128 @@
+#include "desp_profile.h"
+#include "network.h"
+#include <rohc/compressor.h>
+#include <rohc/decomp.h>
+
+namespace ROHC
+{
+    DESPProfile::DESPProfile(Decompressor* decomp, uint16_t cid)
+    : DIPProfile(decomp, cid)
+    ,esp()
+    {
+    }
+
+    void
+    DESPProfile::MergeGlobalControlAndAppendHeaders(const ROHC::global_control &gc, data_t &output)
+    {
+        state = FULL_CONTEXT;
+
+        ++numberofIRPackets;
+        ++numberOfPacketsReceived;
+
+        msn = gc.msn;
+        SetReorderRatio(gc.reorder_ratio);
+        ip_id_behaviour = gc.ip_id_behaviour;
+        ip = gc.ip;
+        ip6 = gc.ip6;
+        esp = gc.esp;
+
+		UpdateIPIDOffsetFromID();
+        ResetHeaderTemplate(&esp);
+
+        AppendIPHeader(output);
+        AppendData(output, esp);
+        SendFeedback1();
+    }
+
+    bool
+    DESPProfile::ParseIR(global_control& gc, const data_t& data, const_data_iterator& pos)
+    {
+        const_data_iterator end(data.end());
+        if(!DProfile::parse_ip_static(gc, pos, end))
+            return false;
+        if(!parse_esp_static(gc, pos, end))
+            return false;
+
+        if(!DProfile::parse_ip_regular_dynamic(gc, pos, end))
+            return false;
+
+        if(!parse_esp_dynamic(gc, pos, end))
+            return false;
+
+        return true;
+    }
+
+    bool
+    DESPProfile::ParseIRDYN(global_control& gc, const data_t& data, const_data_iterator& pos)
+    {
+        SaveContext(gc);
+        gc.ip6 = ip6;
+
+        const_data_iterator end(data.end());
+        if(!DProfile::parse_ip_regular_dynamic(gc, pos, end))
+            return false;
+
+        return parse_esp_dynamic(gc, pos, end);
+    }
+
+    bool
+    DESPProfile::parse_esp_static(global_control& gc, const_data_iterator& pos, const_data_iterator& end)
+    {
+        if (!GetValue(pos, end, gc.esp.spi)) {
+            error("parse_esp_static, esp spi\n");
+            return false;
+        }
+        return true;
+    }
+
+    bool
+    DESPProfile::parse_esp_dynamic(global_control& gc, const_data_iterator& pos, const_data_iterator& end)
+    {
+        if (!GetValue(pos, end, gc.esp.seq_no)) {
+            error("parse_esp_dynamic, failed to get sequence number\n");
+            return false;
+        }
+        // The MSN is the 16 LSBs of the sequence number
+        gc.msn = static_cast<uint16_t>(rohc_htonl(gc.esp.seq_no));
+
+        if (pos == end) {
+            error("parse_esp_dynamic - not enough data for reorder ratio");
+            return false;
+        }
+        uint8_t reserved_reorderRatio = *pos++;
+
+        if (reserved_reorderRatio & 0xfc) {
+            error("parse_esp_dynamic, not a valid RR\n");
+            return false;
+        }
+
+        gc.reorder_ratio = static_cast<Reordering_t>(reserved_reorderRatio & 3);
+        return true;
+    }
+
+    ParseResult_t
+    DESPProfile::parse_irregular_chain(ByteReader& in)
+    {
+        // esp_irregular is empty, the sequence number moves with the MSN
+        uint32_t sn = rohc_htonl(esp.seq_no);
+        sn += static_cast<int16_t>(msn - static_cast<uint16_t>(sn));
+        esp.seq_no = rohc_htonl(sn);
+
+        return parse_ip_innermost_irregular(in);
+    }
+
+    void
+    DESPProfile::SaveContext(global_control& gc) const
+    {
+        DProfile::SaveContext(gc);
+        gc.esp = esp;
+    }
+
+    void
+    DESPProfile::RestoreContext(const global_control& gc)
+    {
+        DProfile::RestoreContext(gc);
+        esp = gc.esp;
+    }
+
+} // ns ROHC
@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * ESP/IP profile
+ */
+
+#include "dip_profile.h"
+
+namespace ROHC
+{
+    class DESPProfile : public DIPProfile
+    {
+    public:
+        DESPProfile(Decompressor* decomp, uint16_t cid);
+
+        virtual uint8_t LSBID() const { return static_cast<uint8_t>(ProfileID());}
+        static uint16_t ProfileID() {return 0x0103;}
+
+        static bool ParseIR(global_control& gc, const data_t& data, const_data_iterator& pos);
+        virtual bool ParseIRDYN(global_control& gc, const data_t& data, const_data_iterator& pos);
+
+        void MergeGlobalControlAndAppendHeaders(const global_control& gc, data_t& output);
+
+    private:
+        virtual void AppendHeaders(const_data_iterator payload, const_data_iterator end, data_t& output) {AppendHeaderTemplate(&esp, payload, end, output);}
+        virtual ParseResult_t parse_irregular_chain(ByteReader& in);
+
+        void SaveContext(global_control& gc) const;
+        void RestoreContext(const global_control& gc);
+        static bool parse_esp_static(global_control& gc, const_data_iterator& pos, const_data_iterator& end);
+        static bool parse_esp_dynamic(global_control& gc, const_data_iterator& pos, const_data_iterator& end);
+
+        esphdr esp;
+    };
+} // ns ROHC
@@ -0,0 +1,501 @@
+#include "dip_profile.h"
+#include "network.h"
+#include <rohc/compressor.h>
+#include <rohc/decomp.h>
+#include <cstring>
+
+using namespace std;
+namespace ROHC
+{
+    DIPProfile::DIPProfile(Decompressor* decomp, uint16_t cid)
+    : DProfile(decomp, cid)
+    {
+    }
+
+    void
+    DIPProfile::MergeGlobalControlAndAppendHeaders(const ROHC::global_control &gc, data_t &output)
+    {
+        state = FULL_CONTEXT;
+
+        ++numberofIRPackets;
+        ++numberOfPacketsReceived;
+
+        msn = gc.msn;
+        SetReorderRatio(gc.reorder_ratio);
+        ip_id_behaviour = gc.ip_id_behaviour;
+        ip = gc.ip;
+        ip6 = gc.ip6;
+
+		UpdateIPIDOffsetFromID();
+        ResetHeaderTemplate(0, 0);
+
+        AppendIPHeader(output);
+        SendFeedback1();
+    }
+
+    bool
+    DIPProfile::ParseIR(global_control& gc, const data_t& data, const_data_iterator& pos)
+    {
+        const_data_iterator end(data.end());
+        if(!DProfile::parse_ip_static(gc, pos, end))
+            return false;
+
+        if(!DProfile::parse_ip_endpoint_dynamic(gc, pos, end))
+            return false;
+
+        return true;
+    }
+
+    /*
+     The static fields are those of the context
+     */
+    bool
+    DIPProfile::ParseIRDYN(global_control& gc, const data_t& data, const_data_iterator& pos)
+    {
+        SaveContext(gc);
+        gc.ip6 = ip6;
+
+        const_data_iterator end(data.end());
+        return DProfile::parse_ip_endpoint_dynamic(gc, pos, end);
+    }
+
+    /*
+       0   1   2   3   4   5   6   7
+      --- --- --- --- --- --- --- ---
+     : Add-CID octet                 : if for small CIDs and CID 1-15
+     +---+---+---+---+---+---+---+---+
+     | first octet of base header    | (with type indication)
+     +---+---+---+---+---+---+---+---+
+     :                               :
+     / 0, 1, or 2 octets of CID      / 1-2 octets if large CIDs
+     :                               :
+     +---+---+---+---+---+---+---+---+
+     / remainder of base header      / variable length
+     +---+---+---+---+---+---+---+---+
+     :                               :
+     / Irregular Chain               / variable length
+     :                               :
+      --- --- --- --- --- --- --- ---
+     */
+    
+    void
+    DIPProfile::ParseCO(uint8_t packetTypeIndication, data_t &data, data_iterator pos, data_t &output)
+    {
+		if (FULL_CONTEXT != state) {
+			decomp->SendStaticNACK(cid, msn);
+		}
+
+        global_control saved;
+        SaveContext(saved);
+
+        if (!parse_co_header(packetTypeIndication, data, pos)) {
+            RestoreContext(saved);
+            return;
+        }
+
+        size_t outputInitSize = output.size();
+        AppendHeaders(pos, data.end(), output);
+        if (!VerifyHeaderCRC(output, outputInitSize)) {
+            error("ParseCO, header crc %u failure\n", received_crc_bits);
+            output.resize(outputInitSize);
+            RestoreContext(saved);
+            SendNack();
+            return;
+        }
+        SendFeedback1();
+    }
+
+    const DIPProfile::COParsers DIPProfile::co_parsers;
+
+    DIPProfile::COParsers::COParsers()
+    {
+        for (unsigned int i = 0; i < 256; ++i)
+        {
+            parser_t seq = 0;
+            parser_t rnd = 0;
+            if (0xfa == i)
+                seq = rnd = &DIPProfile::parse_co_common;
+            else if (0 == (i & 0x80))
+                seq = rnd = &DIPProfile::parse_pt_0_crc3;
+            else if (0x80 == (i & 0xe0))
+                seq = rnd = &DIPProfile::parse_pt_0_crc7;
+            // The IP-ID formats are only sent with sequential IP-ID
+            else if (0xa0 == (i & 0xe0))
+                seq = &DIPProfile::parse_pt_1_seq_id;
+            else if (0xc0 == (i & 0xe0))
+                seq = &DIPProfile::parse_pt_2_seq_id;
+            sequential[i] = seq;
+            random[i] = rnd;
+        }
+    }
+
+    bool
+    DIPProfile::parse_co_header(uint8_t packetTypeIndication, data_t& data, data_iterator& pos)
+    {
+        // pos will point at remainder of base header
+        data_iterator posMinusOne = pos - 1;
+        
+        // Make first octet of base header adjacent to the remainder
+        uint8_t stored = 0;
+        if (largeCID)
+        {
+            stored = *posMinusOne;
+            *posMinusOne = packetTypeIndication;
+        }
+        
+        const uint8_t* begin = &*posMinusOne;
+        ByteReader in(begin, &data[0] + data.size());
+        ParseResult_t result = parse_co_header(packetTypeIndication, in);
+
+        if (largeCID)
+        {
+            *posMinusOne = stored;
+        }
+
+        if (PARSE_OK != result)
+        {
+            error("ParseCO, %s, type %x\n", ParseResultString(result), (unsigned) packetTypeIndication);
+            if (PARSE_CONTROL_CRC == result)
+                SendNack();
+            return false;
+        }
+        pos = posMinusOne + (in.Position() - begin);
+        return true;
+    }
+
+    ParseResult_t
+    DIPProfile::parse_co_header(uint8_t packetTypeIndication, ByteReader& in)
+    {
+        const parser_t* parsers = (ip_id_behaviour <= IP_ID_BEHAVIOUR_SEQUENTIAL_SWAPPED) ?
+            co_parsers.sequential : co_parsers.random;
+        parser_t parser = parsers[packetTypeIndication];
+        if (!parser)
+            return PARSE_UNKNOWN_TYPE;
+
+        ParseResult_t result = (this->*parser)(in);
+        if (PARSE_OK != result)
+            return result;
+
+        return parse_irregular_chain(in);
+    }
+
+    ParseResult_t
+    DIPProfile::parse_irregular_chain(ByteReader& in)
+    {
+        return parse_ip_innermost_irregular(in);
+    }
+
+    /*
+     See CIPProfile::CreateCORepair. The dynamic chain is parsed as that of
+     an IR-DYN, the context is only changed if the control fields and the
+     rebuilt header match the CRCs.
+     */
+    void
+    DIPProfile::ParseCORepair(const data_t& data, const_data_iterator r1_crc7_pos, data_t& output)
+    {
+        const_data_iterator pos = r1_crc7_pos;
+        if ((data.end() - pos) < 2) {
+            error("co_repair, not enough data\n");
+            return;
+        }
+        uint8_t r1_crc7 = *pos++;
+        uint8_t r2_crc3 = *pos++;
+
+        if ((r1_crc7 & 0x80) || (r2_crc3 & 0xf8))
+        {
+            error("co_repair, reserved bits not zero\n");
+            SendNack();
+            return;
+        }
+
+        global_control gc;
+        memset(&gc, 0, sizeof(gc));
+        if (!ParseIRDYN(gc, data, pos)) {
+            error("co_repair, failed to parse the dynamic chain\n");
+            SendNack();
+            return;
+        }
+
+        if ((r2_crc3 & 7) != control_crc3(gc.reorder_ratio, gc.msn, gc.ip_id_behaviour)) {
+            error("co_repair, control crc failure\n");
+            SendNack();
+            return;
+        }
+
+        global_control saved;
+        SaveContext(saved);
+
+        size_t outputInitSize = output.size();
+        MergeGlobalControlAndAppendHeaders(gc, output);
+        output.insert(output.end(), pos, data.end());
+        setLengthsAndIPChecksum(output.begin() + outputInitSize, output.end());
+
+        SetReceivedCRC(r1_crc7 & 0x7f, 7);
+        if (!VerifyHeaderCRC(output, outputInitSize)) {
+            error("co_repair, header crc failure\n");
+            output.resize(outputInitSize);
+            RestoreContext(saved);
+            SendNack();
+            return;
+        }
+    }
+    
+    uint8_t
+    DIPProfile::control_crc3(Reordering_t newRR, uint16_t new_msn, IPIDBehaviour_t new_ip_id_behaviour) const
+    {
+        uint8_t data[4];
+        // reorder_ratio, 2 bits padded with 6 MSB of zeroes
+        data[0] = static_cast<uint8_t>(newRR) & 3;
+        SetNBO(&data[1], new_msn);
+        data[3] = static_cast<uint8_t>(new_ip_id_behaviour) & 3;
+        return CRC3(data, data + sizeof(data));
+    }
+
+    /*
+     // Replacement for UOR-2-ext3
+     COMPRESSED co_common {
+     ENFORCE(outer_ip_flag == outer_ip_indicator.CVALUE);
+     discriminator          =:= ’1111 1010’                     [ 8 ];
+     ip_id_indicator        =:= irregular(1)                    [ 1 ]; // see ip_id_sequential_variable
+     header_crc =:= crc7(THIS.UVALUE, THIS.ULENGTH)             [ 7 ];
+     flags_indicator        =:= irregular(1)                    [ 1 ];
+     ttl_hopl_indicator     =:= irregular(1)                    [ 1 ];
+     tos_tc_indicator       =:= irregular(1)                    [ 1 ];
+     reorder_ratio          =:= irregular(2)                    [ 2 ];
+     control_crc3           =:= control_crc3_encoding           [ 3 ];
+     outer_ip_indicator : df : ip_id_behavior_innermost =:=
+     profile_2_3_4_flags_enc(
+     flags_indicator.CVALUE, ip_version.UVALUE)              [ 0, 8 ];
+     tos_tc =:= static_or_irreg(tos_tc_indicator.CVALUE, 8)     [ 0, 8 ];
+     ttl_hopl =:= static_or_irreg(ttl_hopl_indicator.CVALUE,
+     ttl_hopl.ULENGTH)                                       [ 0, 8 ];
+     msn =:= msn_lsb(8)                                         [ 8 ];
+     ip_id =:= ip_id_sequential_variable(ip_id_behavior_innermost.UVALUE,
+     ip_id_indicator.CVALUE)                                 [ 0, 8, 16 ];
+     }
+     */
+    ParseResult_t
+    DIPProfile::parse_co_common(ByteReader& in)
+    {
+        if (!in.Has(3))
+            return PARSE_TRUNCATED;
+        // skip discriminator
+        in.Skip(1);
+        
+        uint8_t ip_id_indicator_crc7 = in.U8();
+        
+        bool ip_id_indicator = (ip_id_indicator_crc7 & 0x80) > 0;
+        SetReceivedCRC(ip_id_indicator_crc7 & 0x7f, 7);
+        
+        uint8_t flags_crc3 = in.U8();
+
+        bool flags_indicator = (flags_crc3 & 0x80) > 0;
+        bool ttl_hopl_indicator = (flags_crc3 & 0x40) > 0;
+        bool tos_tc_indicator = (flags_crc3 & 0x20) > 0;
+        
+		Reordering_t newRR = static_cast<Reordering_t>((flags_crc3 >> 3) & 3);
+
+		IPIDBehaviour_t newBehaviour = ip_id_behaviour;
+		bool dontFragment = false;
+
+		// Optional flags, tos and ttl, then the msn
+		size_t size = flags_indicator + tos_tc_indicator + ttl_hopl_indicator + 1;
+		if (!in.Has(size))
+			return PARSE_TRUNCATED;
+
+		if (flags_indicator)
+		{
+			parse_profile_2_3_4_flags_enc(in.U8(), dontFragment, newBehaviour);
+		}
+
+		uint8_t newTOS = ip.tos;
+        if (tos_tc_indicator)
+        {
+            newTOS = in.U8();
+        }
+
+		uint8_t newTTL = ip.ttl;
+        if (ttl_hopl_indicator)
+        {
+			newTTL = in.U8();
+        }
+        
+        uint8_t lsbMsn = in.U8();
+		uint16_t newMsn;
+        UpdateMSN(lsbMsn, 8, newMsn);
+
+		uint16_t new_ip_id_offset = ip_id_offset;
+		uint16_t new_ip_id;
+        ParseResult_t result = parse_ip_id_sequential_variable(ip_id_indicator, in, new_ip_id_offset, new_ip_id);
+        if (PARSE_OK != result)
+            return result;
+
+		if ((flags_crc3 & 7) != control_crc3(newRR, newMsn, newBehaviour))
+            return PARSE_CONTROL_CRC;
+
+        SetReorderRatio(newRR);
+
+		if (flags_indicator) {
+			if (dontFragment) {
+				SetDontFragment(&ip);
+			}
+			else {
+				ClearDontFragment(&ip);
+			}
+		}
+
+		ip_id_behaviour = newBehaviour;
+		ip.tos = newTOS;
+		ip.ttl = newTTL;
+
+		msn = newMsn;
+		if (ip_id_indicator) {
+			ip.id = new_ip_id;
+			UpdateIPIDOffsetFromID();
+		}
+		else {
+			ip_id_offset = new_ip_id_offset;
+			UpdateIPIDFromOffset();
+		}
+        return PARSE_OK;
+    }
+    
+    /*
+     pt_0_crc3: This format conveys only the MSN; it can therefore only
+     update the MSN and fields that are derived from the MSN, such as
+     IP-ID and the RTP Timestamp (for applicable profiles). It is
+     protected by a 3-bit CRC. This format is equivalent to the UO-0
+     header format in [RFC3095].
+     
+     // UO-0
+     COMPRESSED pt_0_crc3 {
+     discriminator =:= ’0’ [ 1 ];
+     msn =:= msn_lsb(4) [ 4 ];
+     header_crc =:= crc3(THIS.UVALUE, THIS.ULENGTH) [ 3 ];
+     ip_id =:= inferred_sequential_ip_id [ 0 ];
+     }
+     */
+    ParseResult_t
+    DIPProfile::parse_pt_0_crc3(ByteReader& in)
+    {
+        if (!in.Has(1))
+            return PARSE_TRUNCATED;
+        uint8_t d = in.U8();
+        SetReceivedCRC(d & 7, 3);
+        
+        uint8_t lsbMsn = d >> 3;
+        uint16_t delta_msn = UpdateMSN(lsbMsn, 4, msn);
+        parse_inferred_sequential_ip_id(delta_msn);
+        return PARSE_OK;
+    }
+    
+    /*
+     pt_0_crc7: This format has the same properties as pt_0_crc3, but
+     is instead protected by a 7-bit CRC and contains a larger amount
+     of lsb-encoded MSN bits. This format is useful in environments
+     where a high amount of reordering or a high-residual error rate
+     can occur.
+     
+     // New format, Type 0 with strong CRC and more SN bits
+     COMPRESSED pt_0_crc7 {
+     discriminator =:= ’100’ [ 3 ];
+     msn =:= msn_lsb(6) [ 6 ];
+     header_crc =:= crc7(THIS.UVALUE, THIS.ULENGTH) [ 7 ];
+     ip_id =:= inferred_sequential_ip_id [ 0 ];
+     }
+     */
+    ParseResult_t
+    DIPProfile::parse_pt_0_crc7(ByteReader& in) {
+        if (!in.Has(2))
+            return PARSE_TRUNCATED;
+        uint8_t msbMsn = in.U8();
+        uint8_t lsbMsn_crc7 = in.U8();
+        SetReceivedCRC(lsbMsn_crc7 & 0x7f, 7);
+        uint8_t lsbMsn = (msbMsn << 1) | (lsbMsn_crc7 >> 7);
+        uint16_t delta_msn = UpdateMSN(lsbMsn, 6, msn);
+        parse_inferred_sequential_ip_id(delta_msn);
+        return PARSE_OK;
+    }
+    
+    /*
+     pt_1_seq_id: This format can convey changes to the MSN and to the
+     IP-ID. It is protected by a 7-bit CRC. It is similar in purpose
+     to the UO-1-ID format in [RFC3095].
+     
+     
+     // UO-1-ID replacement (PT-1 only used for sequential)
+     COMPRESSED pt_1_seq_id {
+     ENFORCE((ip_id_behavior_innermost.UVALUE ==
+     IP_ID_BEHAVIOR_SEQUENTIAL) ||
+     (ip_id_behavior_innermost.UVALUE ==
+     IP_ID_BEHAVIOR_SEQUENTIAL_SWAPPED));
+     discriminator =:= ’101’ [ 3 ];
+     header_crc =:= crc3(THIS.UVALUE, THIS.ULENGTH) [ 3 ];
+     msn =:= msn_lsb(6) [ 6 ];
+     ip_id =:= ip_id_lsb(ip_id_behavior_innermost.UVALUE, 4) [ 4 ];
+     }
+    */
+    ParseResult_t
+    DIPProfile::parse_pt_1_seq_id(ByteReader& in) {
+        // Only in the sequential table, see COParsers
+        if (!in.Has(2))
+            return PARSE_TRUNCATED;
+            
+        uint8_t disc_crc_msbMsn = in.U8();
+        uint8_t lsbMsn_ipId = in.U8();
+        
+        SetReceivedCRC((disc_crc_msbMsn >> 2) & 7, 3);
+        
+        uint8_t lsbMsn = ((disc_crc_msbMsn & 3) << 4) | (lsbMsn_ipId >> 4);
+        UpdateMSN(lsbMsn, 6, msn);
+        UpdateIPIDOffset(lsbMsn_ipId & 0x0f, 4, ip_id_offset);
+        UpdateIPIDFromOffset();
+
+        return PARSE_OK;
+    }
+    
+    /*
+     pt_2_seq_id: This format can convey changes to the MSN and to the
+     IP-ID. It is protected by a 7-bit CRC. It is similar in purpose
+     to the UO-2-ID format in [RFC3095].
+     
+     
+     // UOR-2-ID replacement
+     COMPRESSED pt_2_seq_id {
+     ENFORCE((ip_id_behavior_innermost.UVALUE == IP_ID_BEHAVIOR_SEQUENTIAL) ||
+     (ip_id_behavior_innermost.UVALUE == IP_ID_BEHAVIOR_SEQUENTIAL_SWAPPED));
+     discriminator =:= ’110’ [ 3 ];
+     ip_id =:= ip_id_lsb(ip_id_behavior_innermost.UVALUE, 6) [ 6 ];
+     header_crc =:= crc7(THIS.UVALUE, THIS.ULENGTH) [ 7 ];
+     msn =:= msn_lsb(8) [ 8 ];
+     }     
+     */
+    ParseResult_t
+    DIPProfile::parse_pt_2_seq_id(ByteReader& in)
+    {
+        if (!in.Has(3))
+            return PARSE_TRUNCATED;
+		uint8_t disc_msb_ip_id_offset = in.U8();
+
+		uint8_t new_ip_id_offset = (disc_msb_ip_id_offset & 0x1f) << 1;
+		uint8_t lsb_ip_id_offset_crc7 = in.U8();
+		new_ip_id_offset |= (lsb_ip_id_offset_crc7 >> 7);
+		SetReceivedCRC(lsb_ip_id_offset_crc7 & 0x7f, 7);
+
+		uint8_t newmsn = in.U8();
+
+		UpdateMSN(newmsn, 8, msn);
+		UpdateIPIDOffset(new_ip_id_offset, 6, ip_id_offset);
+		UpdateIPIDFromOffset();
+        return PARSE_OK;
+    }
+
+	void
+	DIPProfile::parse_profile_2_3_4_flags_enc(uint8_t flags, bool& df, IPIDBehaviour_t& new_ip_id_behaviour) const
+	{
+		df = (flags & 0x40) > 0;
+
+		new_ip_id_behaviour = static_cast<IPIDBehaviour_t>((flags & 0x30) >> 4);
+	}
+
+} // ns ROHC
@@ -0,0 +1,63 @@
+#pragma once
+
+/**
+ * IP-only profile, RFC 5225 6.8
+ */
+
+#include "dprofile.h"
+
+namespace ROHC
+{
+    /**
+     * The base header formats shared by the UDP, ESP and IP-only profiles,
+     * the profiles built on this one add their own items to the chains
+     */
+    class DIPProfile : public DProfile
+    {
+    public:
+        DIPProfile(Decompressor* decomp, uint16_t cid);
+
+        virtual uint8_t LSBID() const { return static_cast<uint8_t>(ProfileID());}
+        static uint16_t ProfileID() {return 0x0104;}
+
+        static bool ParseIR(global_control& gc, const data_t& data, const_data_iterator& pos);
+        virtual bool ParseIRDYN(global_control& gc, const data_t& data, const_data_iterator& pos);
+        virtual void ParseCO(uint8_t packetTypeIndication, data_t& data, data_iterator pos, data_t& output);
+        virtual void ParseCORepair(const data_t& data, const_data_iterator r1_crc7_pos, data_t& output);
+
+        virtual void MergeGlobalControlAndAppendHeaders(const global_control& gc, data_t& output);
+
+    protected:
+        /**
+         * The headers appended from the header template, the IP header
+         * alone for IP-only
+         */
+        virtual void AppendHeaders(const_data_iterator payload, const_data_iterator end, data_t& output) {AppendHeaderTemplate(0, 0, payload, end, output);}
+        virtual ParseResult_t parse_irregular_chain(ByteReader& in);
+
+        bool parse_co_header(uint8_t packetTypeIndication, data_t& data, data_iterator& pos);
+        ParseResult_t parse_co_header(uint8_t packetTypeIndication, ByteReader& in);
+
+        /**
+         * Base header parsers indexed by the first octet, see DRTPProfile
+         */
+        typedef ParseResult_t (DIPProfile::*parser_t)(ByteReader& in);
+        struct COParsers
+        {
+            COParsers();
+            parser_t sequential[256];
+            parser_t random[256];
+        };
+        static const COParsers co_parsers;
+
+        ParseResult_t parse_co_common(ByteReader& in);
+        ParseResult_t parse_pt_0_crc3(ByteReader& in);
+        ParseResult_t parse_pt_0_crc7(ByteReader& in);
+        ParseResult_t parse_pt_1_seq_id(ByteReader& in);
+        ParseResult_t parse_pt_2_seq_id(ByteReader& in);
+
+		void parse_profile_2_3_4_flags_enc(uint8_t flags, bool& df, IPIDBehaviour_t& new_ip_id_behaviour) const;
+
+        uint8_t control_crc3(Reordering_t newRR, uint16_t new_msn, IPIDBehaviour_t new_ip_id_behaviour) const;
+    };
+} // ns ROHC
@@ -1,6 +1,11 @@
 #include "dprofile.h"
+#include "dip_profile.h"
+#include "desp_profile.h"
 #include "dudp_profile.h"
+#include "dudplite_profile.h"
 #include "drtp_profile.h"
+#include "drtplite_profile.h"
+#include "dtcp_profile.h"
 #include "duncomp_profile.h"
 #include "network.h"
 #include <cstdlib>
@@ -8,6 +13,7 @@
 #include <rohc/compressor.h>
 
 #include <cstring>
+#include <algorithm>
 
 using namespace std;
 
@@ -26,9 +32,18 @@ namespace ROHC
     ,dataSizeCompressed(0)
     ,largeCID(decomp->LargeCID())
     ,ip()
+    ,ip6()
+    ,header_crc()
+    ,received_crc(0)
+    ,received_crc_bits(0)
+    ,header_template()
+    ,header_template_size(0)
     , packetsSinceLastAck(0)
     {
         memset(&ip, 0, sizeof(ip));
+        memset(&ip6, 0, sizeof(ip6));
+        // Zero version makes the first checksum a full calculation
+        memset(&header_template, 0, sizeof(header_template));
         ip.version = 4;
         ip.ihl = 5;
 		SetReorderRatio(REORDERING_NONE);
@@ -39,13 +54,33 @@ namespace ROHC
     {
         if ((DUDPProfile::ProfileID() & 0xff) == lsbProfileID)
         {
-            return new DUDPProfile(decomp, cid);
+            return new (decomp->Arena()) DUDPProfile(decomp, cid);
         }
         else if ((DRTPProfile::ProfileID() & 0xff) == lsbProfileID)
         {
-            return new DRTPProfile(decomp, cid);
+            return new (decomp->Arena()) DRTPProfile(decomp, cid);
         }
-        return new DUncompressedProfile(decomp, cid);
+        else if ((DUDPLiteProfile::ProfileID() & 0xff) == lsbProfileID)
+        {
+            return new (decomp->Arena()) DUDPLiteProfile(decomp, cid);
+        }
+        else if ((DRTPLiteProfile::ProfileID() & 0xff) == lsbProfileID)
+        {
+            return new (decomp->Arena()) DRTPLiteProfile(decomp, cid);
+        }
+        else if ((DESPProfile::ProfileID() & 0xff) == lsbProfileID)
+        {
+            return new (decomp->Arena()) DESPProfile(decomp, cid);
+        }
+        else if ((DIPProfile::ProfileID() & 0xff) == lsbProfileID)
+        {
+            return new (decomp->Arena()) DIPProfile(decomp, cid);
+        }
+        else if ((DTCPProfile::ProfileID() & 0xff) == lsbProfileID)
+        {
+            return new (decomp->Arena()) DTCPProfile(decomp, cid);
+        }
+        return new (decomp->Arena()) DUncompressedProfile(decomp, cid);
     }
     
     void
@@ -62,7 +97,48 @@ namespace ROHC
 	}
 
     bool
-    DProfile::parse_ipv4_static(ROHC::global_control &gc, const_data_iterator& pos, const_data_iterator& end) {
+    DProfile::parse_ip_static(global_control& gc, const_data_iterator& pos, const_data_iterator& end) {
+        if (pos == end) {
+            error("parse_ip_static, not enough data\n");
+            return false;
+        }
+        // version_flag
+        if (*pos & 0x80) {
+            return parse_ipv6_static(gc, pos, end);
+        }
+        return parse_ipv4_static(gc, pos, end);
+    }
+
+    bool
+    DProfile::parse_ip_static(global_control& gc, const_data_iterator& pos, const_data_iterator& end, bool innermost_flag) {
+        if (pos == end) {
+            error("parse_ip_static, not enough data\n");
+            return false;
+        }
+        if (*pos & 0x80) {
+            return parse_ipv6_static(gc, pos, end, innermost_flag);
+        }
+        return parse_ipv4_static(gc, pos, end, innermost_flag);
+    }
+
+    bool
+    DProfile::parse_ip_regular_dynamic(global_control& gc, const_data_iterator& pos, const_data_iterator& end) {
+        if (6 == gc.ip.version) {
+            return parse_ipv6_regular_dynamic(gc, pos, end);
+        }
+        return parse_ipv4_regular_innermost_dynamic(gc, pos, end);
+    }
+
+    bool
+    DProfile::parse_ip_endpoint_dynamic(global_control& gc, const_data_iterator& pos, const_data_iterator& end) {
+        if (6 == gc.ip.version) {
+            return parse_ipv6_endpoint_dynamic(gc, pos, end);
+        }
+        return parse_ipv4_endpoint_innermost_dynamic(gc, pos, end);
+    }
+
+    bool
+    DProfile::parse_ipv4_static(ROHC::global_control &gc, const_data_iterator& pos, const_data_iterator& end, bool innermost_flag) {
         if ((end - pos) < 10) {
             error("parse_ipv4_static, not enough data\n");
             return false;
@@ -71,7 +147,7 @@ namespace ROHC
         gc.ip.ihl = 5;
         
         uint8_t version_flagInnermost_ipReserved = *pos++;
-        if (version_flagInnermost_ipReserved != 0x40) {
+        if (version_flagInnermost_ipReserved != (innermost_flag ? 0x40 : 0x00)) {
             error("parse_ipv4_static, not a valid ip version\n");
             return false;
         }
@@ -115,6 +191,120 @@ namespace ROHC
         return parse_ip_id_enc_dyn(gc, pos, end);
     }
     
+    bool
+    DProfile::parse_ipv4_endpoint_innermost_dynamic(global_control& gc, const_data_iterator& pos, const_data_iterator& end)
+    {
+        if ((end - pos) < 3) {
+            error("parse_ipv4_endpoint_innermost_dynamic, not enough data\n");
+            return false;
+        }
+        uint8_t reserved_RR_Df_IpIdBehav = *pos++;
+        if (reserved_RR_Df_IpIdBehav & 0xe0) {
+            error("parse_ipv4_endpoint_innermost_dynamic, reserved not zero\n");
+            return false;
+        }
+
+        gc.reorder_ratio = static_cast<Reordering_t>((reserved_RR_Df_IpIdBehav >> 3) & 3);
+        if (reserved_RR_Df_IpIdBehav & 4)
+        {
+            SetDontFragment(&gc.ip);
+        }
+        else
+        {
+            ClearDontFragment(&gc.ip);
+        }
+
+        gc.ip_id_behaviour = static_cast<IPIDBehaviour_t>(reserved_RR_Df_IpIdBehav & 3);
+
+        gc.ip.tos = *pos++;
+        gc.ip.ttl = *pos++;
+
+        if (!parse_ip_id_enc_dyn(gc, pos, end)) {
+            error("parse_ipv4_endpoint_innermost_dynamic, could not get ip id\n");
+            return false;
+        }
+        if (!GetValueFromNBO(pos, end, gc.msn)) {
+            error("parse_ipv4_endpoint_innermost_dynamic, failed to get MSN\n");
+            return false;
+        }
+        return true;
+    }
+
+    bool
+    DProfile::parse_ipv6_static(global_control& gc, const_data_iterator& pos, const_data_iterator& end, bool innermost_flag) {
+        uint8_t versionFlag_innermostIp_reserved_flowLabelEnc = *pos;
+        if ((versionFlag_innermostIp_reserved_flowLabelEnc & 0xe0) != (innermost_flag ? 0xc0 : 0x80)) {
+            error("parse_ipv6_static, not a valid ip version\n");
+            return false;
+        }
+        bool flowLabelPresent = (versionFlag_innermostIp_reserved_flowLabelEnc & 0x10) != 0;
+        if (!flowLabelPresent && (versionFlag_innermostIp_reserved_flowLabelEnc & 0x0f)) {
+            error("parse_ipv6_static, reserved not zero\n");
+            return false;
+        }
+
+        size_t size = (flowLabelPresent ? 3 : 1) + 1 + sizeof(gc.ip6.saddr) + sizeof(gc.ip6.daddr);
+        if (static_cast<size_t>(end - pos) < size) {
+            error("parse_ipv6_static, not enough data\n");
+            return false;
+        }
+        ++pos;
+
+        uint32_t flowLabel = 0;
+        if (flowLabelPresent) {
+            flowLabel = (versionFlag_innermostIp_reserved_flowLabelEnc & 0x0f) << 16;
+            flowLabel |= *pos++ << 8;
+            flowLabel |= *pos++;
+        }
+
+        gc.ip6.version = 6;
+        SetFlowLabel(&gc.ip6, flowLabel);
+        gc.ip6.nexthdr = *pos++;
+        std::copy(pos, pos + sizeof(gc.ip6.saddr), gc.ip6.saddr);
+        pos += sizeof(gc.ip6.saddr);
+        std::copy(pos, pos + sizeof(gc.ip6.daddr), gc.ip6.daddr);
+        pos += sizeof(gc.ip6.daddr);
+
+        gc.ip.version = 6;
+        gc.ip.protocol = gc.ip6.nexthdr;
+        return true;
+    }
+
+    bool
+    DProfile::parse_ipv6_regular_dynamic(global_control& gc, const_data_iterator& pos, const_data_iterator& end)
+    {
+        if ((end - pos) < 2) {
+            error("parse_ipv6_regular_dynamic, not enough data\n");
+            return false;
+        }
+        gc.ip.tos = *pos++;
+        gc.ip.ttl = *pos++;
+        // No IP-ID in IPv6
+        gc.ip_id_behaviour = IP_ID_BEHAVIOUR_RANDOM;
+        return true;
+    }
+    
+    bool
+    DProfile::parse_ipv6_endpoint_dynamic(global_control& gc, const_data_iterator& pos, const_data_iterator& end)
+    {
+        if ((end - pos) < 6) {
+            error("parse_ipv6_endpoint_dynamic, not enough data\n");
+            return false;
+        }
+        gc.ip.tos = *pos++;
+        gc.ip.ttl = *pos++;
+        uint8_t reserved = *pos++;
+        uint8_t reserved_RR = *pos++;
+        if (reserved || (reserved_RR & 0xfc)) {
+            error("parse_ipv6_endpoint_dynamic, reserved not zero\n");
+            return false;
+        }
+        gc.reorder_ratio = static_cast<Reordering_t>(reserved_RR & 3);
+        // No IP-ID in IPv6
+        gc.ip_id_behaviour = IP_ID_BEHAVIOUR_RANDOM;
+        return GetValueFromNBO(pos, end, gc.msn);
+    }
+    
     bool
     DProfile::parse_ip_id_enc_dyn(global_control& gc, const_data_iterator& pos, const_data_iterator& end)
     {
@@ -137,25 +327,25 @@ namespace ROHC
         }
     }
     
-    bool
-    DProfile::parse_ip_id_sequential_variable(bool indicator, data_iterator& pos, const data_iterator& end, uint16_t& new_ip_id_offset, uint16_t& new_ip_id)
+    ParseResult_t
+    DProfile::parse_ip_id_sequential_variable(bool indicator, ByteReader& in, uint16_t& new_ip_id_offset, uint16_t& new_ip_id)
     {
         if (ip_id_behaviour <= IP_ID_BEHAVIOUR_SEQUENTIAL_SWAPPED)
         {
             if (indicator)
             {
-                return GetValue(pos, end, new_ip_id);
+                if (!in.ReadRaw(new_ip_id))
+                    return PARSE_TRUNCATED;
             }
             else
             {
-                if (std::distance(pos, end) < 1) {
-                    error("parse_ip_id_sequential_variable not enough data");
-                    return false;
-                }
-                UpdateIPIDOffset(*pos++, 8, new_ip_id_offset);
+                uint8_t lsb;
+                if (!in.ReadU8(lsb))
+                    return PARSE_TRUNCATED;
+                UpdateIPIDOffset(lsb, 8, new_ip_id_offset);
             }
         }
-        return true;
+        return PARSE_OK;
     }
 
 	void
@@ -167,7 +357,7 @@ namespace ROHC
         }
 		else if (IP_ID_BEHAVIOUR_SEQUENTIAL_SWAPPED == ip_id_behaviour)
         {
-            ip.id = msn + ip_id_offset;
+            ip.id = rohc_htoles(msn + ip_id_offset);
         }
 	}
 
@@ -180,7 +370,7 @@ namespace ROHC
 		}
 		else if (IP_ID_BEHAVIOUR_SEQUENTIAL_SWAPPED == ip_id_behaviour)
 		{
-			ip_id_offset = ip.id - msn;
+			ip_id_offset = rohc_htoles(ip.id) - msn;
 		}
 	}
     
@@ -230,23 +420,214 @@ namespace ROHC
         }
         else if (IP_ID_BEHAVIOUR_SEQUENTIAL_SWAPPED == ip_id_behaviour)
         {
-            ip.id += delta_msn;
+            ip.id = rohc_htoles(rohc_htoles(ip.id) + delta_msn);
+        }
+    }
+
+    const iphdr*
+    DProfile::IPHeader()
+    {
+        if (!IPv6())
+            return &ip;
+        SetTrafficClass(&ip6, ip.tos);
+        ip6.hop_limit = ip.ttl;
+        return reinterpret_cast<const iphdr*>(&ip6);
+    }
+
+    void
+    DProfile::AppendIPHeader(data_t& output)
+    {
+        const uint8_t* h = reinterpret_cast<const uint8_t*>(IPHeader());
+        output.insert(output.end(), h, h + (IPv6() ? sizeof(ipv6hdr) : sizeof(iphdr)));
+    }
+
+    void
+    DProfile::ResetHeaderTemplate(const udphdr* udp, const rtphdr* rtp)
+    {
+        if (IPv6())
+        {
+            header_template.v6.ip = *AsIPv6(IPHeader());
+            header_template_size = sizeof(ipv6hdr);
+            if (udp)
+            {
+                header_template.v6.udp = *udp;
+                header_template_size += sizeof(udphdr);
+            }
+            if (rtp)
+            {
+                header_template.v6.rtp = *rtp;
+                header_template_size += sizeof(rtphdr);
+            }
+            header_crc.SetStatic(HeaderTemplate(), udp ? 4 : 0);
+            return;
+        }
+        header_template.v4.ip = ip;
+        header_template.v4.ip.tot_len = 0;
+        calculateIpHeaderCheckSum(&header_template.v4.ip);
+        header_template_size = sizeof(iphdr);
+        if (udp)
+        {
+            header_template.v4.udp = *udp;
+            header_template_size += sizeof(udphdr);
+        }
+        if (rtp)
+        {
+            header_template.v4.rtp = *rtp;
+            header_template_size += sizeof(rtphdr);
+        }
+        header_crc.SetStatic(HeaderTemplate(), udp ? 4 : 0);
+    }
+
+    void
+    DProfile::AppendHeaderTemplate(const udphdr* udp, const rtphdr* rtp, const_data_iterator payload, const_data_iterator end, data_t& output)
+    {
+        size_t size = header_template_size + (end - payload);
+        udphdr* tudp;
+        rtphdr* trtp;
+        uint16_t udpLength;
+        uint8_t protocol;
+        if (IPv6())
+        {
+            ipv6hdr& tip = header_template.v6.ip;
+            protocol = tip.nexthdr;
+            SetTrafficClass(&tip, ip.tos);
+            tip.hop_limit = ip.ttl;
+            udpLength = static_cast<uint16_t>(size - sizeof(ipv6hdr));
+            tip.payload_len = rohc_htons(udpLength);
+            tudp = &header_template.v6.udp;
+            trtp = &header_template.v6.rtp;
+        }
+        else
+        {
+            iphdr previous = header_template.v4.ip;
+
+            // Everything but the addresses, protocol, version and ihl
+            iphdr& tip = header_template.v4.ip;
+            protocol = tip.protocol;
+            tip.tos = ip.tos;
+            tip.tot_len = rohc_htons(static_cast<uint16_t>(size));
+            tip.id = ip.id;
+            tip.frag_off = ip.frag_off;
+            tip.ttl = ip.ttl;
+            updateIpHeaderCheckSum(&tip, &previous);
+            udpLength = static_cast<uint16_t>(size - sizeof(iphdr));
+            tudp = &header_template.v4.udp;
+            trtp = &header_template.v4.rtp;
+        }
+
+        if (udp)
+        {
+            tudp->len = (17 == protocol) ? rohc_htons(udpLength) : udp->len;
+            tudp->check = udp->check;
+        }
+        if (rtp)
+        {
+            // Flags, payload type, sequence number and timestamp, not the ssrc
+            memcpy(trtp, rtp, 8);
         }
+
+        const uint8_t* h = reinterpret_cast<const uint8_t*>(&header_template);
+        output.reserve(output.size() + size);
+        output.insert(output.end(), h, h + header_template_size);
+        output.insert(output.end(), payload, end);
     }
 
-	bool
-	DProfile::parse_ipv4_innermost_irregular(data_iterator& pos, const data_iterator& end)
+    void
+    DProfile::ResetHeaderTemplate(const esphdr* esp)
+    {
+        ResetHeaderTemplate(0, 0);
+        if (IPv6())
+            header_template.v6.esp = *esp;
+        else
+            header_template.v4.esp = *esp;
+        header_template_size += sizeof(esphdr);
+        header_crc.SetStatic(HeaderTemplate(), 4); // SPI
+    }
+
+    void
+    DProfile::AppendHeaderTemplate(const esphdr* esp, const_data_iterator payload, const_data_iterator end, data_t& output)
+    {
+        // The template size already counts the ESP header
+        if (IPv6())
+            header_template.v6.esp.seq_no = esp->seq_no;
+        else
+            header_template.v4.esp.seq_no = esp->seq_no;
+        AppendHeaderTemplate(0, 0, payload, end, output);
+    }
+
+    void
+    DProfile::ResetHeaderTemplate(const tcphdr* tcp)
+    {
+        ResetHeaderTemplate(0, 0);
+        if (IPv6())
+            header_template.tcp6.tcp = *tcp;
+        else
+            header_template.tcp4.tcp = *tcp;
+        header_template_size += sizeof(tcphdr);
+        header_crc.SetStatic(HeaderTemplate(), 4); // ports
+    }
+
+    void
+    DProfile::AppendHeaderTemplate(const tcphdr* tcp, const uint8_t* options, size_t optionsSize, const_data_iterator payload, const_data_iterator end, data_t& output)
+    {
+        // Everything but the ports, the TCP checksum comes with each packet
+        tcphdr& ttcp = IPv6() ? header_template.tcp6.tcp : header_template.tcp4.tcp;
+        memcpy(&ttcp.sequenceNumber, &tcp->sequenceNumber, sizeof(tcphdr) - 4);
+        // The options follow the header, their size can change with each packet
+        memcpy(IPv6() ? header_template.tcp6.options : header_template.tcp4.options, options, optionsSize);
+        header_template_size = (IPv6() ? sizeof(ipv6hdr) : sizeof(iphdr)) + sizeof(tcphdr) + optionsSize;
+        AppendHeaderTemplate(0, 0, payload, end, output);
+    }
+
+    bool
+    DProfile::VerifyHeaderCRC(const data_t& output, size_t headerStart) const
+    {
+        const iphdr* h = reinterpret_cast<const iphdr*>(&output[headerStart]);
+        if (3 == received_crc_bits)
+        {
+            return header_crc.CRC3(h, header_template_size) == received_crc;
+        }
+        return header_crc.CRC7(h, header_template_size) == received_crc;
+    }
+
+    void
+    DProfile::SaveContext(global_control& gc) const
+    {
+        gc.msn = msn;
+        gc.reorder_ratio = reorder_ratio;
+        gc.ip_id_offset = ip_id_offset;
+        gc.ip_id_behaviour = ip_id_behaviour;
+        gc.ip = ip;
+    }
+
+    void
+    DProfile::RestoreContext(const global_control& gc)
+    {
+        msn = gc.msn;
+        reorder_ratio = gc.reorder_ratio;
+        ip_id_offset = gc.ip_id_offset;
+        ip_id_behaviour = gc.ip_id_behaviour;
+        ip = gc.ip;
+    }
+
+	ParseResult_t
+	DProfile::parse_ip_innermost_irregular(ByteReader& in)
 	{
+        // ipv6_innermost_irregular is empty
+        if (IPv6())
+            return PARSE_OK;
+
         // ipv4_irreg
         if (IP_ID_BEHAVIOUR_RANDOM == ip_id_behaviour)
         {
-            return GetValue(pos, end, ip.id);
+            if (!in.ReadRaw(ip.id))
+                return PARSE_TRUNCATED;
         }
 		else if (IP_ID_BEHAVIOUR_ZERO == ip_id_behaviour)
 		{
 			ip.id = 0;
 		}
-		return true;
+		return PARSE_OK;
 	}
     
 } // namespace ROHC
@@ -3,6 +3,9 @@
 #include <rohc/rohc.h>
 #include "network.h"
 #include "lsb.h"
+#include "arena.h"
+#include "reader.h"
+#include "tcp_profile_supp.h"
 
 namespace ROHC
 {    
@@ -11,7 +14,7 @@ namespace ROHC
         uint16_t    msn;
         Reordering_t reorder_ratio;
         // ip_id fields are for innermost IP header only
-        //uint16_t    ip_id_offset;
+        uint16_t    ip_id_offset;
         IPIDBehaviour_t ip_id_behaviour;
         
         // Used by RTP
@@ -20,12 +23,25 @@ namespace ROHC
         uint32_t    ts_scaled;
         uint32_t    ts_offset;
         
+        // For IPv6 ip only has version, tos (tos_tc) and ttl (ttl_hopl),
+        // the rest of the header is in ip6
         iphdr       ip;
+        ipv6hdr     ip6;
         
         bool        udp_checksum_used;
         udphdr      udp;
+        // Used by UDP-Lite, the coverage is in udp.len
+        CoverageBehaviour_t coverage_behaviour;
         
         rtphdr      rtp;
+
+        esphdr      esp;
+
+        // Used by TCP
+        tcphdr      tcp;
+        bool        ecn_used;
+        uint16_t    ack_stride;
+        TCPOptionContext tcp_options;
     };
     
     class Decompressor;
@@ -36,6 +52,13 @@ namespace ROHC
     public:
         DProfile (Decompressor* decomp, uint16_t cid);
         virtual ~DProfile() {};
+
+        /**
+         * Contexts are allocated from the arena of the owning decompressor
+         */
+        static void* operator new(size_t size, ContextArena* arena) {return ContextArena::Allocate(arena, size);}
+        static void operator delete(void* p, ContextArena*) {ContextArena::Free(p);}
+        static void operator delete(void* p) {ContextArena::Free(p);}
         
         // To be overridden
     public:
@@ -46,17 +69,47 @@ namespace ROHC
         //        virtual void InitializeGlobalControl(global_control& gc);
         virtual void MergeGlobalControlAndAppendHeaders(const global_control& gc, data_t& output) = 0;
         virtual void ParseCO(uint8_t packetTypeIndication, data_t& data, data_iterator pos, data_t& output) = 0;
-        virtual void ParseCORepair(const data_t& data, const_data_iterator r2_crc3_pos, data_t& output) = 0;
+        /**
+         * co_repair from the octet with r1 and the CRC-7 of the header,
+         * after the CID
+         */
+        virtual void ParseCORepair(const data_t& data, const_data_iterator r1_crc7_pos, data_t& output) = 0;
+        /**
+         * The dynamic chain of an IR-DYN (TCP) or a co_repair. gc gets the
+         * static fields of the context and the chain is parsed into it,
+         * the packet is then taken as an IR by
+         * MergeGlobalControlAndAppendHeaders.
+         */
+        virtual bool ParseIRDYN(global_control& gc, const data_t& data, const_data_iterator& pos) = 0;
         
         // Static functions
     public:
         static DProfile* Create(Decompressor* decomp, uint16_t cid, unsigned int lsbProfileID);
     protected:
-        static bool parse_ipv4_static(global_control& gc, const_data_iterator& pos, const_data_iterator& end);
+        /**
+         * The static and dynamic chain items of the innermost IP header,
+         * the version is told by the static one
+         */
+        static bool parse_ip_static(global_control& gc, const_data_iterator& pos, const_data_iterator& end);
+        /**
+         * The same for TCP, RFC 6846 has no innermost_ip flag
+         */
+        static bool parse_ip_static(global_control& gc, const_data_iterator& pos, const_data_iterator& end, bool innermost_flag);
+        static bool parse_ip_regular_dynamic(global_control& gc, const_data_iterator& pos, const_data_iterator& end);
+        /**
+         * The dynamic chain item of the IP-only profile, with the MSN and
+         * reorder_ratio
+         */
+        static bool parse_ip_endpoint_dynamic(global_control& gc, const_data_iterator& pos, const_data_iterator& end);
+        static bool parse_ipv4_static(global_control& gc, const_data_iterator& pos, const_data_iterator& end, bool innermost_flag = true);
         static bool parse_ipv4_regular_innermost_dynamic(global_control& gc, const_data_iterator& pos, const_data_iterator& end);
+        static bool parse_ipv4_endpoint_innermost_dynamic(global_control& gc, const_data_iterator& pos, const_data_iterator& end);
+        static bool parse_ipv6_static(global_control& gc, const_data_iterator& pos, const_data_iterator& end, bool innermost_flag = true);
+        static bool parse_ipv6_regular_dynamic(global_control& gc, const_data_iterator& pos, const_data_iterator& end);
+        static bool parse_ipv6_endpoint_dynamic(global_control& gc, const_data_iterator& pos, const_data_iterator& end);
         static bool parse_ip_id_enc_dyn(global_control& gc, const_data_iterator& pos, const_data_iterator& end);
 
-        bool parse_ip_id_sequential_variable(bool indicator, data_iterator& pos, const data_iterator& end, uint16_t& new_ip_id_offset, uint16_t& new_ip_id);
+        ParseResult_t parse_ip_id_sequential_variable(bool indicator, ByteReader& in, uint16_t& new_ip_id_offset, uint16_t& new_ip_id);
         void parse_inferred_sequential_ip_id(uint16_t delta_msn);
         uint16_t UpdateMSN(uint16_t lsbMSN, unsigned int lsbMSNWidth, uint16_t& newMsn) const;
         void UpdateIPIDOffset(uint8_t lsbIPID, unsigned int width, uint16_t& new_ip_id_offset) const;
@@ -68,7 +121,48 @@ namespace ROHC
         
         void SetReorderRatio(Reordering_t new_rr);
         Reordering_t GetReorderRatio() const {return reorder_ratio;}
-        bool parse_ipv4_innermost_irregular(data_iterator& pos, const data_iterator& end);
+        ParseResult_t parse_ip_innermost_irregular(ByteReader& in);
+
+        bool IPv6() const {return 6 == ip.version;}
+        /**
+         * The stored IP header in wire format, for IPv6 ip6 with the
+         * traffic class and hop limit from ip
+         */
+        const iphdr* IPHeader();
+        void AppendIPHeader(data_t& output);
+
+        /**
+         * The base header parsers store the received header CRC, it is
+         * checked against the uncompressed header once it has been rebuilt
+         * in output at headerStart, with its lengths and checksums. The
+         * context is saved before parsing and restored, and the output
+         * cut back to headerStart, if the CRC does not match.
+         */
+        void SetReceivedCRC(uint8_t crc, unsigned int bits) {received_crc = crc; received_crc_bits = bits;}
+        bool VerifyHeaderCRC(const data_t& output, size_t headerStart) const;
+        virtual void SaveContext(global_control& gc) const;
+        virtual void RestoreContext(const global_control& gc);
+
+        /**
+         * Decompressed headers are built from a template in wire format.
+         *
+         * ResetHeaderTemplate copies the stored headers after an IR and
+         * sets the static part of the header CRC (the ports or the SPI
+         * follow the IP header),
+         * AppendHeaderTemplate patches the fields a CO packet can change,
+         * updates the ip checksum incrementally and appends the headers
+         * and the payload with one copy each. rtp is null for UDP, udp and
+         * rtp for IP-only. The ESP header takes the place of the udp header.
+         * For UDP-Lite the checksum coverage of udp is kept as the length.
+         * The TCP header has its own layout, tcp4 and tcp6.
+         */
+        const iphdr* HeaderTemplate() const {return reinterpret_cast<const iphdr*>(&header_template);}
+        void ResetHeaderTemplate(const udphdr* udp, const rtphdr* rtp);
+        void AppendHeaderTemplate(const udphdr* udp, const rtphdr* rtp, const_data_iterator payload, const_data_iterator end, data_t& output);
+        void ResetHeaderTemplate(const esphdr* esp);
+        void AppendHeaderTemplate(const esphdr* esp, const_data_iterator payload, const_data_iterator end, data_t& output);
+        void ResetHeaderTemplate(const tcphdr* tcp);
+        void AppendHeaderTemplate(const tcphdr* tcp, const uint8_t* options, size_t optionsSize, const_data_iterator payload, const_data_iterator end, data_t& output);
     protected:
         Decompressor* decomp;
         uint16_t cid;
@@ -100,8 +194,52 @@ namespace ROHC
         size_t dataSizeCompressed;  
         bool largeCID;
         
-        // Stored ip header
+        // Stored ip header, see global_control
         iphdr ip;
+        ipv6hdr ip6;
+
+        // Static part set from the IR
+        HeaderCRC header_crc;
+        uint8_t received_crc;
+        unsigned int received_crc_bits;
+
+        // Headers of the last decompressed packet, with lengths and checksum
+        union
+        {
+            struct
+            {
+                iphdr ip;
+                union
+                {
+                    udphdr udp;
+                    esphdr esp;
+                };
+                rtphdr rtp;
+            } v4;
+            struct
+            {
+                ipv6hdr ip;
+                union
+                {
+                    udphdr udp;
+                    esphdr esp;
+                };
+                rtphdr rtp;
+            } v6;
+            struct
+            {
+                iphdr ip;
+                tcphdr tcp;
+                uint8_t options[maxTCPOptionsSize];
+            } tcp4;
+            struct
+            {
+                ipv6hdr ip;
+                tcphdr tcp;
+                uint8_t options[maxTCPOptionsSize];
+            } tcp6;
+        } header_template;
+        size_t header_template_size;
         
         size_t packetsSinceLastAck;
     private:
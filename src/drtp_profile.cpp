@@ -2,6 +2,7 @@
 #include "drtp_profile.h"
 #include "dudp_profile.h"
 #include <rohc/log.h>
+#include <cstring>
 
 using namespace std;
 
@@ -14,6 +15,10 @@ namespace ROHC
     ,time_stride(TIME_STRIDE_DEFAULT)
     , udp()
     , rtp()
+    , crc3_control(CalculateControlCRC3(REORDERING_NONE, 0, 0))
+    , crc3_reorder_ratio(REORDERING_NONE)
+    , crc3_ts_stride(0)
+    , crc3_time_stride(0)
     {
     }
     
@@ -21,7 +26,7 @@ namespace ROHC
     DRTPProfile::ParseIR(global_control& gc, const data_t& data, const_data_iterator& pos)
     {
         const_data_iterator end(data.end());
-        if (!DProfile::parse_ipv4_static(gc, pos, end))
+        if (!DProfile::parse_ip_static(gc, pos, end))
             return false;
         
         if(!DUDPProfile::parse_udp_static(gc, pos, end))
@@ -30,7 +35,7 @@ namespace ROHC
         if(!parse_rtp_static(gc, pos, end))
             return false;
         
-        if(!DProfile::parse_ipv4_regular_innermost_dynamic(gc, pos, end)) {
+        if(!DProfile::parse_ip_regular_dynamic(gc, pos, end)) {
             return false;
         }
 
@@ -39,127 +44,216 @@ namespace ROHC
         
         return parse_rtp_dynamic(gc, pos, end);
     }
+
+    bool
+    DRTPProfile::ParseIRDYN(global_control& gc, const data_t& data, const_data_iterator& pos)
+    {
+        SaveContext(gc);
+        gc.ip6 = ip6;
+
+        const_data_iterator end(data.end());
+        if(!DProfile::parse_ip_regular_dynamic(gc, pos, end))
+            return false;
+
+        if(!parse_udp_regular_dynamic(gc, pos, end))
+            return false;
+
+        return parse_rtp_dynamic(gc, pos, end);
+    }
     
     void
     DRTPProfile::ParseCO(uint8_t packetTypeIndication, data_t &data, data_iterator pos, data_t &output)
     {
-        // pos will point at remainder of base header
-        // Make first octet of base header adjacent to the remainder
-        --pos;
-        *pos = packetTypeIndication;
-        
-        if (0xfa == packetTypeIndication)
-        {
-			//cout << "parse_co_common" << endl;
-            if(!parse_co_common(pos, data.end()))
-                return;
-            
+        global_control saved;
+        SaveContext(saved);
+
+        if (!parse_co_header(packetTypeIndication, data, pos)) {
+            RestoreContext(saved);
+            return;
         }
-        else if (0x80 == (packetTypeIndication & 0xf0))
-        {
-            if(!parse_pt_0_crc7(pos, data.end()))
-                return;
+
+        size_t outputInitSize = output.size();
+        AppendHeaders(pos, data.end(), output);
+        if (!VerifyHeaderCRC(output, outputInitSize)) {
+            error("RTP - ParseCO, header crc %u failure\n", received_crc_bits);
+            output.resize(outputInitSize);
+            RestoreContext(saved);
+            SendNack();
+            return;
         }
-        else if (0 == (packetTypeIndication & 0x80))
+        SendFeedback1();        
+    }
+
+    const DRTPProfile::COParsers DRTPProfile::co_parsers;
+
+    DRTPProfile::COParsers::COParsers()
+    {
+        for (unsigned int i = 0; i < 256; ++i)
         {
-            if(!parse_pt_0_crc3(pos, data.end())) {
-                return;
+            parser_t seq = 0;
+            parser_t rnd = 0;
+            if (0xfa == i)
+                seq = rnd = &DRTPProfile::parse_co_common;
+            else if (0 == (i & 0x80))
+                seq = rnd = &DRTPProfile::parse_pt_0_crc3;
+            else if (0x80 == (i & 0xf0))
+                seq = rnd = &DRTPProfile::parse_pt_0_crc7;
+            else
+            {
+                if (0x90 == (i & 0xf0))
+                    seq = &DRTPProfile::parse_pt_1_seq_id;
+                else if (0xa0 == (i & 0xe0))
+                    seq = &DRTPProfile::parse_pt_1_seq_ts;
+                else if (0xc0 == (i & 0xf8))
+                    seq = &DRTPProfile::parse_pt_2_seq_id;
+                else if (0xc8 == (i & 0xf8))
+                    seq = &DRTPProfile::parse_pt_2_seq_both;
+                else if (0xd0 == (i & 0xf0))
+                    seq = &DRTPProfile::parse_pt_2_seq_ts;
+
+                if (0xa0 == (i & 0xe0))
+                    rnd = &DRTPProfile::parse_pt_1_rnd;
+                else if (0xc0 == (i & 0xe0))
+                    rnd = &DRTPProfile::parse_pt_2_rnd;
             }
+            sequential[i] = seq;
+            random[i] = rnd;
         }
-		else if ((0xa0 == (packetTypeIndication & 0xe0)) &&
-			(ip_id_behaviour >= IP_ID_BEHAVIOUR_RANDOM))
-		{
-            if(!parse_pt_1_rnd(pos, data.end()))
-                return;
-		}
-        else if( (0x90 == (packetTypeIndication & 0xf0)) &&
-			(ip_id_behaviour <= IP_ID_BEHAVIOUR_SEQUENTIAL_SWAPPED))
+    }
+
+    bool
+    DRTPProfile::parse_co_header(uint8_t packetTypeIndication, data_t& data, data_iterator& pos)
+    {
+        // pos will point at remainder of base header
+        // Make first octet of base header adjacent to the remainder
+        --pos;
+        *pos = packetTypeIndication;
+        
+        const uint8_t* begin = &*pos;
+        ByteReader in(begin, &data[0] + data.size());
+        ParseResult_t result = parse_co_header(packetTypeIndication, in);
+        if (PARSE_OK != result)
         {
-            if(!parse_pt_1_seq_id(pos, data.end())) {
-                return;
-            }
+            error("RTP - ParseCO, %s, type %x\n", ParseResultString(result), (unsigned) packetTypeIndication);
+            SendNack();
+            return false;
         }
-		else if ( (0xa0 == (packetTypeIndication & 0xe0)) &&
-			(ip_id_behaviour <= IP_ID_BEHAVIOUR_SEQUENTIAL_SWAPPED))
-		{
-			if(!parse_pt_1_seq_ts(pos, data.end())) {
-                return;
-            }
-		}
-		else if ( (0xc0 == (packetTypeIndication & 0xe0)) &&
-			(ip_id_behaviour >= IP_ID_BEHAVIOUR_RANDOM))
-		{
-            if (!parse_pt_2_rnd(pos, data.end())) {
-                return;
-            }
-		}
-        else if ((0xc0 == (packetTypeIndication & 0xf8)) &&
-			(ip_id_behaviour <= IP_ID_BEHAVIOUR_SEQUENTIAL_SWAPPED))
-        {
-            if(!parse_pt_2_seq_id(pos, data.end())) {
-                return;
-            }
+        pos += in.Position() - begin;
+        return true;
+    }
+
+    ParseResult_t
+    DRTPProfile::parse_co_header(uint8_t packetTypeIndication, ByteReader& in)
+    {
+        const parser_t* parsers = (ip_id_behaviour <= IP_ID_BEHAVIOUR_SEQUENTIAL_SWAPPED) ?
+            co_parsers.sequential : co_parsers.random;
+        parser_t parser = parsers[packetTypeIndication];
+        if (!parser)
+            return PARSE_UNKNOWN_TYPE;
+
+        ParseResult_t result = (this->*parser)(in);
+        if (PARSE_OK != result)
+            return result;
+
+        if (!in.Remaining())
+            return PARSE_TRUNCATED;
+
+        result = parse_ip_innermost_irregular(in);
+        if (PARSE_OK != result)
+            return result;
+        
+        result = parse_udp_irregular(in);
+        if (PARSE_OK != result)
+            return result;
+        
+		// The sequence number should always be the msn, in NB order
+		rtp.sequence_number = rohc_htons(msn);
+        return PARSE_OK;
+    }
+
+    ParseResult_t
+    DRTPProfile::parse_udp_irregular(ByteReader& in)
+    {
+        if (udp_checksum_used && !in.ReadRaw(udp.check))
+            return PARSE_TRUNCATED;
+        return PARSE_OK;
+    }
+
+    void
+    DRTPProfile::SaveContext(global_control& gc) const
+    {
+        DProfile::SaveContext(gc);
+        gc.ts_stride = ts_stride;
+        gc.time_stride = time_stride;
+        gc.ts_scaled = ts_scaled;
+        gc.ts_offset = ts_offset;
+        gc.udp = udp;
+        gc.rtp = rtp;
+    }
+
+    void
+    DRTPProfile::RestoreContext(const global_control& gc)
+    {
+        DProfile::RestoreContext(gc);
+        ts_stride = gc.ts_stride;
+        time_stride = gc.time_stride;
+        ts_scaled = gc.ts_scaled;
+        ts_offset = gc.ts_offset;
+        udp = gc.udp;
+        rtp = gc.rtp;
+    }
+    
+    /*
+     See DIPProfile::ParseCORepair
+     */
+    void
+    DRTPProfile::ParseCORepair(const data_t& data, const_data_iterator r1_crc7_pos, data_t& output)
+    {
+        const_data_iterator pos = r1_crc7_pos;
+        if ((data.end() - pos) < 2) {
+            error("RTP - co_repair, not enough data\n");
+            return;
         }
-		else if ((0xc8 == (packetTypeIndication & 0xf8)) &&
-			(ip_id_behaviour <= IP_ID_BEHAVIOUR_SEQUENTIAL_SWAPPED))
-		{
-			if(!parse_pt_2_seq_both(pos, data.end())) {
-                return;
-            }
-		}
-		else if ((0xd0 == (packetTypeIndication & 0xf0)) &&
-			(ip_id_behaviour <= IP_ID_BEHAVIOUR_SEQUENTIAL_SWAPPED))
-		{
-            if(!parse_pt_2_seq_ts(pos, data.end()))
-                return;
-		}
-        else
+        uint8_t r1_crc7 = *pos++;
+        uint8_t r2_crc3 = *pos++;
+
+        if ((r1_crc7 & 0x80) || (r2_crc3 & 0xf8))
         {
-            error("Unknown base header type: %x\n", (unsigned) packetTypeIndication);
+            error("RTP - co_repair, reserved bits not zero\n");
             SendNack();
             return;
         }
 
-        if (data.end() == pos)
-        {
-            error("RTP - ParseCO, missing data");
+        global_control gc;
+        memset(&gc, 0, sizeof(gc));
+        if (!ParseIRDYN(gc, data, pos)) {
+            error("RTP - co_repair, failed to parse the dynamic chain\n");
             SendNack();
             return;
         }
 
-		if(!parse_ipv4_innermost_irregular(pos, data.end()))
+        if ((r2_crc3 & 7) != control_crc3(gc.reorder_ratio, gc.ts_stride, gc.time_stride)) {
+            error("RTP - co_repair, control crc failure\n");
+            SendNack();
             return;
-        
-        // udp irreg
-        if (udp_checksum_used)
-        {
-            if (!GetValue(pos, data.end(), udp.check)) {
-                error("RTP - failed to get udp checksum\n");
-                return;
-            }
         }
-        
-		// The sequence number should always be the msn, in NB order
-		rtp.sequence_number = rohc_htons(msn);
 
-        // Append payload
-        size_t ipIdx = output.size();
-        AppendData(output, ip);
-        AppendData(output, udp);
-		AppendData(output, rtp);
+        global_control saved;
+        SaveContext(saved);
+
+        size_t outputInitSize = output.size();
+        MergeGlobalControlAndAppendHeaders(gc, output);
         output.insert(output.end(), pos, data.end());
-        iphdr* pip = reinterpret_cast<iphdr*>(&output[ipIdx]);
-        pip->tot_len = rohc_htons(static_cast<uint16_t>(output.size()));
-        udphdr* pudp = reinterpret_cast<udphdr*>(pip+1);
-        pudp->len = rohc_htons(static_cast<uint16_t>(output.size() - sizeof(iphdr)));
-        calculateIpHeaderCheckSum(pip);
-        SendFeedback1();        
-    }
-    
-    void
-    DRTPProfile::ParseCORepair(const data_t& /*data*/, const_data_iterator /*r2_crc3_pos*/, data_t& /*output*/)
-    {
-        
+        setLengthsAndIPChecksum(output.begin() + outputInitSize, output.end());
+
+        SetReceivedCRC(r1_crc7 & 0x7f, 7);
+        if (!VerifyHeaderCRC(output, outputInitSize)) {
+            error("RTP - co_repair, header crc failure\n");
+            output.resize(outputInitSize);
+            RestoreContext(saved);
+            SendNack();
+            return;
+        }
     }
     
     void
@@ -173,6 +267,7 @@ namespace ROHC
         ip_id_behaviour = gc.ip_id_behaviour;
         udp_checksum_used = gc.udp_checksum_used;
         ip = gc.ip;
+        ip6 = gc.ip6;
         udp = gc.udp;
         rtp = gc.rtp;
 
@@ -180,13 +275,16 @@ namespace ROHC
 			ts_stride = gc.ts_stride;
 
 		UpdateIPIDOffsetFromID();
+		ResetHeaderTemplate(&udp, &rtp);
 
 		if (ts_stride)
 		{
-			ts_offset = rohc_htonl(rtp.timestamp) * ts_stride;
+			uint32_t host_ts = rohc_htonl(rtp.timestamp);
+			ts_scaled = host_ts / ts_stride;
+			ts_offset = host_ts % ts_stride;
 		}
         
-        AppendData(output, ip);
+        AppendIPHeader(output);
         AppendData(output, udp);        
         AppendData(output, rtp);  
 
@@ -343,22 +441,17 @@ namespace ROHC
            cc.UVALUE)                                               [ VARIABLE ];
      }
      */
-	bool
-	DRTPProfile::parse_co_common(data_iterator& pos, const data_iterator& end) {
-        if ((end - pos) < 3) {
-            error("parse_co_common, not enough data\n");
-            return false;
-        }
-		data_iterator headerStart = pos;
-
+	ParseResult_t
+	DRTPProfile::parse_co_common(ByteReader& in) {
+        if (!in.Has(3))
+            return PARSE_TRUNCATED;
 		// skip packet type indication
-		++pos;
+		in.Skip(1);
 
-		uint8_t marker_crc7 = *pos;
-		// reset CRC
-		*pos++ &= 0x80;
+		uint8_t marker_crc7 = in.U8();
+		SetReceivedCRC(marker_crc7 & 0x7f, 7);
 
-		uint8_t flags_crc3 = *pos++;
+		uint8_t flags_crc3 = in.U8();
 
 		bool flags1_indicator = (flags_crc3 & 0x80) > 0;
 		bool flags2_indicator = (flags_crc3 & 0x40) > 0;
@@ -370,11 +463,7 @@ namespace ROHC
 		bool tos_tc_indicator = false;
 		bool df = HasDontFragment(&ip);
 		IPIDBehaviour_t new_ip_id_behaviour = ip_id_behaviour;
-		Reordering_t newRR = GetReorderRatio();;
-
-        if (!parse_profile_1_7_flags1_enc(flags1_indicator, pos, end, ttl_hopl_indicator, tos_tc_indicator, df, new_ip_id_behaviour, newRR)){
-            return false;
-        }
+		Reordering_t newRR = GetReorderRatio();
 
 		bool list_indicator = false;
 		bool pt_indicator = false;
@@ -382,69 +471,53 @@ namespace ROHC
 		bool pad_bit = rtp.padding != 0;
 		bool extension = rtp.extension != 0;
 
-		if (!parse_profile_1_flags2_enc(flags2_indicator, pos, end, list_indicator, pt_indicator, tis_indicator, pad_bit, extension)) {
-            return false;
-        }
+		if (!in.Has(flags1_indicator + flags2_indicator))
+			return PARSE_TRUNCATED;
+		if (flags1_indicator)
+			parse_profile_1_7_flags1_enc(in.U8(), ttl_hopl_indicator, tos_tc_indicator, df, new_ip_id_behaviour, newRR);
+		if (flags2_indicator)
+			parse_profile_1_flags2_enc(in.U8(), list_indicator, pt_indicator, tis_indicator, pad_bit, extension);
+
+		if (!in.Has(tos_tc_indicator + ttl_hopl_indicator + pt_indicator))
+			return PARSE_TRUNCATED;
 
 		uint8_t tos_tc = ip.tos;
 		if (tos_tc_indicator)
-		{
-            if ((end - pos) < 1) {
-                error("parse_co_common, tos_tc_indicator\n");
-                return false;
-            }
-			tos_tc = *pos++;
-		}
+			tos_tc = in.U8();
 
 		uint8_t ttl_hopl = ip.ttl;
 		if (ttl_hopl_indicator)
-		{
-            if ((end - pos) < 1) {
-                error("parse_co_common, ttl_hopl_indicator\n");
-                return false;
-            }
-			ttl_hopl = *pos++;
-		}
+			ttl_hopl = in.U8();
 
 		uint8_t new_payload_type = rtp.payload_type;
 		if (pt_indicator)
-		{
-            if ((end - pos) < 1) {
-                error("parse_co_common, pt_indicator\n");
-                return false;
-            }
-			new_payload_type = *pos++;
-		}
+			new_payload_type = in.U8();
 
 		uint16_t new_msn = 0;
 		unsigned int delta_msn = 0;
-        if (!parse_sdvl_sn_lsb(pos, end, new_msn, delta_msn)) {
-            return false;
-        }
+		ParseResult_t result = parse_sdvl_sn_lsb(in, new_msn, delta_msn);
+		if (PARSE_OK != result)
+			return result;
 		
 		uint16_t new_ip_id_offset = ip_id_offset;
 		uint16_t new_ip_id;
-        if (!parse_ip_id_sequential_variable(ip_id_indicator, pos, end, new_ip_id_offset, new_ip_id)) {
-            return false;
-        }
-
+		result = parse_ip_id_sequential_variable(ip_id_indicator, in, new_ip_id_offset, new_ip_id);
+		if (PARSE_OK != result)
+			return result;
 
 		// ts_scaled
 		// timestamp
 		// ts_stride
 		uint32_t new_timestamp = 0;
-		if (!parse_variable_unscaled_timestamp(tss_indicator, tsc_indicator, pos, end, new_timestamp) ) {
-            return false;
-        }
-            
+		result = parse_variable_unscaled_timestamp(tss_indicator, tsc_indicator, in, new_timestamp);
+		if (PARSE_OK != result)
+			return result;
 
 		uint32_t new_ts_stride = ts_stride;
 		if (tss_indicator) {
-            if (!SDVLDecode(pos, end, &new_ts_stride)) {
-                error("parse_co_common, tss_indicator\n");
-                SendNack();
-                return false;
-            }
+			result = in.ReadSDVL(new_ts_stride);
+			if (PARSE_OK != result)
+				return result;
 		}
 
 		// time_stride
@@ -452,19 +525,9 @@ namespace ROHC
 
 		// csrc_list
 
-		// Check CRC7 && CRC3
-		if ((flags_crc3 & 7) != control_crc3(newRR, new_ts_stride, new_time_stride)) {
-            //error("parse_co_common, CRC 3\n");
-			SendNack();
-			return false;
-		}
-
-		uint8_t calc_crc7 = CRC7(headerStart, pos);
-		if (calc_crc7 != (marker_crc7 & 0x7f)) {
-            error("parse_co_common, CRC 7\n");
-			SendNack();
-			return false;
-		}
+		// The header CRC is checked by ParseCO
+		if ((flags_crc3 & 7) != control_crc3(newRR, new_ts_stride, new_time_stride))
+			return PARSE_CONTROL_CRC;
 
 		if (df) {
 			SetDontFragment(&ip);
@@ -511,7 +574,7 @@ namespace ROHC
 			return parse_inferred_scaled_ts(delta_msn);
 		}
 
-		return true;
+		return PARSE_OK;
 	}
 
 	/*
@@ -524,32 +587,22 @@ namespace ROHC
          ip_id =:= inferred_sequential_ip_id                [ 0 ];
      }
      */
-	bool 
-	DRTPProfile::parse_pt_0_crc3(data_iterator& pos, const data_iterator& end) {
-        if ((end - pos) < 1) {
-            error("parse_pt_0_crc3, not enough data\n");
-            return false;
-        }
-		uint8_t msn_crc3 = *pos++;
-
-		uint8_t cpy = msn_crc3 & 0xf8;
-
-		uint8_t crc3 = CRC3(&cpy, &cpy + 1);
-		if ((msn_crc3 & 0x07) != crc3) {
-            error("parse_pt_0_crc3, checksum\n");
-			SendNack();
-			return false;
-		}
+	ParseResult_t
+	DRTPProfile::parse_pt_0_crc3(ByteReader& in) {
+        if (!in.Has(1))
+            return PARSE_TRUNCATED;
+		uint8_t msn_crc3 = in.U8();
+		SetReceivedCRC(msn_crc3 & 0x07, 3);
 
 		uint16_t lsbMsn = (msn_crc3 >> 3) & 0x0f;
 		uint16_t delta_msn = UpdateMSN(lsbMsn, 4, msn);
 		
-		if (!parse_inferred_scaled_ts(delta_msn)) {
-            return false;
-        }
+		ParseResult_t result = parse_inferred_scaled_ts(delta_msn);
+		if (PARSE_OK != result)
+			return result;
 		parse_inferred_sequential_ip_id(delta_msn);
 
-		return true;
+		return PARSE_OK;
 	}
 
 	/*
@@ -562,34 +615,26 @@ namespace ROHC
          ip_id =:= inferred_sequential_ip_id                [ 0 ];
      }
      */
-	bool 
-	DRTPProfile::parse_pt_0_crc7(data_iterator& pos, const data_iterator& end) {
-        if ((end - pos) < 2) {
-            error("parse_pt_0_crc7, not enough data\n");
-            return false;
-        }
+	ParseResult_t
+	DRTPProfile::parse_pt_0_crc7(ByteReader& in) {
+        if (!in.Has(2))
+            return PARSE_TRUNCATED;
 		uint8_t buf[2];
-		buf[0] = *pos++;
-		buf[1] = *pos++;
+		buf[0] = in.U8();
+		buf[1] = in.U8();
 
-		uint8_t crc7 = buf[1] & 0x7f;
-		buf[1] &= 0x80;
+		SetReceivedCRC(buf[1] & 0x7f, 7);
 
-		if (crc7 != CRC7(buf, buf + sizeof(buf))) {
-            error("parse_pt_0_crc7, checksum\n");
-			SendNack();
-			return false;
-		}
 		uint16_t lsbMsn = ((buf[0] & 0x0f) << 1) | (buf[1] >> 7);
 		uint16_t delta_msn = UpdateMSN(lsbMsn, 5, msn);
 
-		if (!parse_inferred_scaled_ts(delta_msn)) {
-            return false;
-        }
+		ParseResult_t result = parse_inferred_scaled_ts(delta_msn);
+		if (PARSE_OK != result)
+			return result;
 
 		parse_inferred_sequential_ip_id(delta_msn);
 
-		return true;
+		return PARSE_OK;
 	}
 
 
@@ -607,27 +652,17 @@ namespace ROHC
          header_crc =:= crc3(THIS.UVALUE, THIS.ULENGTH)         [ 3 ];
      }
      */
-	bool 
-	DRTPProfile::parse_pt_1_rnd(data_iterator& pos, const data_iterator& end)
+	ParseResult_t
+	DRTPProfile::parse_pt_1_rnd(ByteReader& in)
 	{
-        if ((end - pos) < 2) {
-            error("parse_pt_1_rnd, not enough data\n");
-            return false;
-        }
+        if (!in.Has(2))
+            return PARSE_TRUNCATED;
 		uint8_t buf[2];
-		buf[0] = *pos++;
-		buf[1] = *pos++;
+		buf[0] = in.U8();
+		buf[1] = in.U8();
 
 		uint8_t ts_scaled_crc3 = buf[1];
-		buf[1] &= 0xf8;
-
-		uint8_t crc3 = CRC3(buf, buf + sizeof(buf));
-
-		if (crc3 != (ts_scaled_crc3 & 0x07)) {
-            error("parse_pt_1_rnd, checksum\n");
-			SendNack();
-			return false;
-		}
+		SetReceivedCRC(ts_scaled_crc3 & 0x07, 3);
 
 		rtp.marker = (buf[0] & 0x10) > 0;
 
@@ -638,7 +673,7 @@ namespace ROHC
 		UpdateMSN(lsbMsn, 4, msn);
 		UpdateTimestamp(scaled_ts_lsb, 5);
 
-		return true;
+		return PARSE_OK;
 	}
 
     /*
@@ -655,26 +690,17 @@ namespace ROHC
          timestamp =:= inferred_scaled_field                        [ 0 ];
      }
      */
-	bool 
-	DRTPProfile::parse_pt_1_seq_id(data_iterator& pos, const data_iterator& end)
+	ParseResult_t
+	DRTPProfile::parse_pt_1_seq_id(ByteReader& in)
 	{
-        if ((end - pos) < 2) {
-            error("parse_pt_1_seq_id, not enough data\n");
-            return false;
-        }
+        if (!in.Has(2))
+            return PARSE_TRUNCATED;
 		uint8_t buf[2];
-		buf[0] = *pos++;
-		buf[1] = *pos++;
+		buf[0] = in.U8();
+		buf[1] = in.U8();
 
 		uint8_t msn_crc3 = buf[1];
-		buf[1] &= 0xf8;
-
-		uint8_t crc3 = CRC3(buf, buf + sizeof(buf));
-		if ((msn_crc3 & 7) != crc3) {
-            error("parse_pt_1_seq_id, checksum\n");
-			SendNack();
-			return false;
-		}
+		SetReceivedCRC(msn_crc3 & 7, 3);
 
 		uint16_t lsbMsn = msn_crc3 >> 3;
 		uint16_t delta_msn = UpdateMSN(lsbMsn, 5, msn);
@@ -700,30 +726,25 @@ namespace ROHC
          ip_id =:= inferred_sequential_ip_id                    [ 0 ];
      }
      */
-	bool 
-	DRTPProfile::parse_pt_1_seq_ts(data_iterator& pos, const data_iterator& end) {
-        if ((end - pos) < 2) {
-            error("parse_pt_1_seq_ts, not enough data\n");
-            return false;
-        }
+	ParseResult_t
+	DRTPProfile::parse_pt_1_seq_ts(ByteReader& in) {
+        if (!in.Has(2))
+            return PARSE_TRUNCATED;
 		uint8_t buf[2];
-		buf[0] = *pos++;
-		buf[1] = *pos++;
+		buf[0] = in.U8();
+		buf[1] = in.U8();
 
 		uint8_t scaled_ts_lsb_crc3 = buf[1];
-		buf[1] &= 0xf8;
+		SetReceivedCRC(scaled_ts_lsb_crc3 & 0x07, 3);
 
-		uint8_t crc3 = CRC3(buf, buf + sizeof(buf));
-		if (crc3 != (scaled_ts_lsb_crc3 & 0x07))
-		{
-            error("parse_pt_1_seq_ts, checksum\n");
-			SendNack();
-			return false;
-		}
+		rtp.marker = (buf[0] & 0x10) > 0;
 
-		rtp.marker = buf[0] & 0x10;
+		uint8_t lsbMsn = buf[0] & 0x0f;
+		uint16_t delta_msn = UpdateMSN(lsbMsn, 4, msn);
+		parse_inferred_sequential_ip_id(delta_msn);
+		UpdateTimestamp(scaled_ts_lsb_crc3 >> 3, 5);
 
-		return true;
+		return PARSE_OK;
 	}
 
 	 /*
@@ -740,27 +761,17 @@ namespace ROHC
          header_crc =:= crc7(THIS.UVALUE, THIS.ULENGTH)         [ 7 ];
      }
      */
-	bool 
-	DRTPProfile::parse_pt_2_rnd(data_iterator& pos, const data_iterator& end) {
-        if ((end - pos) < 3) {
-            error("parse_pt_2_rnd, not enough data\n");
-            return false;
-        }
+	ParseResult_t
+	DRTPProfile::parse_pt_2_rnd(ByteReader& in) {
+        if (!in.Has(3))
+            return PARSE_TRUNCATED;
 		uint8_t buf[3];
-		buf[0] = *pos++;
-		buf[1] = *pos++;
-		buf[2] = *pos++;
+		buf[0] = in.U8();
+		buf[1] = in.U8();
+		buf[2] = in.U8();
 
 		uint8_t marker_crc7 = buf[2];
-		buf[2] &= 0x80;
-
-		uint8_t crc7 = CRC7(buf, buf + sizeof(buf));
-
-		if (crc7 != (marker_crc7 & 0x7f)) {
-            error("parse_pt_2_rnd, checksum\n");
-			SendNack();
-			return false;
-		}
+		SetReceivedCRC(marker_crc7 & 0x7f, 7);
 
 		uint8_t lsbMsn = (buf[0] & 0x1f) << 2;
 		lsbMsn |= buf[1] >> 6;
@@ -772,7 +783,7 @@ namespace ROHC
 		UpdateMSN(lsbMsn, 7, msn);
 		UpdateTimestamp(scaled_ts_lsb, 6);
 
-		return true;
+		return PARSE_OK;
 	}
 
 	/*
@@ -789,29 +800,19 @@ namespace ROHC
          timestamp =:= inferred_scaled_field                        [ 0 ];
      }
      */
-	bool 
-	DRTPProfile::parse_pt_2_seq_id(data_iterator& pos, const data_iterator& end)
+	ParseResult_t
+	DRTPProfile::parse_pt_2_seq_id(ByteReader& in)
 	{
-        if ((end - pos) < 3) {
-            error("parse_pt_2_seq_id, not enough data\n");
-            return false;
-        }
+        if (!in.Has(3))
+            return PARSE_TRUNCATED;
 		uint8_t buf[3];
 
-		buf[0] = *pos++;
-		buf[1] = *pos++;
-		buf[2] = *pos++;
+		buf[0] = in.U8();
+		buf[1] = in.U8();
+		buf[2] = in.U8();
 
 		uint8_t ip_id_crc7 = buf[2];
-		buf[2] &= 0x80;
-
-		uint8_t crc7 = CRC7(buf, buf + sizeof(buf));
-
-		if (crc7 != (ip_id_crc7 & 0x7f)) {
-            error("parse_pt_2_seq_id, checksum\n");
-			SendNack();
-			return false;
-		}
+		SetReceivedCRC(ip_id_crc7 & 0x7f, 7);
 
 		uint8_t lsbMsn = (buf[0] & 0x07) << 4;
 		lsbMsn |= buf[1] >> 4;
@@ -841,26 +842,18 @@ namespace ROHC
          marker =:= irregular(1)                                    [ 1 ];
      }
      */
-	bool 
-	DRTPProfile::parse_pt_2_seq_both(data_iterator& pos, const data_iterator& end) {
-        if ((end - pos) < 4) {
-            error("parse_pt_2_seq_both, not enough data\n");
-            return false;
-        }
+	ParseResult_t
+	DRTPProfile::parse_pt_2_seq_both(ByteReader& in) {
+        if (!in.Has(4))
+            return PARSE_TRUNCATED;
 		uint8_t buf[4];
-		buf[0] = *pos++;
-		buf[1] = *pos++;
-		buf[2] = *pos++;
-		buf[3] = *pos++;
+		buf[0] = in.U8();
+		buf[1] = in.U8();
+		buf[2] = in.U8();
+		buf[3] = in.U8();
 
 		uint8_t ip_id_crc7 = buf[2];
-		buf[2] &= 0x80;
-
-		if ((ip_id_crc7 & 0x7f) != CRC7(buf, buf + sizeof(buf))) {
-            error("parse_pt_2_seq_both, checksum\n");
-			SendNack();
-			return false;
-		}
+		SetReceivedCRC(ip_id_crc7 & 0x7f, 7);
 
 		uint16_t lsbMsn = (buf[0] & 0x07) << 4;
 		lsbMsn |= buf[1] >> 4;
@@ -876,7 +869,7 @@ namespace ROHC
 		UpdateIPIDFromOffset();
 		UpdateTimestamp(scaled_ts_lsb, 7);
 
-		return true;
+		return PARSE_OK;
 	}
 
 	 /*
@@ -893,27 +886,17 @@ namespace ROHC
      ip_id =:= inferred_sequential_ip_id							[ 0 ];
      }
      */
-	bool 
-	DRTPProfile::parse_pt_2_seq_ts(data_iterator& pos, const data_iterator& end) {
-        if ((end - pos) < 3) {
-            error("parse_pt_2_seq_ts, not enough data\n");
-            return false;
-        }
+	ParseResult_t
+	DRTPProfile::parse_pt_2_seq_ts(ByteReader& in) {
+        if (!in.Has(3))
+            return PARSE_TRUNCATED;
 		uint8_t buf[3];
-		buf[0] = *pos++;
-		buf[1] = *pos++;
-		buf[2] = *pos++;
+		buf[0] = in.U8();
+		buf[1] = in.U8();
+		buf[2] = in.U8();
 
 		uint8_t marker_crc = buf[2];
-		buf[2] &= 0x80;
-
-		uint8_t crc7 = CRC7(buf, buf + sizeof(buf));
-
-		if ((marker_crc & 0x7f) != crc7) {
-            error("parse_pt_2_seq_ts, checksum\n");
-			SendNack();
-			return false;
-		}
+		SetReceivedCRC(marker_crc & 0x7f, 7);
 
 		uint8_t msn_lsb = (buf[0] & 0x0f) << 3;
 		msn_lsb |= buf[1] >> 5;
@@ -926,132 +909,110 @@ namespace ROHC
 		parse_inferred_sequential_ip_id(delta_msn);
 
 		UpdateTimestamp(scaled_ts_lsb, 5);
-		return true;
+		return PARSE_OK;
 	}
 
 
 	uint8_t 
-	DRTPProfile::control_crc3(Reordering_t new_reorder_ratio, uint32_t new_ts_stride, uint32_t new_time_stride) const {
-		data_t data;
+	DRTPProfile::control_crc3(Reordering_t new_reorder_ratio, uint32_t new_ts_stride, uint32_t new_time_stride) {
+		// Only recalculated when one of the control fields has changed
+		if ((new_reorder_ratio != crc3_reorder_ratio) ||
+			(new_ts_stride != crc3_ts_stride) ||
+			(new_time_stride != crc3_time_stride))
+		{
+			crc3_control = CalculateControlCRC3(new_reorder_ratio, new_ts_stride, new_time_stride);
+			crc3_reorder_ratio = new_reorder_ratio;
+			crc3_ts_stride = new_ts_stride;
+			crc3_time_stride = new_time_stride;
+		}
+		return crc3_control;
+	}
 
-		data.push_back(static_cast<uint8_t>(new_reorder_ratio) & 0x03);
-		AppendDataToNBO(data, new_ts_stride);
-		AppendDataToNBO(data, new_time_stride);
-		return CRC3(data.begin(), data.end());
+	uint8_t
+	DRTPProfile::CalculateControlCRC3(Reordering_t new_reorder_ratio, uint32_t new_ts_stride, uint32_t new_time_stride) {
+		uint8_t data[9];
+		data[0] = static_cast<uint8_t>(new_reorder_ratio) & 0x03;
+		SetNBO(&data[1], new_ts_stride);
+		SetNBO(&data[5], new_time_stride);
+		return CRC3(data, data + sizeof(data));
 	}
 		
 
-	bool 
-	DRTPProfile::parse_profile_1_7_flags1_enc(bool flags1_indicator, data_iterator& pos, const data_iterator& end, bool& ttl_hopl_indicator, bool& tos_tc_indicator, bool& df, IPIDBehaviour_t& new_ip_id_behaviour, Reordering_t& new_reorder_ratio) const {
-		if (flags1_indicator) {
-            if ((end - pos) < 1) {
-                error("parse_profile_1_7_flags1_enc, not enough data\n");
-                return false;
-            }
-			uint8_t flags = *pos++;
-			ttl_hopl_indicator = (flags & 0x40) > 0;
-			tos_tc_indicator = (flags & 0x20) > 0;
-			df = (flags & 0x10) > 0;
-			new_ip_id_behaviour = static_cast<IPIDBehaviour_t>((flags >> 2) & 3);
-			new_reorder_ratio = static_cast<Reordering_t>(flags & 3);
-		}
-
-		return true;
+	void
+	DRTPProfile::parse_profile_1_7_flags1_enc(uint8_t flags, bool& ttl_hopl_indicator, bool& tos_tc_indicator, bool& df, IPIDBehaviour_t& new_ip_id_behaviour, Reordering_t& new_reorder_ratio) const {
+		ttl_hopl_indicator = (flags & 0x40) > 0;
+		tos_tc_indicator = (flags & 0x20) > 0;
+		df = (flags & 0x10) > 0;
+		new_ip_id_behaviour = static_cast<IPIDBehaviour_t>((flags >> 2) & 3);
+		new_reorder_ratio = static_cast<Reordering_t>(flags & 3);
 	}
 
-	bool 
-	DRTPProfile::parse_profile_1_flags2_enc(bool flags2_indicator, data_iterator& pos, const data_iterator& end, bool& list_indicator, bool& pt_indicator, bool& tis_indicator, bool& pad_bit, bool& extension) const {
-		if (flags2_indicator) {
-            if ((end - pos) < 1) {
-                error("parse_profile_1_flags2_enc, not enough data\n");
-                return false;
-            }
-			uint8_t flags = *pos++;
-			list_indicator = (flags & 0x80) > 0;
-			pt_indicator = (flags & 0x40) > 0;
-			tis_indicator = (flags & 0x20) > 0;
-			pad_bit = (flags & 0x10) > 0;
-			extension = (flags & 0x08) > 0;
-		}
-		
-		return true;
+	void
+	DRTPProfile::parse_profile_1_flags2_enc(uint8_t flags, bool& list_indicator, bool& pt_indicator, bool& tis_indicator, bool& pad_bit, bool& extension) const {
+		list_indicator = (flags & 0x80) > 0;
+		pt_indicator = (flags & 0x40) > 0;
+		tis_indicator = (flags & 0x20) > 0;
+		pad_bit = (flags & 0x10) > 0;
+		extension = (flags & 0x08) > 0;
 	}
 
-    bool DRTPProfile::parse_sdvl_sn_lsb(data_iterator& pos, const data_iterator& end, uint16_t& new_msn, unsigned int& delta_msn) const
+    ParseResult_t DRTPProfile::parse_sdvl_sn_lsb(ByteReader& in, uint16_t& new_msn, unsigned int& delta_msn) const
 	{
-        if ((end - pos) < 1) {
-            error("parse_sdvl_sn_lsb, not enough data\n");
-            return false;
-        }
-		uint8_t first = *pos++;
+        if (!in.Has(1))
+            return PARSE_TRUNCATED;
+		uint8_t first = in.Peek();
 
-		if ((first & 0xe0) == 0xc0) {
-            if ((end - pos) < 2) {
-                error("parse_sdvl_sn_lsb, not enough data\n");
-                return false;
-            }
-			uint8_t msb = *pos++;
-			uint8_t lsb = *pos++;
-			new_msn = (msb << 8) + lsb;
-			delta_msn = new_msn - msn;
+		if ((first & 0x80) == 0x00) {
+			in.Skip(1);
+			uint16_t maskedMsn = first & 0x7f;
+			delta_msn = UpdateMSN(maskedMsn, 7, new_msn);
 		}
 		else if ((first & 0xc0) == 0x80) {
-            if ((end - pos) < 1) {
-                error("parse_sdvl_sn_lsb, not enough data\n");
-                return false;
-            }
+            if (!in.Has(2))
+                return PARSE_TRUNCATED;
+			in.Skip(1);
 			uint8_t msb = first & 0x3f;
-			uint8_t lsb = *pos++;
+			uint8_t lsb = in.U8();
 			uint16_t maskedMsn = (msb << 8) + lsb;
 			delta_msn = UpdateMSN(maskedMsn, 14, new_msn);
 		}
-		else if ((first & 0x80) == 0x00) {
-			uint16_t maskedMsn = first & 0x7f;
-			delta_msn = UpdateMSN(maskedMsn, 7, new_msn);
+		else if ((first & 0xe0) == 0xc0) {
+            if (!in.Has(3))
+                return PARSE_TRUNCATED;
+			in.Skip(1);
+			new_msn = in.U16();
+			delta_msn = new_msn - msn;
 		}
 		else {
-            error("parse_sdvl_sn_lsb, unknown\n");
-            return false;
+            return PARSE_BAD_SDVL;
 		}
 
-		return true;
+		return PARSE_OK;
 	}
 
-	bool 
-	DRTPProfile::parse_variable_unscaled_timestamp(bool /*tss_indicator*/, bool tsc_indicator, data_iterator& pos, const data_iterator& end, uint32_t& new_timestamp) const {
+	ParseResult_t
+	DRTPProfile::parse_variable_unscaled_timestamp(bool /*tss_indicator*/, bool tsc_indicator, ByteReader& in, uint32_t& new_timestamp) const {
 		if (!tsc_indicator) {
-            if ((end - pos) < 5) {
-                error("parse_variable_unscaled_timestamp, not enough data\n");
-                return false;
-            }
-			uint8_t disc = *pos++;
-            if (0xff != disc) {
-                error("parse_variable_unscaled_timestamp, wrong disc\n");
-                return false;
-            }
-			new_timestamp = (*pos++) << 24;
-			new_timestamp |= (*pos++) << 16;
-			new_timestamp |= (*pos++) << 8;
-			new_timestamp |= (*pos++);
+            if (!in.Has(5))
+                return PARSE_TRUNCATED;
+            if (0xff != in.U8())
+                return PARSE_BAD_FIELD;
+			new_timestamp = in.U32();
 		}
 
-		return true;
+		return PARSE_OK;
 	}
 
-	bool 
+	ParseResult_t
 	DRTPProfile::parse_inferred_scaled_ts(uint16_t delta_msn) {
-        if (!ts_stride) {
-//            error("received inferred scaled ts, but have no ts_stride\n");
-            SendNack();
-            return false;
-        }
-        
+        if (!ts_stride)
+            return PARSE_NO_TS_STRIDE;
         
 		uint32_t new_ts = rohc_htonl(rtp.timestamp) + delta_msn * ts_stride;
 		rtp.timestamp = rohc_htonl( new_ts );
 		ts_offset = new_ts % ts_stride;
 		ts_scaled = new_ts / ts_stride;
-        return true;
+        return PARSE_OK;
 	}
 
 	void
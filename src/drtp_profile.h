@@ -16,10 +16,11 @@ namespace ROHC
 
         void MergeGlobalControlAndAppendHeaders(const global_control& gc, data_t& output);
         static bool ParseIR(global_control& gc, const data_t& data, const_data_iterator& pos);
+        virtual bool ParseIRDYN(global_control& gc, const data_t& data, const_data_iterator& pos);
         virtual void ParseCO(uint8_t packetTypeIndication, data_t& data, data_iterator pos, data_t& output);
         
         
-        virtual void ParseCORepair(const data_t& data, const_data_iterator r2_crc3_pos, data_t& output);
+        virtual void ParseCORepair(const data_t& data, const_data_iterator r1_crc7_pos, data_t& output);
 
         
         
@@ -28,28 +29,57 @@ namespace ROHC
         static bool parse_rtp_dynamic(global_control& gc, const_data_iterator& pos, const_data_iterator end);
         static bool parse_udp_regular_dynamic(global_control& gc, const_data_iterator& pos, const_data_iterator end);
 
-        bool parse_co_common(data_iterator& pos, const data_iterator& end);
-		bool parse_pt_0_crc3(data_iterator& pos, const data_iterator& end);
-		bool parse_pt_0_crc7(data_iterator& pos, const data_iterator& end);
-		bool parse_pt_1_rnd(data_iterator& pos, const data_iterator& end);
-		bool parse_pt_1_seq_id(data_iterator& pos, const data_iterator& end);
-		bool parse_pt_1_seq_ts(data_iterator& pos, const data_iterator& end);
-		bool parse_pt_2_rnd(data_iterator& pos, const data_iterator& end);
-		bool parse_pt_2_seq_id(data_iterator& pos, const data_iterator& end);
-		bool parse_pt_2_seq_both(data_iterator& pos, const data_iterator& end);
-		bool parse_pt_2_seq_ts(data_iterator& pos, const data_iterator& end);
-
-		bool parse_profile_1_7_flags1_enc(bool flags1_indicator, data_iterator& pos, const data_iterator& end, bool& ttl_hopl_indicator, bool& tos_tc_indicator, bool& df, IPIDBehaviour_t& new_ip_id_behaviour, Reordering_t& new_reorder_ratio) const;
+        bool parse_co_header(uint8_t packetTypeIndication, data_t& data, data_iterator& pos);
+        ParseResult_t parse_co_header(uint8_t packetTypeIndication, ByteReader& in);
+
+        /**
+         * The udp item of the irregular chain and the headers appended
+         * from the header template, the UDP-Lite profile adds the checksum
+         * coverage
+         */
+        virtual ParseResult_t parse_udp_irregular(ByteReader& in);
+        virtual void AppendHeaders(const_data_iterator payload, const_data_iterator end, data_t& output) {AppendHeaderTemplate(&udp, &rtp, payload, end, output);}
+
+        /**
+         * Base header parsers indexed by the first octet, for sequential and
+         * for random/zero IP-ID. Null for types that are not valid with that
+         * IP-ID behaviour.
+         */
+        typedef ParseResult_t (DRTPProfile::*parser_t)(ByteReader& in);
+        struct COParsers
+        {
+            COParsers();
+            parser_t sequential[256];
+            parser_t random[256];
+        };
+        static const COParsers co_parsers;
+
+        void SaveContext(global_control& gc) const;
+        void RestoreContext(const global_control& gc);
+
+        ParseResult_t parse_co_common(ByteReader& in);
+		ParseResult_t parse_pt_0_crc3(ByteReader& in);
+		ParseResult_t parse_pt_0_crc7(ByteReader& in);
+		ParseResult_t parse_pt_1_rnd(ByteReader& in);
+		ParseResult_t parse_pt_1_seq_id(ByteReader& in);
+		ParseResult_t parse_pt_1_seq_ts(ByteReader& in);
+		ParseResult_t parse_pt_2_rnd(ByteReader& in);
+		ParseResult_t parse_pt_2_seq_id(ByteReader& in);
+		ParseResult_t parse_pt_2_seq_both(ByteReader& in);
+		ParseResult_t parse_pt_2_seq_ts(ByteReader& in);
+
+		void parse_profile_1_7_flags1_enc(uint8_t flags, bool& ttl_hopl_indicator, bool& tos_tc_indicator, bool& df, IPIDBehaviour_t& new_ip_id_behaviour, Reordering_t& new_reorder_ratio) const;
 		
-        bool parse_profile_1_flags2_enc(bool flags2_indicator, data_iterator& pos, const data_iterator& end, bool& list_indicator, bool& pt_indicator, bool& tis_indicator, bool& pad_bit, bool& extension) const;
+        void parse_profile_1_flags2_enc(uint8_t flags, bool& list_indicator, bool& pt_indicator, bool& tis_indicator, bool& pad_bit, bool& extension) const;
         
-        bool parse_sdvl_sn_lsb(data_iterator& pos, const data_iterator& end, uint16_t& new_msn, unsigned int& delta_msn) const;
+        ParseResult_t parse_sdvl_sn_lsb(ByteReader& in, uint16_t& new_msn, unsigned int& delta_msn) const;
 		
-        bool parse_variable_unscaled_timestamp(bool tss_indicator, bool tsc_indicator, data_iterator& pos, const data_iterator& end, uint32_t& new_timestamp) const;
+        ParseResult_t parse_variable_unscaled_timestamp(bool tss_indicator, bool tsc_indicator, ByteReader& in, uint32_t& new_timestamp) const;
 
-		uint8_t control_crc3(Reordering_t newRR, uint32_t new_ts_stride, uint32_t new_time_stride) const;
+		uint8_t control_crc3(Reordering_t newRR, uint32_t new_ts_stride, uint32_t new_time_stride);
+		static uint8_t CalculateControlCRC3(Reordering_t newRR, uint32_t new_ts_stride, uint32_t new_time_stride);
 
-		bool parse_inferred_scaled_ts(uint16_t delta_msn);
+		ParseResult_t parse_inferred_scaled_ts(uint16_t delta_msn);
 
 		void UpdateTimestamp(uint32_t ts_scaled_lsb, unsigned int width);
 
@@ -62,5 +92,11 @@ namespace ROHC
         bool udp_checksum_used;
         udphdr udp;
         rtphdr rtp;
+
+		// control_crc3 and the control fields it was calculated from
+		uint8_t crc3_control;
+		Reordering_t crc3_reorder_ratio;
+		uint32_t crc3_ts_stride;
+		uint32_t crc3_time_stride;
     };
 } // ns ROHC
\ No newline at end of file
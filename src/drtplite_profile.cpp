@@ -0,0 +1,99 @@
+#include "drtplite_profile.h"
+#include "dudplite_profile.h"
+#include "network.h"
+#include <rohc/log.h>
+
+namespace ROHC
+{
+    DRTPLiteProfile::DRTPLiteProfile(Decompressor* decomp, uint16_t cid)
+    : DRTPProfile(decomp, cid)
+    , coverage_behaviour(UDP_LITE_COVERAGE_INFERRED)
+    {
+    }
+
+    bool
+    DRTPLiteProfile::ParseIR(global_control& gc, const data_t& data, const_data_iterator& pos)
+    {
+        const_data_iterator end(data.end());
+        if (!DProfile::parse_ip_static(gc, pos, end))
+            return false;
+
+        if(!DUDPProfile::parse_udp_static(gc, pos, end))
+            return false;
+
+        if(!parse_rtp_static(gc, pos, end))
+            return false;
+
+        if(!DProfile::parse_ip_regular_dynamic(gc, pos, end))
+            return false;
+
+        if(!parse_udp_lite_regular_dynamic(gc, pos, end))
+            return false;
+
+        return parse_rtp_dynamic(gc, pos, end);
+    }
+
+    bool
+    DRTPLiteProfile::ParseIRDYN(global_control& gc, const data_t& data, const_data_iterator& pos)
+    {
+        SaveContext(gc);
+        gc.ip6 = ip6;
+
+        const_data_iterator end(data.end());
+        if(!DProfile::parse_ip_regular_dynamic(gc, pos, end))
+            return false;
+
+        if(!parse_udp_lite_regular_dynamic(gc, pos, end))
+            return false;
+
+        return parse_rtp_dynamic(gc, pos, end);
+    }
+
+    void
+    DRTPLiteProfile::MergeGlobalControlAndAppendHeaders(const ROHC::global_control &gc, data_t &output)
+    {
+        coverage_behaviour = gc.coverage_behaviour;
+        DRTPProfile::MergeGlobalControlAndAppendHeaders(gc, output);
+    }
+
+    bool
+    DRTPLiteProfile::parse_udp_lite_regular_dynamic(ROHC::global_control &gc, const_data_iterator& pos, const_data_iterator end)
+    {
+        if (!GetValue(pos, end, gc.udp.len)) {
+            error("parse_udp_lite_regular_dynamic, failed to get checksum coverage\n");
+            return false;
+        }
+        if (!GetValue(pos, end, gc.udp.check)) {
+            error("parse_udp_lite_regular_dynamic, failed to get udp checksum\n");
+            return false;
+        }
+        gc.udp_checksum_used = true;
+
+        if (pos == end) {
+            error("parse_udp_lite_regular_dynamic - not enough data for coverage behaviour");
+            return false;
+        }
+        uint8_t reserved_coverage = *pos++;
+        if ((reserved_coverage & 0xfc) ||
+            !DUDPLiteProfile::parse_coverage_behaviour(reserved_coverage, gc))
+        {
+            error("parse_udp_lite_regular_dynamic, not a valid coverage behaviour\n");
+            return false;
+        }
+        return true;
+    }
+
+    ParseResult_t
+    DRTPLiteProfile::parse_udp_irregular(ByteReader& in)
+    {
+        return DUDPLiteProfile::parse_udp_lite_irregular(coverage_behaviour, in, udp);
+    }
+
+    void
+    DRTPLiteProfile::AppendHeaders(const_data_iterator payload, const_data_iterator end, data_t& output)
+    {
+        DUDPLiteProfile::InferCoverage(coverage_behaviour, sizeof(udphdr) + sizeof(rtphdr) + (end - payload), udp);
+        AppendHeaderTemplate(&udp, &rtp, payload, end, output);
+    }
+
+} // ns ROHC
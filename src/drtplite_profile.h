@@ -0,0 +1,30 @@
+#pragma once
+
+/**
+ * RTP/UDP-Lite/IP profile
+ */
+
+#include "drtp_profile.h"
+
+namespace ROHC
+{
+    class DRTPLiteProfile : public DRTPProfile
+    {
+    public:
+        DRTPLiteProfile(Decompressor* decomp, uint16_t cid);
+        virtual uint8_t LSBID() const { return static_cast<uint8_t>(ProfileID());}
+        static uint16_t ProfileID() {return 0x0107;}
+
+        void MergeGlobalControlAndAppendHeaders(const global_control& gc, data_t& output);
+        static bool ParseIR(global_control& gc, const data_t& data, const_data_iterator& pos);
+        virtual bool ParseIRDYN(global_control& gc, const data_t& data, const_data_iterator& pos);
+
+    private:
+        virtual ParseResult_t parse_udp_irregular(ByteReader& in);
+        virtual void AppendHeaders(const_data_iterator payload, const_data_iterator end, data_t& output);
+
+        static bool parse_udp_lite_regular_dynamic(global_control& gc, const_data_iterator& pos, const_data_iterator end);
+
+        CoverageBehaviour_t coverage_behaviour;
+    };
+} // ns ROHC
@@ -1,2 +1,1093 @@
 #include "dtcp_profile.h"
+#include "network.h"
+#include <rohc/compressor.h>
+#include <rohc/decomp.h>
+#include <rohc/log.h>
 
+#include <cstring>
+
+namespace
+{
+    // The flag octets of the TCP header, see CTCPProfile
+    inline uint8_t& DataOffsetResFlags(ROHC::tcphdr& tcp) {
+        return reinterpret_cast<uint8_t*>(&tcp)[12];
+    }
+    inline uint8_t& Flags(ROHC::tcphdr& tcp) {
+        return reinterpret_cast<uint8_t*>(&tcp)[13];
+    }
+
+    /*
+     The header is 20 bytes and the options, which are whole words
+     */
+    bool SetDataOffset(ROHC::tcphdr& tcp, size_t optionsSize) {
+        if ((optionsSize % 4) || (optionsSize > ROHC::maxTCPOptionsSize))
+            return false;
+        DataOffsetResFlags(tcp) = static_cast<uint8_t>(((5 + optionsSize / 4) << 4) | (DataOffsetResFlags(tcp) & 0x0f));
+        return true;
+    }
+
+    inline uint32_t OptionU32(const ROHC::TCPOptionItem& item, size_t pos) {
+        uint32_t value;
+        memcpy(&value, &item.data[pos], sizeof(value));
+        return ROHC::rohc_htonl(value);
+    }
+
+    inline void SetOptionU32(ROHC::TCPOptionItem& item, size_t pos, uint32_t value) {
+        value = ROHC::rohc_htonl(value);
+        memcpy(&item.data[pos], &value, sizeof(value));
+    }
+
+    /*
+     tcp_opt_ts_lsb, see CTCPProfile, value is the reference
+     */
+    ROHC::ParseResult_t ts_lsb_dec(ROHC::ByteReader& in, uint32_t& value)
+    {
+        if (!in.Has(1))
+            return ROHC::PARSE_TRUNCATED;
+        uint8_t discriminator = in.Peek();
+        if (!(discriminator & 0x80)) {
+            value = ROHC::DecodeLSB<uint32_t>(value, in.U8() & 0x7f, 7, -1);
+        }
+        else if (0x80 == (discriminator & 0xc0)) {
+            if (!in.Has(2))
+                return ROHC::PARSE_TRUNCATED;
+            value = ROHC::DecodeLSB<uint32_t>(value, in.U16() & 0x3fff, 14, -1);
+        }
+        else if (0xc0 == (discriminator & 0xe0)) {
+            if (!in.Has(3))
+                return ROHC::PARSE_TRUNCATED;
+            uint32_t lsb = (in.U8() & 0x1f) << 16;
+            lsb |= in.U16();
+            value = ROHC::DecodeLSB<uint32_t>(value, lsb, 21, 0x00040000);
+        }
+        else {
+            if (!in.Has(4))
+                return ROHC::PARSE_TRUNCATED;
+            value = ROHC::DecodeLSB<uint32_t>(value, in.U32() & 0x1fffffff, 29, 0x04000000);
+        }
+        return ROHC::PARSE_OK;
+    }
+
+    /*
+     sack_var_length_enc, see CTCPProfile
+     */
+    ROHC::ParseResult_t sack_var_length_dec(ROHC::ByteReader& in, uint32_t& offset)
+    {
+        if (!in.Has(2))
+            return ROHC::PARSE_TRUNCATED;
+        uint8_t discriminator = in.Peek();
+        if (!(discriminator & 0x80)) {
+            offset = in.U16();
+        }
+        else if (0x80 == (discriminator & 0xc0)) {
+            if (!in.Has(3))
+                return ROHC::PARSE_TRUNCATED;
+            offset = (in.U8() & 0x3f) << 16;
+            offset |= in.U16();
+        }
+        else if (0xc0 == (discriminator & 0xe0)) {
+            if (!in.Has(4))
+                return ROHC::PARSE_TRUNCATED;
+            offset = in.U32() & 0x1fffffff;
+        }
+        else if (0xff == discriminator) {
+            if (!in.Has(5))
+                return ROHC::PARSE_TRUNCATED;
+            in.Skip(1);
+            offset = in.U32();
+        }
+        else {
+            return ROHC::PARSE_BAD_FIELD;
+        }
+        return ROHC::PARSE_OK;
+    }
+} // anon ns
+
+namespace ROHC
+{
+    DTCPProfile::DTCPProfile(Decompressor* decomp, uint16_t cid)
+    : DProfile(decomp, cid)
+    , tcp()
+    , ecn_used(false)
+    , ack_stride(0)
+    , seq_scaled_present(false)
+    , seq_scaled_lsb(0)
+    {
+        tcp_options.Clear();
+    }
+
+    void
+    DTCPProfile::MergeGlobalControlAndAppendHeaders(const ROHC::global_control &gc, data_t &output)
+    {
+        state = FULL_CONTEXT;
+
+        ++numberofIRPackets;
+        ++numberOfPacketsReceived;
+
+        msn = gc.msn;
+        ip_id_behaviour = gc.ip_id_behaviour;
+        ip = gc.ip;
+        ip6 = gc.ip6;
+        tcp = gc.tcp;
+        ecn_used = gc.ecn_used;
+        ack_stride = gc.ack_stride;
+        tcp_options = gc.tcp_options;
+
+		UpdateIPIDOffsetFromID();
+        ResetHeaderTemplate(&tcp);
+
+        uint8_t options[maxTCPOptionsSize];
+        size_t optionsSize = tcp_options.Options(options);
+
+        AppendIPHeader(output);
+        AppendData(output, tcp);
+        output.insert(output.end(), options, options + optionsSize);
+        SendFeedback1();
+    }
+
+    bool
+    DTCPProfile::ParseIR(global_control& gc, const data_t& data, const_data_iterator& pos)
+    {
+        const_data_iterator end(data.end());
+        if(!DProfile::parse_ip_static(gc, pos, end, false))
+            return false;
+        if(!parse_tcp_static(gc, pos, end))
+            return false;
+
+        if(!DProfile::parse_ip_regular_dynamic(gc, pos, end))
+            return false;
+
+        if(!parse_tcp_dynamic(gc, pos, end))
+            return false;
+
+        return true;
+    }
+
+    bool
+    DTCPProfile::ParseIRDYN(global_control& gc, const data_t& data, const_data_iterator& pos)
+    {
+        SaveContext(gc);
+        gc.ip6 = ip6;
+
+        const_data_iterator end(data.end());
+        if(!DProfile::parse_ip_regular_dynamic(gc, pos, end))
+            return false;
+
+        return parse_tcp_dynamic(gc, pos, end);
+    }
+
+    bool
+    DTCPProfile::parse_tcp_static(global_control& gc, const_data_iterator& pos, const_data_iterator& end)
+    {
+        if (!GetValue(pos, end, gc.tcp.source) ||
+            !GetValue(pos, end, gc.tcp.dest)) {
+            error("parse_tcp_static, not enough data\n");
+            return false;
+        }
+        return true;
+    }
+
+    /*
+     See CTCPProfile::create_tcp_dynamic
+     */
+    bool
+    DTCPProfile::parse_tcp_dynamic(global_control& gc, const_data_iterator& pos, const_data_iterator& end)
+    {
+        if ((end - pos) < 2) {
+            error("parse_tcp_dynamic, not enough data\n");
+            return false;
+        }
+        uint8_t ecn_ackStride_ackZero_urpZero_res = *pos++;
+        gc.ecn_used = (ecn_ackStride_ackZero_urpZero_res & 0x80) != 0;
+        bool ack_stride_flag = (ecn_ackStride_ackZero_urpZero_res & 0x40) != 0;
+        bool ack_zero = (ecn_ackStride_ackZero_urpZero_res & 0x20) != 0;
+        bool urp_zero = (ecn_ackStride_ackZero_urpZero_res & 0x10) != 0;
+
+        DataOffsetResFlags(gc.tcp) = ecn_ackStride_ackZero_urpZero_res & 0x0f;
+        Flags(gc.tcp) = *pos++;
+
+        // For an IR-DYN gc has the fields of the context
+        gc.tcp.ackNumber = 0;
+        gc.tcp.urgPtr = 0;
+        gc.ack_stride = 0;
+
+        if (!GetValueFromNBO(pos, end, gc.msn) ||
+            !GetValue(pos, end, gc.tcp.sequenceNumber) ||
+            (!ack_zero && !GetValue(pos, end, gc.tcp.ackNumber)) ||
+            !GetValue(pos, end, gc.tcp.windowSize) ||
+            !GetValue(pos, end, gc.tcp.check) ||
+            (!urp_zero && !GetValue(pos, end, gc.tcp.urgPtr)) ||
+            (ack_stride_flag && !GetValueFromNBO(pos, end, gc.ack_stride)))
+        {
+            error("parse_tcp_dynamic, not enough data\n");
+            return false;
+        }
+
+        if (pos == end) {
+            error("parse_tcp_dynamic, not enough data\n");
+            return false;
+        }
+
+        // The items of the list all have X set
+        gc.tcp_options.Clear();
+        bool x[maxTCPOptionListSize];
+        const uint8_t* begin = &*pos;
+        ByteReader in(begin, begin + (end - pos));
+        ParseResult_t result = parse_list_tcp_options(gc.tcp_options, rohc_htonl(gc.tcp.ackNumber), in, x);
+        if (PARSE_OK != result) {
+            error("parse_tcp_dynamic, list_tcp_options %s\n", ParseResultString(result));
+            return false;
+        }
+        pos += in.Position() - begin;
+
+        uint8_t options[maxTCPOptionsSize];
+        if (!SetDataOffset(gc.tcp, gc.tcp_options.Options(options))) {
+            error("parse_tcp_dynamic, options are not whole words\n");
+            return false;
+        }
+        return true;
+    }
+
+    void
+    DTCPProfile::ParseCO(uint8_t packetTypeIndication, data_t &data, data_iterator pos, data_t &output)
+    {
+		if (FULL_CONTEXT != state) {
+			decomp->SendStaticNACK(cid, msn);
+		}
+
+        global_control saved;
+        SaveContext(saved);
+
+        if (!parse_co_header(packetTypeIndication, data, pos)) {
+            RestoreContext(saved);
+            return;
+        }
+
+        if (!DecodeSeqScaled(data.end() - pos)) {
+            error("ParseCO, seq_number_scaled without payload\n");
+            RestoreContext(saved);
+            SendNack();
+            return;
+        }
+
+        uint8_t options[maxTCPOptionsSize];
+        size_t optionsSize = tcp_options.Options(options);
+        if (!SetDataOffset(tcp, optionsSize)) {
+            error("ParseCO, options are not whole words\n");
+            RestoreContext(saved);
+            SendNack();
+            return;
+        }
+
+        size_t outputInitSize = output.size();
+        AppendHeaderTemplate(&tcp, options, optionsSize, pos, data.end(), output);
+        if (!VerifyHeaderCRC(output, outputInitSize)) {
+            error("ParseCO, header crc %u failure\n", received_crc_bits);
+            output.resize(outputInitSize);
+            RestoreContext(saved);
+            SendNack();
+            return;
+        }
+        SendFeedback1();
+    }
+
+    /*
+     RFC 6846 has no co_repair, the compressor repairs the context with
+     IR-DYN once it gets the NACK
+     */
+    void
+    DTCPProfile::ParseCORepair(const data_t& /*data*/, const_data_iterator /*r1_crc7_pos*/, data_t& /*output*/)
+    {
+        error("TCP - co_repair is not a packet type of the profile\n");
+        SendNack();
+    }
+
+    const DTCPProfile::COParsers DTCPProfile::co_parsers;
+
+    DTCPProfile::COParsers::COParsers()
+    {
+        for (unsigned int i = 0; i < 256; ++i)
+        {
+            parser_t seq = 0;
+            parser_t rnd = 0;
+            if (0xfa == i)
+            {
+                seq = rnd = &DTCPProfile::parse_co_common;
+            }
+            else if (0 == (i & 0x80))
+            {
+                seq = &DTCPProfile::parse_seq_4;
+                rnd = &DTCPProfile::parse_rnd_3;
+            }
+            else if (0x80 == (i & 0xf0))
+            {
+                seq = &DTCPProfile::parse_seq_5;
+                rnd = &DTCPProfile::parse_rnd_5;
+            }
+            else if (0x90 == (i & 0xf0))
+            {
+                seq = &DTCPProfile::parse_seq_3;
+                rnd = &DTCPProfile::parse_rnd_5;
+            }
+            else if (0xa0 == (i & 0xf0))
+            {
+                seq = &DTCPProfile::parse_seq_1;
+                rnd = &DTCPProfile::parse_rnd_6;
+            }
+            else if (0xb0 == (i & 0xf0))
+            {
+                seq = &DTCPProfile::parse_seq_8;
+                if (0xb0 == (i & 0xf8))
+                    rnd = &DTCPProfile::parse_rnd_8;
+                else if (0xb8 == (i & 0xfc))
+                    rnd = &DTCPProfile::parse_rnd_1;
+                else
+                    rnd = &DTCPProfile::parse_rnd_7;
+            }
+            else if (0xc0 == (i & 0xf0))
+            {
+                seq = &DTCPProfile::parse_seq_7;
+                rnd = &DTCPProfile::parse_rnd_2;
+            }
+            else if (0xd0 == (i & 0xf0))
+            {
+                seq = (i & 0x08) ? &DTCPProfile::parse_seq_6 : &DTCPProfile::parse_seq_2;
+                rnd = &DTCPProfile::parse_rnd_4;
+            }
+            sequential[i] = seq;
+            random[i] = rnd;
+        }
+    }
+
+    bool
+    DTCPProfile::parse_co_header(uint8_t packetTypeIndication, data_t& data, data_iterator& pos)
+    {
+        // pos will point at remainder of base header
+        data_iterator posMinusOne = pos - 1;
+
+        // Make first octet of base header adjacent to the remainder
+        uint8_t stored = 0;
+        if (largeCID)
+        {
+            stored = *posMinusOne;
+            *posMinusOne = packetTypeIndication;
+        }
+
+        const uint8_t* begin = &*posMinusOne;
+        ByteReader in(begin, &data[0] + data.size());
+        ParseResult_t result = parse_co_header(packetTypeIndication, in);
+
+        if (largeCID)
+        {
+            *posMinusOne = stored;
+        }
+
+        if (PARSE_OK != result)
+        {
+            error("ParseCO, %s, type %x\n", ParseResultString(result), (unsigned) packetTypeIndication);
+            return false;
+        }
+        pos = posMinusOne + (in.Position() - begin);
+        return true;
+    }
+
+    ParseResult_t
+    DTCPProfile::parse_co_header(uint8_t packetTypeIndication, ByteReader& in)
+    {
+        const parser_t* parsers = (ip_id_behaviour <= IP_ID_BEHAVIOUR_SEQUENTIAL_SWAPPED) ?
+            co_parsers.sequential : co_parsers.random;
+        parser_t parser = parsers[packetTypeIndication];
+        if (!parser)
+            return PARSE_UNKNOWN_TYPE;
+
+        seq_scaled_present = false;
+        // Without a list in the base header the items of the context list
+        // are all in the irregular chain
+        memset(option_x, 0, sizeof(option_x));
+        ParseResult_t result = (this->*parser)(in);
+        if (PARSE_OK != result)
+            return result;
+
+        return parse_irregular_chain(in);
+    }
+
+    /*
+     See CTCPProfile::create_tcp_irregular
+     */
+    ParseResult_t
+    DTCPProfile::parse_irregular_chain(ByteReader& in)
+    {
+        ParseResult_t result = parse_ip_innermost_irregular(in);
+        if (PARSE_OK != result)
+            return result;
+
+        if (ecn_used)
+        {
+            uint8_t ecn;
+            if (!in.ReadU8(ecn))
+                return PARSE_TRUNCATED;
+            ip.tos = static_cast<uint8_t>((ip.tos & 0xfc) | (ecn >> 6));
+            DataOffsetResFlags(tcp) = static_cast<uint8_t>((DataOffsetResFlags(tcp) & 0xf0) | ((ecn >> 2) & 0x0f));
+            Flags(tcp) = static_cast<uint8_t>((Flags(tcp) & 0x3f) | (ecn << 6));
+        }
+
+        if (!in.ReadRaw(tcp.check))
+            return PARSE_TRUNCATED;
+        return parse_tcp_options_irregular(in);
+    }
+
+    ParseResult_t
+    DTCPProfile::parse_list_tcp_options(TCPOptionContext& options, uint32_t ack, ByteReader& in, bool* x)
+    {
+        uint8_t reserved_ps_m;
+        if (!in.ReadU8(reserved_ps_m))
+            return PARSE_TRUNCATED;
+        if (reserved_ps_m & 0xe0)
+            return PARSE_BAD_FIELD;
+
+        bool ps = (reserved_ps_m & 0x10) != 0;
+        unsigned int m = reserved_ps_m & 0x0f;
+        if (!in.Has(ps ? m : (m + 1) / 2))
+            return PARSE_TRUNCATED;
+
+        for (unsigned int i = 0; i < m; ++i)
+        {
+            uint8_t xi;
+            if (ps)
+            {
+                xi = in.U8();
+                if (xi & 0x70)
+                    return PARSE_BAD_FIELD;
+            }
+            else
+            {
+                // 4 bit XIs, the first in the high nibble
+                xi = (i & 1) ? (in.U8() & 0x0f) : (in.Peek() >> 4);
+                if ((i & 1) == 0 && (i + 1 == m))
+                    in.Skip(1);
+                xi = static_cast<uint8_t>(((xi & 0x08) << 4) | (xi & 0x07));
+            }
+            x[i] = (xi & 0x80) != 0;
+            options.list[i] = xi & 0x0f;
+        }
+        options.listSize = m;
+
+        for (unsigned int i = 0; i < m; ++i)
+        {
+            unsigned int index = options.list[i];
+            if (x[i])
+            {
+                ParseResult_t result = parse_tcp_option_item(index, ack, in, options.table[index]);
+                if (PARSE_OK != result)
+                    return result;
+            }
+            else if (!options.table[index].size)
+            {
+                return PARSE_BAD_FIELD;
+            }
+        }
+        return PARSE_OK;
+    }
+
+    /*
+     See CTCPProfile::create_tcp_option_item
+     */
+    ParseResult_t
+    DTCPProfile::parse_tcp_option_item(unsigned int index, uint32_t ack, ByteReader& in, TCPOptionItem& item)
+    {
+        switch (index)
+        {
+            case ReservedTableIndexs::OPT_NOP:
+                item.data[0] = TCPOptions::NOP;
+                item.size = 1;
+                break;
+            case ReservedTableIndexs::OPT_EOL:
+            {
+                uint8_t pad_len;
+                if (!in.ReadU8(pad_len))
+                    return PARSE_TRUNCATED;
+                if (pad_len >= maxTCPOptionsSize)
+                    return PARSE_BAD_FIELD;
+                memset(item.data, 0, pad_len + 1);
+                item.size = static_cast<uint8_t>(pad_len + 1);
+                break;
+            }
+            case ReservedTableIndexs::OPT_MSS:
+                if (!in.Has(2))
+                    return PARSE_TRUNCATED;
+                item.data[0] = TCPOptions::MaximumSegmentSize;
+                item.data[1] = item.size = 4;
+                item.data[2] = in.U8();
+                item.data[3] = in.U8();
+                break;
+            case ReservedTableIndexs::OPT_WINDOW_SCALE:
+                if (!in.Has(1))
+                    return PARSE_TRUNCATED;
+                item.data[0] = TCPOptions::WSOPT_WindowScale;
+                item.data[1] = item.size = 3;
+                item.data[2] = in.U8();
+                break;
+            case ReservedTableIndexs::OPT_TIMESTAMP:
+                if (!in.Has(8))
+                    return PARSE_TRUNCATED;
+                item.data[0] = TCPOptions::TSOPT;
+                item.data[1] = item.size = 10;
+                SetOptionU32(item, 2, in.U32());
+                SetOptionU32(item, 6, in.U32());
+                break;
+            case ReservedTableIndexs::OPT_SACK_PERMITTED:
+                item.data[0] = TCPOptions::SACK_permitted;
+                item.data[1] = item.size = 2;
+                break;
+            case ReservedTableIndexs::OPT_SACK:
+            {
+                uint8_t length;
+                if (!in.ReadU8(length))
+                    return PARSE_TRUNCATED;
+                if ((length < 10) || (length > 34) || ((length - 2) % 8))
+                    return PARSE_BAD_FIELD;
+                item.data[0] = TCPOptions::SACK;
+                item.data[1] = item.size = length;
+                for (size_t pos = 2; pos < length; pos += 8)
+                {
+                    uint32_t start;
+                    uint32_t end;
+                    ParseResult_t result = sack_var_length_dec(in, start);
+                    if (PARSE_OK != result)
+                        return result;
+                    result = sack_var_length_dec(in, end);
+                    if (PARSE_OK != result)
+                        return result;
+                    start += ack;
+                    SetOptionU32(item, pos, start);
+                    SetOptionU32(item, pos + 4, start + end);
+                }
+                break;
+            }
+            default:
+            {
+                // type, option_static and length, contents
+                if (!in.Has(2))
+                    return PARSE_TRUNCATED;
+                uint8_t kind = in.U8();
+                uint8_t length = in.U8() & 0x7f;
+                if ((length < 2) || (length > maxTCPOptionsSize))
+                    return PARSE_BAD_FIELD;
+                if (!in.Has(length - 2u))
+                    return PARSE_TRUNCATED;
+                item.data[0] = kind;
+                item.data[1] = item.size = length;
+                memcpy(&item.data[2], in.Position(), length - 2u);
+                in.Skip(length - 2u);
+                break;
+            }
+        }
+        return PARSE_OK;
+    }
+
+    /*
+     See CTCPProfile::create_tcp_options_irregular
+     */
+    ParseResult_t
+    DTCPProfile::parse_tcp_options_irregular(ByteReader& in)
+    {
+        for (unsigned int i = 0; i < tcp_options.listSize; ++i)
+        {
+            if (option_x[i])
+                continue;
+
+            unsigned int index = tcp_options.list[i];
+            TCPOptionItem& item = tcp_options.table[index];
+            if (ReservedTableIndexs::OPT_TIMESTAMP == index)
+            {
+                uint32_t tsval = OptionU32(item, 2);
+                uint32_t tsecr = OptionU32(item, 6);
+                ParseResult_t result = ts_lsb_dec(in, tsval);
+                if (PARSE_OK != result)
+                    return result;
+                result = ts_lsb_dec(in, tsecr);
+                if (PARSE_OK != result)
+                    return result;
+                SetOptionU32(item, 2, tsval);
+                SetOptionU32(item, 6, tsecr);
+            }
+            else if (ReservedTableIndexs::OPT_SACK == index)
+            {
+                if (!in.Has(1))
+                    return PARSE_TRUNCATED;
+                if (!in.Peek())
+                {
+                    in.Skip(1);
+                    continue;
+                }
+                ParseResult_t result = parse_tcp_option_item(index, rohc_htonl(tcp.ackNumber), in, item);
+                if (PARSE_OK != result)
+                    return result;
+            }
+        }
+        return PARSE_OK;
+    }
+
+    void
+    DTCPProfile::SaveContext(global_control& gc) const
+    {
+        DProfile::SaveContext(gc);
+        gc.tcp = tcp;
+        gc.ecn_used = ecn_used;
+        gc.ack_stride = ack_stride;
+        gc.tcp_options = tcp_options;
+    }
+
+    void
+    DTCPProfile::RestoreContext(const global_control& gc)
+    {
+        DProfile::RestoreContext(gc);
+        tcp = gc.tcp;
+        ecn_used = gc.ecn_used;
+        ack_stride = gc.ack_stride;
+        tcp_options = gc.tcp_options;
+    }
+
+    void
+    DTCPProfile::parse_msn_psh_crc3(uint8_t msn_psh_crc3)
+    {
+        SetReceivedCRC(msn_psh_crc3 & 7, 3);
+        tcp.PSH = (msn_psh_crc3 >> 3) & 1;
+        DecodeMSN(msn_psh_crc3 >> 4);
+    }
+
+    void
+    DTCPProfile::DecodeMSN(uint8_t lsbMsn)
+    {
+        msn = DecodeLSB<uint16_t>(msn, lsbMsn, 4, 4);
+    }
+
+    void
+    DTCPProfile::DecodeIPID(uint16_t lsbIPID, unsigned int k, int p)
+    {
+        ip_id_offset = DecodeLSB<uint16_t>(ip_id_offset, lsbIPID, k, p);
+        UpdateIPIDFromOffset();
+    }
+
+    void
+    DTCPProfile::DecodeSeq(uint32_t lsbSeq, unsigned int k, int p)
+    {
+        tcp.sequenceNumber = rohc_htonl(DecodeLSB<uint32_t>(rohc_htonl(tcp.sequenceNumber), lsbSeq, k, p));
+    }
+
+    void
+    DTCPProfile::DecodeAck(uint32_t lsbAck, unsigned int k, int p)
+    {
+        tcp.ackNumber = rohc_htonl(DecodeLSB<uint32_t>(rohc_htonl(tcp.ackNumber), lsbAck, k, p));
+    }
+
+    /*
+     ack_number = ack_number_scaled * ack_stride + ack_number_residue,
+     the residue and the reference are those of the context
+     */
+    ParseResult_t
+    DTCPProfile::DecodeAckScaled(uint8_t lsbScaled)
+    {
+        if (!ack_stride)
+            return PARSE_BAD_FIELD;
+        uint32_t ack = rohc_htonl(tcp.ackNumber);
+        uint32_t scaled = DecodeLSB<uint32_t>(ack / ack_stride, lsbScaled, 4, 3);
+        tcp.ackNumber = rohc_htonl(scaled * ack_stride + ack % ack_stride);
+        return PARSE_OK;
+    }
+
+    /*
+     The same with the payload size as the stride
+     */
+    bool
+    DTCPProfile::DecodeSeqScaled(size_t payloadSize)
+    {
+        if (!seq_scaled_present)
+            return true;
+        if (!payloadSize)
+            return false;
+        uint32_t seq = rohc_htonl(tcp.sequenceNumber);
+        uint32_t stride = static_cast<uint32_t>(payloadSize);
+        uint32_t scaled = DecodeLSB<uint32_t>(seq / stride, seq_scaled_lsb, 4, 7);
+        tcp.sequenceNumber = rohc_htonl(scaled * stride + seq % stride);
+        return true;
+    }
+
+    ParseResult_t
+    DTCPProfile::parse_variable_length_32(unsigned int indicator, ByteReader& in, uint32_t& field) const
+    {
+        uint32_t value = rohc_htonl(field);
+        switch (indicator)
+        {
+            case 1:
+                if (!in.Has(1))
+                    return PARSE_TRUNCATED;
+                value = DecodeLSB<uint32_t>(value, in.U8(), 8, 63);
+                break;
+            case 2:
+                if (!in.Has(2))
+                    return PARSE_TRUNCATED;
+                value = DecodeLSB<uint32_t>(value, in.U16(), 16, 16383);
+                break;
+            case 3:
+                if (!in.Has(4))
+                    return PARSE_TRUNCATED;
+                value = in.U32();
+                break;
+        }
+        field = rohc_htonl(value);
+        return PARSE_OK;
+    }
+
+    void
+    DTCPProfile::SetRsfIndex(uint8_t rsf_index)
+    {
+        tcp.RST = (1 == rsf_index);
+        tcp.SYN = (2 == rsf_index);
+        tcp.FIN = (3 == rsf_index);
+    }
+
+    /*
+     See CTCPProfile::create_co_common
+     */
+    ParseResult_t
+    DTCPProfile::parse_co_common(ByteReader& in)
+    {
+        if (!in.Has(5))
+            return PARSE_TRUNCATED;
+        // skip discriminator
+        in.Skip(1);
+
+        uint8_t ack_psh_rsf_msn = in.U8();
+        uint8_t indicators = in.U8();
+        uint8_t ecn_dscp_ttl_list_behaviour_urg = in.U8();
+        uint8_t df_crc7 = in.U8();
+
+        if (ecn_dscp_ttl_list_behaviour_urg & 0x80)
+            return PARSE_BAD_FIELD;
+
+        SetReceivedCRC(df_crc7 & 0x7f, 7);
+        tcp.ACK = ack_psh_rsf_msn >> 7;
+        tcp.PSH = (ack_psh_rsf_msn >> 6) & 1;
+        SetRsfIndex((ack_psh_rsf_msn >> 4) & 3);
+        DecodeMSN(ack_psh_rsf_msn & 0x0f);
+
+        ecn_used = (ecn_dscp_ttl_list_behaviour_urg & 0x40) != 0;
+        ip_id_behaviour = static_cast<IPIDBehaviour_t>((ecn_dscp_ttl_list_behaviour_urg >> 1) & 3);
+        tcp.URG = ecn_dscp_ttl_list_behaviour_urg & 1;
+        if (!IPv6())
+        {
+            if (df_crc7 & 0x80)
+                SetDontFragment(&ip);
+            else
+                ClearDontFragment(&ip);
+        }
+
+        ParseResult_t result = parse_variable_length_32(indicators >> 6, in, tcp.sequenceNumber);
+        if (PARSE_OK != result)
+            return result;
+        result = parse_variable_length_32((indicators >> 4) & 3, in, tcp.ackNumber);
+        if (PARSE_OK != result)
+            return result;
+
+        if (indicators & 0x08)
+        {
+            if (!in.Has(2))
+                return PARSE_TRUNCATED;
+            ack_stride = in.U16();
+        }
+
+        if ((indicators & 0x04) && !in.ReadRaw(tcp.windowSize))
+            return PARSE_TRUNCATED;
+
+        // optional_ip_id_lsb
+        if (ip_id_behaviour <= IP_ID_BEHAVIOUR_SEQUENTIAL_SWAPPED)
+        {
+            if (indicators & 0x02)
+            {
+                if (!in.ReadRaw(ip.id))
+                    return PARSE_TRUNCATED;
+                UpdateIPIDOffsetFromID();
+            }
+            else
+            {
+                uint8_t lsb;
+                if (!in.ReadU8(lsb))
+                    return PARSE_TRUNCATED;
+                DecodeIPID(lsb, 8, 3);
+            }
+        }
+
+        if ((indicators & 0x01) && !in.ReadRaw(tcp.urgPtr))
+            return PARSE_TRUNCATED;
+
+        if (ecn_dscp_ttl_list_behaviour_urg & 0x20)
+        {
+            uint8_t dscp;
+            if (!in.ReadU8(dscp))
+                return PARSE_TRUNCATED;
+            ip.tos = static_cast<uint8_t>((dscp & 0xfc) | (ip.tos & 3));
+        }
+
+        if ((ecn_dscp_ttl_list_behaviour_urg & 0x10) && !in.ReadU8(ip.ttl))
+            return PARSE_TRUNCATED;
+
+        if (ecn_dscp_ttl_list_behaviour_urg & 0x08)
+            return parse_list_tcp_options(tcp_options, rohc_htonl(tcp.ackNumber), in, option_x);
+        return PARSE_OK;
+    }
+
+    ParseResult_t
+    DTCPProfile::parse_rnd_1(ByteReader& in)
+    {
+        if (!in.Has(4))
+            return PARSE_TRUNCATED;
+        uint32_t seq = (in.U8() & 0x03) << 16;
+        seq |= in.U16();
+        parse_msn_psh_crc3(in.U8());
+        DecodeSeq(seq, 18, 65535);
+        SetRsfIndex(0);
+        return PARSE_OK;
+    }
+
+    ParseResult_t
+    DTCPProfile::parse_rnd_2(ByteReader& in)
+    {
+        if (!in.Has(2))
+            return PARSE_TRUNCATED;
+        seq_scaled_present = true;
+        seq_scaled_lsb = in.U8() & 0x0f;
+        parse_msn_psh_crc3(in.U8());
+        SetRsfIndex(0);
+        return PARSE_OK;
+    }
+
+    ParseResult_t
+    DTCPProfile::parse_rnd_3(ByteReader& in)
+    {
+        if (!in.Has(3))
+            return PARSE_TRUNCATED;
+        uint16_t ack = in.U16() & 0x7fff;
+        parse_msn_psh_crc3(in.U8());
+        DecodeAck(ack, 15, 8191);
+        SetRsfIndex(0);
+        return PARSE_OK;
+    }
+
+    ParseResult_t
+    DTCPProfile::parse_rnd_4(ByteReader& in)
+    {
+        if (!in.Has(2))
+            return PARSE_TRUNCATED;
+        uint8_t scaled = in.U8() & 0x0f;
+        parse_msn_psh_crc3(in.U8());
+        SetRsfIndex(0);
+        return DecodeAckScaled(scaled);
+    }
+
+    ParseResult_t
+    DTCPProfile::parse_rnd_5(ByteReader& in)
+    {
+        if (!in.Has(5))
+            return PARSE_TRUNCATED;
+        uint8_t disc_psh_msn = in.U8();
+        uint32_t crc_seq_ack = in.U32();
+        tcp.PSH = (disc_psh_msn >> 4) & 1;
+        DecodeMSN(disc_psh_msn & 0x0f);
+        SetReceivedCRC(static_cast<uint8_t>(crc_seq_ack >> 29), 3);
+        DecodeSeq((crc_seq_ack >> 15) & 0x3fff, 14, 8191);
+        DecodeAck(crc_seq_ack & 0x7fff, 15, 8191);
+        SetRsfIndex(0);
+        return PARSE_OK;
+    }
+
+    ParseResult_t
+    DTCPProfile::parse_rnd_6(ByteReader& in)
+    {
+        if (!in.Has(4))
+            return PARSE_TRUNCATED;
+        uint8_t disc_crc_psh = in.U8();
+        uint16_t ack = in.U16();
+        uint8_t msn_scaled = in.U8();
+        SetReceivedCRC((disc_crc_psh >> 1) & 7, 3);
+        tcp.PSH = disc_crc_psh & 1;
+        DecodeMSN(msn_scaled >> 4);
+        DecodeAck(ack, 16, 16383);
+        seq_scaled_present = true;
+        seq_scaled_lsb = msn_scaled & 0x0f;
+        SetRsfIndex(0);
+        return PARSE_OK;
+    }
+
+    ParseResult_t
+    DTCPProfile::parse_rnd_7(ByteReader& in)
+    {
+        if (!in.Has(6))
+            return PARSE_TRUNCATED;
+        uint32_t ack = (in.U8() & 0x03) << 16;
+        ack |= in.U16();
+        in.Raw(tcp.windowSize);
+        parse_msn_psh_crc3(in.U8());
+        DecodeAck(ack, 18, 65535);
+        SetRsfIndex(0);
+        return PARSE_OK;
+    }
+
+    ParseResult_t
+    DTCPProfile::parse_rnd_8(ByteReader& in)
+    {
+        if (!in.Has(7))
+            return PARSE_TRUNCATED;
+        uint8_t disc_rsf_list = in.U8();
+        uint8_t crc_msn = in.U8();
+        uint8_t msn_psh_ttl_ecn = in.U8();
+        uint16_t seq = in.U16();
+        uint16_t ack = in.U16();
+
+        SetRsfIndex((disc_rsf_list >> 1) & 3);
+        SetReceivedCRC(crc_msn >> 1, 7);
+        DecodeMSN(static_cast<uint8_t>(((crc_msn & 1) << 3) | (msn_psh_ttl_ecn >> 5)));
+        tcp.PSH = (msn_psh_ttl_ecn >> 4) & 1;
+        ip.ttl = DecodeLSB<uint8_t>(ip.ttl, (msn_psh_ttl_ecn >> 1) & 7, 3, 3);
+        ecn_used = (msn_psh_ttl_ecn & 1) != 0;
+        DecodeSeq(seq, 16, 65535);
+        DecodeAck(ack, 16, 16383);
+
+        if (disc_rsf_list & 0x01)
+            return parse_list_tcp_options(tcp_options, rohc_htonl(tcp.ackNumber), in, option_x);
+        return PARSE_OK;
+    }
+
+    ParseResult_t
+    DTCPProfile::parse_seq_1(ByteReader& in)
+    {
+        if (!in.Has(4))
+            return PARSE_TRUNCATED;
+        uint8_t ip_id = in.U8() & 0x0f;
+        uint16_t seq = in.U16();
+        parse_msn_psh_crc3(in.U8());
+        DecodeIPID(ip_id, 4, 3);
+        DecodeSeq(seq, 16, 32767);
+        SetRsfIndex(0);
+        return PARSE_OK;
+    }
+
+    ParseResult_t
+    DTCPProfile::parse_seq_2(ByteReader& in)
+    {
+        if (!in.Has(3))
+            return PARSE_TRUNCATED;
+        uint8_t disc_ip_id = in.U8();
+        uint8_t ip_id_scaled = in.U8();
+        parse_msn_psh_crc3(in.U8());
+        DecodeIPID(static_cast<uint16_t>(((disc_ip_id & 0x07) << 4) | (ip_id_scaled >> 4)), 7, 3);
+        seq_scaled_present = true;
+        seq_scaled_lsb = ip_id_scaled & 0x0f;
+        SetRsfIndex(0);
+        return PARSE_OK;
+    }
+
+    ParseResult_t
+    DTCPProfile::parse_seq_3(ByteReader& in)
+    {
+        if (!in.Has(4))
+            return PARSE_TRUNCATED;
+        uint8_t ip_id = in.U8() & 0x0f;
+        uint16_t ack = in.U16();
+        parse_msn_psh_crc3(in.U8());
+        DecodeIPID(ip_id, 4, 3);
+        DecodeAck(ack, 16, 16383);
+        SetRsfIndex(0);
+        return PARSE_OK;
+    }
+
+    ParseResult_t
+    DTCPProfile::parse_seq_4(ByteReader& in)
+    {
+        if (!in.Has(2))
+            return PARSE_TRUNCATED;
+        uint8_t scaled_ip_id = in.U8();
+        parse_msn_psh_crc3(in.U8());
+        DecodeIPID(scaled_ip_id & 0x07, 3, 1);
+        SetRsfIndex(0);
+        return DecodeAckScaled((scaled_ip_id >> 3) & 0x0f);
+    }
+
+    ParseResult_t
+    DTCPProfile::parse_seq_5(ByteReader& in)
+    {
+        if (!in.Has(6))
+            return PARSE_TRUNCATED;
+        uint8_t ip_id = in.U8() & 0x0f;
+        uint16_t ack = in.U16();
+        uint16_t seq = in.U16();
+        parse_msn_psh_crc3(in.U8());
+        DecodeIPID(ip_id, 4, 3);
+        DecodeAck(ack, 16, 16383);
+        DecodeSeq(seq, 16, 32767);
+        SetRsfIndex(0);
+        return PARSE_OK;
+    }
+
+    ParseResult_t
+    DTCPProfile::parse_seq_6(ByteReader& in)
+    {
+        if (!in.Has(5))
+            return PARSE_TRUNCATED;
+        uint8_t disc_scaled = in.U8();
+        uint8_t scaled_ip_id = in.U8();
+        uint16_t ack = in.U16();
+        parse_msn_psh_crc3(in.U8());
+        seq_scaled_present = true;
+        seq_scaled_lsb = static_cast<uint8_t>(((disc_scaled & 0x07) << 1) | (scaled_ip_id >> 7));
+        DecodeIPID(scaled_ip_id & 0x7f, 7, 3);
+        DecodeAck(ack, 16, 16383);
+        SetRsfIndex(0);
+        return PARSE_OK;
+    }
+
+    ParseResult_t
+    DTCPProfile::parse_seq_7(ByteReader& in)
+    {
+        if (!in.Has(6))
+            return PARSE_TRUNCATED;
+        uint8_t disc_window = in.U8();
+        uint8_t window = in.U8();
+        uint8_t window_ip_id = in.U8();
+        uint16_t ack = in.U16();
+        parse_msn_psh_crc3(in.U8());
+        uint16_t lsbWindow = static_cast<uint16_t>(((disc_window & 0x0f) << 11) | (window << 3) | (window_ip_id >> 5));
+        tcp.windowSize = rohc_htons(DecodeLSB<uint16_t>(rohc_htons(tcp.windowSize), lsbWindow, 15, 16383));
+        DecodeIPID(window_ip_id & 0x1f, 5, 3);
+        DecodeAck(ack, 16, 32767);
+        SetRsfIndex(0);
+        return PARSE_OK;
+    }
+
+    ParseResult_t
+    DTCPProfile::parse_seq_8(ByteReader& in)
+    {
+        if (!in.Has(7))
+            return PARSE_TRUNCATED;
+        uint8_t ip_id = in.U8() & 0x0f;
+        uint8_t list_crc7 = in.U8();
+        uint8_t msn_psh_ttl = in.U8();
+        uint16_t ecn_ack = in.U16();
+        uint16_t rsf_seq = in.U16();
+
+        SetReceivedCRC(list_crc7 & 0x7f, 7);
+        DecodeMSN(msn_psh_ttl >> 4);
+        tcp.PSH = (msn_psh_ttl >> 3) & 1;
+        ip.ttl = DecodeLSB<uint8_t>(ip.ttl, msn_psh_ttl & 7, 3, 3);
+        ecn_used = (ecn_ack & 0x8000) != 0;
+        DecodeIPID(ip_id, 4, 3);
+        DecodeAck(ecn_ack & 0x7fff, 15, 8191);
+        SetRsfIndex(static_cast<uint8_t>(rsf_seq >> 14));
+        DecodeSeq(rsf_seq & 0x3fff, 14, 8191);
+
+        if (list_crc7 & 0x80)
+            return parse_list_tcp_options(tcp_options, rohc_htonl(tcp.ackNumber), in, option_x);
+        return PARSE_OK;
+    }
+
+} // ns ROHC
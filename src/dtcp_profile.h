@@ -1,2 +1,105 @@
 #pragma once
 
+/**
+ * TCP/IP profile, RFC 6846
+ */
+
+#include "dprofile.h"
+
+namespace ROHC
+{
+    class DTCPProfile : public DProfile
+    {
+    public:
+        DTCPProfile(Decompressor* decomp, uint16_t cid);
+
+        virtual uint8_t LSBID() const { return static_cast<uint8_t>(ProfileID());}
+        static uint16_t ProfileID() {return 0x0106;}
+
+        static bool ParseIR(global_control& gc, const data_t& data, const_data_iterator& pos);
+        virtual bool ParseIRDYN(global_control& gc, const data_t& data, const_data_iterator& pos);
+        virtual void ParseCO(uint8_t packetTypeIndication, data_t& data, data_iterator pos, data_t& output);
+        virtual void ParseCORepair(const data_t& data, const_data_iterator r1_crc7_pos, data_t& output);
+
+        virtual void MergeGlobalControlAndAppendHeaders(const global_control& gc, data_t& output);
+
+    private:
+        bool parse_co_header(uint8_t packetTypeIndication, data_t& data, data_iterator& pos);
+        ParseResult_t parse_co_header(uint8_t packetTypeIndication, ByteReader& in);
+        ParseResult_t parse_irregular_chain(ByteReader& in);
+
+        static bool parse_tcp_static(global_control& gc, const_data_iterator& pos, const_data_iterator& end);
+        static bool parse_tcp_dynamic(global_control& gc, const_data_iterator& pos, const_data_iterator& end);
+
+        /**
+         * The compressed list of RFC 6846 6.3.3, see CTCPProfile. Sets the
+         * list and the items with X set in options, x gets the X flags.
+         */
+        static ParseResult_t parse_list_tcp_options(TCPOptionContext& options, uint32_t ack, ByteReader& in, bool* x);
+        static ParseResult_t parse_tcp_option_item(unsigned int index, uint32_t ack, ByteReader& in, TCPOptionItem& item);
+        ParseResult_t parse_tcp_options_irregular(ByteReader& in);
+
+        /**
+         * Base header parsers indexed by the first octet, see DIPProfile
+         */
+        typedef ParseResult_t (DTCPProfile::*parser_t)(ByteReader& in);
+        struct COParsers
+        {
+            COParsers();
+            parser_t sequential[256];
+            parser_t random[256];
+        };
+        static const COParsers co_parsers;
+
+        ParseResult_t parse_co_common(ByteReader& in);
+        ParseResult_t parse_rnd_1(ByteReader& in);
+        ParseResult_t parse_rnd_2(ByteReader& in);
+        ParseResult_t parse_rnd_3(ByteReader& in);
+        ParseResult_t parse_rnd_4(ByteReader& in);
+        ParseResult_t parse_rnd_5(ByteReader& in);
+        ParseResult_t parse_rnd_6(ByteReader& in);
+        ParseResult_t parse_rnd_7(ByteReader& in);
+        ParseResult_t parse_rnd_8(ByteReader& in);
+        ParseResult_t parse_seq_1(ByteReader& in);
+        ParseResult_t parse_seq_2(ByteReader& in);
+        ParseResult_t parse_seq_3(ByteReader& in);
+        ParseResult_t parse_seq_4(ByteReader& in);
+        ParseResult_t parse_seq_5(ByteReader& in);
+        ParseResult_t parse_seq_6(ByteReader& in);
+        ParseResult_t parse_seq_7(ByteReader& in);
+        ParseResult_t parse_seq_8(ByteReader& in);
+
+        /**
+         * The fields all formats but co_common, seq_8 and rnd_8 end with
+         */
+        void parse_msn_psh_crc3(uint8_t msn_psh_crc3);
+        void DecodeMSN(uint8_t lsbMsn);
+        void DecodeIPID(uint16_t lsbIPID, unsigned int k, int p);
+        void DecodeSeq(uint32_t lsbSeq, unsigned int k, int p);
+        void DecodeAck(uint32_t lsbAck, unsigned int k, int p);
+        ParseResult_t DecodeAckScaled(uint8_t lsbScaled);
+        /**
+         * seq_number_scaled is decoded once the size of the payload is
+         * known, after the irregular chain
+         */
+        bool DecodeSeqScaled(size_t payloadSize);
+        /**
+         * variable_length_32_enc of co_common, field in network byte order
+         */
+        ParseResult_t parse_variable_length_32(unsigned int indicator, ByteReader& in, uint32_t& field) const;
+        void SetRsfIndex(uint8_t rsf_index);
+
+        void SaveContext(global_control& gc) const;
+        void RestoreContext(const global_control& gc);
+
+        tcphdr tcp;
+        bool ecn_used;
+        uint16_t ack_stride;
+        TCPOptionContext tcp_options;
+
+        bool seq_scaled_present;
+        uint8_t seq_scaled_lsb;
+        // X of the items of the packet being parsed
+        bool option_x[maxTCPOptionListSize];
+    };
+} // ns ROHC
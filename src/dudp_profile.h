@@ -4,11 +4,11 @@
  * UDP/IP profile
  */
 
-#include "dprofile.h"
+#include "dip_profile.h"
 
 namespace ROHC
 {
-    class DUDPProfile : public DProfile
+    class DUDPProfile : public DIPProfile
     {
     public:
         DUDPProfile(Decompressor* decomp, uint16_t cid);
@@ -17,27 +17,21 @@ namespace ROHC
         static uint16_t ProfileID() {return 0x0102;}
         
         static bool ParseIR(global_control& gc, const data_t& data, const_data_iterator& pos);
-        virtual void ParseCO(uint8_t packetTypeIndication, data_t& data, data_iterator pos, data_t& output);
-        virtual void ParseCORepair(const data_t& data, const_data_iterator r2_crc3_pos, data_t& output);
+        virtual bool ParseIRDYN(global_control& gc, const data_t& data, const_data_iterator& pos);
         
         void MergeGlobalControlAndAppendHeaders(const global_control& gc, data_t& output);        
         
         
         static bool parse_udp_static(global_control& gc, const_data_iterator& pos, const_data_iterator& end);
         
-    private:
+    protected:
         void InitIPHeader(iphdr* ip);
-        static bool parse_udp_endpoint_dynamic(global_control& gc, const_data_iterator& pos, const_data_iterator& end);
-        
-        bool parse_co_common(data_iterator& pos, const data_iterator& end);
-        bool parse_pt_0_crc3(data_iterator& pos, const data_iterator& end);
-        bool parse_pt_0_crc7(data_iterator& pos, const data_iterator& end);
-        bool parse_pt_1_seq_id(data_iterator& pos, const data_iterator& end);
-        bool parse_pt_2_seq_id(data_iterator& pos, const data_iterator& end);
+        virtual void AppendHeaders(const_data_iterator payload, const_data_iterator end, data_t& output) {AppendHeaderTemplate(&udp, 0, payload, end, output);}
+        virtual ParseResult_t parse_irregular_chain(ByteReader& in);
 
-		bool parse_profile_2_3_4_flags_enc(data_iterator& pos, const data_iterator& end, bool& df, IPIDBehaviour_t& new_ip_id_behaviour) const;
-
-        uint8_t control_crc3(Reordering_t newRR, uint16_t new_msn, IPIDBehaviour_t new_ip_id_behaviour) const;
+        void SaveContext(global_control& gc) const;
+        void RestoreContext(const global_control& gc);
+        static bool parse_udp_endpoint_dynamic(global_control& gc, const_data_iterator& pos, const_data_iterator& end);
         
         bool checksum_used;
         udphdr udp;
@@ -0,0 +1,130 @@
+#include "dudplite_profile.h"
+#include "network.h"
+#include <rohc/decomp.h>
+
+namespace ROHC
+{
+    DUDPLiteProfile::DUDPLiteProfile(Decompressor* decomp, uint16_t cid)
+    : DUDPProfile(decomp, cid)
+    , coverage_behaviour(UDP_LITE_COVERAGE_INFERRED)
+    {
+    }
+
+    void
+    DUDPLiteProfile::MergeGlobalControlAndAppendHeaders(const ROHC::global_control &gc, data_t &output)
+    {
+        coverage_behaviour = gc.coverage_behaviour;
+        DUDPProfile::MergeGlobalControlAndAppendHeaders(gc, output);
+    }
+
+    bool
+    DUDPLiteProfile::ParseIR(global_control& gc, const data_t& data, const_data_iterator& pos)
+    {
+        const_data_iterator end(data.end());
+        if(!DProfile::parse_ip_static(gc, pos, end))
+            return false;
+        if(!parse_udp_static(gc, pos, end))
+            return false;
+
+        if(!DProfile::parse_ip_regular_dynamic(gc, pos, end))
+            return false;
+
+        if(!parse_udp_lite_endpoint_dynamic(gc, pos, end))
+            return false;
+
+        return true;
+    }
+
+    bool
+    DUDPLiteProfile::ParseIRDYN(global_control& gc, const data_t& data, const_data_iterator& pos)
+    {
+        SaveContext(gc);
+        gc.ip6 = ip6;
+
+        const_data_iterator end(data.end());
+        if(!DProfile::parse_ip_regular_dynamic(gc, pos, end))
+            return false;
+
+        return parse_udp_lite_endpoint_dynamic(gc, pos, end);
+    }
+
+    bool
+    DUDPLiteProfile::parse_udp_lite_endpoint_dynamic(global_control& gc, const_data_iterator& pos, const_data_iterator& end)
+    {
+        if(!GetValue(pos, end, gc.udp.len)) {
+            error("parse_udp_lite_endpoint_dynamic, failed to get checksum coverage\n");
+            return false;
+        }
+        if(!GetValue(pos, end, gc.udp.check)) {
+            error("parse_udp_lite_endpoint_dynamic, failed to get udp checksum\n");
+            return false;
+        }
+        // The checksum is mandatory for UDP-Lite
+        gc.udp_checksum_used = true;
+
+        if (!GetValueFromNBO(pos, end, gc.msn)) {
+            error("parse_udp_lite_endpoint_dynamic, failed to get MSN\n");
+            return false;
+        }
+
+        if (pos == end) {
+            error("parse_udp_lite_endpoint_dynamic - not enough data for coverage behaviour");
+            return false;
+        }
+        uint8_t reserved_coverage_reorderRatio = *pos++;
+
+        if ((reserved_coverage_reorderRatio & 0xf0) ||
+            !parse_coverage_behaviour(static_cast<uint8_t>(reserved_coverage_reorderRatio >> 2), gc))
+        {
+            error("parse_udp_lite_endpoint_dynamic, not a valid coverage behaviour\n");
+            return false;
+        }
+
+        gc.reorder_ratio = static_cast<Reordering_t>(reserved_coverage_reorderRatio & 3);
+        return true;
+    }
+
+    bool
+    DUDPLiteProfile::parse_coverage_behaviour(uint8_t coverage_behaviour, global_control& gc)
+    {
+        if (coverage_behaviour > UDP_LITE_COVERAGE_IRREGULAR)
+            return false;
+        gc.coverage_behaviour = static_cast<CoverageBehaviour_t>(coverage_behaviour);
+        return true;
+    }
+
+    ParseResult_t
+    DUDPLiteProfile::parse_udp_lite_irregular(CoverageBehaviour_t coverage_behaviour, ByteReader& in, udphdr& udp)
+    {
+        if ((UDP_LITE_COVERAGE_IRREGULAR == coverage_behaviour) && !in.ReadRaw(udp.len))
+            return PARSE_TRUNCATED;
+        if (!in.ReadRaw(udp.check))
+            return PARSE_TRUNCATED;
+        return PARSE_OK;
+    }
+
+    void
+    DUDPLiteProfile::InferCoverage(CoverageBehaviour_t coverage_behaviour, size_t udpLength, udphdr& udp)
+    {
+        if (UDP_LITE_COVERAGE_INFERRED == coverage_behaviour)
+            udp.len = rohc_htons(static_cast<uint16_t>(udpLength));
+    }
+
+    ParseResult_t
+    DUDPLiteProfile::parse_irregular_chain(ByteReader& in)
+    {
+        ParseResult_t result = parse_ip_innermost_irregular(in);
+        if (PARSE_OK != result)
+            return result;
+
+        return parse_udp_lite_irregular(coverage_behaviour, in, udp);
+    }
+
+    void
+    DUDPLiteProfile::AppendHeaders(const_data_iterator payload, const_data_iterator end, data_t& output)
+    {
+        InferCoverage(coverage_behaviour, sizeof(udphdr) + (end - payload), udp);
+        AppendHeaderTemplate(&udp, 0, payload, end, output);
+    }
+
+} // ns ROHC
@@ -0,0 +1,42 @@
+#pragma once
+
+/**
+ * UDP-Lite/IP profile
+ */
+
+#include "dudp_profile.h"
+
+namespace ROHC
+{
+    class DUDPLiteProfile : public DUDPProfile
+    {
+    public:
+        DUDPLiteProfile(Decompressor* decomp, uint16_t cid);
+
+        virtual uint8_t LSBID() const { return static_cast<uint8_t>(ProfileID());}
+        static uint16_t ProfileID() {return 0x0108;}
+
+        static bool ParseIR(global_control& gc, const data_t& data, const_data_iterator& pos);
+        virtual bool ParseIRDYN(global_control& gc, const data_t& data, const_data_iterator& pos);
+
+        void MergeGlobalControlAndAppendHeaders(const global_control& gc, data_t& output);
+
+        /**
+         * used by the RTP/UDP-Lite profile
+         */
+        static bool parse_coverage_behaviour(uint8_t coverage_behaviour, global_control& gc);
+        static ParseResult_t parse_udp_lite_irregular(CoverageBehaviour_t coverage_behaviour, ByteReader& in, udphdr& udp);
+        /**
+         * Sets an inferred checksum coverage to the UDP-Lite length
+         */
+        static void InferCoverage(CoverageBehaviour_t coverage_behaviour, size_t udpLength, udphdr& udp);
+
+    private:
+        virtual void AppendHeaders(const_data_iterator payload, const_data_iterator end, data_t& output);
+        virtual ParseResult_t parse_irregular_chain(ByteReader& in);
+
+        static bool parse_udp_lite_endpoint_dynamic(global_control& gc, const_data_iterator& pos, const_data_iterator& end);
+
+        CoverageBehaviour_t coverage_behaviour;
+    };
+} // ns ROHC
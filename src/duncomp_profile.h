@@ -23,7 +23,9 @@ namespace ROHC
         void MergeGlobalControlAndAppendHeaders(const global_control& gc, data_t& output);
         
         void ParseCO(uint8_t packetTypeIndication, data_t& data, data_iterator pos, data_t& output);
-        void ParseCORepair(const data_t& /*data*/, const_data_iterator /*r2_crc3_pos*/, data_t& /*output*/) {};
+        void ParseCORepair(const data_t& /*data*/, const_data_iterator /*r1_crc7_pos*/, data_t& /*output*/) {};
+        // There is no dynamic chain, RFC 4995 5.4 has no IR-DYN
+        bool ParseIRDYN(global_control& /*gc*/, const data_t& /*data*/, const_data_iterator& /*pos*/) {return false;}
         size_t IRCRCSize(const_data_iterator ) {return 0;}        
     };
     
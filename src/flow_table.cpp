@@ -0,0 +1,292 @@
+#include "flow_table.h"
+#include "network.h"
+
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define ROHC_FLOW_SIMD 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace
+{
+    using ROHC::FlowTable;
+
+    struct Tables
+    {
+        const uint32_t* column[FlowTable::NUMBER_OF_COLUMNS];
+        const uint32_t* armed;
+        const uint32_t* index;
+        unsigned int shift;
+    };
+
+    typedef uint32_t (*eligibleKernel_t)(const FlowTable::Lanes& lanes, const Tables& tables, uint32_t* cids);
+
+    const uint32_t hashMultiplier1 = 0x9e3779b1;
+    const uint32_t hashMultiplier2 = 0x85ebca6b;
+
+    // Shape of a lane, not a fragment, UDP and RTP version 2
+    const uint32_t shapeMask = ROHC::rohc_htons(ROHC::IP_MORE_FRAGMENTS | ROHC::IP_FRAGMENT_OFFSET) | (0xffU << 16) | (0xc0U << 24);
+    const uint32_t shapeValue = (17U << 16) | (0x80U << 24);
+
+    uint32_t Hash(uint32_t saddr, uint32_t daddr, uint32_t ports, uint32_t ssrc)
+    {
+        return ((saddr ^ ports) * hashMultiplier1 + (daddr ^ ssrc)) * hashMultiplier2;
+    }
+
+    uint32_t LaneMask(size_t count)
+    {
+        return count >= 32 ? 0xffffffff : (1U << count) - 1;
+    }
+
+    uint32_t EligibleScalar(const FlowTable::Lanes& lanes, const Tables& tables, uint32_t* cids)
+    {
+        uint32_t eligible = 0;
+        for (size_t lane = 0; lane < lanes.count; ++lane)
+        {
+            uint32_t hash = Hash(lanes.column[FlowTable::COLUMN_SADDR][lane],
+                                 lanes.column[FlowTable::COLUMN_DADDR][lane],
+                                 lanes.column[FlowTable::COLUMN_PORTS][lane],
+                                 lanes.column[FlowTable::COLUMN_SSRC][lane]);
+            uint32_t cid = tables.index[hash >> tables.shift];
+            cids[lane] = cid;
+
+            bool match = tables.armed[cid] && (lanes.shape[lane] & shapeMask) == shapeValue;
+            for (int c = 0; match && c < FlowTable::NUMBER_OF_COLUMNS; ++c)
+                match = tables.column[c][cid] == lanes.column[c][lane];
+            if (match)
+                eligible |= 1U << lane;
+        }
+        return eligible;
+    }
+
+#ifdef ROHC_FLOW_SIMD
+    __attribute__((target("avx2")))
+    __m256i LoadLanes8(const uint32_t* p)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    /**
+     * 8 lanes starting at first
+     */
+    __attribute__((target("avx2")))
+    uint32_t Eligible8(const FlowTable::Lanes& lanes, size_t first, const Tables& tables, uint32_t* cids)
+    {
+        const __m256i saddr = LoadLanes8(&lanes.column[FlowTable::COLUMN_SADDR][first]);
+        const __m256i daddr = LoadLanes8(&lanes.column[FlowTable::COLUMN_DADDR][first]);
+        const __m256i ports = LoadLanes8(&lanes.column[FlowTable::COLUMN_PORTS][first]);
+        const __m256i ssrc = LoadLanes8(&lanes.column[FlowTable::COLUMN_SSRC][first]);
+
+        __m256i hash = _mm256_mullo_epi32(_mm256_xor_si256(saddr, ports), _mm256_set1_epi32(hashMultiplier1));
+        hash = _mm256_add_epi32(hash, _mm256_xor_si256(daddr, ssrc));
+        hash = _mm256_mullo_epi32(hash, _mm256_set1_epi32(hashMultiplier2));
+        __m256i bucket = _mm256_srl_epi32(hash, _mm_cvtsi32_si128(static_cast<int>(tables.shift)));
+        __m256i cid = _mm256_i32gather_epi32(reinterpret_cast<const int*>(tables.index), bucket, 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&cids[first]), cid);
+
+        __m256i match = _mm256_i32gather_epi32(reinterpret_cast<const int*>(tables.armed), cid, 4);
+        __m256i shape = _mm256_and_si256(LoadLanes8(&lanes.shape[first]), _mm256_set1_epi32(shapeMask));
+        match = _mm256_and_si256(match, _mm256_cmpeq_epi32(shape, _mm256_set1_epi32(shapeValue)));
+        for (int c = 0; c < FlowTable::NUMBER_OF_COLUMNS; ++c)
+        {
+            __m256i expected = _mm256_i32gather_epi32(reinterpret_cast<const int*>(tables.column[c]), cid, 4);
+            match = _mm256_and_si256(match, _mm256_cmpeq_epi32(expected, LoadLanes8(&lanes.column[c][first])));
+        }
+        return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(match)));
+    }
+
+    __attribute__((target("avx2")))
+    uint32_t EligibleAVX2(const FlowTable::Lanes& lanes, const Tables& tables, uint32_t* cids)
+    {
+        uint32_t eligible = 0;
+        for (size_t first = 0; first < lanes.count; first += 8)
+            eligible |= Eligible8(lanes, first, tables, cids) << first;
+        return eligible & LaneMask(lanes.count);
+    }
+
+    __attribute__((target("avx512f")))
+    __m512i LoadLanes16(const uint32_t* p)
+    {
+        return _mm512_loadu_si512(p);
+    }
+
+    __attribute__((target("avx512f")))
+    uint32_t EligibleAVX512(const FlowTable::Lanes& lanes, const Tables& tables, uint32_t* cids)
+    {
+        const __m512i saddr = LoadLanes16(lanes.column[FlowTable::COLUMN_SADDR]);
+        const __m512i daddr = LoadLanes16(lanes.column[FlowTable::COLUMN_DADDR]);
+        const __m512i ports = LoadLanes16(lanes.column[FlowTable::COLUMN_PORTS]);
+        const __m512i ssrc = LoadLanes16(lanes.column[FlowTable::COLUMN_SSRC]);
+
+        __m512i hash = _mm512_mullo_epi32(_mm512_xor_si512(saddr, ports), _mm512_set1_epi32(hashMultiplier1));
+        hash = _mm512_add_epi32(hash, _mm512_xor_si512(daddr, ssrc));
+        hash = _mm512_mullo_epi32(hash, _mm512_set1_epi32(hashMultiplier2));
+        const __m512i zero = _mm512_setzero_si512();
+        const __mmask16 lanes16 = static_cast<__mmask16>(LaneMask(lanes.count));
+        __m512i bucket = _mm512_maskz_srlv_epi32(lanes16, hash, _mm512_set1_epi32(static_cast<int>(tables.shift)));
+        __m512i cid = _mm512_mask_i32gather_epi32(zero, lanes16, bucket, tables.index, 4);
+        _mm512_storeu_si512(cids, cid);
+
+        __m512i armed = _mm512_mask_i32gather_epi32(zero, lanes16, cid, tables.armed, 4);
+        __mmask16 match = _mm512_test_epi32_mask(armed, armed);
+        __m512i shape = _mm512_and_si512(LoadLanes16(lanes.shape), _mm512_set1_epi32(shapeMask));
+        match = _mm512_mask_cmpeq_epi32_mask(match, shape, _mm512_set1_epi32(shapeValue));
+        for (int c = 0; c < FlowTable::NUMBER_OF_COLUMNS; ++c)
+        {
+            __m512i expected = _mm512_mask_i32gather_epi32(zero, match, cid, tables.column[c], 4);
+            match = _mm512_mask_cmpeq_epi32_mask(match, expected, LoadLanes16(lanes.column[c]));
+        }
+        return match;
+    }
+
+    eligibleKernel_t eligibleKernel = EligibleScalar;
+
+    struct FlowTableStartup
+    {
+        FlowTableStartup()
+        {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) {
+                eligibleKernel = EligibleAVX512;
+            } else if (__builtin_cpu_supports("avx2")) {
+                eligibleKernel = EligibleAVX2;
+            }
+        }
+    } flowTableStartup;
+#else
+    eligibleKernel_t eligibleKernel = EligibleScalar;
+#endif
+
+    uint32_t Read32(const void* p)
+    {
+        uint32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint32_t Read16(const void* p)
+    {
+        uint16_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+} // anon ns
+
+namespace ROHC
+{
+    const size_t FlowTable::MaxLanes;
+
+    FlowTable::FlowTable(size_t maxCID)
+    : armed(1, 0)
+    , index()
+    , indexBits(5)
+    {
+        // At least two buckets per CID
+        while ((static_cast<size_t>(1) << indexBits) < 2 * (maxCID + 1))
+            ++indexBits;
+        index.assign(static_cast<size_t>(1) << indexBits, 0);
+        for (int c = 0; c < NUMBER_OF_COLUMNS; ++c)
+            column[c].assign(1, 0);
+    }
+
+    void
+    FlowTable::Load(Lanes& lanes, size_t lane, const data_t& packet)
+    {
+        if (packet.size() < sizeof(iphdr) + sizeof(udphdr) + sizeof(rtphdr) ||
+            IsIPv6(reinterpret_cast<const iphdr*>(&packet[0])))
+        {
+            lanes.shape[lane] = 0;
+            for (int c = 0; c < NUMBER_OF_COLUMNS; ++c)
+                lanes.column[c][lane] = 0;
+            return;
+        }
+        const iphdr* ip = reinterpret_cast<const iphdr*>(&packet[0]);
+        const udphdr* udp = reinterpret_cast<const udphdr*>(ip+1);
+        const rtphdr* rtp = reinterpret_cast<const rtphdr*>(udp+1);
+        const uint8_t* rtpBytes = reinterpret_cast<const uint8_t*>(rtp);
+
+        lanes.column[COLUMN_SADDR][lane] = Read32(&ip->saddr);
+        lanes.column[COLUMN_DADDR][lane] = Read32(&ip->daddr);
+        lanes.column[COLUMN_PORTS][lane] = Read32(&udp->source);
+        lanes.column[COLUMN_SSRC][lane] = Read32(&rtp->ssrc);
+        lanes.column[COLUMN_SEQUENCE_NUMBER][lane] = Read16(&rtp->sequence_number);
+        lanes.column[COLUMN_TIMESTAMP][lane] = Read32(&rtp->timestamp);
+        lanes.column[COLUMN_IP_ID][lane] = Read16(&ip->id);
+        lanes.shape[lane] = Read16(&ip->frag_off) | (static_cast<uint32_t>(ip->protocol) << 16) | (static_cast<uint32_t>(rtpBytes[0]) << 24);
+    }
+
+    uint32_t
+    FlowTable::Eligible(const Lanes& lanes, uint32_t* cids) const
+    {
+        Tables tables;
+        for (int c = 0; c < NUMBER_OF_COLUMNS; ++c)
+            tables.column[c] = &column[c][0];
+        tables.armed = &armed[0];
+        tables.index = &index[0];
+        tables.shift = 32 - indexBits;
+        return eligibleKernel(lanes, tables, cids);
+    }
+
+    uint32_t
+    FlowTable::Bucket(uint32_t saddr, uint32_t daddr, uint32_t ports, uint32_t ssrc) const
+    {
+        return Hash(saddr, daddr, ports, ssrc) >> (32 - indexBits);
+    }
+
+    void
+    FlowTable::Arm(uint16_t cid, const iphdr* ip, const udphdr* udp, const rtphdr* rtp)
+    {
+        if (!cid)
+            return;
+        if (cid >= armed.size())
+        {
+            armed.resize(cid + 1, 0);
+            for (int c = 0; c < NUMBER_OF_COLUMNS; ++c)
+                column[c].resize(cid + 1, 0);
+        }
+
+        uint32_t saddr = Read32(&ip->saddr);
+        uint32_t daddr = Read32(&ip->daddr);
+        uint32_t ports = Read32(&udp->source);
+        uint32_t ssrc = Read32(&rtp->ssrc);
+        if (column[COLUMN_SADDR][cid] != saddr ||
+            column[COLUMN_DADDR][cid] != daddr ||
+            column[COLUMN_PORTS][cid] != ports ||
+            column[COLUMN_SSRC][cid] != ssrc)
+        {
+            // A new flow in this CID
+            Remove(cid);
+            column[COLUMN_SADDR][cid] = saddr;
+            column[COLUMN_DADDR][cid] = daddr;
+            column[COLUMN_PORTS][cid] = ports;
+            column[COLUMN_SSRC][cid] = ssrc;
+        }
+        // Taken when the flow holding the bucket is removed
+        uint32_t& bucket = index[Bucket(saddr, daddr, ports, ssrc)];
+        if (!bucket)
+            bucket = cid;
+
+        column[COLUMN_SEQUENCE_NUMBER][cid] = Read16(&rtp->sequence_number);
+        column[COLUMN_TIMESTAMP][cid] = Read32(&rtp->timestamp);
+        column[COLUMN_IP_ID][cid] = Read16(&ip->id);
+        armed[cid] = 0xffffffff;
+    }
+
+    void
+    FlowTable::Remove(uint16_t cid)
+    {
+        if (!cid || cid >= armed.size())
+            return;
+        armed[cid] = 0;
+        uint32_t& bucket = index[Bucket(column[COLUMN_SADDR][cid], column[COLUMN_DADDR][cid],
+                                        column[COLUMN_PORTS][cid], column[COLUMN_SSRC][cid])];
+        if (cid == bucket)
+            bucket = 0;
+        for (int c = 0; c < NUMBER_OF_COLUMNS; ++c)
+            column[c][cid] = 0;
+    }
+
+} // ns ROHC
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <rohc/rohc.h>
+#include "network.h"
+#include <vector>
+
+namespace ROHC
+{
+
+    /**
+     * Hot state of the RTP flows whose next header is predicted (see
+     * CRTPProfile::PredictNextHeader), kept as a structure of arrays
+     * indexed by CID for the batch compressor.
+     *
+     * The packets of a batch are transposed into Lanes, and Eligible tests
+     * up to MaxLanes of them at once: a UDP packet with RTP version 2 that
+     * is not a fragment, the key of an armed flow and its predicted
+     * sequence number, timestamp and IP-ID. All fields are compared in
+     * network byte order, as they are in the packet. The test only picks
+     * the context, the profile still compares the whole header.
+     *
+     * Flows are found through a direct mapped index on a hash of the key,
+     * a flow colliding with another one is not indexed and always takes
+     * the scalar path.
+     *
+     * Not thread safe, only used by the thread owning the compressor.
+     */
+    class FlowTable
+    {
+        void operator=(const FlowTable&);
+        FlowTable(const FlowTable&);
+    public:
+        enum Column_t
+        {
+            // Key, the fields CRTPProfile::Matches compares
+            COLUMN_SADDR = 0,
+            COLUMN_DADDR,
+            COLUMN_PORTS,
+            COLUMN_SSRC,
+            // Predicted next header
+            COLUMN_SEQUENCE_NUMBER,
+            COLUMN_TIMESTAMP,
+            COLUMN_IP_ID,
+            NUMBER_OF_COLUMNS
+        };
+
+        static const size_t MaxLanes = 16;
+
+        struct Lanes
+        {
+            size_t count;
+            uint32_t column[NUMBER_OF_COLUMNS][MaxLanes];
+            // frag_off, protocol and the first RTP byte
+            uint32_t shape[MaxLanes];
+        };
+
+        explicit FlowTable(size_t maxCID);
+
+        /**
+         * Transposes the headers of packet into lane, an IPv6 packet or
+         * one shorter than the IP/UDP/RTP header is never eligible
+         */
+        static void Load(Lanes& lanes, size_t lane, const data_t& packet);
+
+        /**
+         * Bit i is set if lane i is the predicted next packet of the flow
+         * with CID cids[i]
+         */
+        uint32_t Eligible(const Lanes& lanes, uint32_t* cids) const;
+
+        /**
+         * The next packet of cid is expected to have these headers
+         */
+        void Arm(uint16_t cid, const iphdr* ip, const udphdr* udp, const rtphdr* rtp);
+        void Disarm(uint16_t cid)
+        {
+            if (cid < armed.size())
+                armed[cid] = 0;
+        }
+
+        /**
+         * The context with cid is gone
+         */
+        void Remove(uint16_t cid);
+
+    private:
+        uint32_t Bucket(uint32_t saddr, uint32_t daddr, uint32_t ports, uint32_t ssrc) const;
+
+        std::vector<uint32_t> column[NUMBER_OF_COLUMNS];
+        // All ones when the CID has a prediction
+        std::vector<uint32_t> armed;
+
+        // CID per bucket, 0 (the uncompressed profile, never armed) if empty
+        std::vector<uint32_t> index;
+        unsigned int indexBits;
+    };
+
+} // ns ROHC
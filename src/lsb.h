@@ -47,6 +47,37 @@ namespace ROHC
         return k;
     }        
 
+    /**
+     * f(v_ref, k, p) contains value. For an unsigned T the interval wraps
+     * around at the width of T, as in DecodeLSB, signed windows are
+     * compared without wrapping.
+     */
+    template<typename T>
+    bool InInterval(T value, T v_ref, unsigned int k, int p)
+    {
+        if (!std::numeric_limits<T>::is_signed) {
+            if (k >= static_cast<unsigned int>(std::numeric_limits<T>::digits))
+                return true;
+            T min = static_cast<T>(v_ref - p);
+            return static_cast<T>(value - min) <= static_cast<T>((1u << k) - 1);
+        }
+        T min, max;
+        f<T>(v_ref, static_cast<T>(k), p, min, max);
+        return (min <= value) && (value <= max);
+    }
+
+    /**
+     * The value whose k LSBs are lsb in the interval f(v_ref, k, p),
+     * wrapping around at the width of T
+     */
+    template<typename T>
+    T DecodeLSB(T v_ref, T lsb, unsigned int k, int p)
+    {
+        T min = static_cast<T>(v_ref - p);
+        T mask = static_cast<T>((1u << k) - 1);
+        return static_cast<T>(min + ((lsb - min) & mask));
+    }
+
     template <typename T>
     class WLSB
     {
@@ -58,18 +89,22 @@ namespace ROHC
             uint16_t msn;
         };
         
-        typedef typename std::vector<LSB > window_t;
-        typedef typename window_t::iterator window_iterator;
-        typedef typename window_t::const_iterator const_window_iterator;
-        
     public:   
+        /**
+         * The window is stored inline so that it is part of the context
+         * memory, see ContextArena
+         */
+        static const size_t MaxWindowSize = 16;
+
         WLSB(size_t windowSize, unsigned int maxWidth, int p)
-        : window(windowSize)
-        , windowSize(windowSize)
+        : windowSize(windowSize)
         , first(0)
         , next(0)
         , p(p)
-        , maxWidth(maxWidth) {}
+        , maxWidth(maxWidth)
+        {
+            RASSERT(windowSize <= MaxWindowSize);
+        }
         
         void setP(int p)
         {
@@ -103,6 +138,33 @@ namespace ROHC
             unsigned int max_bits = g(value, v_max, maxWidth, p);
             return std::max(min_bits, max_bits);
         }
+
+        bool empty() const {
+            return first == next;
+        }
+
+        /**
+         * width(value) <= k, without searching for the smallest width
+         */
+        bool fits(T value, unsigned int k) const {
+            return fits(value, k, p);
+        }
+
+        /**
+         * The same with another p than that of the window, for profiles
+         * whose formats use several (RFC 6846)
+         */
+        bool fits(T value, unsigned int k, int p) const {
+            if (first == next) {
+                return k >= maxWidth;
+            }
+
+            for (size_t i = first; i != next; ++i) {
+                if (!InInterval(value, window[i % windowSize].v_ref, k, p))
+                    return false;
+            }
+            return true;
+        }
     
         void add(uint16_t msn, T v_ref)
         {
@@ -122,7 +184,8 @@ namespace ROHC
             if ((next - first) < 2) return;
             
             while(first != next) {
-                if (window[first % windowSize].msn < msn) {
+                // Compare modulo 2^16 so the window survives the MSN wrapping
+                if (static_cast<int16_t>(window[first % windowSize].msn - msn) < 0) {
                     ++first;
                 }
                 else {
@@ -132,7 +195,7 @@ namespace ROHC
         }
 
     private:
-        window_t window;
+        LSB window[MaxWindowSize];
         size_t windowSize;
         size_t first, next;
         
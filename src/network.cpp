@@ -5,6 +5,8 @@
 #include <cstdlib>
 
 #include <cstdio>
+#include <cstring>
+#include <cstddef>
 
 #ifdef _MSC_VER
 	#define snprintf _snprintf
@@ -14,36 +16,9 @@ using namespace std;
 
 namespace 
 {
-    uint32_t OneChecksum(const uint8_t* data, size_t size)
-    {
-        uint32_t cs = 0;
-        uint16_t* ptr = (uint16_t*) data;
-        size_t cnt = size;
-        
-        while (cnt > 1)
-        {
-            cs += *ptr++;
-            cnt -= 2;
-        }
-        
-        if (cnt)
-        {
-            cs += data[size - 1] << 8;
-        }
-        
-        return cs;
-    }
-    
     uint16_t OneComplementCs(const uint8_t* data, size_t size)
     {
-        uint32_t cs = OneChecksum(data, size);
-        while (cs >> 16)
-        {
-            cs = (cs & 0xffff) + (cs >> 16);
-        }
-        cs = ~cs;
-        
-        return static_cast<uint16_t>(cs);
+        return static_cast<uint16_t>(~ROHC::OnesComplementSum(data, size));
     }    
 } // ns anon
 
@@ -60,20 +35,10 @@ namespace ROHC
         udphdr* udp = reinterpret_cast<udphdr*>(reinterpret_cast<uint8_t*>(ip) + ip->ihl * 4);
         udp->check = 0;
 
-        uint32_t sum = OneChecksum(reinterpret_cast<uint8_t*>(udp), rohc_htons(udp->len));
-        
-        uint16_t* psaddr = reinterpret_cast<uint16_t*>(&ip->saddr);
-        uint16_t* pdaddr = reinterpret_cast<uint16_t*>(&ip->daddr);
-        
-        sum += rohc_htons(ip->protocol) + udp->len +
-            psaddr[0] + psaddr[1] +
-            pdaddr[0] + pdaddr[1];
-        
-        while (sum >> 16)
-        {
-            sum = (sum & 0xffff) + (sum >> 16);
-        }
-        
+        // Pseudo header, the addresses are summed with the payload
+        uint32_t sum = rohc_htons(ip->protocol) + udp->len;
+        sum = OnesComplementSum(reinterpret_cast<uint8_t*>(&ip->saddr), 8, sum);
+        sum = OnesComplementSum(reinterpret_cast<uint8_t*>(udp), rohc_htons(udp->len), sum);
         
         sum = ~sum;
         
@@ -85,10 +50,61 @@ namespace ROHC
 
     }  
     
+    void
+    HeaderCRC::SetStatic(const iphdr* ip, size_t transportStatic)
+    {
+        // The addresses end the IP header
+        static_begin = IsIPv6(ip) ? offsetof(ipv6hdr, saddr) : offsetof(iphdr, saddr);
+        static_size = IPHeaderSize(ip) - static_begin + transportStatic;
+
+        const uint8_t* begin = reinterpret_cast<const uint8_t*>(ip) + static_begin;
+        static_crc3 = ROHC::CRC3(0, begin, begin + static_size);
+        static_crc7 = ROHC::CRC7(0, begin, begin + static_size);
+    }
+
+    void
+    HeaderCRC::Calculate(const iphdr* ip, size_t headerSize, uint8_t& crc3, uint8_t& crc7) const
+    {
+        crc3 = CRC3(ip, headerSize);
+        crc7 = CRC7(ip, headerSize);
+    }
+
+    uint8_t
+    HeaderCRC::CRC3(const iphdr* ip, size_t headerSize) const
+    {
+        const uint8_t* h = reinterpret_cast<const uint8_t*>(ip);
+        const uint8_t* staticEnd = h + static_begin + static_size;
+        uint8_t crc = ROHC::CRC3(h, h + static_begin);
+        crc = static_cast<uint8_t>(CRC3Shift(crc, static_size) ^ static_crc3);
+        return ROHC::CRC3(crc, staticEnd, h + headerSize);
+    }
+
+    uint8_t
+    HeaderCRC::CRC7(const iphdr* ip, size_t headerSize) const
+    {
+        const uint8_t* h = reinterpret_cast<const uint8_t*>(ip);
+        const uint8_t* staticEnd = h + static_begin + static_size;
+        uint8_t crc = ROHC::CRC7(h, h + static_begin);
+        crc = static_cast<uint8_t>(CRC7Shift(crc, static_size) ^ static_crc7);
+        return ROHC::CRC7(crc, staticEnd, h + headerSize);
+    }
+
     void
     setLengthsAndIPChecksum(data_iterator b, data_iterator e)
     {
         iphdr* ip = reinterpret_cast<iphdr*>(&*b);
+        if (IsIPv6(ip))
+        {
+            // No header checksum, the payload length does not count the header
+            ipv6hdr* ip6 = reinterpret_cast<ipv6hdr*>(ip);
+            uint16_t payloadLength = static_cast<uint16_t>(e - b - sizeof(ipv6hdr));
+            ip6->payload_len = rohc_htons(payloadLength);
+            if (ip6->nexthdr == 17)
+            {
+                reinterpret_cast<udphdr*>(ip6+1)->len = ip6->payload_len;
+            }
+            return;
+        }
         ip->tot_len = rohc_htons(static_cast<uint16_t>(e-b));
         if (ip->protocol == 17)
         {
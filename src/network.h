@@ -3,10 +3,114 @@
 #include <stdint.h>
 #include <rohc/rohc.h>
 #include <vector>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace ROHC {
-    
-    struct iphdr
+
+    /**
+     * Host byte order, from the compiler. Define ROHC_BIG_ENDIAN to 0 or 1
+     * to override it for a compiler that does not tell.
+     */
+#ifndef ROHC_BIG_ENDIAN
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define ROHC_BIG_ENDIAN 1
+#else
+#define ROHC_BIG_ENDIAN 0
+#endif
+#endif
+
+#if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 8)))
+#define ROHC_HAVE_BSWAP 1
+#endif
+
+    inline uint16_t rohc_bswap16(uint16_t v)
+    {
+#ifdef ROHC_HAVE_BSWAP
+        return __builtin_bswap16(v);
+#else
+        return static_cast<uint16_t>((v << 8) | (v >> 8));
+#endif
+    }
+
+    inline uint32_t rohc_bswap32(uint32_t v)
+    {
+#ifdef ROHC_HAVE_BSWAP
+        return __builtin_bswap32(v);
+#else
+        return (v << 24) | ((v << 8) & 0xff0000) | ((v >> 8) & 0xff00) | (v >> 24);
+#endif
+    }
+
+    /**
+     * The conversions between a byte order and the network (big endian) or
+     * little endian order, and the header layouts below, for a host of
+     * either byte order. The library uses the host instantiation; a test
+     * can instantiate the other one.
+     */
+    template<bool BigEndian>
+    struct ByteOrder
+    {
+        static uint16_t Network16(uint16_t v) {return BigEndian ? v : rohc_bswap16(v);}
+        static uint32_t Network32(uint32_t v) {return BigEndian ? v : rohc_bswap32(v);}
+        static uint16_t Little16(uint16_t v) {return BigEndian ? rohc_bswap16(v) : v;}
+    };
+
+    typedef ByteOrder<ROHC_BIG_ENDIAN != 0> HostByteOrder;
+
+    /**
+     * Network <-> host byte order, the same conversion both ways
+     */
+    inline uint16_t rohc_htons(uint16_t v) {return HostByteOrder::Network16(v);}
+
+    inline uint32_t rohc_htonl(uint32_t v) {return HostByteOrder::Network32(v);}
+
+    /**
+     * Little endian <-> host byte order, for the IP-ID of
+     * IP_ID_BEHAVIOUR_SEQUENTIAL_SWAPPED
+     */
+    inline uint16_t rohc_htoles(uint16_t v) {return HostByteOrder::Little16(v);}
+
+    /**
+     * The headers with bit fields are declared for both byte orders, as
+     * the compilers allocate bit fields from the most significant bit on
+     * big endian hosts and from the least significant one on little
+     * endian hosts. iphdr, ipv6hdr, rtphdr and tcphdr are the host layouts.
+     */
+    template<bool BigEndian> struct basic_iphdr;
+    template<bool BigEndian> struct basic_ipv6hdr;
+    template<bool BigEndian> struct basic_rtphdr;
+    template<bool BigEndian> struct basic_tcphdr;
+
+    typedef basic_iphdr<ROHC_BIG_ENDIAN != 0> iphdr;
+    typedef basic_ipv6hdr<ROHC_BIG_ENDIAN != 0> ipv6hdr;
+    typedef basic_rtphdr<ROHC_BIG_ENDIAN != 0> rtphdr;
+    typedef basic_tcphdr<ROHC_BIG_ENDIAN != 0> tcphdr;
+
+    template<>
+    struct basic_iphdr<true>
+    {
+        uint8_t version:4,
+                ihl:4
+                ;
+        uint8_t tos;
+        uint16_t tot_len;
+        uint16_t id;
+        uint16_t frag_off;
+        uint8_t ttl;
+        uint8_t protocol;
+        uint16_t check;
+        uint32_t saddr;
+        uint32_t daddr;
+    };
+
+    template<>
+    struct basic_iphdr<false>
     {
         uint8_t ihl:4,
                 version:4
@@ -21,32 +125,111 @@ namespace ROHC {
         uint32_t saddr;
         uint32_t daddr;
     };
+
+    // frag_off flags, host order
+    const uint16_t IP_DONT_FRAGMENT = 0x4000;
+    const uint16_t IP_MORE_FRAGMENTS = 0x2000;
+    const uint16_t IP_FRAGMENT_OFFSET = 0x1fff;
     
     inline bool HasDontFragment(const iphdr* ip) {
-        // TODO: Little/big endian fix
-        return (ip->frag_off & 0x0040) != 0;
+        return (ip->frag_off & rohc_htons(IP_DONT_FRAGMENT)) != 0;
     }
     
     inline void SetDontFragment(iphdr* ip) {
-        // TODO: Little/big endian fix
-        ip->frag_off |= 0x0040;
+        ip->frag_off |= rohc_htons(IP_DONT_FRAGMENT);
     }
     
     inline void ClearDontFragment(iphdr* ip) {
-        // TODO: Little/big endian fix
-        ip->frag_off &= 0xffbf;
+        ip->frag_off &= rohc_htons(static_cast<uint16_t>(~IP_DONT_FRAGMENT));
     }
 
     inline bool HasMoreFragments(iphdr const* ip) {
-        // TODO: Little/big endian fix
-        return (ip->frag_off & 0x0020) != 0;
+        return (ip->frag_off & rohc_htons(IP_MORE_FRAGMENTS)) != 0;
     }   
 
     inline bool HasFragmentOffset(iphdr const* ip) {
-        // TODO: Little/big endian fix
-        return (ip->frag_off & 0xff1f) != 0;
+        return (ip->frag_off & rohc_htons(IP_FRAGMENT_OFFSET)) != 0;
     }   
 
+    template<>
+    struct basic_ipv6hdr<true>
+    {
+        uint8_t version:4,
+                priority:4
+                ;
+        uint8_t flow_lbl[3];
+        uint16_t payload_len;
+        uint8_t nexthdr;
+        uint8_t hop_limit;
+        uint8_t saddr[16];
+        uint8_t daddr[16];
+    };
+
+    template<>
+    struct basic_ipv6hdr<false>
+    {
+        uint8_t priority:4,
+                version:4
+                ;
+        uint8_t flow_lbl[3];
+        uint16_t payload_len;
+        uint8_t nexthdr;
+        uint8_t hop_limit;
+        uint8_t saddr[16];
+        uint8_t daddr[16];
+    };
+
+    inline uint8_t TrafficClass(const ipv6hdr* ip) {
+        return static_cast<uint8_t>((ip->priority << 4) | (ip->flow_lbl[0] >> 4));
+    }
+
+    inline void SetTrafficClass(ipv6hdr* ip, uint8_t tc) {
+        ip->priority = tc >> 4;
+        ip->flow_lbl[0] = static_cast<uint8_t>((ip->flow_lbl[0] & 0x0f) | (tc << 4));
+    }
+
+    // 20 bits, host order
+    inline uint32_t FlowLabel(const ipv6hdr* ip) {
+        return (static_cast<uint32_t>(ip->flow_lbl[0] & 0x0f) << 16) | (ip->flow_lbl[1] << 8) | ip->flow_lbl[2];
+    }
+
+    inline void SetFlowLabel(ipv6hdr* ip, uint32_t flowLabel) {
+        ip->flow_lbl[0] = static_cast<uint8_t>((ip->flow_lbl[0] & 0xf0) | ((flowLabel >> 16) & 0x0f));
+        ip->flow_lbl[1] = static_cast<uint8_t>(flowLabel >> 8);
+        ip->flow_lbl[2] = static_cast<uint8_t>(flowLabel);
+    }
+
+    /**
+     * ip points at an IPv4 or an IPv6 header, the version is in the same
+     * place in both. TosTc and TtlHopl are the tos_tc and ttl_hopl fields
+     * of RFC 5225 for either version. IPv6 extension headers are not
+     * supported, the next header follows the fixed header.
+     */
+    inline bool IsIPv6(const iphdr* ip) {return 6 == ip->version;}
+
+    inline const ipv6hdr* AsIPv6(const iphdr* ip) {return reinterpret_cast<const ipv6hdr*>(ip);}
+
+    inline size_t IPHeaderSize(const iphdr* ip) {
+        return IsIPv6(ip) ? sizeof(ipv6hdr) : sizeof(iphdr);
+    }
+
+    inline uint8_t IPProtocol(const iphdr* ip) {
+        return IsIPv6(ip) ? AsIPv6(ip)->nexthdr : ip->protocol;
+    }
+
+    inline uint8_t TosTc(const iphdr* ip) {
+        return IsIPv6(ip) ? TrafficClass(AsIPv6(ip)) : ip->tos;
+    }
+
+    inline uint8_t TtlHopl(const iphdr* ip) {
+        return IsIPv6(ip) ? AsIPv6(ip)->hop_limit : ip->ttl;
+    }
+
+    template<class T>
+    inline const T* NextHeader(const iphdr* ip) {
+        return reinterpret_cast<const T*>(reinterpret_cast<const uint8_t*>(ip) + IPHeaderSize(ip));
+    }
+
     struct udphdr
     {
         uint16_t source;
@@ -55,8 +238,30 @@ namespace ROHC {
         uint16_t check;
         static uint8_t ipproto() {return 17;}
     };
+
+    struct esphdr
+    {
+        uint32_t spi;
+        uint32_t seq_no;
+        static uint8_t ipproto() {return 50;}
+    };
     
-    struct rtphdr
+    template<>
+    struct basic_rtphdr<true>
+    {
+        uint8_t version:2,
+        padding:1,
+        extension:1,
+        csrc_count:4;
+        uint8_t marker:1,
+            payload_type: 7;
+        uint16_t sequence_number;
+        uint32_t timestamp;
+        uint32_t ssrc;
+    };
+
+    template<>
+    struct basic_rtphdr<false>
     {
         uint8_t csrc_count:4,
         extension:1,
@@ -69,7 +274,9 @@ namespace ROHC {
         uint32_t ssrc;
     };
     
-    struct tcphdr {
+    template<>
+    struct basic_tcphdr<true>
+    {
         uint16_t source;
         uint16_t dest;
         uint32_t sequenceNumber;
@@ -89,26 +296,179 @@ namespace ROHC {
         uint16_t check;
         uint16_t urgPtr;
     };
+
+    template<>
+    struct basic_tcphdr<false>
+    {
+        uint16_t source;
+        uint16_t dest;
+        uint32_t sequenceNumber;
+        uint32_t ackNumber;
+        uint8_t NS:1,
+                reserved:3,
+                dataOffset:4;
+        uint8_t FIN:1,
+                SYN:1,
+                RST:1,
+                PSH:1,
+                ACK:1,
+                URG:1,
+                ECE:1,
+                CWR:1;
+        uint16_t windowSize;
+        uint16_t check;
+        uint16_t urgPtr;
+    };
     
     
+    /**
+     * Header CRC over the uncompressed header, RFC 5225 5.3.2: all the
+     * octets of the headers in wire order, lengths and checksums included.
+     *
+     * The addresses, followed by the ports or the SPI, are the same for
+     * the whole context. As the CRC is affine (see CRC3Shift), the CRC of
+     * that block from a zero register is computed once by SetStatic and
+     * each packet only runs the CRC over the octets around it.
+     *
+     * transportStatic is the size of the static start of the header that
+     * follows ip, 4 for the ports or the SPI and 0 for the IP-only profile.
+     * headerSize counts all the headers from ip on, including the TCP
+     * options.
+     */
+    class HeaderCRC
+    {
+    public:
+        HeaderCRC() : static_begin(0), static_size(0), static_crc3(0), static_crc7(0) {}
+
+        void SetStatic(const iphdr* ip, size_t transportStatic);
+        void Calculate(const iphdr* ip, size_t headerSize, uint8_t& crc3, uint8_t& crc7) const;
+        uint8_t CRC3(const iphdr* ip, size_t headerSize) const;
+        uint8_t CRC7(const iphdr* ip, size_t headerSize) const;
+
+    private:
+        // The static block, offset and size from ip
+        size_t static_begin;
+        size_t static_size;
+        uint8_t static_crc3;
+        uint8_t static_crc7;
+    };
+
+    /**
+     * Size of the header block the compressor compares between packets,
+     * the ip and udp headers and the first word of rtp
+     */
+    const size_t headerBlockSize = 32;
+
+    /**
+     * The bits that differ between two header blocks, computed with one
+     * XOR (one AVX2 or two SSE2 registers). Any tests a mask of the fields
+     * of interest, headerBlockSize bytes in wire layout, so a packet where
+     * none of them changed is found without comparing field by field.
+     */
+    class HeaderChange
+    {
+    public:
+        HeaderChange(const uint8_t* previous, const uint8_t* current)
+        {
+#if defined(__AVX2__)
+            diff = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(previous)),
+                                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(current)));
+#elif defined(__SSE2__)
+            lo = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(previous)),
+                               _mm_loadu_si128(reinterpret_cast<const __m128i*>(current)));
+            hi = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(previous + 16)),
+                               _mm_loadu_si128(reinterpret_cast<const __m128i*>(current + 16)));
+#else
+            for (size_t i = 0; i < 4; ++i)
+            {
+                uint64_t a, b;
+                memcpy(&a, previous + 8 * i, 8);
+                memcpy(&b, current + 8 * i, 8);
+                diff[i] = a ^ b;
+            }
+#endif
+        }
+
+        bool Any(const uint8_t* fields) const
+        {
+#if defined(__AVX2__)
+            return !_mm256_testz_si256(diff, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(fields)));
+#elif defined(__SSE2__)
+            __m128i m = _mm_or_si128(_mm_and_si128(lo, _mm_loadu_si128(reinterpret_cast<const __m128i*>(fields))),
+                                     _mm_and_si128(hi, _mm_loadu_si128(reinterpret_cast<const __m128i*>(fields + 16))));
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(m, _mm_setzero_si128())) != 0xffff;
+#else
+            uint64_t any = 0;
+            for (size_t i = 0; i < 4; ++i)
+            {
+                uint64_t f;
+                memcpy(&f, fields + 8 * i, 8);
+                any |= diff[i] & f;
+            }
+            return any != 0;
+#endif
+        }
+
+    private:
+#if defined(__AVX2__)
+        __m256i diff;
+#elif defined(__SSE2__)
+        __m128i lo;
+        __m128i hi;
+#else
+        uint64_t diff[4];
+#endif
+    };
+
     void setLengthsAndIPChecksum(data_iterator b, data_iterator e);
     void calculateIpHeaderCheckSum(iphdr* iph);
     void calculateUdpHeaderCheckSum(iphdr* ip);    
-    
-    void PrintHeaders(std::vector<uint8_t>::const_iterator ip);
-    void PrintIPHeader(std::vector<uint8_t>::const_iterator ip);
-    void PrintIPHeader(const iphdr* ip);
-    void PrintUDPHeader(const udphdr* udp);
 
-    inline uint16_t rohc_htons(uint16_t v) 
+    /**
+     * Updates the checksum of ip from the header previous, when they only
+     * differ in tot_len, id and ttl this is a few adds (RFC 1624), otherwise
+     * the checksum is calculated from scratch.
+     */
+    void updateIpHeaderCheckSum(iphdr* ip, const iphdr* previous);
+
+    /**
+     * One's complement sum (RFC 1071) of data as 16 bit words in host order,
+     * added to sum and folded to 16 bits but not complemented. Large buffers
+     * use SSE2/AVX2 when the CPU has it.
+     */
+    uint32_t OnesComplementSum(const uint8_t* data, size_t size, uint32_t sum = 0);
+
+    /**
+     * The kernels behind OnesComplementSum, for the tests. They return the
+     * sum before folding, sse2 and avx2 are null when they are not built
+     * or the CPU does not have them.
+     */
+    struct OnesComplementSumKernels
     {
-        return static_cast<uint16_t>((v << 8) | (v >> 8));
-    }
+        uint64_t (*scalar)(const uint8_t* data, size_t size);
+        uint64_t (*sse2)(const uint8_t* data, size_t size);
+        uint64_t (*avx2)(const uint8_t* data, size_t size);
+    };
+
+    OnesComplementSumKernels GetOnesComplementSumKernels();
 
-    inline uint32_t rohc_htonl(uint32_t v)
+    /**
+     * RFC 1624 eqn. 3, the checksum hc after a 16 bit word it covers
+     * changes from m to m_new: HC' = ~(~HC + ~m + m')
+     */
+    inline uint16_t UpdateChecksum(uint16_t hc, uint16_t m, uint16_t m_new)
     {
-        uint8_t* p = reinterpret_cast<uint8_t*>(&v);
-        return (p[0] << 24) + (p[1] << 16) + (p[2] << 8) + p[3];
+        uint32_t sum = static_cast<uint16_t>(~hc);
+        sum += static_cast<uint16_t>(~m);
+        sum += m_new;
+        sum = (sum & 0xffff) + (sum >> 16);
+        sum = (sum & 0xffff) + (sum >> 16);
+        return static_cast<uint16_t>(~sum);
     }
     
+    void PrintHeaders(std::vector<uint8_t>::const_iterator ip);
+    void PrintIPHeader(std::vector<uint8_t>::const_iterator ip);
+    void PrintIPHeader(const iphdr* ip);
+    void PrintUDPHeader(const udphdr* udp);
+
 } // ns ROHC
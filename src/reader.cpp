@@ -0,0 +1,64 @@
+#include "reader.h"
+
+namespace ROHC
+{
+    const char*
+    ParseResultString(ParseResult_t result)
+    {
+        switch (result)
+        {
+            case PARSE_OK:
+                return "ok";
+            case PARSE_TRUNCATED:
+                return "not enough data";
+            case PARSE_BAD_SDVL:
+                return "invalid SDVL value";
+            case PARSE_BAD_FIELD:
+                return "invalid field";
+            case PARSE_CONTROL_CRC:
+                return "control crc3 failure";
+            case PARSE_NO_TS_STRIDE:
+                return "inferred timestamp without ts_stride";
+            case PARSE_UNKNOWN_TYPE:
+                return "unknown base header type";
+        }
+        return "unknown error";
+    }
+
+    ParseResult_t
+    ByteReader::ReadLongSDVL(uint32_t& value)
+    {
+        if (!Has(1))
+            return PARSE_TRUNCATED;
+
+        uint8_t first = *pos;
+        if (!(first & 0x80))
+        {
+            value = first;
+            pos += 1;
+            return PARSE_OK;
+        }
+        if ((first & 0xc0) == 0x80)
+        {
+            if (!Has(2))
+                return PARSE_TRUNCATED;
+            value = ((first & 0x3f) << 8) | pos[1];
+            pos += 2;
+            return PARSE_OK;
+        }
+        if ((first & 0xe0) == 0xc0)
+        {
+            if (!Has(3))
+                return PARSE_TRUNCATED;
+            value = ((first & 0x1f) << 16) | (pos[1] << 8) | pos[2];
+            pos += 3;
+            return PARSE_OK;
+        }
+        // 111xxxxx, four bytes
+        if (!Has(4))
+            return PARSE_TRUNCATED;
+        value = (static_cast<uint32_t>(first & 0x1f) << 24) | (pos[1] << 16) | (pos[2] << 8) | pos[3];
+        pos += 4;
+        return PARSE_OK;
+    }
+} // ns ROHC
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <rohc/rohc.h>
+#include <cstring>
+
+namespace ROHC
+{
+    /**
+     * Why a compressed header could not be parsed. The CO parsers return
+     * these instead of logging, ParseCO logs once per packet.
+     */
+    enum ParseResult_t
+    {
+        PARSE_OK = 0,
+        PARSE_TRUNCATED,        // fewer bytes than the format needs
+        PARSE_BAD_SDVL,         // reserved SDVL prefix
+        PARSE_BAD_FIELD,        // a value the format or context does not allow
+        PARSE_CONTROL_CRC,      // control_crc3 mismatch
+        PARSE_NO_TS_STRIDE,     // inferred timestamp without a ts_stride
+        PARSE_UNKNOWN_TYPE      // no base header with this discriminator
+    };
+
+    const char* ParseResultString(ParseResult_t result);
+
+    /**
+     * Cursor over a compressed header.
+     *
+     * A format checks Has() once for its fixed part and then reads it with
+     * the unchecked accessors, only the optional fields use the checked
+     * Read functions.
+     */
+    class ByteReader
+    {
+    public:
+        ByteReader(const uint8_t* begin, const uint8_t* end) : pos(begin), end(end) {}
+
+        size_t Remaining() const {return static_cast<size_t>(end - pos);}
+        bool Has(size_t size) const {return size <= Remaining();}
+        const uint8_t* Position() const {return pos;}
+
+        // Unchecked, Has() must have been called
+        uint8_t Peek() const {return *pos;}
+        uint8_t U8() {return *pos++;}
+        uint16_t U16()
+        {
+            uint16_t value = static_cast<uint16_t>((pos[0] << 8) | pos[1]);
+            pos += 2;
+            return value;
+        }
+        uint32_t U32()
+        {
+            uint32_t value = (static_cast<uint32_t>(pos[0]) << 24) | (pos[1] << 16) | (pos[2] << 8) | pos[3];
+            pos += 4;
+            return value;
+        }
+        // Fields kept in network byte order are copied as they are
+        template<class T>
+        void Raw(T& value)
+        {
+            memcpy(&value, pos, sizeof(T));
+            pos += sizeof(T);
+        }
+        void Skip(size_t size) {pos += size;}
+
+        // Checked
+        bool ReadU8(uint8_t& value)
+        {
+            if (!Has(1))
+                return false;
+            value = U8();
+            return true;
+        }
+        template<class T>
+        bool ReadRaw(T& value)
+        {
+            if (!Has(sizeof(T)))
+                return false;
+            Raw(value);
+            return true;
+        }
+
+        /**
+         * RFC 4995 5.3.2, the one and two byte forms are decoded inline
+         */
+        ParseResult_t ReadSDVL(uint32_t& value)
+        {
+            if (Has(1) && !(pos[0] & 0x80))
+            {
+                value = *pos++;
+                return PARSE_OK;
+            }
+            if (Has(2) && (pos[0] & 0xc0) == 0x80)
+            {
+                value = ((pos[0] & 0x3f) << 8) | pos[1];
+                pos += 2;
+                return PARSE_OK;
+            }
+            return ReadLongSDVL(value);
+        }
+
+    private:
+        ParseResult_t ReadLongSDVL(uint32_t& value);
+
+        const uint8_t* pos;
+        const uint8_t* end;
+    };
+} // ns ROHC
@@ -0,0 +1,109 @@
+#include "tcp_profile_supp.h"
+
+namespace ROHC {
+
+    void
+    TCPOptionContext::Clear()
+    {
+        for (unsigned int i = 0; i < tcpOptionTableSize; ++i)
+            table[i].size = 0;
+        listSize = 0;
+    }
+
+    size_t
+    TCPOptionContext::Options(uint8_t* options) const
+    {
+        size_t size = 0;
+        for (unsigned int i = 0; i < listSize; ++i)
+        {
+            const TCPOptionItem& item = table[list[i]];
+            if (size + item.size > maxTCPOptionsSize)
+                break;
+            memcpy(options + size, item.data, item.size);
+            size += item.size;
+        }
+        return size;
+    }
+
+    bool
+    SplitTCPOptions(const uint8_t* options, size_t size, TCPOptionItem* items, unsigned int& count)
+    {
+        count = 0;
+        size_t pos = 0;
+        while (pos < size)
+        {
+            if (count == maxTCPOptionListSize)
+                return false;
+
+            uint8_t kind = options[pos];
+            size_t length;
+            if (TCPOptions::EndOfOptionList == kind)
+            {
+                for (size_t i = pos + 1; i < size; ++i)
+                {
+                    if (options[i])
+                        return false;
+                }
+                length = size - pos;
+            }
+            else if (TCPOptions::NOP == kind)
+            {
+                length = 1;
+            }
+            else
+            {
+                if (pos + 2 > size)
+                    return false;
+                length = options[pos + 1];
+                if ((length < 2) || (pos + length > size))
+                    return false;
+
+                switch (kind)
+                {
+                    case TCPOptions::MaximumSegmentSize:
+                        if (4 != length)
+                            return false;
+                        break;
+                    case TCPOptions::WSOPT_WindowScale:
+                        if (3 != length)
+                            return false;
+                        break;
+                    case TCPOptions::SACK_permitted:
+                        if (2 != length)
+                            return false;
+                        break;
+                    case TCPOptions::TSOPT:
+                        if (10 != length)
+                            return false;
+                        break;
+                    case TCPOptions::SACK:
+                        if ((length < 10) || ((length - 2) % 8))
+                            return false;
+                        break;
+                }
+            }
+
+            TCPOptionItem& item = items[count++];
+            item.size = static_cast<uint8_t>(length);
+            memcpy(item.data, options + pos, length);
+            pos += length;
+        }
+        return true;
+    }
+
+    unsigned int
+    ReservedTableIndex(uint8_t kind)
+    {
+        switch (kind)
+        {
+            case TCPOptions::NOP: return ReservedTableIndexs::OPT_NOP;
+            case TCPOptions::EndOfOptionList: return ReservedTableIndexs::OPT_EOL;
+            case TCPOptions::MaximumSegmentSize: return ReservedTableIndexs::OPT_MSS;
+            case TCPOptions::WSOPT_WindowScale: return ReservedTableIndexs::OPT_WINDOW_SCALE;
+            case TCPOptions::TSOPT: return ReservedTableIndexs::OPT_TIMESTAMP;
+            case TCPOptions::SACK_permitted: return ReservedTableIndexs::OPT_SACK_PERMITTED;
+            case TCPOptions::SACK: return ReservedTableIndexs::OPT_SACK;
+            default: return tcpOptionTableSize;
+        }
+    }
+}
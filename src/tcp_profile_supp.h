@@ -1,7 +1,10 @@
 #pragma once
 
+#include <rohc/rohc.h>
+#include <cstring>
+
 namespace ROHC {
-    
+
     // RFC 4996, 6.3.4
     namespace ReservedTableIndexs {
         enum _ReservedTableIndex {
@@ -14,7 +17,7 @@ namespace ROHC {
             OPT_SACK = 6                // SACK
         };
     }
-    
+
     namespace TCPOptions {
         enum TCPOption {
             EndOfOptionList                     = 0,
@@ -26,7 +29,69 @@ namespace ROHC {
             Echo                                = 6,
             EchoReply                           = 7,
             TSOPT                               = 8
-            
+
         };
     }
-}
\ No newline at end of file
+
+    // The option area of a TCP header, dataOffset is 4 bits
+    const size_t maxTCPOptionsSize = 40;
+    // m of the compressed list is 4 bits
+    const unsigned int maxTCPOptionListSize = 15;
+    // The XI index is at most 4 bits
+    const unsigned int tcpOptionTableSize = 16;
+    // Table indexes after the reserved ones are for the other options
+    const unsigned int firstGenericTableIndex = 7;
+
+    /**
+     * An option as it is in the header, kind and length included. The
+     * EOL option takes the padding after it.
+     */
+    struct TCPOptionItem
+    {
+        uint8_t size; // 0 for an unused table entry
+        uint8_t data[maxTCPOptionsSize];
+
+        uint8_t Kind() const {return data[0];}
+    };
+
+    inline bool operator==(const TCPOptionItem& a, const TCPOptionItem& b) {
+        return (a.size == b.size) && !memcmp(a.data, b.data, a.size);
+    }
+    inline bool operator!=(const TCPOptionItem& a, const TCPOptionItem& b) {
+        return !(a == b);
+    }
+
+    /**
+     * The item table and the list of the last packet, RFC 6846 6.3.3.
+     * A plain struct, it is part of global_control and Clear() sets it
+     * up.
+     */
+    struct TCPOptionContext
+    {
+        TCPOptionItem table[tcpOptionTableSize];
+        uint8_t list[maxTCPOptionListSize];
+        unsigned int listSize;
+
+        void Clear();
+
+        /**
+         * Writes the options of the list to options, which has room for
+         * maxTCPOptionsSize, and returns their size
+         */
+        size_t Options(uint8_t* options) const;
+    };
+
+    /**
+     * Splits an option area into items. Returns false when the options
+     * cannot be compressed: a length that does not fit the area or the
+     * kind, padding after EOL that is not zero, or more than
+     * maxTCPOptionListSize options.
+     */
+    bool SplitTCPOptions(const uint8_t* options, size_t size, TCPOptionItem* items, unsigned int& count);
+
+    /**
+     * The reserved table index of kind, tcpOptionTableSize for the
+     * options that use the generic indexes
+     */
+    unsigned int ReservedTableIndex(uint8_t kind);
+}
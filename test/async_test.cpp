@@ -0,0 +1,65 @@
+#include <rohc/async.h>
+#include <stdio.h>
+#include "test_packets.h"
+
+using namespace ROHC;
+
+namespace {
+    struct Echo
+    {
+        AsyncChannel* channel;
+        size_t decompressed;
+        size_t compressed;
+    };
+
+    void Compressed(void* user, CompletionStatus, const uint8_t*, size_t)
+    {
+        ++static_cast<Echo*>(user)->compressed;
+    }
+
+    // Sends each received packet back out from its callback
+    void Decompressed(void* user, CompletionStatus status, const uint8_t* data, size_t size)
+    {
+        Echo* echo = static_cast<Echo*>(user);
+        ++echo->decompressed;
+        if (COMPLETION_OK == status) {
+            echo->channel->SubmitCompress(data, size, Compressed, echo);
+        }
+    }
+}
+
+/**
+ * Packets submitted from the callbacks of a Process call are only
+ * handled by the next one, a compress request from a decompress callback
+ * included
+ */
+int main()
+{
+    AsyncChannel sender(15, REORDERING_NONE, IP_ID_BEHAVIOUR_SEQUENTIAL);
+    AsyncChannel channel(15, REORDERING_NONE, IP_ID_BEHAVIOUR_SEQUENTIAL);
+    Echo echo = {&channel, 0, 0};
+
+    const size_t count = 4;
+    for (uint32_t sn = 1; sn <= count; ++sn) {
+        data_t packet = ESPPacket(static_cast<uint16_t>(sn), sn);
+        data_t compressed;
+        sender.GetCompressor().compress(packet, compressed);
+        channel.SubmitDecompress(&compressed[0], compressed.size(), Decompressed, &echo);
+    }
+
+    size_t completed = channel.Process();
+    if ((count != completed) || (count != echo.decompressed) || echo.compressed || (count != channel.Pending())) {
+        printf("first Process: %u completed, %u compressed, %u pending\n",
+               static_cast<unsigned int>(completed), static_cast<unsigned int>(echo.compressed),
+               static_cast<unsigned int>(channel.Pending()));
+        return 1;
+    }
+
+    completed = channel.Process();
+    if ((count != completed) || (count != echo.compressed) || channel.Pending()) {
+        printf("second Process: %u completed, %u compressed\n",
+               static_cast<unsigned int>(completed), static_cast<unsigned int>(echo.compressed));
+        return 1;
+    }
+    return 0;
+}
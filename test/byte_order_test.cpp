@@ -0,0 +1,125 @@
+#include <rohc/rohc.h>
+#include "network.h"
+#include <stdio.h>
+#include <string.h>
+
+using namespace ROHC;
+
+namespace {
+    // IPv4 and TCP headers on the wire: version 4, ihl 5, data offset 5
+    // with NS, CWR, ECE and SYN set
+    const uint8_t wire[] = {
+        0x45, 0x00, 0x00, 0x3c, 0x1c, 0x46, 0x40, 0x00,
+        0x40, 0x06, 0xb1, 0xe6, 0xc0, 0xa8, 0x00, 0x68,
+        0xc0, 0xa8, 0x00, 0x01,
+        0xd4, 0x31, 0x00, 0x50, 0x12, 0x34, 0x56, 0x78,
+        0x9a, 0xbc, 0xde, 0xf0, 0x51, 0xc2, 0x72, 0x10,
+        0xab, 0xcd, 0x01, 0x02,
+    };
+
+    const bool hostBigEndian = ROHC_BIG_ENDIAN != 0;
+
+    struct Field
+    {
+        size_t offset;
+        size_t size;
+    };
+
+    // The multi-octet fields, and the bit fields of an octet from the
+    // most significant bit on, as in the headers of network.h
+    const Field words[] = {
+        {2, 2}, {4, 2}, {6, 2}, {10, 2}, {12, 4}, {16, 4},
+        {20, 2}, {22, 2}, {24, 4}, {28, 4}, {34, 2}, {36, 2}, {38, 2},
+    };
+    const unsigned int ipBits[] = {4, 4};
+    const unsigned int tcpOffsetBits[] = {4, 3, 1};
+    const unsigned int tcpFlagBits[] = {1, 1, 1, 1, 1, 1, 1, 1};
+
+    uint8_t MirrorFields(uint8_t octet, const unsigned int* widths, size_t count)
+    {
+        uint8_t mirrored = 0;
+        unsigned int shift = 8;
+        for (size_t i = 0; i < count; ++i) {
+            shift -= widths[i];
+            unsigned int value = (octet >> shift) & ((1u << widths[i]) - 1);
+            mirrored = static_cast<uint8_t>(mirrored | (value << (8 - shift - widths[i])));
+        }
+        return mirrored;
+    }
+
+    /**
+     * The memory of the headers as read by a host of the given byte
+     * order, seen from this host: the other byte order reads the
+     * multi-octet fields reversed and allocates the bit fields from the
+     * other end of the octet.
+     */
+    template<bool BigEndian>
+    void HostImage(uint8_t* image)
+    {
+        memcpy(image, wire, sizeof(wire));
+        if (BigEndian == hostBigEndian)
+            return;
+        for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); ++i) {
+            for (size_t j = 0; j < words[i].size; ++j) {
+                image[words[i].offset + j] = wire[words[i].offset + words[i].size - 1 - j];
+            }
+        }
+        image[0] = MirrorFields(wire[0], ipBits, 2);
+        image[32] = MirrorFields(wire[32], tcpOffsetBits, 3);
+        image[33] = MirrorFields(wire[33], tcpFlagBits, 8);
+    }
+
+    template<bool BigEndian>
+    bool Check(const char* name)
+    {
+        typedef ByteOrder<BigEndian> Order;
+        uint8_t image[sizeof(wire)];
+        HostImage<BigEndian>(image);
+        const basic_iphdr<BigEndian>* ip = reinterpret_cast<const basic_iphdr<BigEndian>*>(image);
+        const basic_tcphdr<BigEndian>* tcp = reinterpret_cast<const basic_tcphdr<BigEndian>*>(image + 20);
+
+        bool ok = (4 == ip->version) && (5 == ip->ihl) &&
+            (0x003c == Order::Network16(ip->tot_len)) &&
+            (0x1c46 == Order::Network16(ip->id)) &&
+            (0x461c == Order::Little16(ip->id)) &&
+            (0x4000 == Order::Network16(ip->frag_off)) &&
+            (6 == ip->protocol) &&
+            (0xc0a80068 == Order::Network32(ip->saddr)) &&
+            (0xd431 == Order::Network16(tcp->source)) &&
+            (0x12345678 == Order::Network32(tcp->sequenceNumber)) &&
+            (0x9abcdef0 == Order::Network32(tcp->ackNumber)) &&
+            (5 == tcp->dataOffset) && (0 == tcp->reserved) && (1 == tcp->NS) &&
+            (1 == tcp->CWR) && (1 == tcp->ECE) && (0 == tcp->URG) && (0 == tcp->ACK) &&
+            (0 == tcp->PSH) && (0 == tcp->RST) && (1 == tcp->SYN) && (0 == tcp->FIN) &&
+            (0x7210 == Order::Network16(tcp->windowSize)) &&
+            (0x0102 == Order::Network16(tcp->urgPtr));
+        if (!ok) {
+            printf("%s: header fields differ from the wire\n", name);
+        }
+        return ok;
+    }
+
+    bool CheckHost()
+    {
+        const iphdr* ip = reinterpret_cast<const iphdr*>(wire);
+        const tcphdr* tcp = reinterpret_cast<const tcphdr*>(wire + 20);
+        bool ok = (IPHeaderSize(ip) == 20) && (IPProtocol(ip) == 6) &&
+            (rohc_htons(ip->tot_len) == 0x003c) && HasDontFragment(ip) &&
+            (rohc_htonl(ip->daddr) == 0xc0a80001) &&
+            (rohc_htons(tcp->dest) == 80) && (rohc_htonl(tcp->sequenceNumber) == 0x12345678) &&
+            (rohc_htons(rohc_htons(0x1234)) == 0x1234) &&
+            (rohc_htonl(rohc_htonl(0x12345678)) == 0x12345678);
+        if (!ok) {
+            printf("host: header fields differ from the wire\n");
+        }
+        return ok;
+    }
+}
+
+int main()
+{
+    bool ok = Check<false>("little endian");
+    ok = Check<true>("big endian") && ok;
+    ok = CheckHost() && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,74 @@
+#include <rohc/rohc.h>
+#include "network.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace ROHC;
+
+namespace {
+    typedef uint64_t (*sumKernel_t)(const uint8_t* data, size_t size);
+
+    uint32_t Fold(uint64_t sum)
+    {
+        while (sum >> 16) {
+            sum = (sum & 0xffff) + (sum >> 16);
+        }
+        return static_cast<uint32_t>(sum);
+    }
+
+    bool Compare(const char* name, sumKernel_t kernel, sumKernel_t reference, const uint8_t* data, size_t size)
+    {
+        if (!kernel)
+            return true;
+        uint32_t sum = Fold(kernel(data, size));
+        uint32_t expected = Fold(reference(data, size));
+        if (sum != expected) {
+            printf("%s: %u octets at offset %u, sum 0x%04x instead of 0x%04x\n", name,
+                   static_cast<unsigned int>(size), static_cast<unsigned int>(reinterpret_cast<size_t>(data) & 31),
+                   sum, expected);
+            return false;
+        }
+        return true;
+    }
+
+    bool CompareAll(const OnesComplementSumKernels& kernels, const uint8_t* data, size_t size)
+    {
+        bool ok = Compare("SSE2", kernels.sse2, kernels.scalar, data, size);
+        ok = Compare("AVX2", kernels.avx2, kernels.scalar, data, size) && ok;
+        ok = (OnesComplementSum(data, size) == Fold(kernels.scalar(data, size))) && ok;
+        return ok;
+    }
+}
+
+/**
+ * The SIMD sums against the scalar one, over random data of random
+ * lengths and alignments, and over long buffers of 0xff octets that fill
+ * the 32 bit lanes
+ */
+int main()
+{
+    OnesComplementSumKernels kernels = GetOnesComplementSumKernels();
+    bool ok = true;
+
+    data_t random(4096 + 32);
+    for (size_t i = 0; i < random.size(); ++i) {
+        random[i] = static_cast<uint8_t>(rand());
+    }
+    for (int n = 0; n < 2000; ++n) {
+        size_t offset = rand() % 32;
+        size_t size = rand() % (random.size() - offset);
+        ok = CompareAll(kernels, &random[offset], size) && ok;
+    }
+
+    const size_t sizes[] = {64, 1 << 20, 600000, 600001, 0x8000 * 32 + 31, 0x8000 * 64 + 17};
+    data_t ones(sizes[sizeof(sizes) / sizeof(sizes[0]) - 1] + 1, 0xff);
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        ok = CompareAll(kernels, &ones[0], sizes[i]) && ok;
+        ok = CompareAll(kernels, &ones[1], sizes[i]) && ok;
+        if (OnesComplementSum(&ones[0], sizes[i] & ~static_cast<size_t>(1)) != 0xffff) {
+            printf("%u octets of 0xff do not sum to 0xffff\n", static_cast<unsigned int>(sizes[i]));
+            ok = false;
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,89 @@
+#include <rohc/rohc.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace ROHC;
+
+namespace {
+    typedef uint8_t (*crcKernel_t)(uint8_t crc, const uint8_t* begin, const uint8_t* end);
+
+    /**
+     * RFC 5225 5.3.1 bit by bit, reflected polynomials without the x^w term
+     */
+    uint8_t Bytewise(uint8_t poly, uint8_t crc, const uint8_t* p, const uint8_t* end)
+    {
+        for (; p != end; ++p) {
+            crc ^= *p;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = static_cast<uint8_t>((crc & 1) ? ((crc >> 1) ^ poly) : (crc >> 1));
+            }
+        }
+        return crc;
+    }
+
+    bool Compare(const char* name, unsigned int width, crcKernel_t kernel, uint8_t poly,
+                 uint8_t crc, const uint8_t* begin, const uint8_t* end)
+    {
+        uint8_t expected = Bytewise(poly, crc, begin, end);
+        uint8_t result = kernel(crc, begin, end);
+        if (result != expected) {
+            printf("CRC%u %s: init 0x%x, %u octets, 0x%x instead of 0x%x\n", width, name, crc,
+                   static_cast<unsigned int>(end - begin), result, expected);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * The slice-by-8 and carry-less multiply kernels against the bit by
+     * bit CRC, for every register value and the lengths around the size
+     * where the carry-less multiply takes over, and at random alignments
+     */
+    bool Check(unsigned int width, uint8_t poly)
+    {
+        CRCKernels kernels = GetCRCKernels(width);
+        uint8_t data[256 + 16];
+        for (size_t i = 0; i < sizeof(data); ++i) {
+            data[i] = static_cast<uint8_t>(rand());
+        }
+
+        bool ok = true;
+        size_t threshold = kernels.clmulMinimumSize ? kernels.clmulMinimumSize : 64;
+        for (unsigned int crc = 0; crc < (1u << width); ++crc) {
+            uint8_t init = static_cast<uint8_t>(crc);
+            for (size_t size = 0; size <= threshold + 48; ++size) {
+                ok = Compare("slice", width, kernels.slice, poly, init, data, data + size) && ok;
+                if (kernels.clmul) {
+                    ok = Compare("clmul", width, kernels.clmul, poly, init, data, data + size) && ok;
+                }
+            }
+        }
+        for (int n = 0; n < 1000; ++n) {
+            size_t offset = rand() % 16;
+            size_t size = rand() % (sizeof(data) - offset);
+            uint8_t init = static_cast<uint8_t>(rand() & ((1u << width) - 1));
+            ok = Compare("slice", width, kernels.slice, poly, init, data + offset, data + offset + size) && ok;
+            if (kernels.clmul) {
+                ok = Compare("clmul", width, kernels.clmul, poly, init, data + offset, data + offset + size) && ok;
+            }
+        }
+        return ok;
+    }
+}
+
+int main()
+{
+    bool ok = Check(3, 0x6);
+    ok = Check(7, 0x79) && ok;
+    ok = Check(8, 0xe0) && ok;
+
+    // The public functions start from all ones
+    uint8_t data[100];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = static_cast<uint8_t>(i * 31);
+    }
+    ok = (CRC3(data, data + sizeof(data)) == Bytewise(0x6, 0x7, data, data + sizeof(data))) && ok;
+    ok = (CRC7(data, data + sizeof(data)) == Bytewise(0x79, 0x7f, data, data + sizeof(data))) && ok;
+    ok = (CRC8(data, data + sizeof(data)) == Bytewise(0xe0, 0xff, data, data + sizeof(data))) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,61 @@
+#include <rohc/compressor.h>
+#include <rohc/decomp.h>
+#include <stdio.h>
+#include "test_packets.h"
+
+using namespace ROHC;
+
+/**
+ * ESP flow whose decompressor sends ACKs back to the compressor, which
+ * has to stay on co_common and pt_0-2 once the context is established
+ */
+int main()
+{
+    Compressor compressor(15, REORDERING_NONE, IP_ID_BEHAVIOUR_SEQUENTIAL);
+    Decompressor decompressor(false, &compressor);
+
+    const size_t warmup = 100;
+    const size_t count = 2000;
+    CompressorStatistics atWarmup;
+    uint32_t sn = 1;
+    for (size_t i = 0; i < count; ++i) {
+        // Skip a few sequence numbers now and then
+        sn += ((i % 97) == 50) ? 3 : 1;
+        data_t packet = ESPPacket(static_cast<uint16_t>(100 + i), sn);
+
+        data_t compressed;
+        compressor.compress(packet, compressed);
+
+        data_t decompressed;
+        decompressor.Decompress(compressed, decompressed);
+        if (decompressed != packet) {
+            printf("packet %u was not restored\n", static_cast<unsigned int>(i));
+            return 1;
+        }
+
+        if (warmup == i) {
+            compressor.StatisticsSnapshot(atWarmup);
+        }
+    }
+
+    CompressorStatistics total;
+    compressor.StatisticsSnapshot(total);
+
+    size_t refreshes = 0;
+    for (int type = PT_IR; type <= PT_CO_REPAIR; ++type) {
+        refreshes += total.packetCount[type] - atWarmup.packetCount[type];
+    }
+    size_t compressed = 0;
+    for (int type = PT_CO_COMMON; type <= PT_2_SEQ_TS; ++type) {
+        compressed += total.packetCount[type] - atWarmup.packetCount[type];
+    }
+
+    if (refreshes || (compressed != count - warmup - 1)) {
+        printf("steady state: %u IR/IR-DYN/co_repair, %u co_common/pt_x of %u packets\n",
+               static_cast<unsigned int>(refreshes),
+               static_cast<unsigned int>(compressed),
+               static_cast<unsigned int>(count - warmup - 1));
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include <rohc/rohc.h>
+#include "network.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace ROHC;
+
+namespace {
+    /**
+     * HeaderCRC against the CRCs of all the header octets in wire order,
+     * with the static block set from one header and the other octets of
+     * the next headers changed at random
+     */
+    bool Check(const char* name, uint8_t version, size_t ipSize, size_t transportStatic, size_t headerSize)
+    {
+        uint8_t header[80];
+        for (size_t i = 0; i < sizeof(header); ++i) {
+            header[i] = static_cast<uint8_t>(rand());
+        }
+        header[0] = static_cast<uint8_t>((version << 4) | (header[0] & 0x0f));
+        const iphdr* ip = reinterpret_cast<const iphdr*>(header);
+
+        HeaderCRC crc;
+        crc.SetStatic(ip, transportStatic);
+        size_t staticBegin = (6 == version) ? 8 : 12;
+        size_t staticEnd = ipSize + transportStatic;
+
+        for (int n = 0; n < 1000; ++n) {
+            for (size_t i = 0; i < headerSize; ++i) {
+                if ((i >= staticBegin) && (i < staticEnd))
+                    continue;
+                header[i] = static_cast<uint8_t>(rand());
+            }
+            header[0] = static_cast<uint8_t>((version << 4) | (header[0] & 0x0f));
+
+            uint8_t crc3;
+            uint8_t crc7;
+            crc.Calculate(ip, headerSize, crc3, crc7);
+            if ((crc3 != CRC3(header, header + headerSize)) ||
+                (crc7 != CRC7(header, header + headerSize)) ||
+                (crc3 != crc.CRC3(ip, headerSize)) ||
+                (crc7 != crc.CRC7(ip, headerSize)))
+            {
+                printf("%s: header CRC differs from the CRC of the header\n", name);
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main()
+{
+    bool ok = Check("IPv4", 4, 20, 0, 20);
+    ok = Check("IPv4/UDP/RTP", 4, 20, 4, 40) && ok;
+    ok = Check("IPv4/TCP with options", 4, 20, 4, 60) && ok;
+    ok = Check("IPv6", 6, 40, 0, 40) && ok;
+    ok = Check("IPv6/UDP/RTP", 6, 40, 4, 60) && ok;
+    ok = Check("IPv6/ESP", 6, 40, 4, 48) && ok;
+    return ok ? 0 : 1;
+}
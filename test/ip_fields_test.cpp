@@ -0,0 +1,105 @@
+#include <rohc/compressor.h>
+#include <rohc/decomp.h>
+#include <stdio.h>
+#include "test_packets.h"
+
+using namespace ROHC;
+
+namespace {
+    typedef data_t (*packetBuilder_t)(uint16_t n);
+
+    data_t ESP(uint16_t n) {return ESPPacket(n, n);}
+    data_t UDP(uint16_t n) {return UDPPacket(n);}
+    data_t RTP(uint16_t n) {return RTPPacket(n, n);}
+
+    enum Field
+    {
+        FIELD_TTL,
+        FIELD_TOS,
+        FIELD_DF
+    };
+
+    void Change(data_t& packet, Field field)
+    {
+        switch (field) {
+        case FIELD_TTL: packet[8] = 63; break;
+        case FIELD_TOS: packet[1] = 0x10; break;
+        case FIELD_DF: packet[6] = 0; break;
+        }
+        IPv4Checksum(packet);
+    }
+
+    size_t PT0Count(Compressor& compressor)
+    {
+        return compressor.PacketCount(PT_0_CRC3) + compressor.PacketCount(PT_0_CRC7);
+    }
+
+    /**
+     * field changes after warmup packets, and the first lost packets with
+     * the new value never reach the decompressor. Every packet after them
+     * has to be restored, and the last ones sent as pt_0 again.
+     */
+    bool Check(const char* name, packetBuilder_t builder, Field field, unsigned int lost)
+    {
+        Compressor compressor(15, REORDERING_NONE, IP_ID_BEHAVIOUR_SEQUENTIAL);
+        Compressor peer(15, REORDERING_NONE, IP_ID_BEHAVIOUR_SEQUENTIAL);
+        Decompressor decompressor(false, &peer);
+        compressor.addRTPDestinationPort(testRTPPort);
+
+        const uint16_t warmup = 30;
+        const uint16_t total = 60;
+        unsigned int failures = 0;
+        size_t pt0 = 0;
+        for (uint16_t n = 1; n <= total; ++n) {
+            data_t packet = builder(n);
+            if (n > warmup) {
+                Change(packet, field);
+            }
+            if (n == total - 9) {
+                pt0 = PT0Count(compressor);
+            }
+            data_t compressed;
+            compressor.compress(packet, compressed);
+            if ((n > warmup) && (n <= warmup + lost))
+                continue;
+
+            data_t decompressed;
+            decompressor.Decompress(compressed, decompressed);
+            if (decompressed != packet) {
+                ++failures;
+            }
+        }
+
+        size_t lastPT0 = PT0Count(compressor) - pt0;
+        if (failures || (lastPT0 != 10)) {
+            printf("%s, %u lost: %u packets not restored, %u of the last 10 sent as pt_0\n",
+                   name, lost, failures, static_cast<unsigned int>(lastPT0));
+            return false;
+        }
+        return true;
+    }
+}
+
+/**
+ * A change of ttl, tos or df is repeated until the decompressor has it
+ * even if the first packets with it were lost
+ */
+int main()
+{
+    const packetBuilder_t builders[] = {ESP, UDP, RTP};
+    const char* names[] = {"ESP", "UDP", "RTP"};
+    const Field fields[] = {FIELD_TTL, FIELD_TOS, FIELD_DF};
+    const char* fieldNames[] = {"TTL", "TOS", "DF"};
+
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(builders) / sizeof(builders[0]); ++i) {
+        for (size_t j = 0; j < sizeof(fields) / sizeof(fields[0]); ++j) {
+            for (unsigned int lost = 0; lost <= 3; ++lost) {
+                char name[64];
+                snprintf(name, sizeof(name), "%s, %s changed", names[i], fieldNames[j]);
+                ok = Check(name, builders[i], fields[j], lost) && ok;
+            }
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+#include <rohc/compressor.h>
+#include <rohc/decomp.h>
+#include <stdio.h>
+#include "test_packets.h"
+
+using namespace ROHC;
+
+namespace {
+    typedef data_t (*packetBuilder_t)(uint16_t n);
+
+    data_t ESP(uint16_t n) {return ESPPacket(n, n);}
+    data_t UDP(uint16_t n) {return UDPPacket(n);}
+    data_t RTP(uint16_t n) {return RTPPacket(n, n);}
+    data_t TCP(uint16_t n) {return TCPPacket(n, 1000000u + 100u * n, 5000, 70000u + 3u * n, 90000);}
+
+    struct Flow
+    {
+        Flow(packetBuilder_t builder)
+        : builder(builder)
+        , compressor(15, REORDERING_NONE, IP_ID_BEHAVIOUR_SEQUENTIAL)
+        , peer(15, REORDERING_NONE, IP_ID_BEHAVIOUR_SEQUENTIAL)
+        , decompressor(false, &peer)
+        , n(1)
+        {
+            compressor.addRTPDestinationPort(testRTPPort);
+        }
+
+        // Sends the next packet, returns false if it was not restored
+        bool Send(PacketType expected, bool& isExpected)
+        {
+            data_t packet = builder(n++);
+            size_t before = compressor.PacketCount(expected);
+            data_t compressed;
+            compressor.compress(packet, compressed);
+            isExpected = compressor.PacketCount(expected) != before;
+
+            data_t decompressed;
+            decompressor.Decompress(compressed, decompressed);
+            return decompressed == packet;
+        }
+
+        // For CID 1, the first context after the uncompressed profile
+        void Feedback(FBAckType_t type)
+        {
+            data_t options;
+            compressor.ReceivedFeedback2(1, 0, type, options.begin(), options.end());
+        }
+
+        packetBuilder_t builder;
+        Compressor compressor;
+        Compressor peer;
+        Decompressor decompressor;
+        uint16_t n;
+    };
+
+    /**
+     * A NACK after warmup packets, and a STATIC-NACK two packets before it
+     * if staticNack, has to be answered with count packets of type
+     * expected, and no more
+     */
+    bool Check(const char* name, packetBuilder_t builder, size_t warmup, bool staticNack, PacketType expected, unsigned int count)
+    {
+        Flow flow(builder);
+        bool isExpected;
+        bool restored = true;
+        for (size_t i = 0; i < warmup; ++i) {
+            restored = flow.Send(expected, isExpected) && restored;
+        }
+        if (staticNack) {
+            flow.Feedback(FB_STATIC_NACK);
+            restored = flow.Send(expected, isExpected) && restored;
+            restored = flow.Send(expected, isExpected) && restored;
+        }
+        flow.Feedback(FB_NACK);
+
+        unsigned int sent = 0;
+        for (unsigned int i = 0; i <= count; ++i) {
+            restored = flow.Send(expected, isExpected) && restored;
+            if (!isExpected)
+                break;
+            ++sent;
+        }
+        if (!restored || (sent != count)) {
+            printf("%s: %u packets of the expected type after the NACK instead of %u%s\n",
+                   name, sent, count, restored ? "" : ", packets not restored");
+            return false;
+        }
+        return true;
+    }
+}
+
+/**
+ * A NACK is answered with the IRs while the context is still in IR state
+ * and with co_repair in FO and SO state, and is never taken for an ACK.
+ * TCP has no co_repair and answers with IR-DYN packets instead.
+ */
+int main()
+{
+    const packetBuilder_t builders[] = {ESP, UDP, RTP, TCP};
+    const char* names[] = {"ESP", "UDP", "RTP", "TCP"};
+    Compressor compressor(15, REORDERING_NONE, IP_ID_BEHAVIOUR_SEQUENTIAL);
+    const unsigned int irs = compressor.NumberOfIRPacketsToSend();
+    const unsigned int fos = compressor.NumberOfFOPacketsToSend();
+    const unsigned int repairs = compressor.NumberOfCORepairPacketsToSend();
+
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(builders) / sizeof(builders[0]); ++i) {
+        char name[64];
+        snprintf(name, sizeof(name), "%s, NACK in IR state", names[i]);
+        ok = Check(name, builders[i], 2, false, PT_IR, irs) && ok;
+        bool tcp = builders[i] == TCP;
+        PacketType repair = tcp ? PT_IR_DYN : PT_CO_REPAIR;
+        unsigned int repairCount = tcp ? irs : repairs;
+        snprintf(name, sizeof(name), "%s, NACK in FO state", names[i]);
+        ok = Check(name, builders[i], irs + 1, false, repair, repairCount) && ok;
+        snprintf(name, sizeof(name), "%s, NACK in SO state", names[i]);
+        ok = Check(name, builders[i], irs + fos + 20, false, repair, repairCount) && ok;
+        snprintf(name, sizeof(name), "%s, NACK after a STATIC-NACK", names[i]);
+        ok = Check(name, builders[i], irs + fos + 20, true, PT_IR, irs) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+#include <rohc/compressor.h>
+#include <rohc/decomp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "test_packets.h"
+
+using namespace ROHC;
+
+namespace {
+    typedef data_t (*packetBuilder_t)(uint16_t n, bool ipv6);
+
+    data_t IP(uint16_t n, bool ipv6) {return IPPacket(n, ipv6);}
+    data_t UDP(uint16_t n, bool ipv6) {return UDPPacket(n, ipv6);}
+    data_t ESP(uint16_t n, bool ipv6) {return ESPPacket(n, n, ipv6);}
+    data_t RTP(uint16_t n, bool ipv6) {return RTPPacket(n, n, ipv6);}
+    data_t UDPLite(uint16_t n, bool ipv6) {return UDPPacket(n, ipv6, true);}
+    data_t RTPLite(uint16_t n, bool ipv6) {return RTPPacket(n, n, ipv6, true);}
+
+    /**
+     * A bulk transfer: full segments, the ACK number moving every other
+     * segment, the timestamp every segment and its echo every fourth, and
+     * a SACK block in every tenth
+     */
+    data_t TCP(uint16_t n, bool ipv6)
+    {
+        uint32_t seq = 1000000u + 100u * n;
+        uint32_t ack = 5000u + 10u * (n / 2);
+        uint32_t tsval = 70000u + 3u * n;
+        uint32_t tsecr = 90000u + (n / 4);
+        bool sack = (n % 10) == 5;
+        return TCPPacket(n, seq, ack, tsval, tsecr, sack ? ack + 100 : 0, sack ? ack + 300 : 0, ipv6);
+    }
+
+    struct Profile
+    {
+        const char* name;
+        packetBuilder_t builder;
+        unsigned int id;
+    };
+
+    const Profile profiles[] = {
+        {"IP", IP, 0x0104},
+        {"UDP", UDP, 0x0102},
+        {"ESP", ESP, 0x0103},
+        {"RTP", RTP, 0x0101},
+        {"UDP-Lite", UDPLite, 0x0108},
+        {"RTP-Lite", RTPLite, 0x0107},
+        {"TCP", TCP, 0x0106},
+    };
+
+    const uint16_t count = 400;
+    // The last packets have to be restored after any loss
+    const uint16_t settled = 100;
+
+    /**
+     * count packets of a flow through a compressor and a decompressor that
+     * sends its feedback back to it, piggybacked on the packets. If lossy,
+     * a burst of packets longer than pt_0 covers and some single packets
+     * never reach the decompressor, whose ACKs have to keep the encodings
+     * decodable.
+     */
+    bool Check(const Profile& profile, bool ipv6, bool lossy)
+    {
+        Compressor compressor(15, REORDERING_NONE, IP_ID_BEHAVIOUR_SEQUENTIAL);
+        Decompressor decompressor(false, &compressor);
+        compressor.addRTPDestinationPort(testRTPPort);
+
+        srand(1);
+        unsigned int failures = 0;
+        unsigned int lost = 0;
+        for (uint16_t n = 1; n <= count; ++n) {
+            data_t packet = profile.builder(n, ipv6);
+            data_t compressed;
+            compressor.compress(packet, compressed);
+
+            if (lossy && (n < count - settled) &&
+                (((n >= 150) && (n < 170)) || !(rand() % 20))) {
+                ++lost;
+                continue;
+            }
+
+            data_t decompressed;
+            decompressor.Decompress(compressed, decompressed);
+            if (decompressed != packet) {
+                if (!lossy || (n >= count - settled)) {
+                    printf("%s over IPv%d%s: packet %u not restored\n", profile.name, ipv6 ? 6 : 4,
+                           lossy ? " with loss" : "", n);
+                    return false;
+                }
+                ++failures;
+            }
+        }
+
+        ContextStatistics context;
+        if (!compressor.ContextCounters(1, context) || (context.profileID != profile.id)) {
+            printf("%s over IPv%d: compressed with profile 0x%04x\n", profile.name, ipv6 ? 6 : 4, context.profileID);
+            return false;
+        }
+
+        // Most packets have to be sent with small headers
+        size_t small = compressor.PacketCount(PT_0_CRC3) + compressor.PacketCount(PT_0_CRC7);
+        for (int type = PT_1_RND; type <= PT_SEQ_8; ++type) {
+            small += compressor.PacketCount(static_cast<PacketType>(type));
+        }
+        if (small < count / 2) {
+            printf("%s over IPv%d%s: %u of %u packets with small headers\n", profile.name, ipv6 ? 6 : 4,
+                   lossy ? " with loss" : "", static_cast<unsigned int>(small), count);
+            return false;
+        }
+        if (lossy && !failures && !lost) {
+            printf("%s over IPv%d: nothing lost\n", profile.name, ipv6 ? 6 : 4);
+            return false;
+        }
+        return true;
+    }
+}
+
+/**
+ * Every profile over IPv4 and IPv6 restores each packet, and recovers
+ * through feedback from losses
+ */
+int main()
+{
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(profiles) / sizeof(profiles[0]); ++i) {
+        for (int ipv6 = 0; ipv6 <= 1; ++ipv6) {
+            ok = Check(profiles[i], ipv6 != 0, false) && ok;
+            ok = Check(profiles[i], ipv6 != 0, true) && ok;
+        }
+    }
+    return ok ? 0 : 1;
+}
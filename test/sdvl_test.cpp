@@ -0,0 +1,66 @@
+#include <rohc/rohc.h>
+#include "reader.h"
+#include <iterator>
+#include <stdio.h>
+
+using namespace ROHC;
+
+namespace {
+    size_t SDVLSize(uint32_t value)
+    {
+        return (value < 0x80) ? 1 : (value < 0x4000) ? 2 : (value < 0x200000) ? 3 : 4;
+    }
+
+    /**
+     * value encoded by SDVLEncode and decoded by ByteReader::ReadSDVL and
+     * SDVLDecode, and every truncation of it rejected
+     */
+    bool Check(uint32_t value)
+    {
+        data_t encoded;
+        SDVLEncode(std::back_inserter(encoded), value);
+        if (encoded.size() != SDVLSize(value)) {
+            printf("0x%x: %u octets\n", value, static_cast<unsigned int>(encoded.size()));
+            return false;
+        }
+
+        uint32_t decoded = 0;
+        ByteReader in(&encoded[0], &encoded[0] + encoded.size());
+        if ((PARSE_OK != in.ReadSDVL(decoded)) || (decoded != value) || in.Remaining()) {
+            printf("0x%x: ReadSDVL gave 0x%x\n", value, decoded);
+            return false;
+        }
+
+        uint32_t decodedIt = 0;
+        const data_t& constEncoded = encoded;
+        const_data_iterator pos = constEncoded.begin();
+        if (!SDVLDecode(pos, constEncoded.end(), &decodedIt) || (decodedIt != value) || (pos != constEncoded.end())) {
+            printf("0x%x: SDVLDecode gave 0x%x\n", value, decodedIt);
+            return false;
+        }
+
+        for (size_t size = 0; size < encoded.size(); ++size) {
+            ByteReader truncated(&encoded[0], &encoded[0] + size);
+            if (PARSE_TRUNCATED != truncated.ReadSDVL(decoded)) {
+                printf("0x%x: %u octets not reported as truncated\n", value, static_cast<unsigned int>(size));
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main()
+{
+    const uint32_t values[] = {
+        0, 1, 0x7f, 0x80, 0xa0, 0x3fff, 0x4000, 0x1fffff, 0x200000, 0x1fffffff,
+    };
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+        ok = Check(values[i]) && ok;
+    }
+    for (uint32_t value = 0; value < 0x20000; value += 7) {
+        ok = Check(value) && ok;
+    }
+    return ok ? 0 : 1;
+}
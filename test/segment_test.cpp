@@ -0,0 +1,86 @@
+#include <rohc/compressor.h>
+#include <rohc/decomp.h>
+#include <stdio.h>
+#include "test_packets.h"
+
+using namespace ROHC;
+
+namespace {
+    /**
+     * FEEDBACK-2 element for CID 0 (RFC 5225 6.9.1) of size octets in
+     * total, with the size octet and padded with options of zeros
+     */
+    void AddFeedback(Compressor& compressor, size_t size)
+    {
+        data_t element(size);
+        element[0] = CreateFeedback(0);
+        element[1] = static_cast<uint8_t>(size - 2);
+        element[3] = 5;
+        element[4] = CRC8(&element[2], &element[0] + size);
+        compressor.SendFeedback(element.begin(), element.end());
+    }
+
+    size_t CountFeedback(const data_t& packet)
+    {
+        size_t count = 0;
+        for (size_t pos = 0; (pos + 1 < packet.size()) && IsFeedback(packet[pos]); ++count) {
+            pos += 2 + packet[pos + 1];
+        }
+        return count;
+    }
+}
+
+/**
+ * Packets segmented to a small MTU with more piggybacked feedback than
+ * fits in it: every packet stays within the MTU, the feedback is spread
+ * over the packets and the decompressor restores each packet
+ */
+int main()
+{
+    const size_t mtu = 48;
+    Compressor compressor(15, REORDERING_NONE, IP_ID_BEHAVIOUR_SEQUENTIAL, 1000);
+    Compressor peer(15, REORDERING_NONE, IP_ID_BEHAVIOUR_SEQUENTIAL);
+    Decompressor decompressor(false, &peer, 1000);
+
+    AddFeedback(compressor, 32);
+    AddFeedback(compressor, 32);
+    AddFeedback(compressor, mtu + 10);
+    AddFeedback(compressor, 32);
+
+    size_t feedback = 0;
+    for (uint32_t sn = 1; sn <= 6; ++sn) {
+        data_t packet = ESPPacket(static_cast<uint16_t>(sn), sn);
+        std::vector<data_t> outputs;
+        compressor.compress(packet, outputs, mtu);
+
+        data_t decompressed;
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            if (outputs[i].size() > mtu) {
+                printf("packet %u: %u octets over the MTU\n", static_cast<unsigned int>(sn),
+                       static_cast<unsigned int>(outputs[i].size()));
+                return 1;
+            }
+            feedback += CountFeedback(outputs[i]);
+            decompressor.Decompress(outputs[i], decompressed);
+        }
+        if (decompressed != packet) {
+            printf("packet %u was not restored\n", static_cast<unsigned int>(sn));
+            return 1;
+        }
+    }
+
+    // The element larger than the MTU is dropped, the others sent
+    std::vector<data_t> outputs;
+    compressor.compress(ESPPacket(7, 7), outputs, 0);
+    if ((3 != feedback) || (1 != outputs.size()) || IsFeedback(outputs[0][0])) {
+        printf("%u feedback elements sent, 3 expected\n", static_cast<unsigned int>(feedback));
+        return 1;
+    }
+
+    compressor.compress(ESPPacket(8, 8), outputs, 1);
+    if (!outputs.empty()) {
+        printf("packet sent with an MTU of 1\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include <rohc/compressor.h>
+#include <pthread.h>
+#include <stdio.h>
+#include "test_packets.h"
+
+using namespace ROHC;
+
+namespace {
+    const unsigned int packets = 200000;
+
+    struct Shared
+    {
+        Compressor* compressor;
+        volatile int done;
+    };
+
+    void* Compress(void* arg)
+    {
+        Shared* shared = static_cast<Shared*>(arg);
+        data_t output;
+        for (unsigned int i = 0; i < packets; ++i) {
+            output.clear();
+            shared->compressor->compress(ESPPacket(static_cast<uint16_t>(i), i), output);
+        }
+        __atomic_store_n(&shared->done, 1, __ATOMIC_RELEASE);
+        return 0;
+    }
+
+    size_t TypedPackets(const CompressorStatistics& stats)
+    {
+        size_t sum = 0;
+        for (unsigned int type = PT_IR; type < PT_SEGMENT; ++type) {
+            sum += stats.packetCount[type];
+        }
+        return sum;
+    }
+}
+
+/**
+ * Snapshots taken while another thread compresses always count each
+ * packet both by its type and in the totals
+ */
+int main()
+{
+    Compressor compressor(15, REORDERING_NONE, IP_ID_BEHAVIOUR_SEQUENTIAL);
+    Shared shared = {&compressor, 0};
+    pthread_t thread;
+    pthread_create(&thread, 0, Compress, &shared);
+
+    bool ok = true;
+    unsigned int mismatches = 0;
+    while (!__atomic_load_n(&shared.done, __ATOMIC_ACQUIRE)) {
+        CompressorStatistics stats;
+        compressor.StatisticsSnapshot(stats);
+        if (TypedPackets(stats) != stats.numberOfPacketsSent) {
+            if (!mismatches++) {
+                printf("%u packets sent, %u counted by type\n", static_cast<unsigned int>(stats.numberOfPacketsSent),
+                       static_cast<unsigned int>(TypedPackets(stats)));
+            }
+            ok = false;
+        }
+    }
+    pthread_join(thread, 0);
+
+    CompressorStatistics stats;
+    compressor.StatisticsSnapshot(stats);
+    if ((stats.numberOfPacketsSent != packets) || (TypedPackets(stats) != packets)) {
+        printf("%u packets sent, %u counted by type instead of %u\n", static_cast<unsigned int>(stats.numberOfPacketsSent),
+               static_cast<unsigned int>(TypedPackets(stats)), packets);
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <rohc/rohc.h>
+
+namespace ROHC {
+    inline void put16(uint8_t* p, uint16_t v) {
+        p[0] = static_cast<uint8_t>(v >> 8);
+        p[1] = static_cast<uint8_t>(v);
+    }
+
+    inline void put32(uint8_t* p, uint32_t v) {
+        put16(p, static_cast<uint16_t>(v >> 16));
+        put16(p + 2, static_cast<uint16_t>(v));
+    }
+
+    const uint16_t testRTPPort = 5004;
+
+    /**
+     * Sets the header checksum of the IPv4 header at the start of packet
+     */
+    inline void IPv4Checksum(data_t& packet)
+    {
+        uint8_t* p = &packet[0];
+        put16(p + 10, 0);
+        uint32_t sum = 0;
+        for (size_t i = 0; i < 20; i += 2) {
+            sum += (p[i] << 8) | p[i + 1];
+        }
+        while (sum >> 16) {
+            sum = (sum & 0xffff) + (sum >> 16);
+        }
+        put16(p + 10, static_cast<uint16_t>(~sum));
+    }
+
+    /**
+     * IPv4 header at the start of packet, for a packet of its size
+     */
+    inline void IPv4Header(data_t& packet, uint8_t protocol, uint16_t id)
+    {
+        uint8_t* p = &packet[0];
+        p[0] = 0x45;
+        put16(p + 2, static_cast<uint16_t>(packet.size()));
+        put16(p + 4, id);
+        put16(p + 6, 0x4000);
+        p[8] = 64;
+        p[9] = protocol;
+        put32(p + 12, 0x0a000001);
+        put32(p + 16, 0x0a000100);
+        IPv4Checksum(packet);
+    }
+
+    /**
+     * IPv6 header at the start of packet, for a packet of its size
+     */
+    inline void IPv6Header(data_t& packet, uint8_t nextHeader)
+    {
+        uint8_t* p = &packet[0];
+        put32(p, 0x60012345);
+        put16(p + 4, static_cast<uint16_t>(packet.size() - 40));
+        p[6] = nextHeader;
+        p[7] = 64;
+        put32(p + 8, 0x20010db8);
+        put32(p + 20, 1);
+        put32(p + 24, 0x20010db8);
+        put32(p + 36, 0x100);
+    }
+
+    inline size_t IPSize(bool ipv6)
+    {
+        return ipv6 ? 40 : 20;
+    }
+
+    /**
+     * IPv4 or IPv6 header, the IP-ID is only used for IPv4
+     */
+    inline void IPHeader(data_t& packet, bool ipv6, uint8_t protocol, uint16_t id)
+    {
+        if (ipv6)
+            IPv6Header(packet, protocol);
+        else
+            IPv4Header(packet, protocol, id);
+    }
+
+    inline void FillPayload(data_t& packet, size_t begin, uint32_t seed)
+    {
+        for (size_t i = begin; i < packet.size(); ++i) {
+            packet[i] = static_cast<uint8_t>(i ^ seed);
+        }
+    }
+
+    /**
+     * IP packet of a protocol no other profile than IP-only takes, 253
+     * is for experimentation (RFC 3692)
+     */
+    inline data_t IPPacket(uint16_t id, bool ipv6 = false)
+    {
+        data_t packet(IPSize(ipv6) + 40);
+        IPHeader(packet, ipv6, 253, id);
+        FillPayload(packet, IPSize(ipv6), id);
+        return packet;
+    }
+
+    /**
+     * ESP packet with sequence number sn
+     */
+    inline data_t ESPPacket(uint16_t id, uint32_t sn, bool ipv6 = false)
+    {
+        size_t ip = IPSize(ipv6);
+        data_t packet(ip + 8 + 40);
+        IPHeader(packet, ipv6, 50, id);
+        uint8_t* p = &packet[ip];
+        put32(p, 0xabc00000);
+        put32(p + 4, sn);
+        FillPayload(packet, ip + 8, sn);
+        return packet;
+    }
+
+    /**
+     * UDP or UDP-Lite header after the IP header, covering the whole
+     * packet. IPv4 UDP goes without checksum, it is mandatory otherwise.
+     */
+    inline void UDPHeader(data_t& packet, bool ipv6, bool lite, uint16_t dport, uint16_t checksum)
+    {
+        size_t ip = IPSize(ipv6);
+        uint8_t* p = &packet[ip];
+        put16(p, 4000);
+        put16(p + 2, dport);
+        put16(p + 4, static_cast<uint16_t>(packet.size() - ip));
+        put16(p + 6, (ipv6 || lite) ? checksum : 0);
+    }
+
+    /**
+     * UDP, or UDP-Lite if lite, packet
+     */
+    inline data_t UDPPacket(uint16_t id, bool ipv6 = false, bool lite = false)
+    {
+        size_t ip = IPSize(ipv6);
+        data_t packet(ip + 8 + 40);
+        IPHeader(packet, ipv6, lite ? 136 : 17, id);
+        UDPHeader(packet, ipv6, lite, 4001, static_cast<uint16_t>(0x1000 + id));
+        FillPayload(packet, ip + 8, id);
+        return packet;
+    }
+
+    /**
+     * RTP packet to testRTPPort over UDP, or UDP-Lite if lite, 160
+     * timestamp units per packet
+     */
+    inline data_t RTPPacket(uint16_t id, uint16_t sn, bool ipv6 = false, bool lite = false)
+    {
+        size_t ip = IPSize(ipv6);
+        data_t packet(ip + 8 + 12 + 40);
+        IPHeader(packet, ipv6, lite ? 136 : 17, id);
+        UDPHeader(packet, ipv6, lite, testRTPPort, static_cast<uint16_t>(0x1000 + sn));
+        uint8_t* p = &packet[ip + 8];
+        p[0] = 0x80;
+        p[1] = 8;
+        put16(p + 2, sn);
+        put32(p + 4, 160u * sn);
+        put32(p + 8, 0x12345678);
+        FillPayload(packet, ip + 8 + 12, sn);
+        return packet;
+    }
+
+    /**
+     * TCP segment with ACK and PSH set and the timestamp option. A SACK
+     * block is added if sackEnd is not 0.
+     */
+    inline data_t TCPPacket(uint16_t id, uint32_t seq, uint32_t ack, uint32_t tsval, uint32_t tsecr,
+                            uint32_t sackBegin = 0, uint32_t sackEnd = 0, bool ipv6 = false)
+    {
+        size_t ip = IPSize(ipv6);
+        size_t options = sackEnd ? 24 : 12;
+        data_t packet(ip + 20 + options + 100);
+        IPHeader(packet, ipv6, 6, id);
+        uint8_t* p = &packet[ip];
+        put16(p, 4000);
+        put16(p + 2, 80);
+        put32(p + 4, seq);
+        put32(p + 8, ack);
+        p[12] = static_cast<uint8_t>(((20 + options) / 4) << 4);
+        p[13] = 0x18;
+        put16(p + 14, 1024);
+        put16(p + 16, static_cast<uint16_t>(0x2000 + id));
+
+        uint8_t* o = p + 20;
+        o[0] = 1;
+        o[1] = 1;
+        o[2] = 8;
+        o[3] = 10;
+        put32(o + 4, tsval);
+        put32(o + 8, tsecr);
+        if (sackEnd) {
+            o[12] = 1;
+            o[13] = 1;
+            o[14] = 5;
+            o[15] = 10;
+            put32(o + 16, sackBegin);
+            put32(o + 20, sackEnd);
+        }
+        FillPayload(packet, ip + 20 + options, seq);
+        return packet;
+    }
+}